@@ -14,10 +14,18 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <string.h>
 #include "channels.h"
+#include "primitives.h"
 #include "private.h"
 
+#if defined(__SSE2__) && !HAVE_BIG_ENDIAN
+#define USE_X86_SIMD 1
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#include <immintrin.h>
+#endif
+
 /*
  * Clamps a 24-bit value from a 32-bit sample
  */
@@ -345,13 +353,205 @@ static inline uint8x3_t int32_to_uint8x3(int32_t in) {
     for (src_index = 0; src_index < num_in_samples; src_index += in_buff_chans) { \
         temp = uint8x3_to_int32(*src_ptr++); \
         temp += uint8x3_to_int32(*src_ptr++); \
-        *dst_ptr = int32_to_uint8x3(temp >> 1); \
+        *dst_ptr++ = int32_to_uint8x3(temp >> 1); \
         src_ptr += num_skip_samples; \
     } \
     /* return number of *bytes* generated */ \
     return num_out_samples * sizeof(*(out_buff)); \
 }
 
+/* Shuffle kernels of adjust_channels() for the common channel counts of 16 and 32 bit samples.
+ * A block of frames fills a whole number of 16 byte vectors at the input and at the output,
+ * each output vector is the OR of byte shuffles of the input vectors. The shuffle controls
+ * are computed once, on first use. Contraction to mono shuffles the first and the second
+ * channel separately and averages them like CONTRACT_TO_MONO().
+ * The byte shuffle needs SSSE3, the kernels are enabled at the AVX2 level of primitives.h.
+ */
+#ifdef USE_X86_SIMD
+
+#define SHUFFLE_MAX_VECS 4
+
+typedef struct {
+    uint8_t in_chans;
+    uint8_t out_chans;
+    uint8_t sample_size;
+    uint8_t frames;         /* frames per block */
+    uint8_t in_vecs;        /* input vectors per block */
+    uint8_t out_vecs;       /* output vectors per block */
+    /* [first, second channel of mono][output vector][input vector] byte shuffle */
+    int8_t ctrl[2][SHUFFLE_MAX_VECS][SHUFFLE_MAX_VECS][16];
+} channel_shuffle_t;
+
+static const uint8_t shuffle_chans[][2] = {
+    {1, 2}, {2, 1}, {2, 6}, {6, 2}, {2, 8}, {8, 2}, {6, 8}, {8, 6},
+};
+
+static channel_shuffle_t shuffle_table[2][sizeof(shuffle_chans) / sizeof(shuffle_chans[0])];
+static pthread_once_t shuffle_once = PTHREAD_ONCE_INIT;
+
+/* input channel of output channel out_chan, or -1 for silence, as the scalar macros */
+static int shuffle_source(size_t in_chans, size_t out_chans, size_t out_chan, int second)
+{
+    if (out_chans == 1) {
+        return second;
+    } else if (in_chans == 1) {
+        return out_chan < 2 ? 0 : -1;
+    }
+    return out_chan < in_chans ? (int)out_chan : -1;
+}
+
+static void shuffle_table_init(void)
+{
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t c = 0; c < sizeof(shuffle_chans) / sizeof(shuffle_chans[0]); c++) {
+            channel_shuffle_t *table = &shuffle_table[s][c];
+            const size_t size = s == 0 ? sizeof(int16_t) : sizeof(int32_t);
+            const size_t in_frame = shuffle_chans[c][0] * size;
+            const size_t out_frame = shuffle_chans[c][1] * size;
+            size_t frames = 1;
+            while ((frames * in_frame) % 16 != 0 || (frames * out_frame) % 16 != 0) {
+                frames++;
+            }
+            table->in_chans = shuffle_chans[c][0];
+            table->out_chans = shuffle_chans[c][1];
+            table->sample_size = size;
+            table->frames = frames;
+            table->in_vecs = frames * in_frame / 16;
+            table->out_vecs = frames * out_frame / 16;
+            memset(table->ctrl, -1, sizeof(table->ctrl));
+            for (int second = 0; second < (table->out_chans == 1 ? 2 : 1); second++) {
+                for (size_t p = 0; p < frames * out_frame; p++) {
+                    const int src = shuffle_source(table->in_chans, table->out_chans,
+                                                   p % out_frame / size, second);
+                    if (src >= 0) {
+                        const size_t q = p / out_frame * in_frame + src * size + p % size;
+                        table->ctrl[second][p / 16][q / 16][p % 16] = q % 16;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static const channel_shuffle_t *shuffle_find(size_t in_chans, size_t out_chans,
+                                             unsigned sample_size_in_bytes)
+{
+    if (audio_utils_get_simd_level() < AUDIO_UTILS_SIMD_AVX2
+            || (sample_size_in_bytes != sizeof(int16_t)
+                    && sample_size_in_bytes != sizeof(int32_t))) {
+        return NULL;
+    }
+    pthread_once(&shuffle_once, shuffle_table_init);
+    for (size_t c = 0; c < sizeof(shuffle_chans) / sizeof(shuffle_chans[0]); c++) {
+        if (shuffle_chans[c][0] == in_chans && shuffle_chans[c][1] == out_chans) {
+            return &shuffle_table[sample_size_in_bytes == sizeof(int32_t)][c];
+        }
+    }
+    return NULL;
+}
+
+/* Converts whole blocks, downwards from the end when expanding and upwards otherwise so that
+ * in-place use stays valid. Returns the number of frames converted, the last ones of the
+ * buffer when expanding and the first ones when contracting. With float_buff, the output is
+ * converted to float there instead of stored to out_buff, the buffers must not overlap.
+ * in_vecs and out_vecs are constants of each caller, so that the loops unroll and the
+ * controls stay in registers.
+ */
+static inline __attribute__((always_inline)) SSSE3_TARGET size_t shuffle_run(
+        const channel_shuffle_t *table, const void *in_buff, void *out_buff,
+        float *float_buff, size_t frames, const size_t in_vecs, const size_t out_vecs)
+{
+    const size_t blocks = frames / table->frames;
+    const int mono = table->out_chans == 1;
+    const int mono16 = mono && table->sample_size == sizeof(int16_t);
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+    const uint8_t *src = (const uint8_t *)in_buff;
+    uint8_t *dst = (uint8_t *)out_buff;
+    ptrdiff_t in_step = in_vecs * 16;
+    ptrdiff_t out_step = out_vecs * 16;
+    __m128i ctrl[2][SHUFFLE_MAX_VECS][SHUFFLE_MAX_VECS];
+
+    if (blocks == 0) {
+        return 0;
+    }
+    for (size_t o = 0; o < out_vecs; o++) {
+        for (size_t i = 0; i < in_vecs; i++) {
+            ctrl[0][o][i] = _mm_loadu_si128((const __m128i *)table->ctrl[0][o][i]);
+            ctrl[1][o][i] = _mm_loadu_si128((const __m128i *)table->ctrl[1][o][i]);
+        }
+    }
+    if (table->out_chans > table->in_chans && float_buff == NULL) {
+        const size_t first = frames - blocks * table->frames;
+        src += first * table->in_chans * table->sample_size + (blocks - 1) * in_step;
+        dst += first * table->out_chans * table->sample_size + (blocks - 1) * out_step;
+        in_step = -in_step;
+        out_step = -out_step;
+    }
+    for (size_t b = 0; b < blocks; b++) {
+        __m128i in[SHUFFLE_MAX_VECS];
+        for (size_t i = 0; i < in_vecs; i++) {
+            in[i] = _mm_loadu_si128((const __m128i *)src + i);
+        }
+        for (size_t o = 0; o < out_vecs; o++) {
+            __m128i out = _mm_shuffle_epi8(in[0], ctrl[0][o][0]);
+            for (size_t i = 1; i < in_vecs; i++) {
+                out = _mm_or_si128(out, _mm_shuffle_epi8(in[i], ctrl[0][o][i]));
+            }
+            if (mono) {
+                /* average of the first two channels as CONTRACT_TO_MONO() */
+                __m128i second = _mm_shuffle_epi8(in[0], ctrl[1][o][0]);
+                for (size_t i = 1; i < in_vecs; i++) {
+                    second = _mm_or_si128(second, _mm_shuffle_epi8(in[i], ctrl[1][o][i]));
+                }
+                const __m128i both = _mm_and_si128(out, second);
+                const __m128i either = _mm_xor_si128(out, second);
+                out = mono16 ? _mm_add_epi16(both, _mm_srai_epi16(either, 1))
+                             : _mm_add_epi32(both, _mm_srai_epi32(either, 1));
+            }
+            if (float_buff != NULL) {
+                const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(out, out), 16);
+                const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(out, out), 16);
+                _mm_storeu_ps(float_buff, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(float_buff + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+                float_buff += 8;
+            } else {
+                _mm_storeu_si128((__m128i *)dst + o, out);
+            }
+        }
+        src += in_step;
+        dst += out_step;
+    }
+    return blocks * table->frames;
+}
+
+static SSSE3_TARGET size_t shuffle_channels(const channel_shuffle_t *table,
+                                            const void *in_buff, void *out_buff,
+                                            float *float_buff, size_t frames)
+{
+    switch (table->in_vecs * 8 + table->out_vecs) {
+    case 1 * 8 + 2:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 1, 2);
+    case 2 * 8 + 1:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 2, 1);
+    case 1 * 8 + 3:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 1, 3);
+    case 3 * 8 + 1:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 3, 1);
+    case 1 * 8 + 4:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 1, 4);
+    case 4 * 8 + 1:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 4, 1);
+    case 3 * 8 + 4:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 3, 4);
+    case 4 * 8 + 3:
+        return shuffle_run(table, in_buff, out_buff, float_buff, frames, 4, 3);
+    default:
+        return 0;
+    }
+}
+
+#endif // USE_X86_SIMD
+
 /*
  * Convert a buffer of N-channel, interleaved samples to M-channel
  * (where N > M).
@@ -372,6 +572,21 @@ static size_t contract_channels(const void* in_buff, size_t in_buff_chans,
                                 void* out_buff, size_t out_buff_chans,
                                 unsigned sample_size_in_bytes, size_t num_in_bytes)
 {
+#ifdef USE_X86_SIMD
+    const channel_shuffle_t *table =
+            shuffle_find(in_buff_chans, out_buff_chans, sample_size_in_bytes);
+    const size_t in_frame = in_buff_chans * sample_size_in_bytes;
+    if (table != NULL && num_in_bytes % in_frame == 0
+            && num_in_bytes / in_frame >= table->frames) {
+        const size_t frames = num_in_bytes / in_frame;
+        const size_t done = shuffle_channels(table, in_buff, out_buff, NULL, frames);
+        /* the remaining frames are less than a block */
+        contract_channels((const uint8_t*)in_buff + done * in_frame, in_buff_chans,
+                          (uint8_t*)out_buff + done * out_buff_chans * sample_size_in_bytes,
+                          out_buff_chans, sample_size_in_bytes, (frames - done) * in_frame);
+        return frames * out_buff_chans * sample_size_in_bytes;
+    }
+#endif
     switch (sample_size_in_bytes) {
     case 1:
         if (out_buff_chans == 1) {
@@ -490,6 +705,20 @@ static size_t expand_channels(const void* in_buff, size_t in_buff_chans,
                               void* out_buff, size_t out_buff_chans,
                               unsigned sample_size_in_bytes, size_t num_in_bytes)
 {
+#ifdef USE_X86_SIMD
+    const channel_shuffle_t *table =
+            shuffle_find(in_buff_chans, out_buff_chans, sample_size_in_bytes);
+    const size_t in_frame = in_buff_chans * sample_size_in_bytes;
+    if (table != NULL && num_in_bytes % in_frame == 0
+            && num_in_bytes / in_frame >= table->frames) {
+        const size_t frames = num_in_bytes / in_frame;
+        const size_t done = shuffle_channels(table, in_buff, out_buff, NULL, frames);
+        /* the remaining frames are less than a block */
+        expand_channels(in_buff, in_buff_chans, out_buff, out_buff_chans,
+                        sample_size_in_bytes, (frames - done) * in_frame);
+        return frames * out_buff_chans * sample_size_in_bytes;
+    }
+#endif
     static const uint8x3_t packed24_zero; /* zero 24 bit sample */
 
     switch (sample_size_in_bytes) {
@@ -709,3 +938,45 @@ size_t adjust_channels_non_destructive(const void* in_buff, size_t in_buff_chans
 
     return num_in_bytes;
 }
+
+size_t adjust_channels_to_float_from_i16(const int16_t* in_buff, size_t in_buff_chans,
+                       float* out_buff, size_t out_buff_chans, size_t num_in_bytes)
+{
+    const size_t in_frame = in_buff_chans * sizeof(int16_t);
+    size_t frames = num_in_bytes / in_frame;
+    const size_t num_out_bytes = frames * out_buff_chans * sizeof(float);
+
+    if (in_buff_chans == out_buff_chans) {
+        memcpy_to_float_from_i16(out_buff, in_buff, frames * out_buff_chans);
+        return num_out_bytes;
+    }
+#ifdef USE_X86_SIMD
+    const channel_shuffle_t *table =
+            shuffle_find(in_buff_chans, out_buff_chans, sizeof(int16_t));
+    if (table != NULL) {
+        const size_t done = shuffle_channels(table, in_buff, NULL, out_buff, frames);
+        in_buff += done * in_buff_chans;
+        out_buff += done * out_buff_chans;
+        frames -= done;
+    }
+#endif
+    /* in chunks of a local buffer through the int16 output format */
+    int16_t temp[256];
+    const size_t max_chans = in_buff_chans > out_buff_chans ? in_buff_chans : out_buff_chans;
+    const size_t chunk = max_chans <= 256 ? 256 / max_chans : 0;
+    if (chunk == 0 && frames != 0) {
+        return 0;
+    }
+    while (frames > 0) {
+        const size_t n = frames < chunk ? frames : chunk;
+        if (adjust_channels(in_buff, in_buff_chans, temp, out_buff_chans, sizeof(int16_t),
+                            n * in_frame) == 0) {
+            return 0;
+        }
+        memcpy_to_float_from_i16(out_buff, temp, n * out_buff_chans);
+        in_buff += n * in_buff_chans;
+        out_buff += n * out_buff_chans;
+        frames -= n;
+    }
+    return num_out_bytes;
+}
@@ -17,6 +17,8 @@
 #ifndef ANDROID_AUDIO_CHANNELS_H
 #define ANDROID_AUDIO_CHANNELS_H
 
+#include <stdint.h>
+
 /** \cond */
 __BEGIN_DECLS
 /** \endcond */
@@ -94,6 +96,26 @@ size_t adjust_channels_non_destructive(const void* in_buff, size_t in_buff_chans
                        void* out_buff, size_t out_buff_chans,
                        unsigned sample_size_in_bytes, size_t num_in_bytes);
 
+/**
+ * Expands or contracts int16 sample data from one interleaved channel format to another,
+ * as adjust_channels(), and converts the result to float as memcpy_to_float_from_i16(),
+ * in a single pass for the channel counts with a vectorized kernel.
+ *
+ *   \param in_buff              points to the buffer of int16 samples
+ *   \param in_buff_chans        Specifies the number of channels in the input buffer.
+ *   \param out_buff             points to the buffer to receive the float samples.
+ *   \param out_buff_chans       Specifies the number of channels in the output buffer.
+ *   \param num_in_bytes         size of input buffer in bytes
+ *
+ * \return
+ *   the number of bytes of output data or 0 if an error occurs.
+ *
+ * \note
+ *   The out and in buffers must be completely separate (non-overlapping).
+ */
+size_t adjust_channels_to_float_from_i16(const int16_t* in_buff, size_t in_buff_chans,
+                       float* out_buff, size_t out_buff_chans, size_t num_in_bytes);
+
 /** \cond */
 __END_DECLS
 /** \endcond */
@@ -15,11 +15,410 @@
  */
 
 // #include <cutils/bitops.h>  /* for popcount() */
+#include <stdatomic.h>
+#include <string.h>
+
 #include "primitives.h"
 #include "private.h"
 
+/* x86 vectorized kernels. Each kernel converts a whole number of vectors and returns the
+ * number of samples done, the portable loop of the public function converts the rest.
+ * Kernels of shrinking conversions go upwards from the start of the buffers, kernels of
+ * expanding conversions go downwards from the end, so that in-place use stays valid.
+ * Rounding is done on the truncated integer with the remaining fraction, which gives the
+ * same ties away from zero as roundf() and the portable clamp*_from_float() functions.
+ * AVX2 kernels are compiled for that target only and selected at run time.
+ */
+#if defined(__SSE2__) && !HAVE_BIG_ENDIAN
+#define USE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#ifdef USE_X86_SIMD
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+/* read by the conversions of every thread, the first use picks the best level */
+static atomic_int sSimdLevel = -1;
+
+static audio_utils_simd_t best_simd_level(void)
+{
+#ifdef USE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return AUDIO_UTILS_SIMD_AVX2;
+    }
+    return AUDIO_UTILS_SIMD_SSE2;
+#else
+    return AUDIO_UTILS_SIMD_NONE;
+#endif
+}
+
+audio_utils_simd_t audio_utils_get_simd_level(void)
+{
+    int level = atomic_load_explicit(&sSimdLevel, memory_order_relaxed);
+    if (level < 0) {
+        level = best_simd_level();
+        atomic_store_explicit(&sSimdLevel, level, memory_order_relaxed);
+    }
+    return (audio_utils_simd_t)level;
+}
+
+audio_utils_simd_t audio_utils_set_simd_level(audio_utils_simd_t level)
+{
+    const audio_utils_simd_t best = best_simd_level();
+    const audio_utils_simd_t set = level < best ? level : best;
+    atomic_store_explicit(&sSimdLevel, set, memory_order_relaxed);
+    return set;
+}
+
+/* next xorshift32 state and the TPDF dither in lsb in ]-1.0, 1.0[ derived from it */
+static inline uint32_t dither_next(uint32_t x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static inline float dither_from_state(uint32_t x)
+{
+    return ((int32_t)(x >> 16) + (int32_t)(x & 0xFFFF) - 0xFFFF) * (1.f / 65536.f);
+}
+
+#ifdef USE_X86_SIMD
+
+/* round to nearest, ties away from zero, of values already clamped to the int32 range */
+static inline __m128i round_sse2(__m128 x)
+{
+    __m128i t = _mm_cvttps_epi32(x);
+    const __m128 d = _mm_sub_ps(x, _mm_cvtepi32_ps(t));
+    t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(d, _mm_set1_ps(0.5f))));
+    return _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(d, _mm_set1_ps(-0.5f))));
+}
+
+static inline AVX2_TARGET __m256i round_avx2(__m256 x)
+{
+    __m256i t = _mm256_cvttps_epi32(x);
+    const __m256 d = _mm256_sub_ps(x, _mm256_cvtepi32_ps(t));
+    t = _mm256_sub_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(d, _mm256_set1_ps(0.5f),
+                                                             _CMP_GE_OQ)));
+    return _mm256_add_epi32(t, _mm256_castps_si256(_mm256_cmp_ps(d, _mm256_set1_ps(-0.5f),
+                                                                _CMP_LE_OQ)));
+}
+
+/* clamp scaled values to [-lim, lim - 1] and round, as clamp16_from_float() and
+ * clamp24_from_float(); min is first so that NaN gives the positive limit like fminf() */
+static inline __m128i clamp_round_sse2(__m128 x, float lim)
+{
+    x = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(lim - 1.f)), _mm_set1_ps(-lim));
+    return round_sse2(x);
+}
+
+static inline AVX2_TARGET __m256i clamp_round_avx2(__m256 x, float lim)
+{
+    x = _mm256_max_ps(_mm256_min_ps(x, _mm256_set1_ps(lim - 1.f)), _mm256_set1_ps(-lim));
+    return round_avx2(x);
+}
+
+/* scale and round, saturating at limits -lim and lim as clampq4_27_from_float() and
+ * clamp32_from_float() */
+static inline __m128i saturate_round_sse2(__m128 f, float lim, float scale)
+{
+    const __m128i t = round_sse2(_mm_mul_ps(f, _mm_set1_ps(scale)));
+    const __m128i pos = _mm_castps_si128(_mm_cmpge_ps(f, _mm_set1_ps(lim)));
+    const __m128i neg = _mm_castps_si128(_mm_cmple_ps(f, _mm_set1_ps(-lim)));
+    return _mm_or_si128(_mm_andnot_si128(_mm_or_si128(pos, neg), t),
+                        _mm_or_si128(_mm_and_si128(pos, _mm_set1_epi32(0x7fffffff)),
+                                     _mm_and_si128(neg, _mm_set1_epi32(INT32_MIN))));
+}
+
+static inline AVX2_TARGET __m256i saturate_round_avx2(__m256 f, float lim, float scale)
+{
+    const __m256i t = round_avx2(_mm256_mul_ps(f, _mm256_set1_ps(scale)));
+    const __m256i pos = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_set1_ps(lim), _CMP_GE_OQ));
+    const __m256i neg = _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_set1_ps(-lim),
+                                                          _CMP_LE_OQ));
+    return _mm256_blendv_epi8(_mm256_blendv_epi8(t, _mm256_set1_epi32(0x7fffffff), pos),
+                              _mm256_set1_epi32(INT32_MIN), neg);
+}
+
+/* float to int16 */
+static size_t i16_from_float_sse2(int16_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(32768.f);
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        const __m128i a = clamp_round_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), 32768.f);
+        const __m128i b = clamp_round_sse2(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale),
+                                           32768.f);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a, b));
+    }
+    return i;
+}
+
+static size_t AVX2_TARGET i16_from_float_avx2(int16_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(32768.f);
+    size_t i;
+    for (i = 0; i + 16 <= count; i += 16) {
+        const __m256i a = clamp_round_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale),
+                                           32768.f);
+        const __m256i b = clamp_round_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale),
+                                           32768.f);
+        /* packs works per 128 bit lane, restore the sample order */
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+    }
+    return i;
+}
+
+/* float to int16 with dither, the 4 generators are stepped together so state->next
+ * must be 0 on entry and is 0 on return */
+static inline __m128i dither_next_sse2(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+static inline __m128 dither_from_state_sse2(__m128i x)
+{
+    const __m128i sum = _mm_add_epi32(_mm_srli_epi32(x, 16),
+                                      _mm_and_si128(x, _mm_set1_epi32(0xFFFF)));
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sum, _mm_set1_epi32(0xFFFF))),
+                      _mm_set1_ps(1.f / 65536.f));
+}
+
+static size_t i16_from_float_with_dither_sse2(int16_t *dst, const float *src, size_t count,
+                                              dither_state_t *state)
+{
+    const __m128 scale = _mm_set1_ps(32768.f);
+    __m128i s0 = _mm_loadu_si128((const __m128i *)state->seed);
+    __m128i s1;
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        s1 = dither_next_sse2(s0);
+        s0 = dither_next_sse2(s1);
+        const __m128 a = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale),
+                                    dither_from_state_sse2(s1));
+        const __m128 b = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale),
+                                    dither_from_state_sse2(s0));
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_packs_epi32(clamp_round_sse2(a, 32768.f),
+                                         clamp_round_sse2(b, 32768.f)));
+    }
+    _mm_storeu_si128((__m128i *)state->seed, s0);
+    return i;
+}
+
+static size_t AVX2_TARGET i16_from_float_with_dither_avx2(int16_t *dst, const float *src,
+                                                          size_t count, dither_state_t *state)
+{
+    const __m256 scale = _mm256_set1_ps(32768.f);
+    __m128i s0 = _mm_loadu_si128((const __m128i *)state->seed);
+    __m128i s1, s2, s3;
+    size_t i;
+    for (i = 0; i + 16 <= count; i += 16) {
+        s1 = dither_next_sse2(s0);
+        s2 = dither_next_sse2(s1);
+        s3 = dither_next_sse2(s2);
+        s0 = dither_next_sse2(s3);
+        const __m256 a = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale),
+                                       _mm256_set_m128(dither_from_state_sse2(s2),
+                                                       dither_from_state_sse2(s1)));
+        const __m256 b = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale),
+                                       _mm256_set_m128(dither_from_state_sse2(s0),
+                                                       dither_from_state_sse2(s3)));
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_permute4x64_epi64(
+                                    _mm256_packs_epi32(clamp_round_avx2(a, 32768.f),
+                                                       clamp_round_avx2(b, 32768.f)), 0xD8));
+    }
+    _mm_storeu_si128((__m128i *)state->seed, s0);
+    return i;
+}
+
+/* int16 to float, downwards */
+static size_t float_from_i16_sse2(float *dst, const int16_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+    size_t i;
+    for (i = count; i >= 8; i -= 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(src + i - 8));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i - 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        _mm_storeu_ps(dst + i - 8, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    }
+    return count - i;
+}
+
+static size_t AVX2_TARGET float_from_i16_avx2(float *dst, const int16_t *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.f / 32768.f);
+    size_t i;
+    for (i = count; i >= 16; i -= 16) {
+        const __m128i lo = _mm_loadu_si128((const __m128i *)(src + i - 16));
+        const __m128i hi = _mm_loadu_si128((const __m128i *)(src + i - 8));
+        _mm256_storeu_ps(dst + i - 8,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)), scale));
+        _mm256_storeu_ps(dst + i - 16,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)), scale));
+    }
+    return count - i;
+}
+
+/* Q4.27, Q8.23 or Q0.31 to float by a power of 2, exact after the int32 to float rounding */
+static size_t float_from_i32_scaled_sse2(float *dst, const int32_t *src, size_t count,
+                                         float scale)
+{
+    size_t i;
+    for (i = 0; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_loadu_si128((const __m128i *)(src + i))), _mm_set1_ps(scale)));
+    }
+    return i;
+}
+
+static size_t AVX2_TARGET float_from_i32_scaled_avx2(float *dst, const int32_t *src,
+                                                     size_t count, float scale)
+{
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(
+                _mm256_loadu_si256((const __m256i *)(src + i))), _mm256_set1_ps(scale)));
+    }
+    return i;
+}
+
+/* float to Q4.27 or Q0.31 saturated at +/-lim, as clampq4_27_from_float() and
+ * clamp32_from_float() */
+static size_t i32_from_float_saturate_sse2(int32_t *dst, const float *src, size_t count,
+                                           float lim, float scale)
+{
+    size_t i;
+    for (i = 0; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         saturate_round_sse2(_mm_loadu_ps(src + i), lim, scale));
+    }
+    return i;
+}
+
+static size_t AVX2_TARGET i32_from_float_saturate_avx2(int32_t *dst, const float *src,
+                                                       size_t count, float lim, float scale)
+{
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            saturate_round_avx2(_mm256_loadu_ps(src + i), lim, scale));
+    }
+    return i;
+}
+
+/* float to Q8.23 clamped to 24 bits, as clamp24_from_float() */
+static size_t q8_23_from_float_sse2(int32_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(8388608.f);
+    size_t i;
+    for (i = 0; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         clamp_round_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), 8388608.f));
+    }
+    return i;
+}
+
+static size_t AVX2_TARGET q8_23_from_float_avx2(int32_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(8388608.f);
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            clamp_round_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale),
+                                             8388608.f));
+    }
+    return i;
+}
+
+/* int32 shifted right and saturated to int16, as clamp16() */
+static size_t i16_from_i32_shift_sse2(int16_t *dst, const int32_t *src, size_t count,
+                                      int shift)
+{
+    const __m128i sh = _mm_cvtsi32_si128(shift);
+    size_t i;
+    for (i = 0; i + 8 <= count; i += 8) {
+        const __m128i a = _mm_sra_epi32(_mm_loadu_si128((const __m128i *)(src + i)), sh);
+        const __m128i b = _mm_sra_epi32(_mm_loadu_si128((const __m128i *)(src + i + 4)), sh);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a, b));
+    }
+    return i;
+}
+
+static size_t AVX2_TARGET i16_from_i32_shift_avx2(int16_t *dst, const int32_t *src,
+                                                  size_t count, int shift)
+{
+    const __m128i sh = _mm_cvtsi32_si128(shift);
+    size_t i;
+    for (i = 0; i + 16 <= count; i += 16) {
+        const __m256i a = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i *)(src + i)), sh);
+        const __m256i b = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i *)(src + i + 8)),
+                                           sh);
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+    }
+    return i;
+}
+
+/* packed 24 bit, SSSE3 byte shuffles available on AVX2 processors.
+ * float to packed 24 bit stores 12 of the 16 bytes of each vector.
+ */
+static size_t AVX2_TARGET p24_from_float_avx2(uint8_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(8388608.f);
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                       -1, -1, -1, -1);
+    size_t i;
+    for (i = 0; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_shuffle_epi8(
+                clamp_round_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), 8388608.f), pack);
+        _mm_storel_epi64((__m128i *)(dst + i * 3), v);
+        const int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        memcpy(dst + i * 3 + 8, &last, sizeof(last));
+    }
+    return i;
+}
+
+/* packed 24 bit to float, downwards. Each load ends at the last byte of 4 samples, so the
+ * first 4 bytes belong to the previous samples and are skipped by the shuffle. */
+static size_t AVX2_TARGET float_from_p24_avx2(float *dst, const uint8_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+    const __m128i unpack = _mm_setr_epi8(-1, 4, 5, 6, -1, 7, 8, 9,
+                                         -1, 10, 11, 12, -1, 13, 14, 15);
+    size_t i;
+    for (i = count; i >= 6; i -= 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(src + i * 3 - 16));
+        _mm_storeu_ps(dst + i - 4,
+                      _mm_mul_ps(_mm_cvtepi32_ps(_mm_shuffle_epi8(v, unpack)), scale));
+    }
+    return count - i;
+}
+
+#define SIMD_CONVERT(kernel, ...) \
+    (audio_utils_get_simd_level() >= AUDIO_UTILS_SIMD_AVX2 ? kernel##_avx2(__VA_ARGS__) : \
+     audio_utils_get_simd_level() >= AUDIO_UTILS_SIMD_SSE2 ? kernel##_sse2(__VA_ARGS__) : 0)
+
+#endif // USE_X86_SIMD
+
 void ditherAndClamp(int32_t *out, const int32_t *sums, size_t pairs)
 {
+#ifdef USE_X86_SIMD
+    /* little endian pairs of int16 are the packed int16 of the sums */
+    const size_t done = SIMD_CONVERT(i16_from_i32_shift, (int16_t *)out, sums, pairs * 2, 12);
+    out += done / 2;
+    sums += done;
+    pairs -= done / 2;
+#endif
     for (; pairs > 0; --pairs) {
         const int32_t l = clamp16(*sums++ >> 12);
         const int32_t r = clamp16(*sums++ >> 12);
@@ -29,6 +428,12 @@ void ditherAndClamp(int32_t *out, const int32_t *sums, size_t pairs)
 
 void memcpy_to_i16_from_q4_27(int16_t *dst, const int32_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(i16_from_i32_shift, dst, src, count, 12);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clamp16(*src++ >> 12);
     }
@@ -66,13 +471,62 @@ void memcpy_to_i16_from_i32(int16_t *dst, const int32_t *src, size_t count)
 
 void memcpy_to_i16_from_float(int16_t *dst, const float *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(i16_from_float, dst, src, count);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clamp16_from_float(*src++);
     }
 }
 
+void dither_init(dither_state_t *state, uint32_t seed)
+{
+    for (int i = 0; i < 4; i++) {
+        /* murmur3 finalizer of distinct values, xorshift must not start from 0 */
+        uint32_t x = seed + (i + 1) * 0x9E3779B9u;
+        x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+        x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+        x ^= x >> 16;
+        state->seed[i] = x != 0 ? x : 0x9E3779B9u;
+    }
+    state->next = 0;
+}
+
+void memcpy_to_i16_from_float_with_dither(int16_t *dst, const float *src, size_t count,
+                                          dither_state_t *state)
+{
+    for (;;) {
+#ifdef USE_X86_SIMD
+        if (state->next == 0) {
+            const size_t done = SIMD_CONVERT(i16_from_float_with_dither, dst, src, count, state);
+            dst += done;
+            src += done;
+            count -= done;
+        }
+#endif
+        if (count == 0) {
+            break;
+        }
+        const uint32_t x = dither_next(state->seed[state->next]);
+        state->seed[state->next] = x;
+        state->next = (state->next + 1) & 3;
+        const float f = *src++ * 32768.f + dither_from_state(x);
+        *dst++ = roundf(fmaxf(fminf(f, 32767.f), -32768.f));
+        count--;
+    }
+}
+
 void memcpy_to_float_from_q4_27(float *dst, const int32_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(float_from_i32_scaled, dst, src, count, 1.f / (1 << 27));
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = float_from_q4_27(*src++);
     }
@@ -80,6 +534,9 @@ void memcpy_to_float_from_q4_27(float *dst, const int32_t *src, size_t count)
 
 void memcpy_to_float_from_i16(float *dst, const int16_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    count -= SIMD_CONVERT(float_from_i16, dst, src, count);
+#endif
     dst += count;
     src += count;
     for (; count > 0; --count) {
@@ -98,6 +555,11 @@ void memcpy_to_float_from_u8(float *dst, const uint8_t *src, size_t count)
 
 void memcpy_to_float_from_p24(float *dst, const uint8_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    if (audio_utils_get_simd_level() >= AUDIO_UTILS_SIMD_AVX2) {
+        count -= float_from_p24_avx2(dst, src, count);
+    }
+#endif
     dst += count;
     src += count * 3;
     for (; count > 0; --count) {
@@ -153,6 +615,14 @@ void memcpy_to_p24_from_i16(uint8_t *dst, const int16_t *src, size_t count)
 
 void memcpy_to_p24_from_float(uint8_t *dst, const float *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    if (audio_utils_get_simd_level() >= AUDIO_UTILS_SIMD_AVX2) {
+        const size_t done = p24_from_float_avx2(dst, src, count);
+        dst += done * 3;
+        src += done;
+        count -= done;
+    }
+#endif
     for (; count > 0; --count) {
         int32_t ival = clamp24_from_float(*src++);
 
@@ -213,6 +683,12 @@ void memcpy_to_q8_23_from_i16(int32_t *dst, const int16_t *src, size_t count)
 
 void memcpy_to_q8_23_from_float_with_clamp(int32_t *dst, const float *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(q8_23_from_float, dst, src, count);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clamp24_from_float(*src++);
     }
@@ -234,6 +710,12 @@ void memcpy_to_q8_23_from_p24(int32_t *dst, const uint8_t *src, size_t count)
 
 void memcpy_to_q4_27_from_float(int32_t *dst, const float *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(i32_from_float_saturate, dst, src, count, 16.f, 1 << 27);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clampq4_27_from_float(*src++);
     }
@@ -241,6 +723,12 @@ void memcpy_to_q4_27_from_float(int32_t *dst, const float *src, size_t count)
 
 void memcpy_to_i16_from_q8_23(int16_t *dst, const int32_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(i16_from_i32_shift, dst, src, count, 8);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clamp16(*src++ >> 8);
     }
@@ -248,6 +736,12 @@ void memcpy_to_i16_from_q8_23(int16_t *dst, const int32_t *src, size_t count)
 
 void memcpy_to_float_from_q8_23(float *dst, const int32_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(float_from_i32_scaled, dst, src, count, 1.f / (1 << 23));
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = float_from_q8_23(*src++);
     }
@@ -273,6 +767,12 @@ void memcpy_to_i32_from_i16(int32_t *dst, const int16_t *src, size_t count)
 
 void memcpy_to_i32_from_float(int32_t *dst, const float *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(i32_from_float_saturate, dst, src, count, 1.f, 2147483648.f);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = clamp32_from_float(*src++);
     }
@@ -280,6 +780,12 @@ void memcpy_to_i32_from_float(int32_t *dst, const float *src, size_t count)
 
 void memcpy_to_float_from_i32(float *dst, const int32_t *src, size_t count)
 {
+#ifdef USE_X86_SIMD
+    const size_t done = SIMD_CONVERT(float_from_i32_scaled, dst, src, count, 1.f / 2147483648.f);
+    dst += done;
+    src += done;
+    count -= done;
+#endif
     for (; count > 0; --count) {
         *dst++ = float_from_i32(*src++);
     }
@@ -34,6 +34,31 @@ __BEGIN_DECLS
  * for future optimization later).
  */
 
+/**
+ * Instruction set used by the vectorized conversions: memcpy_to_i16_from_float() and its
+ * dithered variant, memcpy_to_float_from_i16(), the conversions between float and Q4.27,
+ * Q8.23, Q0.31 or packed 24 bit, memcpy_to_i16_from_q4_27(), memcpy_to_i16_from_q8_23()
+ * and ditherAndClamp(). All levels produce bit-exact identical output.
+ */
+typedef enum {
+    AUDIO_UTILS_SIMD_NONE = 0,      /**< Portable C */
+    AUDIO_UTILS_SIMD_SSE2 = 1,      /**< x86 SSE2 */
+    AUDIO_UTILS_SIMD_AVX2 = 2,      /**< x86 AVX2, packed 24 bit conversions use SSSE3 */
+} audio_utils_simd_t;
+
+/**
+ * Returns the instruction set used by the conversions. This is the best level supported
+ * by the CPU, detected on the first call, unless limited by audio_utils_set_simd_level().
+ */
+audio_utils_simd_t audio_utils_get_simd_level(void);
+
+/**
+ * Limits the instruction set used by the conversions, e.g. to benchmark or verify the
+ * portable code. Returns the level in use, which is at most the best supported level.
+ * Not thread-safe with respect to conversions running concurrently.
+ */
+audio_utils_simd_t audio_utils_set_simd_level(audio_utils_simd_t level);
+
 /**
  * Deprecated. Use memcpy_to_i16_from_q4_27() instead (double the pairs for the count).
  * Neither this function nor memcpy_to_i16_from_q4_27() actually dither.
@@ -133,6 +158,39 @@ void memcpy_to_i16_from_i32(int16_t *dst, const int32_t *src, size_t count);
  */
 void memcpy_to_i16_from_float(int16_t *dst, const float *src, size_t count);
 
+/**
+ * State of the triangular dither of memcpy_to_i16_from_float_with_dither().
+ * The samples use the four xorshift generators in turn, so the vectorized and the
+ * portable code produce the same output. Initialize with dither_init().
+ */
+typedef struct {
+    uint32_t seed[4];   /**< Generator states, never 0 */
+    uint32_t next;      /**< Generator of the next sample */
+} dither_state_t;
+
+/**
+ * Initialize a dither state from a seed, any value including 0 is valid.
+ */
+void dither_init(dither_state_t *state, uint32_t seed);
+
+/**
+ * Shrink and copy samples from single-precision floating-point to signed 16-bit, adding
+ * triangular probability density (TPDF) dither of +/-1 lsb before rounding.
+ * Each float should be in the range -1.0 to 1.0.  Values outside that range are clamped.
+ * The dither decorrelates the rounding error from the signal, low level signals fade into
+ * a constant noise floor instead of distorting.
+ *
+ *  \param dst     Destination buffer
+ *  \param src     Source buffer
+ *  \param count   Number of samples to copy
+ *  \param state   Dither state, see dither_init()
+ *
+ * The destination and source buffers must either be completely separate (non-overlapping), or
+ * they must both start at the same address.  Partially overlapping buffers are not supported.
+ */
+void memcpy_to_i16_from_float_with_dither(int16_t *dst, const float *src, size_t count,
+                                          dither_state_t *state);
+
 /**
  * Copy samples from signed fixed-point 32-bit Q4.27 to single-precision floating-point.
  * The nominal output float range is [-1.0, 1.0] if the fixed-point range is
@@ -273,6 +273,7 @@ typedef struct
       LVM_UINT16              SampleRate;               /* Sampling rate capabilities */
       LVM_UINT16              CentreFrequency;          /* Centre frequency capabilities */
       LVM_UINT16              MaxBlockSize;             /* Maximum block size in sample pairs */
+      LVM_UINT32              CoefBankRates;            /* Rates switched without clearing the history */
 } LVDBE_Capabilities_t;
 
 
@@ -404,6 +405,32 @@ LVDBE_ReturnStatus_en LVDBE_GetCapabilities(LVDBE_Handle_t            hInstance,
                                               LVDBE_Capabilities_t    *pCapabilities);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                  LVDBE_GetTailLevel                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Returns the peak level of the filter history, the output produced by a silent      */
+/*  input stays below this level times the bass and volume gains.                       */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                   Instance handle                                         */
+/*  pTailLevel                  Pointer to the tail level                               */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVDBE_Success             Always succeeds                                           */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.    The level is full scale (1.0) while the mixers or the AGC gain are changing   */
+/*  2.    This function must not be interrupted by the LVDBE_Process function           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVDBE_ReturnStatus_en LVDBE_GetTailLevel(LVDBE_Handle_t            hInstance,
+                                         LVM_FLOAT                 *pTailLevel);
+#endif
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVDBE_Control                                               */
@@ -477,6 +504,39 @@ LVDBE_ReturnStatus_en LVDBE_Process(LVDBE_Handle_t          hInstance,
                                        LVM_UINT16           NumSamples);
 #endif
 
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                 LVDBE_ProcessWithMono                                      */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function for the Bass Enhancement module, taking the mono stream of the     */
+/*  input from the caller.                                                              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                Instance handle                                            */
+/*  pInData                  Pointer to the input data                                  */
+/*  pMonoData                Pointer to the average of the input channels, LVM_NULL to  */
+/*                           calculate it                                               */
+/*  pOutData                 Pointer to the output data                                 */
+/*  NumSamples              Number of samples in the input buffer                       */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVDBE_SUCCESS             Succeeded                                                 */
+/*    LVDBE_TOOMANYSAMPLES    NumSamples was larger than the maximum block size         */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. pMonoData is not used when the high pass filter is on, the mono stream is then   */
+/*     taken after the filter                                                           */
+/*                                                                                      */
+/****************************************************************************************/
+LVDBE_ReturnStatus_en LVDBE_ProcessWithMono(LVDBE_Handle_t      hInstance,
+                                            const LVM_FLOAT     *pInData,
+                                            const LVM_FLOAT     *pMonoData,
+                                            LVM_FLOAT           *pOutData,
+                                            LVM_UINT16          NumSamples);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
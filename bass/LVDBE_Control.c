@@ -90,12 +90,90 @@ LVDBE_ReturnStatus_en LVDBE_GetCapabilities(LVDBE_Handle_t            hInstance,
 }
 
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:                  LVDBE_GetTailLevel                                    */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the peak level of the high pass and band pass filter history.           */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance                   Instance handle                                     */
+/*  pTailLevel                  Pointer to the tail level                           */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVDBE_Success             Always succeeds                                       */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1.    The level is full scale (1.0) while the mixers or the AGC gain are        */
+/*        changing, they would not progress with a skipped process call             */
+/*                                                                                  */
+/************************************************************************************/
+
+LVDBE_ReturnStatus_en LVDBE_GetTailLevel(LVDBE_Handle_t            hInstance,
+                                         LVM_FLOAT                 *pTailLevel)
+{
+
+    LVDBE_Instance_t    *pInstance =(LVDBE_Instance_t  *)hInstance;
+    LVDBE_Data_FLOAT_t  *pData     = pInstance->pData;
+    LVM_FLOAT           Level;
+    LVM_FLOAT           TailLevel  = 0.0f;
+#ifdef SUPPORT_MC
+    LVM_INT32           NrChannels = pInstance->Params.NrChannels == 1
+                                         ? 2 : pInstance->Params.NrChannels;
+#else
+    LVM_INT32           NrChannels = 2;
+#endif
+
+    if ((LVC_Mixer_IsSteady(&pData->BypassMixer.MixerStream[0]) == LVM_FALSE) ||
+        (LVC_Mixer_IsSteady(&pData->BypassMixer.MixerStream[1]) == LVM_FALSE))
+    {
+        *pTailLevel = 1.0f;
+        return(LVDBE_SUCCESS);
+    }
+
+    if (pInstance->Params.OperatingMode == LVDBE_OFF)
+    {
+        /* Only the bypass volume is processed */
+        if (LVC_Mixer_IsSteady(&pData->BypassVolume.MixerStream[0]) == LVM_FALSE)
+        {
+            *pTailLevel = 1.0f;
+            return(LVDBE_SUCCESS);
+        }
+    }
+    else
+    {
+        if (AGC_MIX_VOL_IsSteady(&pData->AGCInstance) == LVM_FALSE)
+        {
+            *pTailLevel = 1.0f;
+            return(LVDBE_SUCCESS);
+        }
+
+        if (pInstance->Params.HPFSelect == LVDBE_HPF_ON)
+        {
+            TailLevel = PeakAbs_Float(pData->HPFTaps.Storage, 4 * NrChannels);
+        }
+        Level = PeakAbs_Float(pData->BPFTaps.Storage, 4);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    *pTailLevel = TailLevel;
+
+    return(LVDBE_SUCCESS);
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVDBE_SetFilters                                            */
 /*                                                                                  */
 /* DESCRIPTION:                                                                     */
-/*  Sets the filter coefficients and clears the data history                        */
+/*  Sets the filter coefficients and clears the data history. The history is kept   */
+/*  when only the sample rate changes between two banked rates.                     */
 /*                                                                                  */
 /* PARAMETERS:                                                                      */
 /*  pInstance           Pointer to the instance                                     */
@@ -120,21 +198,28 @@ void    LVDBE_SetFilters(LVDBE_Instance_t     *pInstance,
     LVM_UINT16 Offset = (LVM_UINT16)((LVM_UINT16)pParams->SampleRate + \
                                     (LVM_UINT16)(pParams->CentreFrequency * (1+LVDBE_FS_48000)));
 #endif
+    LVM_INT16  ClearTaps = (LVM_INT16)!((pInstance->Params.CentreFrequency == pParams->CentreFrequency) &&
+                                        (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                          (LVM_Fs_en)pInstance->Params.SampleRate,
+                                                          (LVM_Fs_en)pParams->SampleRate) == LVM_TRUE));
 
     /*
      * Setup the high pass filter
      */
+    if (ClearTaps)
+    {
 #ifndef BUILD_FLOAT
-    LoadConst_16(0,                                              /* Clear the history, value 0 */
-                 (void *)&pInstance->pData->HPFTaps,             /* Destination Cast to void: \
-                                                                    no dereferencing in function*/
-                 sizeof(pInstance->pData->HPFTaps)/sizeof(LVM_INT16));   /* Number of words */
+        LoadConst_16(0,                                              /* Clear the history, value 0 */
+                     (void *)&pInstance->pData->HPFTaps,             /* Destination Cast to void: \
+                                                                        no dereferencing in function*/
+                     sizeof(pInstance->pData->HPFTaps)/sizeof(LVM_INT16));   /* Number of words */
 #else
-    LoadConst_Float(0,                                          /* Clear the history, value 0 */
-                   (void *)&pInstance->pData->HPFTaps,          /* Destination Cast to void: \
-                                                                  no dereferencing in function*/
-                    sizeof(pInstance->pData->HPFTaps) / sizeof(LVM_FLOAT)); /* Number of words */
+        LoadConst_Float(0,                                          /* Clear the history, value 0 */
+                       (void *)&pInstance->pData->HPFTaps,          /* Destination Cast to void: \
+                                                                      no dereferencing in function*/
+                        sizeof(pInstance->pData->HPFTaps) / sizeof(LVM_FLOAT)); /* Number of words */
 #endif
+    }
 #ifndef BUILD_FLOAT
     BQ_2I_D32F32Cll_TRC_WRA_01_Init(&pInstance->pCoef->HPFInstance,    /* Initialise the filter */
                                     &pInstance->pData->HPFTaps,
@@ -149,17 +234,20 @@ void    LVDBE_SetFilters(LVDBE_Instance_t     *pInstance,
     /*
      * Setup the band pass filter
      */
+    if (ClearTaps)
+    {
 #ifndef BUILD_FLOAT
-    LoadConst_16(0,                                                 /* Clear the history, value 0 */
-                 (void *)&pInstance->pData->BPFTaps,                /* Destination Cast to void: \
-                                                                     no dereferencing in function*/
-                 sizeof(pInstance->pData->BPFTaps)/sizeof(LVM_INT16));   /* Number of words */
+        LoadConst_16(0,                                                 /* Clear the history, value 0 */
+                     (void *)&pInstance->pData->BPFTaps,                /* Destination Cast to void: \
+                                                                         no dereferencing in function*/
+                     sizeof(pInstance->pData->BPFTaps)/sizeof(LVM_INT16));   /* Number of words */
 #else
-    LoadConst_Float(0,                                           /* Clear the history, value 0 */
-                 (void *)&pInstance->pData->BPFTaps,             /* Destination Cast to void: \
-                                                                    no dereferencing in function*/
-                 sizeof(pInstance->pData->BPFTaps) / sizeof(LVM_FLOAT));   /* Number of words */
+        LoadConst_Float(0,                                           /* Clear the history, value 0 */
+                     (void *)&pInstance->pData->BPFTaps,             /* Destination Cast to void: \
+                                                                        no dereferencing in function*/
+                     sizeof(pInstance->pData->BPFTaps) / sizeof(LVM_FLOAT));   /* Number of words */
 #endif
+    }
 #ifndef BUILD_FLOAT
     BP_1I_D32F32Cll_TRC_WRA_02_Init(&pInstance->pCoef->BPFInstance,         /* Initialise the filter */
                                     &pInstance->pData->BPFTaps,
@@ -39,6 +39,7 @@ extern "C" {
 /****************************************************************************************/
 
 #include "LVDBE.h"                                /* Calling or Application layer definitions */
+#include "LVM_Common.h"                           /* Common definitions */
 #include "BIQUAD.h"
 #include "LVC_Mixer.h"
 #include "AGC.h"
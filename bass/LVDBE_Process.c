@@ -189,6 +189,37 @@ LVDBE_ReturnStatus_en LVDBE_Process(LVDBE_Handle_t hInstance,
     const LVM_FLOAT *pInData,
     LVM_FLOAT *pOutData,
     const LVM_UINT16 NrFrames) // updated to use samples = frames * channels.
+{
+  return LVDBE_ProcessWithMono(hInstance, pInData, LVM_NULL, pOutData, NrFrames);
+}
+
+/********************************************************************************************/
+/*                                                                                          */
+/* FUNCTION:                 LVDBE_ProcessWithMono                                          */
+/*                                                                                          */
+/* DESCRIPTION:                                                                             */
+/*  Process function for the Bass Enhancement module, taking the mono stream of the input   */
+/*  from the caller. The band pass filter reads pMonoData in place of the mono stream       */
+/*  created from the input when the high pass filter is off.                                */
+/*                                                                                          */
+/* PARAMETERS:                                                                              */
+/*  hInstance                 Instance handle                                               */
+/*  pInData                   Pointer to the input data                                     */
+/*  pMonoData                 Pointer to the average of the input channels, LVM_NULL to     */
+/*                            calculate it                                                  */
+/*  pOutData                  Pointer to the output data                                    */
+/*  NrFrames                  Number of frames in the input buffer                          */
+/*                                                                                          */
+/* RETURNS:                                                                                 */
+/*  LVDBE_SUCCESS             Succeeded                                                     */
+/*  LVDBE_TOOMANYSAMPLES      NrFrames was larger than the maximum block size               */
+/*                                                                                          */
+/********************************************************************************************/
+LVDBE_ReturnStatus_en LVDBE_ProcessWithMono(LVDBE_Handle_t hInstance,
+    const LVM_FLOAT *pInData,
+    const LVM_FLOAT *pMonoData,
+    LVM_FLOAT *pOutData,
+    const LVM_UINT16 NrFrames)
 {
   LVDBE_Instance_t *pInstance =(LVDBE_Instance_t *)hInstance;
 
@@ -263,24 +294,29 @@ LVDBE_ReturnStatus_en LVDBE_Process(LVDBE_Handle_t hInstance,
     }
 
     /*
-     * Create the mono stream
+     * Create the mono stream, the mono stream of the caller is only the one of the
+     * filtered data when the high pass filter is off
      */
+    if ((pMonoData == LVM_NULL) || (pInstance->Params.HPFSelect == LVDBE_HPF_ON))
+    {
 #ifdef SUPPORT_MC
-    FromMcToMono_Float(pScratch, /* Source */
-        pMono, /* Mono destination */
-        (LVM_INT16)NrFrames,  /* Number of frames */
-        (LVM_INT16)NrChannels);
+      FromMcToMono_Float(pScratch, /* Source */
+          pMono, /* Mono destination */
+          (LVM_INT16)NrFrames,  /* Number of frames */
+          (LVM_INT16)NrChannels);
 #else
-    From2iToMono_Float(pScratch, /* Stereo source         */
-        pMono, /* Mono destination      */
-        (LVM_INT16)NrFrames);
+      From2iToMono_Float(pScratch, /* Stereo source         */
+          pMono, /* Mono destination      */
+          (LVM_INT16)NrFrames);
 #endif
+      pMonoData = pMono;
+    }
 
     /*
      * Apply the band pass filter
      */
     BP_1I_D32F32C30_TRC_WRA_02(&pInstance->pCoef->BPFInstance, /* Filter instance       */
-        pMono, /* Source                */
+        (LVM_FLOAT *)pMonoData, /* Source                */
         pMono, /* Destination           */
         (LVM_INT16)NrFrames);
 
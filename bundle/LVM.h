@@ -99,6 +99,9 @@ extern "C" {
 /* Headroom management */
 #define LVM_HEADROOM_MAX_NBANDS               5
 
+/* Spectrum Analyzer */
+#define LVM_PSA_SILENCE_DB               (-96.0f)  /* Level of a band below the analyser resolution, in dBFS */
+
 /****************************************************************************************/
 /*                                                                                      */
 /*  Types                                                                               */
@@ -120,6 +123,7 @@ typedef enum
     LVM_WRONGAUDIOTIME     = 5,                     /* Wrong time value for audio time*/
     LVM_ALGORITHMDISABLED  = 6,                     /* Algorithm is disabled*/
     LVM_ALGORITHMPSA       = 7,                     /* Algorithm PSA returns an error */
+    LVM_BUSY               = 8,                     /* Data changed while it was read, call again */
     LVM_RETURNSTATUS_DUMMY = LVM_MAXENUM
 } LVM_ReturnStatus_en;
 
@@ -220,6 +224,23 @@ typedef enum
     LVM_PSA_DUMMY = LVM_MAXENUM
 } LVM_PSA_Mode_en;
 
+/* Denormal protection used by LVM_Process */
+typedef enum
+{
+    LVM_DENORMAL_OFF    = 0,                            /* No protection */
+    LVM_DENORMAL_FTZ    = 1,                            /* Flush denormals to zero during the process call */
+    LVM_DENORMAL_OFFSET = 2,                            /* Add an inaudible offset to the processed signal */
+    LVM_DENORMAL_DUMMY  = LVM_MAXENUM
+} LVM_Denormal_en;
+
+/* Output buffer access of LVM_Process */
+typedef enum
+{
+    LVM_OUTPUT_WRITE        = 0,                        /* The output overwrites pOutData */
+    LVM_OUTPUT_ACCUMULATE   = 1,                        /* The output is added to pOutData */
+    LVM_OUTPUT_DUMMY        = LVM_MAXENUM
+} LVM_OutputMode_en;
+
 /* Version information */
 typedef struct
 {
@@ -258,6 +279,33 @@ typedef struct
 } LVM_HeadroomBandDef_t;
 
 
+/* Denormal detection counters, see LVM_GetDenormalStats */
+typedef struct
+{
+    LVM_UINT32                  ProcessCalls;           /* Number of counted LVM_Process calls */
+    LVM_UINT32                  DenormalCalls;          /* Calls with denormal output samples */
+    LVM_UINT32                  DenormalSamples;        /* Total number of denormal output samples */
+} LVM_DenormalStats_t;
+
+
+/* PCM saturation counters, see LVM_GetPcmStats */
+typedef struct
+{
+    LVM_UINT32                  ProcessCalls;           /* Number of LVM_ProcessPcm calls */
+    LVM_UINT32                  SaturatedCalls;         /* Calls with saturated output samples */
+    LVM_UINT32                  SaturatedSamples;       /* Total number of saturated output samples */
+} LVM_PcmStats_t;
+
+
+/* Spectrum snapshot description, see LVM_GetSpectrumSnapshot */
+typedef struct
+{
+    LVM_UINT32                  Number;                 /* Number of the snapshot, 0 before the first one */
+    LVM_INT32                   AudioTime;              /* Audio time of the levels */
+    LVM_UINT16                  NrBands;                /* Number of bands of the analyser */
+} LVM_PSA_SnapshotInfo_t;
+
+
 /* Control Parameter structure */
 typedef struct
 {
@@ -304,6 +352,20 @@ typedef struct
 } LVM_ControlParams_t;
 
 
+/* Module memory allocator, see LVM_GetMemoryTable. The memory must be 64-bit aligned */
+typedef void *(*LVM_ModuleAlloc_t)(void          *pAllocHandle,    /* Handle given in the allocator structure */
+                                   LVM_UINT32    Size);            /* Number of bytes to allocate */
+typedef void  (*LVM_ModuleFree_t)(void           *pAllocHandle,    /* Handle given in the allocator structure */
+                                  void           *pMemory);        /* Memory returned by the allocation function */
+
+typedef struct
+{
+    LVM_ModuleAlloc_t           pAlloc;                 /* Allocation function, LVM_NULL for no on demand allocation */
+    LVM_ModuleFree_t            pFree;                  /* Free function */
+    void                        *pAllocHandle;          /* Handle passed to both functions */
+} LVM_ModuleAllocator_t;
+
+
 /* Instance Parameter structure */
 typedef struct
 {
@@ -318,6 +380,46 @@ typedef struct
     LVM_PSA_Mode_en             PSA_Included;            /* Controls the instance memory allocation for PSA: ON/OFF */
 } LVM_InstParams_t;
 
+/* Extended instance parameter structure, see LVM_GetMemoryTableEx. Zero fields keep the baseline behaviour */
+typedef struct
+{
+    LVM_UINT32                  Size;                   /* sizeof(LVM_InstParamsEx_t), fields past Size are zero */
+
+    /* N-Band Equaliser */
+    LVM_Mode_en                 EQNB_Parallel;          /* Run the equaliser bands in parallel form: ON/OFF */
+
+    /* PSA */
+    LVM_Mode_en                 PSA_Deferred;            /* Analyse the spectrum in LVM_ProcessSpectrum: ON/OFF */
+    LVM_Mode_en                 PSA_Decimation;          /* Filter the low PSA bands at decimated rates: ON/OFF */
+    LVM_UINT16                  PSA_FFTBands;            /* Bands of the FFT spectrum analyser, 0 for the filter bank */
+
+    /* Module memory */
+    LVM_ModuleAllocator_t       ModuleAllocator;        /* Allocates the module memory when a module is first enabled */
+
+    /* Coefficient banks */
+    LVM_UINT32                  CoefBankRates;          /* Set of LVM_FS_BANK() rates, LVM_FS_BANK_NONE for no banks */
+
+    /* Denormal protection */
+    LVM_Denormal_en             DenormalMode;           /* Denormal protection used by LVM_Process */
+    LVM_Mode_en                 DenormalDetect;         /* Count the denormal output samples: ON/OFF */
+
+    /* Silence detection */
+    LVM_Mode_en                 SilenceDetect;          /* Skip the processing of silent input once idle: ON/OFF */
+
+    /* Planar and PCM processing */
+    LVM_Mode_en                 PlanarIO;               /* Allocates the buffer of LVM_ProcessPlanar: ON/OFF */
+    LVM_Mode_en                 PcmIO;                  /* Allocates the buffer of LVM_ProcessPcm: ON/OFF */
+
+    /* Output */
+    LVM_OutputMode_en           OutputMode;             /* Output buffer access of LVM_Process */
+
+    /* Filter merging */
+    LVM_Mode_en                 FilterMerge;            /* Run the adjacent linear filters as one cascade: ON/OFF */
+
+    /* Coefficient sharing */
+    LVM_Mode_en                 CoefSharing;            /* Clones share the equaliser coefficients of their template: ON/OFF */
+} LVM_InstParamsEx_t;
+
 /* Headroom management parameter structure */
 typedef struct
 {
@@ -385,6 +487,13 @@ LVM_ReturnStatus_en LVM_GetVersionInfo(LVM_VersionInfo_st  *pVersion);
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1.  This function may be interrupted by the LVM_Process function                    */
+/*  2.  The LVM_MEMREGION_TEMPORARY_FAST region holds no data between calls, instances  */
+/*      with the same region size whose LVM_Process calls never overlap (e.g. run on    */
+/*      the same thread) can be given the same temporary memory                         */
+/*  3.  The LVM_MEMREGION_PERSISTENT_FAST_COEF region can not be shared, the filter     */
+/*      instances in it hold the address of their taps in the persistent data region.   */
+/*      Clones can share the equaliser coefficients, see CoefSharing                    */
+/*  4.  The function is LVM_GetMemoryTableEx without extended instance parameters       */
 /*                                                                                      */
 /****************************************************************************************/
 LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
@@ -392,6 +501,48 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
                                        LVM_InstParams_t     *pInstParams);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetMemoryTableEx                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is LVM_GetMemoryTable with the extended instance parameters of the    */
+/*  optional features.                                                                  */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pMemoryTable            Pointer to an empty memory definition table                 */
+/*  pInstParams             Pointer to the instance parameters                          */
+/*  pInstParamsEx           Pointer to the extended instance parameters, LVM_NULL for   */
+/*                          none                                                        */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When one of pMemoryTable or pInstParams is NULL             */
+/*  LVM_OUTOFRANGE          When any of the Instance parameters are out of range        */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  This function may be interrupted by the LVM_Process function                    */
+/*  2.  Only the first Size bytes of the extended instance parameters are read, the     */
+/*      fields of a caller built with an older structure are taken as zero              */
+/*  3.  When ModuleAllocator.pAlloc is set in the extended instance parameters the      */
+/*      table does not include the persistent memory of the Concert Sound, Bass         */
+/*      Enhancement, N-Band Equaliser and Spectrum Analyzer modules.                    */
+/*      LVM_SetControlParameters allocates the memory of a module through the           */
+/*      allocator the first time the module is enabled and the next LVM_Process call    */
+/*      initialises the module in it. The memory is released with                       */
+/*      LVM_FreeModuleMemory. The scratch memory of the modules is always included.     */
+/*  4.  Each rate in CoefBankRates adds one set of N-Band Equaliser and Spectrum        */
+/*      Analyzer coefficients to the persistent coefficient memory                      */
+/*  5.  CoefSharing needs the module allocator, LVM_OUTOFRANGE is returned without it   */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetMemoryTableEx(LVM_Handle_t           hInstance,
+                                         LVM_MemTab_t           *pMemoryTable,
+                                         LVM_InstParams_t       *pInstParams,
+                                         LVM_InstParamsEx_t     *pInstParamsEx);
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVM_GetInstanceHandle                                       */
@@ -412,6 +563,7 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1. This function must not be interrupted by the LVM_Process function                */
+/*  2. The function is LVM_GetInstanceHandleEx without extended instance parameters     */
 /*                                                                                      */
 /****************************************************************************************/
 LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t        *phInstance,
@@ -419,6 +571,37 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t        *phInstance,
                                           LVM_InstParams_t    *pInstParams);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetInstanceHandleEx                                     */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is LVM_GetInstanceHandle with the extended instance parameters of     */
+/*  the optional features.                                                              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  phInstance              pointer to the instance handle                              */
+/*  pMemoryTable            Pointer to the memory definition table                      */
+/*  pInstParams             Pointer to the instance parameters                          */
+/*  pInstParamsEx           Pointer to the extended instance parameters, LVM_NULL for   */
+/*                          none                                                        */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Initialisation succeeded                                    */
+/*  LVM_NULLADDRESS         One or more memory has a NULL pointer                       */
+/*  LVM_OUTOFRANGE          When any of the Instance parameters are out of range        */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*  2. The memory table must come from LVM_GetMemoryTableEx with the same parameters    */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetInstanceHandleEx(LVM_Handle_t          *phInstance,
+                                            LVM_MemTab_t          *pMemoryTable,
+                                            LVM_InstParams_t      *pInstParams,
+                                            LVM_InstParamsEx_t    *pInstParamsEx);
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVM_ClearAudioBuffers                                       */
@@ -440,6 +623,76 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t        *phInstance,
 LVM_ReturnStatus_en LVM_ClearAudioBuffers(LVM_Handle_t  hInstance);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CloneInstance                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is used to create a bundle instance as a copy of an existing,        */
+/*  fully initialised template instance. The persistent memory of the template is       */
+/*  copied to the regions given in the memory table and all internal pointers are       */
+/*  moved to the new regions, so no coefficient calculation or module initialisation    */
+/*  is needed. The new instance has the same control parameters, headroom parameters    */
+/*  and filter history as the template.                                                 */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hTemplate               Template instance handle                                    */
+/*  phInstance              Pointer to the new instance handle                          */
+/*  pMemoryTable            Pointer to the memory definition table of the new instance  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Clone succeeded                                             */
+/*  LVM_NULLADDRESS         When one of hTemplate, phInstance or pMemoryTable is NULL   */
+/*                          or a memory region has a NULL pointer                       */
+/*  LVM_OUTOFRANGE          When the region sizes differ from those of the template     */
+/*  LVM_ALIGNMENTERROR      When a region is not at the 64-bit alignment of the region  */
+/*                          of the template                                             */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The memory table must have the region sizes returned by LVM_GetMemoryTableEx     */
+/*     for the instance parameters of the template                                      */
+/*  2. The template is only read, it can be used for further clones                    */
+/*  3. This function must not be interrupted by the LVM_Process function of the         */
+/*     template                                                                         */
+/*  4. Module memory the template allocated on demand is allocated for the new instance */
+/*     with the same module allocator, LVM_NULLADDRESS is returned when this fails      */
+/*  5. With CoefSharing on the new instance shares the N-Band Equaliser coefficients    */
+/*     of the template instead, while the template equaliser is processing and no       */
+/*     parameters are pending. The shared coefficients are freed with the module       */
+/*     memory of the last instance holding them. LVM_SetControlParameters gives an      */
+/*     instance whose equaliser settings change a copy of its own                       */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_CloneInstance(LVM_Handle_t        hTemplate,
+                                      LVM_Handle_t        *phInstance,
+                                      LVM_MemTab_t        *pMemoryTable);
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_FreeModuleMemory                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function returns the module memory allocated on demand to the module           */
+/*  allocator given in the extended instance parameters. The modules are disabled,      */
+/*  enabling them again allocates new memory.                                           */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When hInstance is NULL                                      */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*  2. Must be called before the memory in the instance memory table is freed, it does  */
+/*     nothing when no module allocator is set                                          */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_FreeModuleMemory(LVM_Handle_t   hInstance);
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                 LVM_GetControlParameters                                   */
@@ -482,6 +735,12 @@ LVM_ReturnStatus_en LVM_GetControlParameters(LVM_Handle_t           hInstance,
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1.  This function may be interrupted by the LVM_Process function                    */
+/*  2.  With a module allocator the memory of a module is allocated here the first time */
+/*      it is enabled, LVM_NULLADDRESS is returned when the allocation fails and        */
+/*      LVM_ALIGNMENTERROR when the memory is not 64-bit aligned                        */
+/*  3.  A change of SampleRate between two rates of the CoefBankRates instance          */
+/*      parameter takes the precomputed coefficients and keeps the filter history, any  */
+/*      other rate change recalculates the coefficients and clears the history          */
 /*                                                                                      */
 /****************************************************************************************/
 LVM_ReturnStatus_en LVM_SetControlParameters(LVM_Handle_t           hInstance,
@@ -516,6 +775,23 @@ LVM_ReturnStatus_en LVM_SetControlParameters(LVM_Handle_t           hInstance,
 /*      MONO                the number of samples in the block                          */
 /*      MONOINSTEREO        the number of sample pairs in the block                     */
 /*      STEREO              the number of sample pairs in the block                     */
+/*  3. With the LVM_DENORMAL_FTZ mode the floating point unit of the calling thread is  */
+/*     switched to flush-to-zero for the call and restored before returning. The        */
+/*     LVM_DENORMAL_OFFSET mode adds an inaudible quarter sampling rate signal (-360dB) */
+/*     to the signal before the first effect                                            */
+/*  4. With SilenceDetect on in the extended instance parameters a silent input block   */
+/*     whose effect tails have decayed below -160dB is not processed, the output is     */
+/*     written with zeros. Processing resumes with the first non-silent block or when   */
+/*     new control parameters are applied. Only used in unmanaged buffer mode           */
+/*  5. With the LVM_OUTPUT_ACCUMULATE output mode the output is added to the contents   */
+/*     of pOutData. The processing runs in an internal block buffer and the DC removal  */
+/*     adds it to pOutData, in managed buffer mode the block is added afterwards. The   */
+/*     mode also applies to LVM_ProcessPlanar, LVM_ProcessPcm does not support it       */
+/*  6. With FilterMerge on in the extended instance parameters the N-Band Equaliser     */
+/*     bands and the treble boost, when no bass enhancement sits between them, are run  */
+/*     as one cascade of second order sections in a single pass over the block. The     */
+/*     output differs from the separate filters by the rounding of the merged           */
+/*     coefficients. The modules run separately during their operating mode transitions */
 /*                                                                                      */
 /****************************************************************************************/
 #ifdef BUILD_FLOAT
@@ -532,6 +808,90 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
                                 LVM_UINT32                  AudioTime);
 #endif
 
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessPlanar                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function for the LifeVibes module with one buffer per channel. The planes   */
+/*  are interleaved in blocks of the internal block size, processed as LVM_Process and  */
+/*  deinterleaved to the output planes.                                                 */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  ppInData                Pointer to the input channel planes                         */
+/*  ppOutData               Pointer to the output channel planes                        */
+/*  NumSamples              Number of samples per channel in the planes                 */
+/*  AudioTime               Audio Time of the processing                                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_INVALIDNUMSAMPLES   When the NumSamples is not a valied multiple in unmanaged   */
+/*                          buffer mode                                                 */
+/*  LVM_ALIGNMENTERROR      When either the input our output buffers are not 32-bit     */
+/*                          aligned in unmanaged mode                                   */
+/*  LVM_NULLADDRESS         When one of hInstance, ppInData, ppOutData or a plane is    */
+/*                          NULL                                                        */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without PlanarIO              */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The output is identical to LVM_Process on the interleaved data.                  */
+/*  2. A mono source has one input plane and two output planes, otherwise there are     */
+/*     NrChannels planes in and out.                                                    */
+/*  3. The input and output planes may be the same buffers.                             */
+/*  4. With the LVM_OUTPUT_ACCUMULATE output mode the output is added to the contents   */
+/*     of the output planes.                                                            */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessPlanar(LVM_Handle_t              hInstance,
+                                      const LVM_FLOAT * const   *ppInData,
+                                      LVM_FLOAT * const         *ppOutData,
+                                      LVM_UINT16                NumSamples,
+                                      LVM_UINT32                AudioTime);
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessPcm                                              */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function for the LifeVibes module with interleaved PCM input and output.    */
+/*  The input is converted to float one internal block at a time and the conversion of  */
+/*  the output is part of the final DC removal stage.                                   */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  pInData                 Pointer to the input data                                   */
+/*  pOutData                Pointer to the output data                                  */
+/*  PcmFormat               Sample format of the input and output data                  */
+/*  NumSamples              Number of samples in the input buffer                       */
+/*  AudioTime               Audio Time of the processing                                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_INVALIDNUMSAMPLES   When the NumSamples is not a valied multiple in unmanaged   */
+/*                          buffer mode                                                 */
+/*  LVM_NULLADDRESS         When one of hInstance, pInData or pOutData is NULL          */
+/*  LVM_OUTOFRANGE          When PcmFormat is not supported or the instance was         */
+/*                          created with the LVM_OUTPUT_ACCUMULATE output mode          */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without PcmIO                 */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The output is identical to the audio_utils conversion to float, LVM_Process and  */
+/*     the conversion back to PcmFormat.                                                */
+/*  2. The output samples clipped by the conversion are counted, see LVM_GetPcmStats.   */
+/*  3. The input and output buffers may only be the same when the input and output     */
+/*     channel counts are the same.                                                     */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessPcm(LVM_Handle_t                 hInstance,
+                                   const void                   *pInData,
+                                   void                         *pOutData,
+                                   LVM_PcmFormat_en             PcmFormat,
+                                   LVM_UINT16                   NumSamples,
+                                   LVM_UINT32                   AudioTime);
+#endif
+
 
 /****************************************************************************************/
 /*                                                                                      */
@@ -602,6 +962,11 @@ LVM_ReturnStatus_en LVM_GetHeadroomParams(  LVM_Handle_t            hInstance,
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1. This function may be interrupted by the LVM_Process function                     */
+/*  2. When the instance was created with PSA_Deferred on the function returns the      */
+/*     results of LVM_ProcessSpectrum and must be called from the same thread           */
+/*  3. Otherwise the function applies the pending settings like LVM_Process and must be */
+/*     called from the thread running LVM_Process. LVM_GetSpectrumSnapshot is the only  */
+/*     function reading the spectrum that is safe on other threads                      */
 /*                                                                                      */
 /****************************************************************************************/
 LVM_ReturnStatus_en LVM_GetSpectrum( LVM_Handle_t            hInstance,
@@ -609,6 +974,82 @@ LVM_ReturnStatus_en LVM_GetSpectrum( LVM_Handle_t            hInstance,
                                      LVM_UINT8               *pPastPeaks,
                                      LVM_INT32               AudioTime);
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessSpectrum                                         */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function runs the Spectrum Analyzer of an instance created with PSA_Deferred   */
+/*  on. LVM_Process only writes the mono mixdown of each block to a single producer,    */
+/*  single consumer ring, this function analyses all the blocks in the ring. It is      */
+/*  meant to be called periodically from an analysis thread, the spectrum is then read  */
+/*  with LVM_GetSpectrum on the same thread.                                            */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pAnalysedSamples        Total number of analysed samples, may be NULL               */
+/*  pDroppedSamples         Total number of samples dropped by LVM_Process when the     */
+/*                          ring was full or by this function when the analyser         */
+/*                          rejected a block, may be NULL                               */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When hInstance is NULL                                      */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without PSA_Deferred          */
+/*  LVM_ALGORITHMPSA        When the analyser rejected the settings of a block, the     */
+/*                          block is dropped and the next call resumes after it         */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may run concurrently with the LVM_Process function                 */
+/*  2. LVM_FreeModuleMemory must not be called while this function runs                 */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessSpectrum( LVM_Handle_t        hInstance,
+                                         LVM_UINT32          *pAnalysedSamples,
+                                         LVM_UINT32          *pDroppedSamples);
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetSpectrumSnapshot                                     */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function reads the last spectrum published by the thread running the Spectrum  */
+/*  Analyzer, LVM_Process or LVM_ProcessSpectrum with PSA_Deferred on. A spectrum is    */
+/*  published every 20 ms of audio with the current and peak level of each band in      */
+/*  dBFS. Any number of threads can read the snapshots, they neither lock nor touch     */
+/*  the analyser.                                                                       */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pCurrentLevels          Pointer to MaxBands current levels                          */
+/*  pPeakLevels             Pointer to MaxBands peak levels                             */
+/*  MaxBands                Number of levels of the buffers, the levels of the bands    */
+/*                          above are not read                                          */
+/*  pInfo                   Pointer to the description of the snapshot                  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without the Spectrum Analyzer */
+/*  LVM_BUSY                When the snapshot changed during each of the reads, the     */
+/*                          buffers are then undefined and the call can be repeated     */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may run concurrently with the LVM_Process and LVM_ProcessSpectrum  */
+/*     functions and with itself. It is wait-free: it never blocks and reads the        */
+/*     snapshot at most LVM_PSA_SNAPSHOT_RETRIES times before returning LVM_BUSY        */
+/*  2. Before the first snapshot the Number is 0 and the levels are LVM_PSA_SILENCE_DB  */
+/*  3. The peaks hold and decay like the past peaks of LVM_GetSpectrum, once per 20 ms  */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetSpectrumSnapshot( LVM_Handle_t            hInstance,
+                                             LVM_FLOAT               *pCurrentLevels,
+                                             LVM_FLOAT               *pPeakLevels,
+                                             LVM_UINT16              MaxBands,
+                                             LVM_PSA_SnapshotInfo_t  *pInfo);
+#endif
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVM_SetVolumeNoSmoothing                                    */
@@ -632,6 +1073,58 @@ LVM_ReturnStatus_en LVM_GetSpectrum( LVM_Handle_t            hInstance,
 LVM_ReturnStatus_en LVM_SetVolumeNoSmoothing( LVM_Handle_t           hInstance,
                                               LVM_ControlParams_t    *pParams);
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetDenormalStats                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/* This function is used to read the denormal detection counters. Denormal output      */
+/* samples show that the recursive filters have decayed into the denormal range, which  */
+/* slows down the processing on most processors.                                        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pStats                  Pointer to the counters (output)                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The counters are only updated when DenormalDetect is on in the extended          */
+/*     instance parameters, they are cleared by LVM_ClearAudioBuffers                   */
+/*  2. This function may be interrupted by the LVM_Process function                     */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetDenormalStats( LVM_Handle_t           hInstance,
+                                          LVM_DenormalStats_t    *pStats);
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetPcmStats                                             */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is used to read the saturation counters of LVM_ProcessPcm             */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pStats                  Pointer to the counters (output)                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The counters are cleared by LVM_ClearAudioBuffers                                */
+/*  2. This function may be interrupted by the LVM_ProcessPcm function                  */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetPcmStats(      LVM_Handle_t           hInstance,
+                                          LVM_PcmStats_t         *pStats);
+#endif
+
 
 #ifdef __cplusplus
 }
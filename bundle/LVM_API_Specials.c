@@ -46,6 +46,10 @@
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1. This function may be interrupted by the LVM_Process function                     */
+/*  2. When the instance was created with PSA_Deferred on the function returns the      */
+/*     results of LVM_ProcessSpectrum and must be called from the same thread           */
+/*  3. Otherwise the function calls LVM_ApplyNewSettings and must be called from the    */
+/*     thread running LVM_Process, other threads use LVM_GetSpectrumSnapshot            */
 /*                                                                                      */
 /****************************************************************************************/
 LVM_ReturnStatus_en LVM_GetSpectrum(
@@ -66,13 +70,28 @@ LVM_ReturnStatus_en LVM_GetSpectrum(
         return LVM_NULLADDRESS;
     }
 
-    /*If PSA is not included at the time of instance creation, return without any processing*/
-    if(pInstance->InstParams.PSA_Included!=LVM_PSA_ON)
+    /*
+     * The deferred analyser belongs to the analysis thread, the settings are applied by
+     * LVM_ProcessSpectrum. Nothing was analysed until it has taken the first block.
+     */
+    if (pInstance->pPSARing != LVM_NULL)
     {
-        return LVM_SUCCESS;
+        hPSAInstance = pInstance->pPSARing->hAnalyser;
+        if (hPSAInstance == LVM_NULL)
+        {
+            return LVM_ALGORITHMDISABLED;
+        }
     }
+    else
+    {
+        /*If PSA is not included at the time of instance creation, return without any processing*/
+        if(pInstance->InstParams.PSA_Included!=LVM_PSA_ON)
+        {
+            return LVM_SUCCESS;
+        }
 
-    hPSAInstance = pInstance->hPSAInstance;
+        hPSAInstance = pInstance->hPSAInstance;
+    }
 
     if((pCurrentPeaks == LVM_NULL) ||
         (pPastPeaks == LVM_NULL))
@@ -81,18 +100,21 @@ LVM_ReturnStatus_en LVM_GetSpectrum(
     }
 
 
-    /*
-     * Update new parameters if necessary
-     */
-    if (pInstance->ControlPending == LVM_TRUE)
+    if (pInstance->pPSARing == LVM_NULL)
     {
-        LVM_ApplyNewSettings(hInstance);
-    }
+        /*
+         * Update new parameters if necessary
+         */
+        if (pInstance->ControlPending == LVM_TRUE)
+        {
+            LVM_ApplyNewSettings(hInstance);
+        }
 
-    /* If PSA module is disabled, do nothing */
-    if(pInstance->Params.PSA_Enable==LVM_PSA_OFF)
-    {
-        return LVM_ALGORITHMDISABLED;
+        /* If PSA module is disabled, do nothing */
+        if(pInstance->Params.PSA_Enable==LVM_PSA_OFF)
+        {
+            return LVM_ALGORITHMDISABLED;
+        }
     }
 
     LVPSA_Status = LVPSA_GetSpectrum(hPSAInstance,
@@ -116,6 +138,237 @@ LVM_ReturnStatus_en LVM_GetSpectrum(
 }
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessSpectrum                                         */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function runs the deferred Spectrum Analyzer on all the blocks LVM_Process     */
+/*  has written to the ring. The analyser handle and settings travel with each block,   */
+/*  the function reads nothing else from the instance.                                  */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pAnalysedSamples        Total number of analysed samples, may be NULL               */
+/*  pDroppedSamples         Total number of samples dropped by LVM_Process when the     */
+/*                          ring was full or by this function when the analyser         */
+/*                          rejected a block, may be NULL                               */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When hInstance is NULL                                      */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without PSA_Deferred          */
+/*  LVM_ALGORITHMPSA        When the analyser rejected the settings of a block, the     */
+/*                          block is dropped and the next call resumes after it         */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may run concurrently with the LVM_Process function, it is the     */
+/*     single consumer of the ring                                                      */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessSpectrum(LVM_Handle_t        hInstance,
+                                        LVM_UINT32          *pAnalysedSamples,
+                                        LVM_UINT32          *pDroppedSamples)
+{
+    LVM_Instance_t          *pInstance = (LVM_Instance_t  *)hInstance;
+    LVM_PSA_Ring_t          *pRing;
+    LVM_PSA_RingBlock_t     *pBlock;
+    LVPSA_ControlParams_t   PSA_Params;
+    LVM_UINT32              ReadBlock;
+    LVM_UINT32              WriteBlock;
+
+
+    if(pInstance == LVM_NULL)
+    {
+        return LVM_NULLADDRESS;
+    }
+
+    pRing = pInstance->pPSARing;
+    if(pRing == LVM_NULL)
+    {
+        return LVM_ALGORITHMDISABLED;
+    }
+
+    /*
+     * The acquire load makes the samples of the published blocks visible
+     */
+    ReadBlock  = atomic_load_explicit(&pRing->ReadBlock, memory_order_relaxed);
+    WriteBlock = atomic_load_explicit(&pRing->WriteBlock, memory_order_acquire);
+
+    while (ReadBlock != WriteBlock)
+    {
+        pBlock = &pRing->Blocks[ReadBlock & (LVM_PSA_RING_BLOCKS - 1)];
+
+        /*
+         * Settings changes are applied by LVPSA_Process
+         */
+        if ((pBlock->hPSAInstance != pRing->hAnalyser) ||
+            (pBlock->SampleRate != pRing->SampleRate) ||
+            (pBlock->PeakDecayRate != pRing->PeakDecayRate))
+        {
+            PSA_Params.Fs                  = pBlock->SampleRate;
+            PSA_Params.LevelDetectionSpeed = (LVPSA_LevelDetectSpeed_en)pBlock->PeakDecayRate;
+            if (LVPSA_Control(pBlock->hPSAInstance, &PSA_Params) != LVPSA_OK)
+            {
+                /*
+                 * Drop the block so the ring does not stall on it
+                 */
+                atomic_fetch_add_explicit(&pRing->DroppedSamples, pBlock->SampleCount,
+                                          memory_order_relaxed);
+                ReadBlock++;
+                atomic_store_explicit(&pRing->ReadBlock, ReadBlock, memory_order_release);
+                return LVM_ALGORITHMPSA;
+            }
+            pRing->hAnalyser     = pBlock->hPSAInstance;
+            pRing->SampleRate    = pBlock->SampleRate;
+            pRing->PeakDecayRate = pBlock->PeakDecayRate;
+        }
+
+        LVPSA_Process(pBlock->hPSAInstance,
+                      &pRing->Samples[pBlock->Start & (LVM_PSA_RING_SAMPLES - 1)],
+                      pBlock->SampleCount,
+                      (LVPSA_Time)pBlock->AudioTime);
+#ifdef BUILD_FLOAT
+        LVM_PSASnapshotPublish(pInstance->pPSASnapshot,
+                               pBlock->hPSAInstance);
+#endif
+        pRing->AnalysedSamples += pBlock->SampleCount;
+
+        /*
+         * Release the block to LVM_Process
+         */
+        ReadBlock++;
+        atomic_store_explicit(&pRing->ReadBlock, ReadBlock, memory_order_release);
+    }
+
+    if (pAnalysedSamples != LVM_NULL)
+    {
+        *pAnalysedSamples = pRing->AnalysedSamples;
+    }
+    if (pDroppedSamples != LVM_NULL)
+    {
+        *pDroppedSamples = atomic_load_explicit(&pRing->DroppedSamples, memory_order_relaxed);
+    }
+
+    return(LVM_SUCCESS);
+}
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetSpectrumSnapshot                                     */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function reads the last spectrum published by the thread running the Spectrum  */
+/*  Analyzer. A slot of the snapshots is copied and the copy is kept when the sequence  */
+/*  of the slot did not change meanwhile, otherwise the last snapshot is read again,    */
+/*  at most LVM_PSA_SNAPSHOT_RETRIES times.                                             */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pCurrentLevels          Pointer to MaxBands current levels                          */
+/*  pPeakLevels             Pointer to MaxBands peak levels                             */
+/*  MaxBands                Number of levels of the buffers                             */
+/*  pInfo                   Pointer to the description of the snapshot                  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*  LVM_ALGORITHMDISABLED   When the instance was created without the Spectrum Analyzer */
+/*  LVM_BUSY                When each copy was torn by the publisher                    */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may run concurrently with the LVM_Process and LVM_ProcessSpectrum  */
+/*     functions and with itself, a copy is only torn when the publisher has reused     */
+/*     its slot, LVM_PSA_SNAPSHOT_SLOTS snapshots later. The number of copies is        */
+/*     bounded so the function is wait-free                                             */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetSpectrumSnapshot(LVM_Handle_t            hInstance,
+                                            LVM_FLOAT               *pCurrentLevels,
+                                            LVM_FLOAT               *pPeakLevels,
+                                            LVM_UINT16              MaxBands,
+                                            LVM_PSA_SnapshotInfo_t  *pInfo)
+{
+    LVM_Instance_t          *pInstance = (LVM_Instance_t  *)hInstance;
+    LVM_PSA_Snapshot_t      *pSnapshot;
+    LVM_PSA_SnapshotSlot_t  *pSlot;
+    LVM_UINT32              Number;
+    LVM_UINT32              Sequence;
+    LVM_UINT32              Slot;
+    LVM_UINT16              NrBands;
+    LVM_UINT16              ii;
+    LVM_UINT16              Retry;
+
+
+    if((pInstance == LVM_NULL) ||
+       (pCurrentLevels == LVM_NULL) ||
+       (pPeakLevels == LVM_NULL) ||
+       (pInfo == LVM_NULL))
+    {
+        return LVM_NULLADDRESS;
+    }
+
+    pSnapshot = pInstance->pPSASnapshot;
+    if(pSnapshot == LVM_NULL)
+    {
+        return LVM_ALGORITHMDISABLED;
+    }
+
+    for (Retry = 0; Retry < LVM_PSA_SNAPSHOT_RETRIES; Retry++)
+    {
+        /*
+         * The acquire loads make the levels of the published slot visible
+         */
+        Number = atomic_load_explicit(&pSnapshot->Published, memory_order_acquire);
+        if (Number == 0)
+        {
+            NrBands = pSnapshot->NrBands;
+            for (ii = 0; (ii < NrBands) && (ii < MaxBands); ii++)
+            {
+                pCurrentLevels[ii] = LVM_PSA_SILENCE_DB;
+                pPeakLevels[ii]    = LVM_PSA_SILENCE_DB;
+            }
+            pInfo->Number    = 0;
+            pInfo->AudioTime = 0;
+            pInfo->NrBands   = NrBands;
+            return(LVM_SUCCESS);
+        }
+
+        Slot     = Number & (LVM_PSA_SNAPSHOT_SLOTS - 1);
+        pSlot    = &pSnapshot->Slots[Slot];
+        Sequence = atomic_load_explicit(&pSnapshot->Sequence[Slot], memory_order_acquire);
+        if (Sequence != 2 * Number)
+        {
+            continue;
+        }
+
+        NrBands = atomic_load_explicit(&pSlot->NrBands, memory_order_relaxed);
+        for (ii = 0; (ii < NrBands) && (ii < MaxBands); ii++)
+        {
+            pCurrentLevels[ii] = atomic_load_explicit(&pSlot->pCurrentLevels[ii], memory_order_relaxed);
+            pPeakLevels[ii]    = atomic_load_explicit(&pSlot->pPeakLevels[ii], memory_order_relaxed);
+        }
+        pInfo->AudioTime = atomic_load_explicit(&pSlot->AudioTime, memory_order_relaxed);
+
+        /*
+         * The acquire fence orders the copy before the second read of the sequence
+         */
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&pSnapshot->Sequence[Slot], memory_order_relaxed) == Sequence)
+        {
+            pInfo->Number  = Number;
+            pInfo->NrBands = NrBands;
+            return(LVM_SUCCESS);
+        }
+    }
+
+    return(LVM_BUSY);
+}
+#endif
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVM_SetVolumeNoSmoothing                                    */
@@ -148,3 +401,72 @@ LVM_ReturnStatus_en LVM_SetVolumeNoSmoothing( LVM_Handle_t           hInstance,
     return Error;
 }
 
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetDenormalStats                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/* This function is used to read the denormal detection counters                        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pStats                  Pointer to the counters (output)                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may be interrupted by the LVM_Process function                     */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetDenormalStats( LVM_Handle_t           hInstance,
+                                          LVM_DenormalStats_t    *pStats)
+{
+    LVM_Instance_t      *pInstance =(LVM_Instance_t  *)hInstance;
+
+    if((hInstance == LVM_NULL) || (pStats == LVM_NULL))
+    {
+        return LVM_NULLADDRESS;
+    }
+
+    *pStats = pInstance->DenormalStats;
+    return(LVM_SUCCESS);
+}
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetPcmStats                                             */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/* This function is used to read the saturation counters of LVM_ProcessPcm              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pStats                  Pointer to the counters (output)                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         If any of input addresses are NULL                          */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function may be interrupted by the LVM_ProcessPcm function                  */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_GetPcmStats(      LVM_Handle_t           hInstance,
+                                          LVM_PcmStats_t         *pStats)
+{
+    LVM_Instance_t      *pInstance =(LVM_Instance_t  *)hInstance;
+
+    if((hInstance == LVM_NULL) || (pStats == LVM_NULL))
+    {
+        return LVM_NULLADDRESS;
+    }
+
+    *pStats = pInstance->PcmStats;
+    return(LVM_SUCCESS);
+}
+#endif
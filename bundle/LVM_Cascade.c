@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/*    Includes                                                                          */
+/*                                                                                      */
+/****************************************************************************************/
+
+#include "LVM_Private.h"
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CascadeCompile                                          */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Merges the adjacent linear filters of the bundle into one cascade of second order   */
+/*  sections and takes over their history. The N-Band Equaliser bands come first, the   */
+/*  treble boost is added as the last section when no bass enhancement sits between     */
+/*  them.                                                                               */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the instance                                     */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The cascade stays pending while the equaliser is in an operating mode           */
+/*      transition, the equaliser then runs its own bypass mixer                        */
+/*  2.  The bass enhancement is not merged, its AGC and its saturating bypass mixer     */
+/*      are not linear. Neither is the DC removal, it follows the saturating balance    */
+/*  3.  A single filter is left to its module, merging it saves no pass over the block  */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_CascadeCompile(LVM_Instance_t      *pInstance)
+{
+    LVM_Cascade_t           *pCascade = pInstance->pCascade;
+    LVM_FLOAT               *pCoefs;
+    LVM_FLOAT               *pHistory;
+    LVM_FLOAT               *pTaps = pInstance->pTE_Taps->TrebleBoost_Taps.Storage;
+    FO_FLOAT_LShx_Coefs_t   *pTE_Coefs = &pInstance->pTE_State->TrebleBoost_Coefs;
+    LVM_UINT16              Stride = (LVM_UINT16)(2 * (pCascade->MaxSections + 1));
+    LVM_UINT16              NrSections = 0;
+    LVM_INT16               NrChannels = 2;
+    LVM_INT16               ch;
+
+#ifdef SUPPORT_MC
+    /* Mono is processed as stereo */
+    if (pInstance->Params.SourceFormat != LVM_MONO)
+    {
+        NrChannels = pInstance->NrChannels;
+    }
+#endif
+
+    /*
+     * N-Band Equaliser bands
+     */
+    if (pInstance->EQNB_Active == LVM_TRUE)
+    {
+        (void)LVEQNB_GetSections(pInstance->hEQNBInstance,
+                                 pCascade->pCoefs,
+                                 pCascade->pHistory,
+                                 Stride,
+                                 &NrSections);
+        if (NrSections == 0)
+        {
+            return;
+        }
+    }
+    pCascade->Pending      = LVM_FALSE;
+    pCascade->NrEQSections = NrSections;
+
+    /*
+     * Treble boost, y = A0*x + A1*x(n-1) + B1*y(n-1) with its unsaturated output history
+     */
+    if ((pInstance->TE_Active == LVM_TRUE) &&
+        (pInstance->DBE_Active == LVM_FALSE) &&
+        (NrSections != 0))
+    {
+        pCoefs = &pCascade->pCoefs[5 * NrSections];
+        pCoefs[0] = pTE_Coefs->A0;
+        pCoefs[1] = pTE_Coefs->A1;
+        pCoefs[2] = 0.0f;
+        pCoefs[3] = pTE_Coefs->B1;
+        pCoefs[4] = 0.0f;
+        for (ch = 0; ch < NrChannels; ch++)
+        {
+            pHistory = &pCascade->pHistory[ch * Stride + 2 * (NrSections + 1)];
+            pHistory[0] = pTaps[2 * ch + 1];
+            pHistory[1] = 0.0f;
+        }
+        NrSections++;
+        pCascade->TE_Merged = LVM_TRUE;
+    }
+
+    if (NrSections < 2)
+    {
+        pCascade->TE_Merged = LVM_FALSE;
+        return;
+    }
+    pCascade->NrChannels = NrChannels;
+    pCascade->NrSections = NrSections;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CascadeRelease                                          */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Gives the history of the cascade back to the modules, they run separately until    */
+/*  the cascade is compiled again in the next block.                                    */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the instance                                     */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  Called before the module parameters change                                     */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_CascadeRelease(LVM_Instance_t      *pInstance)
+{
+    LVM_Cascade_t           *pCascade = pInstance->pCascade;
+    LVM_FLOAT               *pHistory;
+    LVM_FLOAT               *pTaps;
+    LVM_UINT16              Stride;
+    LVM_INT16               ch;
+
+    if (pCascade == LVM_NULL)
+    {
+        return;
+    }
+
+    pCascade->Pending = LVM_TRUE;
+    if (pCascade->NrSections == 0)
+    {
+        return;
+    }
+
+    Stride = (LVM_UINT16)(2 * (pCascade->MaxSections + 1));
+    if (pCascade->NrEQSections != 0)
+    {
+        (void)LVEQNB_SetSectionHistory(pInstance->hEQNBInstance,
+                                       pCascade->pHistory,
+                                       Stride);
+    }
+    if (pCascade->TE_Merged == LVM_TRUE)
+    {
+        pTaps = pInstance->pTE_Taps->TrebleBoost_Taps.Storage;
+        for (ch = 0; ch < pCascade->NrChannels; ch++)
+        {
+            pHistory = &pCascade->pHistory[ch * Stride + 2 * pCascade->NrEQSections];
+            pTaps[2 * ch]     = pHistory[0];
+            pTaps[2 * ch + 1] = pHistory[2];
+        }
+    }
+
+    pCascade->NrSections = 0;
+    pCascade->TE_Merged  = LVM_FALSE;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CascadeProcess                                          */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Runs the sections of the cascade on a block in place, one channel at a time with    */
+/*  all the sections for each sample.                                                   */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pCascade                Pointer to the cascade                                      */
+/*  pData                   Pointer to the interleaved block                            */
+/*  NrFrames                Number of frames in the block                               */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The history of channel ch starts at pHistory[ch * 2 * (MaxSections + 1)], with  */
+/*      x(n-1) and x(n-2) of the input of each section and of the cascade output        */
+/*  2.  The output is saturated when the treble boost is merged, as in its module       */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_CascadeProcess(LVM_Cascade_t       *pCascade,
+                        LVM_FLOAT           *pData,
+                        LVM_INT16           NrFrames)
+{
+    LVM_INT32               Stride = 2 * (pCascade->MaxSections + 1);
+    LVM_INT16               NrChannels = pCascade->NrChannels;
+    LVM_INT16               NrSections = pCascade->NrSections;
+    LVM_FLOAT               *pSample;
+    LVM_FLOAT               *pHistory;
+    LVM_FLOAT               *pCoefs;
+    LVM_FLOAT               x;
+    LVM_FLOAT               y;
+    LVM_INT16               ch;
+    LVM_INT16               ii;
+    LVM_INT16               n;
+
+    for (ch = 0; ch < NrChannels; ch++)
+    {
+        pSample = &pData[ch];
+        for (ii = NrFrames; ii != 0; ii--)
+        {
+            x        = *pSample;
+            pCoefs   = pCascade->pCoefs;
+            pHistory = &pCascade->pHistory[ch * Stride];
+            for (n = NrSections; n != 0; n--)
+            {
+                y  = pCoefs[0] * x;
+                y += pCoefs[1] * pHistory[0];
+                y += pCoefs[2] * pHistory[1];
+                y += pCoefs[3] * pHistory[2];
+                y += pCoefs[4] * pHistory[3];
+                pHistory[1] = pHistory[0];
+                pHistory[0] = x;
+                x = y;
+                pCoefs   += 5;
+                pHistory += 2;
+            }
+            pHistory[1] = pHistory[0];
+            pHistory[0] = x;
+
+            if (pCascade->TE_Merged == LVM_TRUE)
+            {
+                if (x > 1.0f)
+                {
+                    x = 1.0f;
+                }
+                else if (x < -1.0f)
+                {
+                    x = -1.0f;
+                }
+            }
+            *pSample = x;
+            pSample += NrChannels;
+        }
+    }
+}
+#endif
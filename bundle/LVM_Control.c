@@ -22,6 +22,8 @@
 /*                                                                                      */
 /****************************************************************************************/
 
+#include "audio.h"
+
 #include "VectorArithmetic.h"
 #include "ScalarArithmetic.h"
 #include "LVM_Coeffs.h"
@@ -48,6 +50,13 @@
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1. This function may be interrupted by the LVM_Process function                     */
+/*  2. With a module allocator the memory of a module is allocated here the first time  */
+/*     it is enabled, LVM_NULLADDRESS is returned when the allocation fails and         */
+/*     LVM_ALIGNMENTERROR when the memory is not 64-bit aligned. The module is          */
+/*     initialised in it by the next LVM_Process call                                   */
+/*  3. An instance sharing its equaliser coefficients with a template or clones gets a  */
+/*     copy of them here when its equaliser settings change, LVM_NULLADDRESS is         */
+/*     returned when the allocation fails and the parameters are left unchanged         */
 /*                                                                                      */
 /****************************************************************************************/
 
@@ -62,6 +71,14 @@ LVM_ReturnStatus_en LVM_SetControlParameters(LVM_Handle_t           hInstance,
         return (LVM_NULLADDRESS);
     }
 
+    /*
+     * Copy the shared equaliser coefficients before parameters that change them
+     */
+    if (LVM_CoefCopy(pInstance, pParams) != LVM_SUCCESS)
+    {
+        return (LVM_NULLADDRESS);
+    }
+
     pInstance->NewParams = *pParams;
 
     if(
@@ -204,6 +221,35 @@ LVM_ReturnStatus_en LVM_SetControlParameters(LVM_Handle_t           hInstance,
         return (LVM_OUTOFRANGE);
     }
 
+    /*
+     * Allocate the memory of the modules enabled for the first time, the audio thread
+     * initialises a module once its memory is published
+     */
+    {
+        LVM_ReturnStatus_en     Status = LVM_SUCCESS;
+
+        if (pParams->VirtualizerOperatingMode != LVM_MODE_OFF)
+        {
+            Status = LVM_ModuleAlloc(pInstance, LVM_MODULE_CS);
+        }
+        if ((Status == LVM_SUCCESS) && (pParams->BE_OperatingMode != LVM_BE_OFF))
+        {
+            Status = LVM_ModuleAlloc(pInstance, LVM_MODULE_DBE);
+        }
+        if ((Status == LVM_SUCCESS) && (pParams->EQNB_OperatingMode != LVM_EQNB_OFF))
+        {
+            Status = LVM_ModuleAlloc(pInstance, LVM_MODULE_EQNB);
+        }
+        if ((Status == LVM_SUCCESS) && (pParams->PSA_Enable != LVM_PSA_OFF) &&
+            (pInstance->InstParams.PSA_Included == LVM_PSA_ON))
+        {
+            Status = LVM_ModuleAlloc(pInstance, LVM_MODULE_PSA);
+        }
+        if (Status != LVM_SUCCESS)
+        {
+            return (Status);
+        }
+    }
 
     /*
     * Set the flag to indicate there are new parameters to use
@@ -297,6 +343,16 @@ void LVM_SetTrebleBoost(LVM_Instance_t         *pInstance,
 
     LVM_INT16               Offset;
     LVM_INT16               EffectLevel = 0;
+    LVM_INT16               ClearTaps;
+
+    /*
+     * Keep the history when only the sample rate changes between two banked rates
+     */
+    ClearTaps = (LVM_INT16)!((pInstance->TE_Active == LVM_TRUE) &&
+                             (pInstance->Params.TE_EffectLevel == pParams->TE_EffectLevel) &&
+                             (LVM_FsBankSwitch(pInstance->InstParamsEx.CoefBankRates,
+                                               pInstance->Params.SampleRate,
+                                               pParams->SampleRate) == LVM_TRUE));
 
     /*
      * Load the coefficients
@@ -328,15 +384,19 @@ void LVM_SetTrebleBoost(LVM_Instance_t         *pInstance,
             FO_2I_D16F32Css_LShx_TRC_WRA_01_Init(&pInstance->pTE_State->TrebleBoost_State,
                                             &pInstance->pTE_Taps->TrebleBoost_Taps,
                                             &LVM_TrebleBoostCoefs[Offset]);
+            pInstance->pTE_State->TrebleBoost_Coefs = LVM_TrebleBoostCoefs[Offset];
 
             /*
              * Clear the taps
              */
-            LoadConst_Float((LVM_FLOAT)0,                                     /* Value */
-                            (void *)&pInstance->pTE_Taps->TrebleBoost_Taps,  /* Destination.\
-                                                     Cast to void: no dereferencing in function */
-                            (LVM_UINT16)(sizeof(pInstance->pTE_Taps->TrebleBoost_Taps) / \
-                                                        sizeof(LVM_FLOAT))); /* Number of words */
+            if (ClearTaps)
+            {
+                LoadConst_Float((LVM_FLOAT)0,                                     /* Value */
+                                (void *)&pInstance->pTE_Taps->TrebleBoost_Taps,  /* Destination.\
+                                                         Cast to void: no dereferencing in function */
+                                (LVM_UINT16)(sizeof(pInstance->pTE_Taps->TrebleBoost_Taps) / \
+                                                            sizeof(LVM_FLOAT))); /* Number of words */
+            }
 #else
             FO_2I_D16F32Css_LShx_TRC_WRA_01_Init(&pInstance->pTE_State->TrebleBoost_State,
                                             &pInstance->pTE_Taps->TrebleBoost_Taps,
@@ -345,10 +405,13 @@ void LVM_SetTrebleBoost(LVM_Instance_t         *pInstance,
             /*
              * Clear the taps
              */
-            LoadConst_16((LVM_INT16)0,                                     /* Value */
-                         (void *)&pInstance->pTE_Taps->TrebleBoost_Taps,  /* Destination.\
-                                                     Cast to void: no dereferencing in function */
-                         (LVM_UINT16)(sizeof(pInstance->pTE_Taps->TrebleBoost_Taps)/sizeof(LVM_INT16))); /* Number of words */
+            if (ClearTaps)
+            {
+                LoadConst_16((LVM_INT16)0,                                     /* Value */
+                             (void *)&pInstance->pTE_Taps->TrebleBoost_Taps,  /* Destination.\
+                                                         Cast to void: no dereferencing in function */
+                             (LVM_UINT16)(sizeof(pInstance->pTE_Taps->TrebleBoost_Taps)/sizeof(LVM_INT16))); /* Number of words */
+            }
 #endif
         }
     }
@@ -504,36 +567,58 @@ void    LVM_SetVolume(LVM_Instance_t         *pInstance,
 /*  void                Nothing                                                     */
 /*                                                                                  */
 /* NOTES:                                                                           */
+/*  1. The biggest gain of all the bands bounds the gain of each headroom band, a   */
+/*     headroom band is only searched when the bound can raise the headroom and the */
+/*     search stops at the bound                                                    */
 /*                                                                                  */
 /************************************************************************************/
 void    LVM_SetHeadroom(LVM_Instance_t         *pInstance,
                         LVM_ControlParams_t    *pParams)
 {
+    LVM_HeadroomBandDef_t   *pHeadroomDef = pInstance->HeadroomParams.pHeadroomDefinition;
+    LVM_EQNB_BandDef_t      *pBandDef = pParams->pEQNB_BandDefinition;
     LVM_INT16   ii, jj;
     LVM_INT16   Headroom = 0;
     LVM_INT16   MaxGain = 0;
+    LVM_INT16   MaxBandGain = 0;
 
 
     if ((pParams->EQNB_OperatingMode == LVEQNB_ON) && (pInstance->HeadroomParams.Headroom_OperatingMode == LVM_HEADROOM_ON))
     {
+        /* Find the biggest band gain */
+        for (ii = 0; ii < pParams->EQNB_NBands; ii++)
+        {
+            if (pBandDef[ii].Gain > MaxBandGain)
+            {
+                MaxBandGain = pBandDef[ii].Gain;
+            }
+        }
+
         /* Find typical headroom value */
         for(jj = 0; jj < pInstance->HeadroomParams.NHeadroomBands; jj++)
         {
+            if ((MaxBandGain - pHeadroomDef[jj].Headroom_Offset) <= Headroom)
+            {
+                continue;
+            }
+
             MaxGain = 0;
             for( ii = 0; ii < pParams->EQNB_NBands; ii++)
             {
-                if((pParams->pEQNB_BandDefinition[ii].Frequency >= pInstance->HeadroomParams.pHeadroomDefinition[jj].Limit_Low) &&
-                   (pParams->pEQNB_BandDefinition[ii].Frequency <= pInstance->HeadroomParams.pHeadroomDefinition[jj].Limit_High))
+                if ((pBandDef[ii].Gain > MaxGain) &&
+                    (pBandDef[ii].Frequency >= pHeadroomDef[jj].Limit_Low) &&
+                    (pBandDef[ii].Frequency <= pHeadroomDef[jj].Limit_High))
                 {
-                    if(pParams->pEQNB_BandDefinition[ii].Gain > MaxGain)
+                    MaxGain = pBandDef[ii].Gain;
+                    if (MaxGain == MaxBandGain)
                     {
-                        MaxGain = pParams->pEQNB_BandDefinition[ii].Gain;
+                        break;
                     }
                 }
             }
 
-            if((MaxGain - pInstance->HeadroomParams.pHeadroomDefinition[jj].Headroom_Offset) > Headroom){
-                Headroom = (LVM_INT16)(MaxGain - pInstance->HeadroomParams.pHeadroomDefinition[jj].Headroom_Offset);
+            if((MaxGain - pHeadroomDef[jj].Headroom_Offset) > Headroom){
+                Headroom = (LVM_INT16)(MaxGain - pHeadroomDef[jj].Headroom_Offset);
             }
         }
 
@@ -583,9 +668,38 @@ LVM_ReturnStatus_en LVM_ApplyNewSettings(LVM_Handle_t   hInstance)
     } while ((pInstance->ControlPending != LVM_FALSE) &&
              (Count > 0));
 
+    /*
+     * Initialise the modules whose memory was allocated by the control thread and move
+     * the equaliser to its copy of the shared coefficients
+     */
+    if (pInstance->InstParamsEx.ModuleAllocator.pAlloc != LVM_NULL)
+    {
+        LVM_ModuleAttach(pInstance);
+        LVM_CoefAttach(pInstance);
+    }
+
+#ifdef BUILD_FLOAT
+    /*
+     * Give the history of the merged filters back to the modules before they change
+     */
+    LVM_CascadeRelease(pInstance);
+#endif
+
 #ifdef SUPPORT_MC
     pInstance->NrChannels = LocalParams.NrChannels;
     pInstance->ChMask = LocalParams.ChMask;
+
+    /* The balance channel map only changes with the channel configuration, mono input is processed as stereo */
+    if (LocalParams.SourceFormat == LVM_MONO)
+    {
+        LVC_MixSoft_1St_MC_float_SetChMap(pInstance->VC_BalanceChMap, 2, AUDIO_CHANNEL_OUT_STEREO);
+    }
+    else
+    {
+        LVC_MixSoft_1St_MC_float_SetChMap(pInstance->VC_BalanceChMap,
+                                          LocalParams.NrChannels,
+                                          LocalParams.ChMask);
+    }
 #endif
 
     /* Clear all internal data if format change*/
@@ -714,6 +828,7 @@ LVM_ReturnStatus_en LVM_ApplyNewSettings(LVM_Handle_t   hInstance)
     /*
      * Update the bass enhancement
      */
+    if (pInstance->hDBEInstance != LVM_NULL)
     {
         LVDBE_ReturnStatus_en       DBE_Status;
         LVDBE_Params_t              DBE_Params;
@@ -776,6 +891,7 @@ LVM_ReturnStatus_en LVM_ApplyNewSettings(LVM_Handle_t   hInstance)
     /*
      * Update the N-Band Equaliser
      */
+    if (pInstance->hEQNBInstance != LVM_NULL)
     {
         LVEQNB_ReturnStatus_en      EQNB_Status;
         LVEQNB_Params_t             EQNB_Params;
@@ -877,6 +993,7 @@ LVM_ReturnStatus_en LVM_ApplyNewSettings(LVM_Handle_t   hInstance)
     /*
      * Update concert sound
      */
+    if (pInstance->hCSInstance != LVM_NULL)
     {
         LVCS_ReturnStatus_en        CS_Status;
         LVCS_Params_t               CS_Params;
@@ -984,9 +1101,11 @@ LVM_ReturnStatus_en LVM_ApplyNewSettings(LVM_Handle_t   hInstance)
         PSA_Params.LevelDetectionSpeed = (LVPSA_LevelDetectSpeed_en)LocalParams.PSA_PeakDecayRate;
 
         /*
-         * Make the changes
+         * Make the changes, the deferred analyser takes them from the ring blocks
          */
-        if(pInstance->InstParams.PSA_Included==LVM_PSA_ON)
+        if((pInstance->InstParams.PSA_Included==LVM_PSA_ON) &&
+           (pInstance->pPSARing == LVM_NULL) &&
+           (hPSAInstance != LVM_NULL))
         {
             PSA_Status = LVPSA_Control(hPSAInstance,
                 &PSA_Params);
@@ -21,16 +21,83 @@
 /*                                                                                  */
 /************************************************************************************/
 
+#include "audio.h"
+
 #include "LVM_Private.h"
 #include "LVM_Tables.h"
 #include "VectorArithmetic.h"
 #include "InstAlloc.h"
+#include "LVM_Timer_Private.h"
+#include <string.h> /* For memcpy */
+#include <math.h>   /* For log10 */
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CopyInstParamsEx                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Copies the extended instance parameters known to the caller, the fields past Size   */
+/*  and all fields without extended parameters are set to zero.                         */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pDest                   Pointer to the complete extended parameters (output)        */
+/*  pSrc                    Pointer to the caller parameters, LVM_NULL for none         */
+/*                                                                                      */
+/****************************************************************************************/
+
+static void LVM_CopyInstParamsEx(LVM_InstParamsEx_t         *pDest,
+                                 const LVM_InstParamsEx_t   *pSrc)
+{
+    LVM_UINT32      Size = 0;
+
+
+    memset(pDest, 0, sizeof(LVM_InstParamsEx_t));
+    if (pSrc != LVM_NULL)
+    {
+        Size = pSrc->Size;
+        if (Size > sizeof(LVM_InstParamsEx_t))
+        {
+            Size = sizeof(LVM_InstParamsEx_t);
+        }
+        memcpy(pDest, pSrc, Size);
+    }
+    pDest->Size = sizeof(LVM_InstParamsEx_t);
+}
+
 
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVM_GetMemoryTable                                          */
 /*                                                                                      */
 /* DESCRIPTION:                                                                         */
+/*  This function is LVM_GetMemoryTableEx without extended instance parameters.         */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance Handle                                             */
+/*  pMemoryTable            Pointer to an empty memory definition table                 */
+/*  pInstParams             Pointer to the instance parameters                          */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  See LVM_GetMemoryTableEx                                                            */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
+                                       LVM_MemTab_t         *pMemoryTable,
+                                       LVM_InstParams_t     *pInstParams)
+{
+    return LVM_GetMemoryTableEx(hInstance,
+                                pMemoryTable,
+                                pInstParams,
+                                LVM_NULL);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetMemoryTableEx                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
 /*  This function is used for memory allocation and free. It can be called in           */
 /*  two ways:                                                                           */
 /*                                                                                      */
@@ -47,7 +114,9 @@
 /* PARAMETERS:                                                                          */
 /*  hInstance               Instance Handle                                             */
 /*  pMemoryTable            Pointer to an empty memory definition table                 */
-/*  pCapabilities           Pointer to the default capabilities                         */
+/*  pInstParams             Pointer to the instance parameters                          */
+/*  pInstParamsEx           Pointer to the extended instance parameters, LVM_NULL for   */
+/*                          none                                                        */
 /*                                                                                      */
 /* RETURNS:                                                                             */
 /*  LVM_SUCCESS             Succeeded                                                   */
@@ -63,7 +132,6 @@
 
 /*
  * 4 Types of Memory Regions of LVM
- * TODO: Allocate on the fly.
  * i)   LVM_MEMREGION_PERSISTENT_SLOW_DATA - For Instance Handles
  * ii)  LVM_MEMREGION_PERSISTENT_FAST_DATA - Persistent Buffers
  * iii) LVM_MEMREGION_PERSISTENT_FAST_COEF - For Holding Structure values
@@ -72,8 +140,13 @@
  * LVM_MEMREGION_PERSISTENT_SLOW_DATA:
  *   Total Memory size:
  *     sizeof(LVM_Instance_t) + \
- *     sizeof(LVM_Buffer_t) + \
+ *     sizeof(LVCS_Instance_t) + \
+ *     sizeof(LVDBE_Instance_t) + \
+ *     sizeof(LVEQNB_Instance_t) + \
  *     sizeof(LVPSA_InstancePr_t) + \
+ *     PSA_InitParams.nBands * sizeof(LVM_UINT8) - needed with PSA_Decimation + \
+ *     NrPSAGroups * sizeof(LVPSA_BankGroup_t) + \
+ *     sizeof(LVPSA_FFT_Instance_t) - instead of the groups with PSA_FFTBands + \
  *     sizeof(LVM_Buffer_t) - needed if buffer mode is LVM_MANAGED_BUFFER
  *
  * LVM_MEMREGION_PERSISTENT_FAST_DATA:
@@ -87,9 +160,21 @@
  *     pInstParams->EQNB_NumBands * sizeof(Biquad_2I_Order2_FLOAT_Taps_t) + \
  *     pInstParams->EQNB_NumBands * sizeof(LVEQNB_BandDef_t) + \
  *     pInstParams->EQNB_NumBands * sizeof(LVEQNB_BiquadType_en) + \
+ *     pInstParams->EQNB_NumBands * sizeof(Biquad_FLOAT_Instance_t) + \
+ *     NrEQGroups * LVM_MAX_CHANNELS * sizeof(LVEQNB_ParallelTaps_t) - needed with EQNB_Parallel + \
  *     2 * LVM_HEADROOM_MAX_NBANDS * sizeof(LVM_HeadroomBandDef_t) + \
- *     PSA_InitParams.nBands * sizeof(Biquad_1I_Order2_Taps_t) + \
- *     PSA_InitParams.nBands * sizeof(QPD_Taps_t)
+ *     NrPSAGroups * sizeof(LVPSA_BankTaps_t) + \
+ *     LVPSA_MAXDECIMATION * LVPSA_HALFBAND_HISTORY * sizeof(LVM_FLOAT) - needed with PSA_Decimation
+ *     (LVM_PSA_FFT_SIZE + PSA_FFTBands) * sizeof(LVM_FLOAT) - instead of the taps with PSA_FFTBands + \
+ *     sizeof(LVM_PSA_Snapshot_t) + \
+ *     NrSnapshotBands * sizeof(LVM_UINT8) + \
+ *     2 * LVM_PSA_SNAPSHOT_SLOTS * NrSnapshotBands * sizeof(LVM_FLOAT) - needed if PSA_Included is LVM_PSA_ON + \
+ *     sizeof(LVM_Cascade_t) + \
+ *     (pInstParams->EQNB_NumBands + 1) * 5 * sizeof(LVM_FLOAT) + \
+ *     (pInstParams->EQNB_NumBands + 2) * 2 * LVM_MAX_CHANNELS * sizeof(LVM_FLOAT) - needed with FilterMerge
+ *       NrPSAGroups is LVPSA_BANK_GROUPS(PSA_InitParams.nBands, PSA_Decimation)
+ *       NrEQGroups is LVEQNB_PARALLEL_GROUPS(pInstParams->EQNB_NumBands)
+ *       NrSnapshotBands is PSA_FFTBands, or LVM_PSA_NBANDS without it
  *
  * LVM_MEMREGION_PERSISTENT_FAST_COEF:
  *   Total Memory size:
@@ -98,9 +183,14 @@
  *     sizeof(LVDBE_Coef_FLOAT_t) + \
  *     sizeof(Biquad_FLOAT_Instance_t) + \
  *     sizeof(Biquad_FLOAT_Instance_t) + \
- *     pInstParams->EQNB_NumBands * sizeof(Biquad_FLOAT_Instance_t) + \
- *     PSA_InitParams.nBands * sizeof(Biquad_Instance_t) + \
- *     PSA_InitParams.nBands * sizeof(QPD_State_t)
+ *     pInstParams->EQNB_NumBands * sizeof(PK_FLOAT_Coefs_t) + \
+ *     NrPSAGroups * sizeof(LVPSA_BankCoefs_t) + \
+ *     NrEQGroups * sizeof(LVEQNB_ParallelCoefs_t) - needed with EQNB_Parallel + \
+ *     NrBankRates * pInstParams->EQNB_NumBands * sizeof(PK_FLOAT_Coefs_t) + \
+ *     NrBankRates * PSA_InitParams.nBands * sizeof(BP_FLOAT_Coefs_t)
+ *     LVM_PSA_FFT_SIZE * (2 * sizeof(LVM_FLOAT) + sizeof(LVM_UINT16) / 2) + \
+ *     PSA_FFTBands * sizeof(LVPSA_FFT_Band_t) - instead of the PSA coefficients with PSA_FFTBands
+ *       NrBankRates is the number of rates in pInstParamsEx->CoefBankRates
  *
  * LVM_MEMREGION_TEMPORARY_FAST (Scratch):
  *   Total Memory Size:
@@ -120,24 +210,37 @@
  *               * pCapabilities->MaxBlockSize)
  *       DBE  = (LVDBE_SCRATCHBUFFERS_INPLACE*sizeof(LVM_FLOAT)
  *               * pCapabilities->MaxBlockSize)
- *       PSA  = (2 * pInitParams->MaxInputBlockSize * sizeof(LVM_FLOAT))
- *              one MaxInputBlockSize for input and another for filter output
+ *       PSA  = (pInitParams->MaxInputBlockSize * sizeof(LVM_FLOAT))
+ *              for the input, with PSA_Decimation (2 * MaxInputBlockSize +
+ *              (LVPSA_MAXDECIMATION + 1) * (LVPSA_HALFBAND_HISTORY + 1))
+ *              * sizeof(LVM_FLOAT) for the decimated signals, with PSA_FFTBands
+ *              LVM_PSA_FFT_SIZE * sizeof(LVM_FLOAT) for the transform
  *     c)MAX_INTERNAL_BLOCKSIZE
  *       This Memory is needed for PSAInput - Temp memory to store output
  *       from McToMono block and given as input to PSA block
+ *
+ * With a module allocator in the extended instance parameters the persistent
+ * memory of CS, DBE, EQNB and PSA (the LVCS_, LVDBE_, LVEQNB_ and LVPSA_ terms
+ * above) is left out of the table. LVM_ModuleAlloc requests it per module the first time
+ * the module is enabled and keeps it in the ModuleMemoryTable of the instance.
+ * With CoefSharing a clone shares the LVEQNB_ coefficients of its template, see
+ * LVM_CoefShare.
  */
 
-LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
-                                       LVM_MemTab_t         *pMemoryTable,
-                                       LVM_InstParams_t     *pInstParams)
+LVM_ReturnStatus_en LVM_GetMemoryTableEx(LVM_Handle_t           hInstance,
+                                         LVM_MemTab_t           *pMemoryTable,
+                                         LVM_InstParams_t       *pInstParams,
+                                         LVM_InstParamsEx_t     *pInstParamsEx)
 {
 
     LVM_Instance_t      *pInstance = (LVM_Instance_t *)hInstance;
+    LVM_InstParamsEx_t  InstParamsEx;
     LVM_UINT32          AlgScratchSize;
     LVM_UINT32          BundleScratchSize;
     LVM_UINT16          InternalBlockSize;
     INST_ALLOC          AllocMem[LVM_NR_MEMORY_REGIONS];
     LVM_INT16           i;
+    LVM_INT16           Module;
 
 
     /*
@@ -164,14 +267,32 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
         return LVM_NULLADDRESS;
     }
 
+    /*
+     * Complete the extended parameters
+     */
+    LVM_CopyInstParamsEx(&InstParamsEx, pInstParamsEx);
+    pInstParamsEx = &InstParamsEx;
+
     /*
      *  Power Spectrum Analyser
      */
-    if(pInstParams->PSA_Included > LVM_PSA_ON)
+    if((pInstParams->PSA_Included > LVM_PSA_ON) ||
+       (pInstParamsEx->PSA_Deferred > LVM_MODE_ON) ||
+       (pInstParamsEx->PSA_Decimation > LVM_MODE_ON) ||
+       (pInstParamsEx->PSA_FFTBands > LVPSA_FFT_NBANDSMAX))
     {
         return (LVM_OUTOFRANGE);
     }
 
+    /*
+     * Module memory allocator
+     */
+    if ((pInstParamsEx->ModuleAllocator.pAlloc != LVM_NULL) &&
+        (pInstParamsEx->ModuleAllocator.pFree == LVM_NULL))
+    {
+        return (LVM_NULLADDRESS);
+    }
+
     /*
      * Check the instance parameters
      */
@@ -181,7 +302,53 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
     }
 
     /* N-Band Equalizer */
-    if( pInstParams->EQNB_NumBands > 32 )
+    if( (pInstParams->EQNB_NumBands > 32) ||
+        (pInstParamsEx->EQNB_Parallel > LVM_MODE_ON) )
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Coefficient banks */
+    if ((pInstParamsEx->CoefBankRates & ~LVM_FS_BANK_ALL) != 0)
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Denormal protection */
+    if ((pInstParamsEx->DenormalMode > LVM_DENORMAL_OFFSET) ||
+        (pInstParamsEx->DenormalDetect > LVM_MODE_ON))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Silence detection */
+    if (pInstParamsEx->SilenceDetect > LVM_MODE_ON)
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Planar and PCM processing */
+    if ((pInstParamsEx->PlanarIO > LVM_MODE_ON) ||
+        (pInstParamsEx->PcmIO > LVM_MODE_ON))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Filter merging */
+    if (pInstParamsEx->FilterMerge > LVM_MODE_ON)
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /* Coefficient sharing, the shared coefficients come from the module allocator */
+    if ((pInstParamsEx->CoefSharing > LVM_MODE_ON) ||
+        ((pInstParamsEx->CoefSharing == LVM_MODE_ON) &&
+         (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL)))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if (pInstParamsEx->OutputMode > LVM_OUTPUT_ACCUMULATE)
     {
         return (LVM_OUTOFRANGE);
     }
@@ -224,8 +391,9 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
     /*
     * Bundle requirements
     */
-    InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
-        sizeof(LVM_Instance_t));
+    InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
+                               sizeof(LVM_Instance_t),
+                               LVM_MEMBER_ALIGN);
 
 
     /*
@@ -247,6 +415,19 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
                             sizeof(LVM_Buffer_t));
     }
 
+#ifdef BUILD_FLOAT
+    /*
+     * Float block of the planar, PCM and accumulate process functions
+     */
+    if ((pInstParamsEx->PlanarIO == LVM_MODE_ON) ||
+        (pInstParamsEx->PcmIO == LVM_MODE_ON) ||
+        (pInstParamsEx->OutputMode == LVM_OUTPUT_ACCUMULATE))
+    {
+        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
+                            LVM_MAX_CHANNELS * InternalBlockSize * sizeof(LVM_FLOAT));
+    }
+#endif
+
     /*
      * Treble Enhancement requirements
      */
@@ -255,6 +436,24 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
     InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
                         sizeof(LVM_TE_Coefs_t));
 
+#ifdef BUILD_FLOAT
+    /*
+     * Filter merging requirements
+     */
+    if (pInstParamsEx->FilterMerge == LVM_MODE_ON)
+    {
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   sizeof(LVM_Cascade_t),
+                                   LVM_MEMBER_ALIGN);
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   (pInstParams->EQNB_NumBands + 1) * 5 * sizeof(LVM_FLOAT),
+                                   LVM_MEMBER_ALIGN);
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   (pInstParams->EQNB_NumBands + 2) * 2 * LVM_MAX_CHANNELS * sizeof(LVM_FLOAT),
+                                   LVM_MEMBER_ALIGN);
+    }
+#endif
+
     /*
      * N-Band Equalizer requirements
      */
@@ -264,197 +463,105 @@ LVM_ReturnStatus_en LVM_GetMemoryTable(LVM_Handle_t         hInstance,
                         (pInstParams->EQNB_NumBands * sizeof(LVM_EQNB_BandDef_t)));
 
     /*
-     * Concert Sound requirements
+     * Headroom management memory allocation
      */
-    {
-        LVCS_MemTab_t           CS_MemTab;
-        LVCS_Capabilities_t     CS_Capabilities;
-
-        /*
-         * Set the capabilities
-         */
-        CS_Capabilities.MaxBlockSize     = InternalBlockSize;
-
-        /*
-         * Get the memory requirements
-         */
-        LVCS_Memory(LVM_NULL,
-                    &CS_MemTab,
-                    &CS_Capabilities);
-
-        /*
-         * Update the memory allocation structures
-         */
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                            CS_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_DATA].Size);
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                            CS_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].Size);
-        if (CS_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size > AlgScratchSize) AlgScratchSize = CS_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size;
-
-    }
+    InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                       (LVM_HEADROOM_MAX_NBANDS * sizeof(LVM_HeadroomBandDef_t)));
+    InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                       (LVM_HEADROOM_MAX_NBANDS * sizeof(LVM_HeadroomBandDef_t)));
 
 
     /*
-     * Dynamic Bass Enhancement requirements
+     * Concert Sound, Dynamic Bass Enhancement, N-Band equaliser and Spectrum Analyzer
+     * requirements. The persistent memory of the modules is left out when it is
+     * allocated on demand, the scratch memory is always needed.
      */
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
     {
-        LVDBE_MemTab_t          DBE_MemTab;
-        LVDBE_Capabilities_t    DBE_Capabilities;
+        LVM_MemTab_t            ModuleTable;
+        LVM_ReturnStatus_en     Status;
 
-        /*
-         * Set the capabilities
-         */
-#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
-        DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 |
-                                           LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 |
-                                           LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 |
-                                           LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 |
-                                           LVDBE_CAP_FS_48000 | LVDBE_CAP_FS_88200 |
-                                           LVDBE_CAP_FS_96000 | LVDBE_CAP_FS_176400 |
-                                           LVDBE_CAP_FS_192000;
-#else
-        DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 | LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 | LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 | LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 | LVDBE_CAP_FS_48000;
-#endif
-        DBE_Capabilities.CentreFrequency = LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_66Hz | LVDBE_CAP_CENTRE_78Hz | LVDBE_CAP_CENTRE_90Hz;
-        DBE_Capabilities.MaxBlockSize    = InternalBlockSize;
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstParams->PSA_Included != LVM_PSA_ON))
+        {
+            continue;
+        }
 
         /*
          * Get the memory requirements
          */
-        LVDBE_Memory(LVM_NULL,
-                    &DBE_MemTab,
+        Status = LVM_ModuleInit(LVM_NULL,
+                                pInstParams,
+                                pInstParamsEx,
+                                Module,
+                                &ModuleTable);
+        if (Status != LVM_SUCCESS)
+        {
+            return(Status);
+        }
 
-                    &DBE_Capabilities);
         /*
          * Update the bundle table
          */
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                            DBE_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_DATA].Size);
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                            DBE_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].Size);
-        if (DBE_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size > AlgScratchSize) AlgScratchSize = DBE_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size;
-
+        if (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL)
+        {
+            for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+            {
+                InstAlloc_AddMemberAligned(&AllocMem[i],
+                                           ModuleTable.Region[i].Size,
+                                           LVM_MEMBER_ALIGN);
+            }
+        }
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstParamsEx->PSA_Deferred == LVM_MODE_ON))
+        {
+            /* The deferred analyser runs concurrently with LVM_Process */
+            InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                       ModuleTable.Region[LVM_MEMREGION_TEMPORARY_FAST].Size,
+                                       LVM_MEMBER_ALIGN);
+        }
+        else if (ModuleTable.Region[LVM_MEMREGION_TEMPORARY_FAST].Size > AlgScratchSize)
+        {
+            AlgScratchSize = ModuleTable.Region[LVM_MEMREGION_TEMPORARY_FAST].Size;
+        }
     }
 
-
     /*
-     * N-Band equaliser requirements
+     * Spectrum Analyzer input, the output of the channel mixdown. The deferred analyser
+     * takes its input from the ring.
      */
+    if((pInstParams->PSA_Included == LVM_PSA_ON) &&
+       (pInstParamsEx->PSA_Deferred == LVM_MODE_ON))
     {
-        LVEQNB_MemTab_t         EQNB_MemTab;            /* For N-Band Equaliser */
-        LVEQNB_Capabilities_t   EQNB_Capabilities;
-
-        /*
-         * Set the capabilities
-         */
-#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
-        EQNB_Capabilities.SampleRate   = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 |
-                                         LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 |
-                                         LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 |
-                                         LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 |
-                                         LVEQNB_CAP_FS_48000 | LVEQNB_CAP_FS_88200 |
-                                         LVEQNB_CAP_FS_96000 | LVEQNB_CAP_FS_176400 |
-                                         LVEQNB_CAP_FS_192000;
-#else
-        EQNB_Capabilities.SampleRate   = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 | LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 | LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 | LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 | LVEQNB_CAP_FS_48000;
-#endif
-        EQNB_Capabilities.SourceFormat = LVEQNB_CAP_STEREO | LVEQNB_CAP_MONOINSTEREO;
-        EQNB_Capabilities.MaxBlockSize = InternalBlockSize;
-        EQNB_Capabilities.MaxBands     = pInstParams->EQNB_NumBands;
-
-        /*
-         * Get the memory requirements
-         */
-        LVEQNB_Memory(LVM_NULL,
-                      &EQNB_MemTab,
-                      &EQNB_Capabilities);
-
-        /*
-         * Update the bundle table
-         */
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                            EQNB_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_DATA].Size);
-        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                            EQNB_MemTab.Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].Size);
-        if (EQNB_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size > AlgScratchSize) AlgScratchSize = EQNB_MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size;
-
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   sizeof(LVM_PSA_Ring_t),
+                                   LVM_MEMBER_ALIGN);
     }
-
-    /*
-     * Headroom management memory allocation
-     */
-    InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                       (LVM_HEADROOM_MAX_NBANDS * sizeof(LVM_HeadroomBandDef_t)));
-    InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                       (LVM_HEADROOM_MAX_NBANDS * sizeof(LVM_HeadroomBandDef_t)));
-
-
-    /*
-     * Spectrum Analyzer memory requirements
-     */
+    else if(pInstParams->PSA_Included == LVM_PSA_ON)
     {
-        pLVPSA_Handle_t     hPSAInst = LVM_NULL;
-        LVPSA_MemTab_t      PSA_MemTab;
-        LVPSA_InitParams_t  PSA_InitParams;
-        LVPSA_FilterParam_t FiltersParams[9];
-        LVPSA_RETURN        PSA_Status;
-
-        if(pInstParams->PSA_Included == LVM_PSA_ON)
-        {
-            PSA_InitParams.SpectralDataBufferDuration   = (LVM_UINT16) 500;
-            PSA_InitParams.MaxInputBlockSize            = (LVM_UINT16) 1000;
-            PSA_InitParams.nBands                       = (LVM_UINT16) 9;
-
-            PSA_InitParams.pFiltersParams = &FiltersParams[0];
-            for(i = 0; i < PSA_InitParams.nBands; i++)
-            {
-                FiltersParams[i].CenterFrequency    = (LVM_UINT16) 1000;
-                FiltersParams[i].QFactor            = (LVM_UINT16) 25;
-                FiltersParams[i].PostGain           = (LVM_INT16)  0;
-            }
-
-            /*
-            * Get the memory requirements
-            */
-            PSA_Status = LVPSA_Memory (hPSAInst,
-                                        &PSA_MemTab,
-                                        &PSA_InitParams);
-
-            if (PSA_Status != LVPSA_OK)
-            {
-                return((LVM_ReturnStatus_en) LVM_ALGORITHMPSA);
-            }
-
-            /*
-            * Update the bundle table
-            */
-            /* Slow Data */
-            InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
-                PSA_MemTab.Region[LVM_PERSISTENT_SLOW_DATA].Size);
-
-            /* Fast Data */
-            InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                PSA_MemTab.Region[LVM_PERSISTENT_FAST_DATA].Size);
-
-            /* Fast Coef */
-            InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                PSA_MemTab.Region[LVM_PERSISTENT_FAST_COEF].Size);
-
-            /* Fast Temporary */
 #ifdef BUILD_FLOAT
-            InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
-                                MAX_INTERNAL_BLOCKSIZE * sizeof(LVM_FLOAT));
+        InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
+                            MAX_INTERNAL_BLOCKSIZE * sizeof(LVM_FLOAT));
 #else
-            InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
-                                MAX_INTERNAL_BLOCKSIZE * sizeof(LVM_INT16));
+        InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
+                            MAX_INTERNAL_BLOCKSIZE * sizeof(LVM_INT16));
 #endif
-
-            if (PSA_MemTab.Region[LVM_TEMPORARY_FAST].Size > AlgScratchSize)
-            {
-                AlgScratchSize = PSA_MemTab.Region[LVM_TEMPORARY_FAST].Size;
-            }
-        }
     }
+#ifdef BUILD_FLOAT
+    if(pInstParams->PSA_Included == LVM_PSA_ON)
+    {
+        /* Spectrum snapshots of the readers, the peaks and the levels of the slots */
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   sizeof(LVM_PSA_Snapshot_t),
+                                   LVM_MEMBER_ALIGN);
+        InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                            LVM_PSA_SNAPSHOT_NBANDS(pInstParamsEx) * sizeof(LVM_UINT8));
+        InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                   LVM_PSA_SNAPSHOT_SLOTS * 2 * LVM_PSA_SNAPSHOT_NBANDS(pInstParamsEx) *
+                                   sizeof(_Atomic LVM_FLOAT),
+                                   LVM_MEMBER_ALIGN);
+    }
+#endif
 
     /*
      * Return the memory table
@@ -521,11 +628,91 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
                                           LVM_MemTab_t           *pMemoryTable,
                                           LVM_InstParams_t       *pInstParams)
 {
+    return LVM_GetInstanceHandleEx(phInstance,
+                                   pMemoryTable,
+                                   pInstParams,
+                                   LVM_NULL);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetInstanceHandleEx                                     */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is LVM_GetInstanceHandle with the extended instance parameters.       */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  phInstance              pointer to the instance handle                              */
+/*  pMemoryTable            Pointer to the memory definition table                      */
+/*  pInstParams             Pointer to the initialisation capabilities                  */
+/*  pInstParamsEx           Pointer to the extended instance parameters, LVM_NULL for   */
+/*                          none                                                        */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  See LVM_InitInstance                                                                */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_GetInstanceHandleEx(LVM_Handle_t          *phInstance,
+                                            LVM_MemTab_t          *pMemoryTable,
+                                            LVM_InstParams_t      *pInstParams,
+                                            LVM_InstParamsEx_t    *pInstParamsEx)
+{
+    LVM_InstParamsEx_t      InstParamsEx;
+
+
+    LVM_CopyInstParamsEx(&InstParamsEx, pInstParamsEx);
+    return LVM_InitInstance(phInstance,
+                            pMemoryTable,
+                            pInstParams,
+                            &InstParamsEx,
+                            LVM_FALSE);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_InitInstance                                            */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function initialises a bundle instance for LVM_GetInstanceHandle and          */
+/*  LVM_ClearAudioBuffers.                                                              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  phInstance              pointer to the instance handle                              */
+/*  pMemoryTable            Pointer to the memory definition table                      */
+/*  pInstParams             Pointer to the initialisation capabilities                  */
+/*  pInstParamsEx           Pointer to the complete extended instance parameters        */
+/*  KeepAnalyser            LVM_TRUE to leave the ring and the Spectrum Analyzer of a   */
+/*                          deferred analysis untouched, they belong to the analysis    */
+/*                          thread                                                      */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Initialisation succeeded                                    */
+/*  LVM_OUTOFRANGE          When any of the Instance parameters are out of range        */
+/*  LVM_NULLADDRESS         When one of phInstance, pMemoryTable or pInstParams are NULL*/
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_InitInstance(LVM_Handle_t           *phInstance,
+                                     LVM_MemTab_t           *pMemoryTable,
+                                     LVM_InstParams_t       *pInstParams,
+                                     LVM_InstParamsEx_t     *pInstParamsEx,
+                                     LVM_INT16              KeepAnalyser)
+{
 
     LVM_ReturnStatus_en     Status = LVM_SUCCESS;
     LVM_Instance_t          *pInstance;
     INST_ALLOC              AllocMem[LVM_NR_MEMORY_REGIONS];
     LVM_INT16               i;
+    LVM_INT16               Module;
     LVM_UINT16              InternalBlockSize;
     LVM_INT32               BundleScratchSize;
 
@@ -558,34 +745,86 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
         return (LVM_OUTOFRANGE);
     }
 
-    if( pInstParams->EQNB_NumBands > 32 )
+    if( (pInstParams->EQNB_NumBands > 32) ||
+        (pInstParamsEx->EQNB_Parallel > LVM_MODE_ON) )
     {
         return (LVM_OUTOFRANGE);
     }
 
-    if(pInstParams->BufferMode == LVM_MANAGED_BUFFERS)
+    if ((pInstParamsEx->CoefBankRates & ~LVM_FS_BANK_ALL) != 0)
     {
-        if( (pInstParams->MaxBlockSize < LVM_MIN_MAXBLOCKSIZE ) || (pInstParams->MaxBlockSize > LVM_MANAGED_MAX_MAXBLOCKSIZE ) )
-        {
-            return (LVM_OUTOFRANGE);
-        }
+        return (LVM_OUTOFRANGE);
     }
-    else
+
+    if ((pInstParamsEx->DenormalMode > LVM_DENORMAL_OFFSET) ||
+        (pInstParamsEx->DenormalDetect > LVM_MODE_ON))
     {
-        if( (pInstParams->MaxBlockSize < LVM_MIN_MAXBLOCKSIZE ) || (pInstParams->MaxBlockSize > LVM_UNMANAGED_MAX_MAXBLOCKSIZE) )
-        {
-            return (LVM_OUTOFRANGE);
-        }
+        return (LVM_OUTOFRANGE);
     }
 
-    if(pInstParams->PSA_Included > LVM_PSA_ON)
+    if (pInstParamsEx->SilenceDetect > LVM_MODE_ON)
     {
         return (LVM_OUTOFRANGE);
     }
 
-    /*
-     * Initialise the AllocMem structures
-     */
+    if ((pInstParamsEx->PlanarIO > LVM_MODE_ON) ||
+        (pInstParamsEx->PcmIO > LVM_MODE_ON))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if (pInstParamsEx->FilterMerge > LVM_MODE_ON)
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if ((pInstParamsEx->CoefSharing > LVM_MODE_ON) ||
+        ((pInstParamsEx->CoefSharing == LVM_MODE_ON) &&
+         (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL)))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if (pInstParamsEx->OutputMode > LVM_OUTPUT_ACCUMULATE)
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if(pInstParams->BufferMode == LVM_MANAGED_BUFFERS)
+    {
+        if( (pInstParams->MaxBlockSize < LVM_MIN_MAXBLOCKSIZE ) || (pInstParams->MaxBlockSize > LVM_MANAGED_MAX_MAXBLOCKSIZE ) )
+        {
+            return (LVM_OUTOFRANGE);
+        }
+    }
+    else
+    {
+        if( (pInstParams->MaxBlockSize < LVM_MIN_MAXBLOCKSIZE ) || (pInstParams->MaxBlockSize > LVM_UNMANAGED_MAX_MAXBLOCKSIZE) )
+        {
+            return (LVM_OUTOFRANGE);
+        }
+    }
+
+    if((pInstParams->PSA_Included > LVM_PSA_ON) ||
+       (pInstParamsEx->PSA_Deferred > LVM_MODE_ON) ||
+       (pInstParamsEx->PSA_Decimation > LVM_MODE_ON) ||
+       (pInstParamsEx->PSA_FFTBands > LVPSA_FFT_NBANDSMAX))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    /*
+     * Module memory allocator
+     */
+    if ((pInstParamsEx->ModuleAllocator.pAlloc != LVM_NULL) &&
+        (pInstParamsEx->ModuleAllocator.pFree == LVM_NULL))
+    {
+        return (LVM_NULLADDRESS);
+    }
+
+    /*
+     * Initialise the AllocMem structures
+     */
     for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
     {
         InstAlloc_Init(&AllocMem[i],
@@ -596,8 +835,9 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
     /*
      * Set the instance handle
      */
-    *phInstance  = (LVM_Handle_t)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
-                                                     sizeof(LVM_Instance_t));
+    *phInstance  = (LVM_Handle_t)InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
+                                                            sizeof(LVM_Instance_t),
+                                                            LVM_MEMBER_ALIGN);
     pInstance =(LVM_Instance_t  *)*phInstance;
 
 
@@ -606,6 +846,7 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
      */
     pInstance->MemoryTable    = *pMemoryTable;
     pInstance->InstParams     = *pInstParams;
+    pInstance->InstParamsEx   = *pInstParamsEx;
 
 
     /*
@@ -660,6 +901,24 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
         pInstance->pBufferManagement->BufferState = LVM_FIRSTCALL;             /* Set the state ready for the first call */
     }
 
+#ifdef BUILD_FLOAT
+    /*
+     * Float block of the planar, PCM and accumulate process functions
+     */
+    pInstance->pBlockBuffer = LVM_NULL;
+    pInstance->pPcmOut      = LVM_NULL;
+    pInstance->pAccOut      = LVM_NULL;
+    pInstance->OutStored    = LVM_FALSE;
+    if ((pInstParamsEx->PlanarIO == LVM_MODE_ON) ||
+        (pInstParamsEx->PcmIO == LVM_MODE_ON) ||
+        (pInstParamsEx->OutputMode == LVM_OUTPUT_ACCUMULATE))
+    {
+        pInstance->pBlockBuffer = InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
+                                                       (LVM_UINT32)(LVM_MAX_CHANNELS * InternalBlockSize \
+                                                       * sizeof(LVM_FLOAT)));
+    }
+#endif
+
 
     /*
      * Set default parameters
@@ -698,6 +957,36 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
     pInstance->Params.TE_EffectLevel   = 0;
     pInstance->TE_Active               = LVM_FALSE;
 
+#ifdef BUILD_FLOAT
+    /*
+     * Filter merging, the equaliser bands and the treble boost
+     */
+    pInstance->pCascade = LVM_NULL;
+    if (pInstParamsEx->FilterMerge == LVM_MODE_ON)
+    {
+        LVM_Cascade_t   *pCascade;
+
+        pCascade = (LVM_Cascade_t *)InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                                               sizeof(LVM_Cascade_t),
+                                                               LVM_MEMBER_ALIGN);
+        pCascade->pCoefs = (LVM_FLOAT *)InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                                                   (LVM_UINT32)((pInstParams->EQNB_NumBands + 1) * \
+                                                                   5 * sizeof(LVM_FLOAT)),
+                                                                   LVM_MEMBER_ALIGN);
+        pCascade->pHistory = (LVM_FLOAT *)InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                                                     (LVM_UINT32)((pInstParams->EQNB_NumBands + 2) * \
+                                                                     2 * LVM_MAX_CHANNELS * sizeof(LVM_FLOAT)),
+                                                                     LVM_MEMBER_ALIGN);
+        pCascade->MaxSections  = (LVM_UINT16)(pInstParams->EQNB_NumBands + 1);
+        pCascade->NrSections   = 0;
+        pCascade->NrEQSections = 0;
+        pCascade->TE_Merged    = LVM_FALSE;
+        pCascade->NrChannels   = 2;
+        pCascade->Pending      = LVM_TRUE;
+        pInstance->pCascade    = pCascade;
+    }
+#endif
+
 
     /*
      * Set the volume control and initialise Current to Target
@@ -756,6 +1045,9 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
     LVC_Mixer_Init(&pInstance->VC_BalanceMix.MixerStream[1],LVM_MAXINT_16,LVM_MAXINT_16);
 #endif
     LVC_Mixer_VarSlope_SetTimeConstant(&pInstance->VC_BalanceMix.MixerStream[1],LVM_VC_MIXER_TIME,LVM_FS_8000,2);
+#ifdef SUPPORT_MC
+    LVC_MixSoft_1St_MC_float_SetChMap(pInstance->VC_BalanceChMap, 2, AUDIO_CHANNEL_OUT_STEREO);
+#endif
 
     /*
      * Set the default EQNB pre-gain and pointer to the band definitions
@@ -766,190 +1058,6 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
                                                    (pInstParams->EQNB_NumBands * sizeof(LVM_EQNB_BandDef_t)));
 
 
-    /*
-     * Initialise the Concert Sound module
-     */
-    {
-        LVCS_Handle_t           hCSInstance;                /* Instance handle */
-        LVCS_MemTab_t           CS_MemTab;                  /* Memory table */
-        LVCS_Capabilities_t     CS_Capabilities;            /* Initial capabilities */
-        LVCS_ReturnStatus_en    LVCS_Status;                /* Function call status */
-
-        /*
-         * Set default parameters
-         */
-        pInstance->Params.VirtualizerReverbLevel    = 100;
-        pInstance->Params.VirtualizerType           = LVM_CONCERTSOUND;
-        pInstance->Params.VirtualizerOperatingMode  = LVM_MODE_OFF;
-        pInstance->CS_Active                        = LVM_FALSE;
-
-        /*
-         * Set the initialisation capabilities
-         */
-        CS_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
-        CS_Capabilities.CallBack = pInstance->CallBack;
-        CS_Capabilities.pBundleInstance = (void*)pInstance;
-
-
-        /*
-         * Get the memory requirements and then set the address pointers, forcing alignment
-         */
-        LVCS_Status = LVCS_Memory(LVM_NULL,                /* Get the memory requirements */
-                                  &CS_MemTab,
-                                  &CS_Capabilities);
-        CS_MemTab.Region[LVCS_MEMREGION_PERSISTENT_SLOW_DATA].pBaseAddress = &pInstance->CS_Instance;
-        CS_MemTab.Region[LVCS_MEMREGION_PERSISTENT_FAST_DATA].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                                                                                                         CS_MemTab.Region[LVCS_MEMREGION_PERSISTENT_FAST_DATA].Size);
-        CS_MemTab.Region[LVCS_MEMREGION_PERSISTENT_FAST_COEF].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                                                                                                         CS_MemTab.Region[LVCS_MEMREGION_PERSISTENT_FAST_COEF].Size);
-        CS_MemTab.Region[LVCS_MEMREGION_TEMPORARY_FAST].pBaseAddress       = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
-                                                                                                         0);
-
-        /*
-         * Initialise the Concert Sound instance and save the instance handle
-         */
-        hCSInstance = LVM_NULL;                            /* Set to NULL to return handle */
-        LVCS_Status = LVCS_Init(&hCSInstance,              /* Initiailse */
-                                &CS_MemTab,
-                                &CS_Capabilities);
-        if (LVCS_Status != LVCS_SUCCESS) return((LVM_ReturnStatus_en)LVCS_Status);
-        pInstance->hCSInstance = hCSInstance;              /* Save the instance handle */
-
-    }
-
-    /*
-     * Initialise the Bass Enhancement module
-     */
-    {
-        LVDBE_Handle_t          hDBEInstance;               /* Instance handle */
-        LVDBE_MemTab_t          DBE_MemTab;                 /* Memory table */
-        LVDBE_Capabilities_t    DBE_Capabilities;           /* Initial capabilities */
-        LVDBE_ReturnStatus_en   LVDBE_Status;               /* Function call status */
-
-
-        /*
-         * Set the initialisation parameters
-         */
-        pInstance->Params.BE_OperatingMode = LVM_BE_OFF;
-        pInstance->Params.BE_CentreFreq    = LVM_BE_CENTRE_55Hz;
-        pInstance->Params.BE_EffectLevel   = 0;
-        pInstance->Params.BE_HPF           = LVM_BE_HPF_OFF;
-
-        pInstance->DBE_Active              = LVM_FALSE;
-
-
-
-        /*
-         * Set the initialisation capabilities
-         */
-#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
-        DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 |
-                                           LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 |
-                                           LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 |
-                                           LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 |
-                                           LVDBE_CAP_FS_48000 | LVDBE_CAP_FS_88200 |
-                                           LVDBE_CAP_FS_96000 | LVDBE_CAP_FS_176400 |
-                                           LVDBE_CAP_FS_192000;
-#else
-        DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 | LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 | LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 | LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 | LVDBE_CAP_FS_48000;
-#endif
-        DBE_Capabilities.CentreFrequency = LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_66Hz | LVDBE_CAP_CENTRE_78Hz | LVDBE_CAP_CENTRE_90Hz;
-        DBE_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
-
-
-        /*
-         * Get the memory requirements and then set the address pointers
-         */
-        LVDBE_Status = LVDBE_Memory(LVM_NULL,               /* Get the memory requirements */
-                                    &DBE_MemTab,
-                                    &DBE_Capabilities);
-        DBE_MemTab.Region[LVDBE_MEMREGION_INSTANCE].pBaseAddress        = &pInstance->DBE_Instance;
-        DBE_MemTab.Region[LVDBE_MEMREGION_PERSISTENT_DATA].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                                                                                                      DBE_MemTab.Region[LVDBE_MEMREGION_PERSISTENT_DATA].Size);
-        DBE_MemTab.Region[LVDBE_MEMREGION_PERSISTENT_COEF].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                                                                                                      DBE_MemTab.Region[LVDBE_MEMREGION_PERSISTENT_COEF].Size);
-        DBE_MemTab.Region[LVDBE_MEMREGION_SCRATCH].pBaseAddress         = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
-                                                                                                      0);
-
-
-        /*
-         * Initialise the Dynamic Bass Enhancement instance and save the instance handle
-         */
-        hDBEInstance = LVM_NULL;                            /* Set to NULL to return handle */
-        LVDBE_Status = LVDBE_Init(&hDBEInstance,            /* Initiailse */
-                                  &DBE_MemTab,
-                                  &DBE_Capabilities);
-        if (LVDBE_Status != LVDBE_SUCCESS) return((LVM_ReturnStatus_en)LVDBE_Status);
-        pInstance->hDBEInstance = hDBEInstance;             /* Save the instance handle */
-    }
-
-
-    /*
-     * Initialise the N-Band Equaliser module
-     */
-    {
-        LVEQNB_Handle_t          hEQNBInstance;             /* Instance handle */
-        LVEQNB_MemTab_t          EQNB_MemTab;               /* Memory table */
-        LVEQNB_Capabilities_t    EQNB_Capabilities;         /* Initial capabilities */
-        LVEQNB_ReturnStatus_en   LVEQNB_Status;             /* Function call status */
-
-
-        /*
-         * Set the initialisation parameters
-         */
-        pInstance->Params.EQNB_OperatingMode   = LVM_EQNB_OFF;
-        pInstance->Params.EQNB_NBands          = 0;
-        pInstance->Params.pEQNB_BandDefinition = LVM_NULL;
-        pInstance->EQNB_Active                 = LVM_FALSE;
-
-
-        /*
-         * Set the initialisation capabilities
-         */
-#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
-        EQNB_Capabilities.SampleRate      = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 |
-                                            LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 |
-                                            LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 |
-                                            LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 |
-                                            LVEQNB_CAP_FS_48000 | LVEQNB_CAP_FS_88200 |
-                                            LVEQNB_CAP_FS_96000 | LVEQNB_CAP_FS_176400 |
-                                            LVEQNB_CAP_FS_192000;
-#else
-        EQNB_Capabilities.SampleRate      = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 | LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 | LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 | LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 | LVEQNB_CAP_FS_48000;
-#endif
-        EQNB_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
-        EQNB_Capabilities.MaxBands        = pInstParams->EQNB_NumBands;
-        EQNB_Capabilities.SourceFormat    = LVEQNB_CAP_STEREO | LVEQNB_CAP_MONOINSTEREO;
-        EQNB_Capabilities.CallBack        = pInstance->CallBack;
-        EQNB_Capabilities.pBundleInstance  = (void*)pInstance;
-
-
-        /*
-         * Get the memory requirements and then set the address pointers, forcing alignment
-         */
-        LVEQNB_Status = LVEQNB_Memory(LVM_NULL,             /* Get the memory requirements */
-                                      &EQNB_MemTab,
-                                      &EQNB_Capabilities);
-        EQNB_MemTab.Region[LVEQNB_MEMREGION_INSTANCE].pBaseAddress        = &pInstance->EQNB_Instance;
-        EQNB_MemTab.Region[LVEQNB_MEMREGION_PERSISTENT_DATA].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                                                                                                        EQNB_MemTab.Region[LVEQNB_MEMREGION_PERSISTENT_DATA].Size);
-        EQNB_MemTab.Region[LVEQNB_MEMREGION_PERSISTENT_COEF].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                                                                                                        EQNB_MemTab.Region[LVEQNB_MEMREGION_PERSISTENT_COEF].Size);
-        EQNB_MemTab.Region[LVEQNB_MEMREGION_SCRATCH].pBaseAddress         = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
-                                                                                                        0);
-
-
-        /*
-         * Initialise the Dynamic Bass Enhancement instance and save the instance handle
-         */
-        hEQNBInstance = LVM_NULL;                           /* Set to NULL to return handle */
-        LVEQNB_Status = LVEQNB_Init(&hEQNBInstance,         /* Initiailse */
-                                    &EQNB_MemTab,
-                                    &EQNB_Capabilities);
-        if (LVEQNB_Status != LVEQNB_SUCCESS) return((LVM_ReturnStatus_en)LVEQNB_Status);
-        pInstance->hEQNBInstance = hEQNBInstance;           /* Save the instance handle */
-    }
-
     /*
      * Headroom management memory allocation
      */
@@ -975,52 +1083,116 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
 
 
     /*
-     * Initialise the PSA module
+     * Set the default module parameters
      */
+    pInstance->Params.VirtualizerReverbLevel    = 100;      /* Concert Sound */
+    pInstance->Params.VirtualizerType           = LVM_CONCERTSOUND;
+    pInstance->Params.VirtualizerOperatingMode  = LVM_MODE_OFF;
+    pInstance->hCSInstance                      = LVM_NULL;
+    pInstance->CS_Active                        = LVM_FALSE;
+
+    pInstance->Params.BE_OperatingMode          = LVM_BE_OFF; /* Bass Enhancement */
+    pInstance->Params.BE_CentreFreq             = LVM_BE_CENTRE_55Hz;
+    pInstance->Params.BE_EffectLevel            = 0;
+    pInstance->Params.BE_HPF                    = LVM_BE_HPF_OFF;
+    pInstance->hDBEInstance                     = LVM_NULL;
+    pInstance->DBE_Active                       = LVM_FALSE;
+
+    pInstance->Params.EQNB_OperatingMode        = LVM_EQNB_OFF; /* N-Band Equaliser */
+    pInstance->Params.EQNB_NBands               = 0;
+    pInstance->Params.pEQNB_BandDefinition      = LVM_NULL;
+    pInstance->hEQNBInstance                    = LVM_NULL;
+    pInstance->EQNB_Active                      = LVM_FALSE;
+    pInstance->pEQNB_CoefBlock                  = LVM_NULL;
+    pInstance->EQNB_CoefCopied                  = LVM_FALSE;
+    atomic_init(&pInstance->pEQNB_CoefCopy, LVM_NULL);
+
+    pInstance->Params.PSA_PeakDecayRate         = LVM_PSA_SPEED_MEDIUM; /* Spectrum Analyzer */
+    pInstance->Params.PSA_Enable                = LVM_PSA_OFF;
+    if (KeepAnalyser == LVM_FALSE)
     {
-        pLVPSA_Handle_t     hPSAInstance = LVM_NULL;   /* Instance handle */
-        LVPSA_MemTab_t      PSA_MemTab;
-        LVPSA_RETURN        PSA_Status;                 /* Function call status */
-        LVPSA_FilterParam_t FiltersParams[9];
-
-        if(pInstParams->PSA_Included==LVM_PSA_ON)
-        {
-            pInstance->PSA_InitParams.SpectralDataBufferDuration   = (LVM_UINT16) 500;
-            pInstance->PSA_InitParams.MaxInputBlockSize            = (LVM_UINT16) 2048;
-            pInstance->PSA_InitParams.nBands                       = (LVM_UINT16) 9;
-            pInstance->PSA_InitParams.pFiltersParams               = &FiltersParams[0];
-            for(i = 0; i < pInstance->PSA_InitParams.nBands; i++)
-            {
-                FiltersParams[i].CenterFrequency    = (LVM_UINT16) 1000;
-                FiltersParams[i].QFactor            = (LVM_UINT16) 100;
-                FiltersParams[i].PostGain           = (LVM_INT16)  0;
-            }
+        pInstance->hPSAInstance                 = LVM_NULL;
+    }
 
-            /*Get the memory requirements and then set the address pointers*/
-            PSA_Status = LVPSA_Memory (hPSAInstance,
-                                          &PSA_MemTab,
-                                          &pInstance->PSA_InitParams);
+    /*
+     * Denormal protection
+     */
+    pInstance->DenormalStats.ProcessCalls       = 0;
+    pInstance->DenormalStats.DenormalCalls      = 0;
+    pInstance->DenormalStats.DenormalSamples    = 0;
+    pInstance->DenormalPhase                    = 0;
+#ifdef BUILD_FLOAT
+    pInstance->PcmStats.ProcessCalls            = 0;
+    pInstance->PcmStats.SaturatedCalls          = 0;
+    pInstance->PcmStats.SaturatedSamples        = 0;
+#endif
 
-            if (PSA_Status != LVPSA_OK)
-            {
-                return((LVM_ReturnStatus_en) LVM_ALGORITHMPSA);
-            }
+    /*
+     * Silence detection
+     */
+    pInstance->SilenceIdle                      = LVM_FALSE;
 
-            /* Slow Data */
-            PSA_MemTab.Region[LVM_PERSISTENT_SLOW_DATA].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_SLOW_DATA],
-                PSA_MemTab.Region[LVM_PERSISTENT_SLOW_DATA].Size);
 
+    /*
+     * Set the module memory and initialise the modules. The modules all share the
+     * scratch memory after the bundle scratch, the Spectrum Analyzer scratch follows
+     * its input buffer or is persistent when the analysis is deferred. Modules allocated
+     * on demand only get their scratch memory here, see LVM_ModuleAlloc.
+     */
+    if (KeepAnalyser == LVM_FALSE)
+    {
+        pInstance->pPSARing = LVM_NULL;
+#ifdef BUILD_FLOAT
+        pInstance->pPSASnapshot = LVM_NULL;
+#endif
+    }
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
+    {
+        LVM_MemTab_t    *pModuleTable = &pInstance->ModuleMemoryTable[Module];
 
-            /* Fast Data */
-            PSA_MemTab.Region[LVM_PERSISTENT_FAST_DATA].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
-                PSA_MemTab.Region[LVM_PERSISTENT_FAST_DATA].Size);
+        atomic_init(&pInstance->ModuleState[Module],
+                    (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL) ? LVM_MODULE_READY : LVM_MODULE_UNALLOCATED);
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstParams->PSA_Included != LVM_PSA_ON))
+        {
+            for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+            {
+                pModuleTable->Region[i].Size         = 0;
+                pModuleTable->Region[i].pBaseAddress = LVM_NULL;
+            }
+            continue;
+        }
 
+        /*
+         * Get the memory requirements and then set the address pointers
+         */
+        Status = LVM_ModuleInit(LVM_NULL,
+                                pInstParams,
+                                pInstParamsEx,
+                                Module,
+                                pModuleTable);
+        if (Status != LVM_SUCCESS)
+        {
+            return(Status);
+        }
 
-            /* Fast Coef */
-            PSA_MemTab.Region[LVM_PERSISTENT_FAST_COEF].pBaseAddress = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_COEF],
-                PSA_MemTab.Region[LVM_PERSISTENT_FAST_COEF].Size);
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstParamsEx->PSA_Deferred == LVM_MODE_ON))
+        {
+            LVM_PSA_Ring_t  *pRing;
 
-            /* Fast Temporary */
+            pRing = InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                               sizeof(LVM_PSA_Ring_t),
+                                               LVM_MEMBER_ALIGN);
+            if (KeepAnalyser == LVM_FALSE)
+            {
+                LVM_PSARingInit(pRing);
+                pInstance->pPSARing = pRing;
+            }
+            pInstance->pPSAInput = LVM_NULL;
+        }
+        else if (Module == LVM_MODULE_PSA)
+        {
 #ifdef BUILD_FLOAT
             pInstance->pPSAInput = InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
                                                        (LVM_UINT32) MAX_INTERNAL_BLOCKSIZE * \
@@ -1029,35 +1201,80 @@ LVM_ReturnStatus_en LVM_GetInstanceHandle(LVM_Handle_t           *phInstance,
             pInstance->pPSAInput = InstAlloc_AddMember(&AllocMem[LVM_TEMPORARY_FAST],
                                                        (LVM_UINT32) MAX_INTERNAL_BLOCKSIZE * sizeof(LVM_INT16));
 #endif
-            PSA_MemTab.Region[LVM_TEMPORARY_FAST].pBaseAddress       = (void *)InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],0);
-
-
-            /*Initialise PSA instance and save the instance handle*/
-            pInstance->PSA_ControlParams.Fs = LVM_FS_48000;
-            pInstance->PSA_ControlParams.LevelDetectionSpeed  = LVPSA_SPEED_MEDIUM;
-            PSA_Status = LVPSA_Init (&hPSAInstance,
-                                    &pInstance->PSA_InitParams,
-                                    &pInstance->PSA_ControlParams,
-                                    &PSA_MemTab);
-
-            if (PSA_Status != LVPSA_OK)
+        }
+#ifdef BUILD_FLOAT
+        if (Module == LVM_MODULE_PSA)
+        {
+            LVM_PSA_Snapshot_t  *pSnapshot;
+            LVM_UINT8           *pPeaks;
+            _Atomic LVM_FLOAT   *pLevels;
+            LVM_UINT16          NrBands = LVM_PSA_SNAPSHOT_NBANDS(pInstParamsEx);
+
+            pSnapshot = InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                                   sizeof(LVM_PSA_Snapshot_t),
+                                                   LVM_MEMBER_ALIGN);
+            pPeaks    = InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                            NrBands * sizeof(LVM_UINT8));
+            pLevels   = InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                                   LVM_PSA_SNAPSHOT_SLOTS * 2 * NrBands *
+                                                   sizeof(_Atomic LVM_FLOAT),
+                                                   LVM_MEMBER_ALIGN);
+            if (KeepAnalyser == LVM_FALSE)
             {
-                return((LVM_ReturnStatus_en) LVM_ALGORITHMPSA);
+                pSnapshot->pPeaks = pPeaks;
+                for (i = 0; i < LVM_PSA_SNAPSHOT_SLOTS; i++)
+                {
+                    pSnapshot->Slots[i].pCurrentLevels = pLevels + 2 * i * NrBands;
+                    pSnapshot->Slots[i].pPeakLevels    = pLevels + (2 * i + 1) * NrBands;
+                }
+                LVM_PSASnapshotInit(pSnapshot, NrBands);
+                pInstance->pPSASnapshot = pSnapshot;
             }
+        }
+#endif
 
-            pInstance->hPSAInstance = hPSAInstance;       /* Save the instance handle */
-            pInstance->PSA_GainOffset = 0;
+        for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+        {
+            if (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL)
+            {
+                pModuleTable->Region[i].pBaseAddress = InstAlloc_AddMemberAligned(&AllocMem[i],
+                                                                                  pModuleTable->Region[i].Size,
+                                                                                  LVM_MEMBER_ALIGN);
+            }
         }
-        else
+        pModuleTable->Region[LVM_MEMREGION_TEMPORARY_FAST].pBaseAddress = InstAlloc_AddMember(&AllocMem[LVM_MEMREGION_TEMPORARY_FAST],
+                                                                                              0);
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstParamsEx->PSA_Deferred == LVM_MODE_ON))
         {
-            pInstance->hPSAInstance = LVM_NULL;
+            pModuleTable->Region[LVM_MEMREGION_TEMPORARY_FAST].pBaseAddress =
+                InstAlloc_AddMemberAligned(&AllocMem[LVM_MEMREGION_PERSISTENT_FAST_DATA],
+                                           pModuleTable->Region[LVM_MEMREGION_TEMPORARY_FAST].Size,
+                                           LVM_MEMBER_ALIGN);
         }
 
         /*
-         * Set the initialisation parameters.
+         * Initialise the module and save the instance handle, a kept analyser may be
+         * running on the analysis thread
          */
-        pInstance->Params.PSA_PeakDecayRate   = LVM_PSA_SPEED_MEDIUM;
-        pInstance->Params.PSA_Enable          = LVM_PSA_OFF;
+        if ((Module == LVM_MODULE_PSA) &&
+            (pInstance->pPSARing != LVM_NULL) &&
+            (KeepAnalyser == LVM_TRUE))
+        {
+            continue;
+        }
+        if (pInstParamsEx->ModuleAllocator.pAlloc == LVM_NULL)
+        {
+            Status = LVM_ModuleInit(pInstance,
+                                    pInstParams,
+                                    pInstParamsEx,
+                                    Module,
+                                    pModuleTable);
+            if (Status != LVM_SUCCESS)
+            {
+                return(Status);
+            }
+        }
     }
 
     /*
@@ -1117,15 +1334,28 @@ LVM_ReturnStatus_en LVM_ClearAudioBuffers(LVM_Handle_t  hInstance)
 {
     LVM_MemTab_t            MemTab;                                     /* Memory table */
     LVM_InstParams_t        InstParams;                                 /* Instance parameters */
+    LVM_InstParamsEx_t      InstParamsEx;                               /* Extended instance parameters */
     LVM_ControlParams_t     Params;                                     /* Control Parameters */
     LVM_Instance_t          *pInstance  = (LVM_Instance_t  *)hInstance; /* Pointer to Instance */
     LVM_HeadroomParams_t    HeadroomParams;
+    LVM_MemTab_t            ModuleMemTab[LVM_NR_MODULES];              /* Module memory tables */
+    LVM_INT32               ModuleState[LVM_NR_MODULES];               /* Module memory states */
+    LVM_CoefBlock_t         *pCoefBlock;                                /* Shared equaliser coefficients */
+    LVM_INT16               CoefCopied;
+    LVM_INT16               Module;
 
 
     if(hInstance == LVM_NULL){
         return LVM_NULLADDRESS;
     }
 
+    /* The equaliser is initialised again, in coefficients of its own */
+    if (LVM_CoefCopy(pInstance, LVM_NULL) != LVM_SUCCESS)
+    {
+        return LVM_NULLADDRESS;
+    }
+    LVM_CoefAttach(pInstance);
+
     /* Save the control parameters */ /* coverity[unchecked_value] */ /* Do not check return value internal function calls */
     LVM_GetControlParameters(hInstance, &Params);
 
@@ -1135,13 +1365,50 @@ LVM_ReturnStatus_en LVM_ClearAudioBuffers(LVM_Handle_t  hInstance)
     /*  Retrieve allocated buffers in memtab */
     LVM_GetMemoryTable(hInstance, &MemTab,  LVM_NULL);
 
-    /*  Save the instance parameters */
-    InstParams = pInstance->InstParams;
-
-    /*  Call  LVM_GetInstanceHandle to re-initialise the bundle */
-    LVM_GetInstanceHandle( &hInstance,
-                           &MemTab,
-                           &InstParams);
+    /*  Save the instance parameters and the module memory */
+    InstParams   = pInstance->InstParams;
+    InstParamsEx = pInstance->InstParamsEx;
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
+    {
+        ModuleMemTab[Module] = pInstance->ModuleMemoryTable[Module];
+        ModuleState[Module]  = atomic_load_explicit(&pInstance->ModuleState[Module], memory_order_acquire);
+    }
+    pCoefBlock = pInstance->pEQNB_CoefBlock;
+    CoefCopied = pInstance->EQNB_CoefCopied;
+
+    /*  Re-initialise the bundle, a deferred Spectrum Analyzer belongs to the analysis thread */
+    LVM_InitInstance(&hInstance,
+                     &MemTab,
+                     &InstParams,
+                     &InstParamsEx,
+                     (LVM_INT16)(pInstance->pPSARing != LVM_NULL));
+    pInstance->pEQNB_CoefBlock = pCoefBlock;
+    pInstance->EQNB_CoefCopied = CoefCopied;
+
+    /*  Re-initialise the modules allocated on demand in their own memory, a pending module
+        is initialised by the next LVM_Process call */
+    if (InstParamsEx.ModuleAllocator.pAlloc != LVM_NULL)
+    {
+        for (Module = 0; Module < LVM_NR_MODULES; Module++)
+        {
+            if (ModuleState[Module] != LVM_MODULE_UNALLOCATED)
+            {
+                pInstance->ModuleMemoryTable[Module] = ModuleMemTab[Module];
+                atomic_store_explicit(&pInstance->ModuleState[Module], ModuleState[Module], memory_order_relaxed);
+                if ((ModuleState[Module] != LVM_MODULE_READY) ||
+                    ((Module == LVM_MODULE_PSA) &&
+                     (pInstance->pPSARing != LVM_NULL)))
+                {
+                    continue;
+                }
+                LVM_ModuleInit(pInstance,
+                               &InstParams,
+                               &InstParamsEx,
+                               Module,
+                               &pInstance->ModuleMemoryTable[Module]);
+            }
+        }
+    }
 
     /* Restore control parameters */ /* coverity[unchecked_value] */ /* Do not check return value internal function calls */
     LVM_SetControlParameters(hInstance, &Params);
@@ -1161,3 +1428,1317 @@ LVM_ReturnStatus_en LVM_ClearAudioBuffers(LVM_Handle_t  hInstance)
 
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ModuleInit                                              */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is used for the memory allocation and initialisation of the Concert   */
+/*  Sound, Bass Enhancement, N-Band Equaliser and Spectrum Analyzer modules. It can be  */
+/*  called in two ways:                                                                 */
+/*                                                                                      */
+/*      pInstance = NULL                Returns the memory requirements of the module   */
+/*      pInstance = Instance pointer    Initialises the module in the memory given by   */
+/*                                      the module table and saves its instance handle  */
+/*                                                                                      */
+/*  The regions of the module table are in the order of the bundle memory table.        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*  pInstParams             Pointer to the instance parameters                          */
+/*  pInstParamsEx           Pointer to the extended instance parameters                 */
+/*  Module                  Module index, one of the LVM_MODULE_ defines                */
+/*  pModuleTable            Pointer to the module memory table                          */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_ALGORITHMPSA        When the Spectrum Analyzer memory or initialisation failed  */
+/*  Otherwise the status of the module initialisation                                   */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_ModuleInit(LVM_Instance_t      *pInstance,
+                                   LVM_InstParams_t    *pInstParams,
+                                   LVM_InstParamsEx_t  *pInstParamsEx,
+                                   LVM_INT16           Module,
+                                   LVM_MemTab_t        *pModuleTable)
+{
+    LVM_UINT16              InternalBlockSize;
+    LVM_INT16               i;
+
+
+    InternalBlockSize = (LVM_UINT16)((pInstParams->MaxBlockSize) & MIN_INTERNAL_BLOCKMASK); /* Force to a multiple of MIN_INTERNAL_BLOCKSIZE */
+    if (InternalBlockSize < MIN_INTERNAL_BLOCKSIZE)
+    {
+        InternalBlockSize = MIN_INTERNAL_BLOCKSIZE;
+    }
+
+    /* Maximum Internal Black Size should not be more than MAX_INTERNAL_BLOCKSIZE*/
+    if(InternalBlockSize > MAX_INTERNAL_BLOCKSIZE)
+    {
+        InternalBlockSize = MAX_INTERNAL_BLOCKSIZE;
+    }
+
+    switch (Module)
+    {
+        /*
+         * Concert Sound
+         */
+        case LVM_MODULE_CS:
+        {
+            LVCS_Handle_t           hCSInstance = LVM_NULL;     /* Instance handle */
+            LVCS_MemTab_t           CS_MemTab;                  /* Memory table */
+            LVCS_Capabilities_t     CS_Capabilities;            /* Initial capabilities */
+            LVCS_ReturnStatus_en    LVCS_Status;                /* Function call status */
+
+            /*
+             * Set the initialisation capabilities
+             */
+            CS_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
+            CS_Capabilities.CoefBankRates   = pInstParamsEx->CoefBankRates;
+            CS_Capabilities.CallBack        = LVM_AlgoCallBack;
+            CS_Capabilities.pBundleInstance = (void*)pInstance;
+
+            /*
+             * Get the memory requirements
+             */
+            LVCS_Memory(LVM_NULL,
+                        &CS_MemTab,
+                        &CS_Capabilities);
+            if (pInstance == LVM_NULL)
+            {
+                for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+                {
+                    pModuleTable->Region[i].Size = CS_MemTab.Region[i].Size;
+                }
+                break;
+            }
+
+            /*
+             * Initialise the Concert Sound instance and save the instance handle
+             */
+            for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+            {
+                CS_MemTab.Region[i].pBaseAddress = pModuleTable->Region[i].pBaseAddress;
+            }
+            LVCS_Status = LVCS_Init(&hCSInstance,
+                                    &CS_MemTab,
+                                    &CS_Capabilities);
+            if (LVCS_Status != LVCS_SUCCESS) return((LVM_ReturnStatus_en)LVCS_Status);
+            pInstance->hCSInstance = hCSInstance;
+            break;
+        }
+
+        /*
+         * Dynamic Bass Enhancement
+         */
+        case LVM_MODULE_DBE:
+        {
+            LVDBE_Handle_t          hDBEInstance = LVM_NULL;    /* Instance handle */
+            LVDBE_MemTab_t          DBE_MemTab;                 /* Memory table */
+            LVDBE_Capabilities_t    DBE_Capabilities;           /* Initial capabilities */
+            LVDBE_ReturnStatus_en   LVDBE_Status;               /* Function call status */
+
+            /*
+             * Set the initialisation capabilities
+             */
+#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
+            DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 |
+                                               LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 |
+                                               LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 |
+                                               LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 |
+                                               LVDBE_CAP_FS_48000 | LVDBE_CAP_FS_88200 |
+                                               LVDBE_CAP_FS_96000 | LVDBE_CAP_FS_176400 |
+                                               LVDBE_CAP_FS_192000;
+#else
+            DBE_Capabilities.SampleRate      = LVDBE_CAP_FS_8000 | LVDBE_CAP_FS_11025 | LVDBE_CAP_FS_12000 | LVDBE_CAP_FS_16000 | LVDBE_CAP_FS_22050 | LVDBE_CAP_FS_24000 | LVDBE_CAP_FS_32000 | LVDBE_CAP_FS_44100 | LVDBE_CAP_FS_48000;
+#endif
+            DBE_Capabilities.CentreFrequency = LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_55Hz | LVDBE_CAP_CENTRE_66Hz | LVDBE_CAP_CENTRE_78Hz | LVDBE_CAP_CENTRE_90Hz;
+            DBE_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
+            DBE_Capabilities.CoefBankRates   = pInstParamsEx->CoefBankRates;
+
+            /*
+             * Get the memory requirements
+             */
+            LVDBE_Memory(LVM_NULL,
+                         &DBE_MemTab,
+                         &DBE_Capabilities);
+            if (pInstance == LVM_NULL)
+            {
+                for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+                {
+                    pModuleTable->Region[i].Size = DBE_MemTab.Region[i].Size;
+                }
+                break;
+            }
+
+            /*
+             * Initialise the Dynamic Bass Enhancement instance and save the instance handle
+             */
+            for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+            {
+                DBE_MemTab.Region[i].pBaseAddress = pModuleTable->Region[i].pBaseAddress;
+            }
+            LVDBE_Status = LVDBE_Init(&hDBEInstance,
+                                      &DBE_MemTab,
+                                      &DBE_Capabilities);
+            if (LVDBE_Status != LVDBE_SUCCESS) return((LVM_ReturnStatus_en)LVDBE_Status);
+            pInstance->hDBEInstance = hDBEInstance;
+            break;
+        }
+
+        /*
+         * N-Band Equaliser
+         */
+        case LVM_MODULE_EQNB:
+        {
+            LVEQNB_Handle_t          hEQNBInstance = LVM_NULL;  /* Instance handle */
+            LVEQNB_MemTab_t          EQNB_MemTab;               /* Memory table */
+            LVEQNB_Capabilities_t    EQNB_Capabilities;         /* Initial capabilities */
+            LVEQNB_ReturnStatus_en   LVEQNB_Status;             /* Function call status */
+
+            /*
+             * Set the initialisation capabilities
+             */
+#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
+            EQNB_Capabilities.SampleRate      = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 |
+                                                LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 |
+                                                LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 |
+                                                LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 |
+                                                LVEQNB_CAP_FS_48000 | LVEQNB_CAP_FS_88200 |
+                                                LVEQNB_CAP_FS_96000 | LVEQNB_CAP_FS_176400 |
+                                                LVEQNB_CAP_FS_192000;
+#else
+            EQNB_Capabilities.SampleRate      = LVEQNB_CAP_FS_8000 | LVEQNB_CAP_FS_11025 | LVEQNB_CAP_FS_12000 | LVEQNB_CAP_FS_16000 | LVEQNB_CAP_FS_22050 | LVEQNB_CAP_FS_24000 | LVEQNB_CAP_FS_32000 | LVEQNB_CAP_FS_44100 | LVEQNB_CAP_FS_48000;
+#endif
+            EQNB_Capabilities.MaxBlockSize    = (LVM_UINT16)InternalBlockSize;
+            EQNB_Capabilities.MaxBands        = pInstParams->EQNB_NumBands;
+            EQNB_Capabilities.CoefBankRates   = pInstParamsEx->CoefBankRates;
+            EQNB_Capabilities.Engine          = (pInstParamsEx->EQNB_Parallel == LVM_MODE_ON) ?
+                                                LVEQNB_ENGINE_PARALLEL : LVEQNB_ENGINE_CASCADE;
+            EQNB_Capabilities.SourceFormat    = LVEQNB_CAP_STEREO | LVEQNB_CAP_MONOINSTEREO;
+            EQNB_Capabilities.CallBack        = LVM_AlgoCallBack;
+            EQNB_Capabilities.pBundleInstance = (void*)pInstance;
+
+            /*
+             * Get the memory requirements
+             */
+            LVEQNB_Memory(LVM_NULL,
+                          &EQNB_MemTab,
+                          &EQNB_Capabilities);
+            if (pInstance == LVM_NULL)
+            {
+                for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+                {
+                    pModuleTable->Region[i].Size = EQNB_MemTab.Region[i].Size;
+                }
+                break;
+            }
+
+            /*
+             * Initialise the N-Band Equaliser instance and save the instance handle
+             */
+            for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+            {
+                EQNB_MemTab.Region[i].pBaseAddress = pModuleTable->Region[i].pBaseAddress;
+            }
+            LVEQNB_Status = LVEQNB_Init(&hEQNBInstance,
+                                        &EQNB_MemTab,
+                                        &EQNB_Capabilities);
+            if (LVEQNB_Status != LVEQNB_SUCCESS) return((LVM_ReturnStatus_en)LVEQNB_Status);
+            pInstance->hEQNBInstance = hEQNBInstance;
+            break;
+        }
+
+        /*
+         * Spectrum Analyzer, the memory is queried with the initialisation parameters
+         */
+        case LVM_MODULE_PSA:
+        {
+            pLVPSA_Handle_t         hPSAInstance = LVM_NULL;    /* Instance handle */
+            LVPSA_MemTab_t          PSA_MemTab;                 /* Memory table */
+            LVPSA_InitParams_t      PSA_InitParams;             /* Initialisation parameters */
+            LVPSA_FilterParam_t     FiltersParams[LVM_PSA_NBANDS];
+            LVPSA_RETURN            PSA_Status;                 /* Function call status */
+
+            PSA_InitParams.SpectralDataBufferDuration   = (LVM_UINT16) 500;
+            PSA_InitParams.MaxInputBlockSize            = (LVM_UINT16) 2048;
+            PSA_InitParams.nBands                       = (LVM_UINT16) LVM_PSA_NBANDS;
+            PSA_InitParams.pFiltersParams               = &FiltersParams[0];
+            PSA_InitParams.CoefBankRates                = pInstParamsEx->CoefBankRates;
+            PSA_InitParams.Decimation                   = pInstParamsEx->PSA_Decimation;
+            PSA_InitParams.Engine                       = LVPSA_ENGINE_FILTERBANK;
+            PSA_InitParams.FFTSize                      = 0;
+            PSA_InitParams.HopSize                      = 0;
+            if (pInstParamsEx->PSA_FFTBands != 0)
+            {
+                /* The bands of the FFT engine are spread with the sampling rate */
+                PSA_InitParams.Engine                   = LVPSA_ENGINE_FFT;
+                PSA_InitParams.nBands                   = pInstParamsEx->PSA_FFTBands;
+                PSA_InitParams.pFiltersParams           = LVM_NULL;
+                PSA_InitParams.FFTSize                  = LVM_PSA_FFT_SIZE;
+                PSA_InitParams.HopSize                  = LVM_PSA_FFT_HOP;
+            }
+            for(i = 0; i < 9; i++)
+            {
+                FiltersParams[i].CenterFrequency    = (LVM_UINT16) 1000;
+                FiltersParams[i].QFactor            = (LVM_UINT16) 100;
+                FiltersParams[i].PostGain           = (LVM_INT16)  0;
+            }
+
+            /*
+             * Get the memory requirements
+             */
+            PSA_Status = LVPSA_Memory(hPSAInstance,
+                                      &PSA_MemTab,
+                                      &PSA_InitParams);
+            if (PSA_Status != LVPSA_OK)
+            {
+                return((LVM_ReturnStatus_en) LVM_ALGORITHMPSA);
+            }
+            if (pInstance == LVM_NULL)
+            {
+                for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+                {
+                    pModuleTable->Region[i].Size = PSA_MemTab.Region[i].Size;
+                }
+                break;
+            }
+
+            /*
+             * Initialise the PSA instance and save the instance handle
+             */
+            for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+            {
+                PSA_MemTab.Region[i].pBaseAddress = pModuleTable->Region[i].pBaseAddress;
+            }
+            pInstance->PSA_InitParams = PSA_InitParams;
+            pInstance->PSA_ControlParams.Fs = LVM_FS_48000;
+            pInstance->PSA_ControlParams.LevelDetectionSpeed  = LVPSA_SPEED_MEDIUM;
+            PSA_Status = LVPSA_Init(&hPSAInstance,
+                                    &pInstance->PSA_InitParams,
+                                    &pInstance->PSA_ControlParams,
+                                    &PSA_MemTab);
+            if (PSA_Status != LVPSA_OK)
+            {
+                return((LVM_ReturnStatus_en) LVM_ALGORITHMPSA);
+            }
+            pInstance->hPSAInstance = hPSAInstance;
+            pInstance->PSA_GainOffset = 0;
+            break;
+        }
+
+        default:
+            return (LVM_OUTOFRANGE);
+    }
+
+    /*
+     * Set the region types and clear the addresses when returning the requirements
+     */
+    if (pInstance == LVM_NULL)
+    {
+        pModuleTable->Region[LVM_MEMREGION_PERSISTENT_SLOW_DATA].Type = LVM_PERSISTENT_SLOW_DATA;
+        pModuleTable->Region[LVM_MEMREGION_PERSISTENT_FAST_DATA].Type = LVM_PERSISTENT_FAST_DATA;
+        pModuleTable->Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].Type = LVM_PERSISTENT_FAST_COEF;
+        pModuleTable->Region[LVM_MEMREGION_TEMPORARY_FAST].Type       = LVM_TEMPORARY_FAST;
+        for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+        {
+            pModuleTable->Region[i].pBaseAddress = LVM_NULL;
+        }
+    }
+
+    return(LVM_SUCCESS);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ModuleAlloc                                             */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Allocates the persistent memory of a module with the module allocator of the        */
+/*  instance and hands it to the audio thread, LVM_ModuleAttach initialises the module  */
+/*  in it. Nothing is done when no allocator is set or the module already has its       */
+/*  memory.                                                                             */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*  Module                  Module index, one of the LVM_MODULE_ defines                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When the allocator returned NULL                            */
+/*  LVM_ALIGNMENTERROR      When the allocator returned memory that is not 64-bit       */
+/*                          aligned                                                     */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The function can be interrupted by the LVM_Process function, the memory table   */
+/*     of the module is complete before its state is published with release order       */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_ModuleAlloc(LVM_Instance_t      *pInstance,
+                                    LVM_INT16           Module)
+{
+    LVM_ModuleAllocator_t   *pAllocator  = &pInstance->InstParamsEx.ModuleAllocator;
+    LVM_MemTab_t            ModuleTable;
+    LVM_ReturnStatus_en     Status;
+    LVM_INT16               i;
+
+
+    if ((pAllocator->pAlloc == LVM_NULL) ||
+        (atomic_load_explicit(&pInstance->ModuleState[Module], memory_order_relaxed) != LVM_MODULE_UNALLOCATED))
+    {
+        return(LVM_SUCCESS);
+    }
+    ModuleTable = pInstance->ModuleMemoryTable[Module];    /* LVM_CoefAttach moves a module in use */
+
+    /*
+     * Allocate the persistent regions, the scratch memory was set by LVM_GetInstanceHandle
+     */
+    for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+    {
+        if (ModuleTable.Region[i].Size != 0)
+        {
+            ModuleTable.Region[i].pBaseAddress = pAllocator->pAlloc(pAllocator->pAllocHandle,
+                                                                    ModuleTable.Region[i].Size);
+            if ((ModuleTable.Region[i].pBaseAddress == LVM_NULL) ||
+                (((uintptr_t)ModuleTable.Region[i].pBaseAddress & (LVM_MEMBER_ALIGN - 1)) != 0))
+            {
+                Status = (ModuleTable.Region[i].pBaseAddress == LVM_NULL) ? LVM_NULLADDRESS : LVM_ALIGNMENTERROR;
+                for (; i>=0; i--)
+                {
+                    if (ModuleTable.Region[i].pBaseAddress != LVM_NULL)
+                    {
+                        pAllocator->pFree(pAllocator->pAllocHandle,
+                                          ModuleTable.Region[i].pBaseAddress);
+                    }
+                }
+                return(Status);
+            }
+        }
+    }
+
+    /*
+     * Publish the memory, the module is initialised by the audio thread
+     */
+    pInstance->ModuleMemoryTable[Module] = ModuleTable;
+    atomic_store_explicit(&pInstance->ModuleState[Module], LVM_MODULE_PENDING, memory_order_release);
+
+    return(LVM_SUCCESS);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ModuleAttach                                            */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Initialises the modules whose memory was allocated by LVM_ModuleAlloc since the     */
+/*  last call. The module instance handles are only written here, on the audio thread.  */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Called by LVM_ApplyNewSettings before the module parameters are applied, a      */
+/*     module that fails to initialise keeps a NULL handle and stays disabled           */
+/*                                                                                      */
+/****************************************************************************************/
+
+void LVM_ModuleAttach(LVM_Instance_t      *pInstance)
+{
+    LVM_INT16               Module;
+
+
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
+    {
+        if (atomic_load_explicit(&pInstance->ModuleState[Module], memory_order_acquire) == LVM_MODULE_PENDING)
+        {
+            (void)LVM_ModuleInit(pInstance,
+                                 &pInstance->InstParams,
+                                 &pInstance->InstParamsEx,
+                                 Module,
+                                 &pInstance->ModuleMemoryTable[Module]);
+            atomic_store_explicit(&pInstance->ModuleState[Module], LVM_MODULE_READY, memory_order_relaxed);
+        }
+    }
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CoefRelease                                             */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Drops the reference of an instance to its shared equaliser coefficients, the last   */
+/*  instance holding the block frees it.                                                */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*                                                                                      */
+/****************************************************************************************/
+
+static void LVM_CoefRelease(LVM_Instance_t      *pInstance)
+{
+    LVM_ModuleAllocator_t   *pAllocator = &pInstance->InstParamsEx.ModuleAllocator;
+    LVM_CoefBlock_t         *pBlock     = pInstance->pEQNB_CoefBlock;
+
+
+    if ((pBlock != LVM_NULL) &&
+        (atomic_fetch_sub_explicit(&pBlock->RefCount, 1, memory_order_acq_rel) == 1))
+    {
+        pAllocator->pFree(pAllocator->pAllocHandle, pBlock);
+    }
+    pInstance->pEQNB_CoefBlock = LVM_NULL;
+    pInstance->EQNB_CoefCopied = LVM_FALSE;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CoefMatch                                               */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Checks whether control parameters leave the shared equaliser coefficients as they   */
+/*  are.                                                                                */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pBlock                  Pointer to the shared coefficients                          */
+/*  pParams                 Pointer to the control parameters                           */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_TRUE                When the equaliser settings are those of the block          */
+/*  LVM_FALSE               Otherwise                                                   */
+/*                                                                                      */
+/****************************************************************************************/
+
+static LVM_INT16 LVM_CoefMatch(const LVM_CoefBlock_t        *pBlock,
+                               const LVM_ControlParams_t    *pParams)
+{
+    LVM_UINT16              i;
+
+
+    if ((pParams->SampleRate != pBlock->SampleRate) ||
+        (pParams->SourceFormat != pBlock->SourceFormat) ||
+        (pParams->EQNB_NBands != pBlock->NBands))
+    {
+        return LVM_FALSE;
+    }
+    if ((pBlock->NBands != 0) && (pParams->pEQNB_BandDefinition == LVM_NULL))
+    {
+        return LVM_FALSE;
+    }
+    for (i = 0; i < pBlock->NBands; i++)
+    {
+        if ((pParams->pEQNB_BandDefinition[i].Frequency != pBlock->pBandDefs[i].Frequency) ||
+            (pParams->pEQNB_BandDefinition[i].Gain      != pBlock->pBandDefs[i].Gain)      ||
+            (pParams->pEQNB_BandDefinition[i].QFactor   != pBlock->pBandDefs[i].QFactor))
+        {
+            return LVM_FALSE;
+        }
+    }
+
+    return LVM_TRUE;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CoefShare                                               */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Returns the equaliser coefficients of a template for its clones to share. The first */
+/*  time the coefficient region of the template is moved into a shared block.           */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pTemplate               Pointer to the template instance                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  The shared block, LVM_NULL when the clone needs a copy of its own                   */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The coefficients are shared with CoefSharing on while the equaliser of the       */
+/*     template is processing and no parameters are pending                             */
+/*  2. The block is read only. LVM_SetControlParameters copies it for an instance       */
+/*     whose equaliser settings change, the instance drops it with its module memory    */
+/*     or the next time it is cloned                                                    */
+/*  3. This function must not be interrupted by the LVM_Process function of the         */
+/*     template                                                                         */
+/*                                                                                      */
+/****************************************************************************************/
+
+static LVM_CoefBlock_t *LVM_CoefShare(LVM_Instance_t      *pTemplate)
+{
+    LVM_ModuleAllocator_t   *pAllocator = &pTemplate->InstParamsEx.ModuleAllocator;
+    LVM_MemoryRegion_st     *pRegion;
+    LVM_CoefBlock_t         *pBlock;
+    LVM_UINT32              Offset;
+    LVM_UINT16              i;
+
+
+    /*
+     * Drop the block the template replaced by a copy
+     */
+    if ((pTemplate->EQNB_CoefCopied != LVM_FALSE) &&
+        (atomic_load_explicit(&pTemplate->pEQNB_CoefCopy, memory_order_acquire) == LVM_NULL))
+    {
+        LVM_CoefRelease(pTemplate);
+    }
+
+    if ((pTemplate->InstParamsEx.CoefSharing != LVM_MODE_ON) ||
+        (pTemplate->EQNB_Active == LVM_FALSE) ||
+        (pTemplate->ControlPending != LVM_FALSE) ||
+        (pTemplate->EQNB_CoefCopied != LVM_FALSE))
+    {
+        return LVM_NULL;
+    }
+    if (pTemplate->pEQNB_CoefBlock != LVM_NULL)
+    {
+        return pTemplate->pEQNB_CoefBlock;
+    }
+
+    /*
+     * Move the coefficients of the template into the block
+     */
+    pRegion = &pTemplate->ModuleMemoryTable[LVM_MODULE_EQNB].Region[LVM_MEMREGION_PERSISTENT_FAST_COEF];
+    Offset  = (LVM_UINT32)(sizeof(LVM_CoefBlock_t) +
+                           pTemplate->InstParams.EQNB_NumBands * sizeof(LVM_EQNB_BandDef_t));
+    Offset  = (Offset + LVM_COEFBLOCK_ALIGN - 1) & ~(LVM_UINT32)(LVM_COEFBLOCK_ALIGN - 1);
+    pBlock  = pAllocator->pAlloc(pAllocator->pAllocHandle, Offset + pRegion->Size);
+    if (pBlock == LVM_NULL)
+    {
+        return LVM_NULL;
+    }
+    atomic_init(&pBlock->RefCount, 1);
+    pBlock->SampleRate   = pTemplate->Params.SampleRate;
+    pBlock->SourceFormat = pTemplate->Params.SourceFormat;
+    pBlock->NBands       = pTemplate->Params.EQNB_NBands;
+    pBlock->pBandDefs    = (LVM_EQNB_BandDef_t *)(pBlock + 1);
+    pBlock->pCoefs       = (LVM_UINT8 *)pBlock + Offset;
+    for (i = 0; i < pBlock->NBands; i++)
+    {
+        pBlock->pBandDefs[i] = pTemplate->Params.pEQNB_BandDefinition[i];
+    }
+    memcpy(pBlock->pCoefs, pRegion->pBaseAddress, pRegion->Size);
+    (void)LVEQNB_SetCoefMemory(pTemplate->hEQNBInstance, pBlock->pCoefs);
+    pAllocator->pFree(pAllocator->pAllocHandle, pRegion->pBaseAddress);
+    pRegion->pBaseAddress      = pBlock->pCoefs;
+    pTemplate->pEQNB_CoefBlock = pBlock;
+
+    return pBlock;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CoefCopy                                                */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Makes a private copy of the shared equaliser coefficients of an instance before     */
+/*  control parameters that change them are applied. The copy is published to the       */
+/*  audio thread, LVM_CoefAttach moves the equaliser to it.                             */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*  pParams                 Pointer to the new control parameters, LVM_NULL to copy     */
+/*                          the coefficients whatever the parameters                    */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When the module allocator returned NULL                     */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The function can be interrupted by the LVM_Process function, the copy is         */
+/*     complete before it is published with release order                               */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_CoefCopy(LVM_Instance_t            *pInstance,
+                                 const LVM_ControlParams_t *pParams)
+{
+    LVM_ModuleAllocator_t   *pAllocator = &pInstance->InstParamsEx.ModuleAllocator;
+    LVM_CoefBlock_t         *pBlock     = pInstance->pEQNB_CoefBlock;
+    LVM_UINT32              Size;
+    void                    *pCoefs;
+
+
+    if ((pBlock == LVM_NULL) ||
+        (pInstance->EQNB_CoefCopied != LVM_FALSE) ||
+        ((pParams != LVM_NULL) && (LVM_CoefMatch(pBlock, pParams) == LVM_TRUE)))
+    {
+        return(LVM_SUCCESS);
+    }
+
+    Size   = pInstance->ModuleMemoryTable[LVM_MODULE_EQNB].Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].Size;
+    pCoefs = pAllocator->pAlloc(pAllocator->pAllocHandle, Size);
+    if (pCoefs == LVM_NULL)
+    {
+        return(LVM_NULLADDRESS);
+    }
+    memcpy(pCoefs, pBlock->pCoefs, Size);
+    pInstance->EQNB_CoefCopied = LVM_TRUE;
+    atomic_store_explicit(&pInstance->pEQNB_CoefCopy, pCoefs, memory_order_release);
+
+    return(LVM_SUCCESS);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CoefAttach                                              */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Moves the equaliser to the private copy of its coefficients made by LVM_CoefCopy    */
+/*  since the last call. The shared block is only read from then on.                    */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the bundle instance                              */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Called by LVM_ApplyNewSettings before the module parameters are applied          */
+/*                                                                                      */
+/****************************************************************************************/
+
+void LVM_CoefAttach(LVM_Instance_t      *pInstance)
+{
+    void                    *pCoefs;
+
+
+    pCoefs = atomic_exchange_explicit(&pInstance->pEQNB_CoefCopy, LVM_NULL, memory_order_acquire);
+    if (pCoefs != LVM_NULL)
+    {
+        (void)LVEQNB_SetCoefMemory(pInstance->hEQNBInstance, pCoefs);
+        pInstance->ModuleMemoryTable[LVM_MODULE_EQNB].Region[LVM_MEMREGION_PERSISTENT_FAST_COEF].pBaseAddress = pCoefs;
+    }
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_FreeModuleMemory                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function returns the module memory allocated on demand to the module           */
+/*  allocator given in the extended instance parameters. The modules are disabled,      */
+/*  enabling them again allocates new memory.                                           */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Succeeded                                                   */
+/*  LVM_NULLADDRESS         When hInstance is NULL                                      */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function                */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_ReturnStatus_en LVM_FreeModuleMemory(LVM_Handle_t   hInstance)
+{
+    LVM_Instance_t          *pInstance = (LVM_Instance_t  *)hInstance;
+    LVM_ModuleAllocator_t   *pAllocator;
+    LVM_MemoryRegion_st     *pRegion;
+    void                    *pCoefs;
+    LVM_INT16               Module;
+    LVM_INT16               i;
+
+
+    if (hInstance == LVM_NULL)
+    {
+        return(LVM_NULLADDRESS);
+    }
+
+    pAllocator = &pInstance->InstParamsEx.ModuleAllocator;
+    if (pAllocator->pAlloc == LVM_NULL)
+    {
+        return(LVM_SUCCESS);
+    }
+
+    /*
+     * Disable the modules
+     */
+    pInstance->hCSInstance                          = LVM_NULL;
+    pInstance->CS_Active                            = LVM_FALSE;
+    pInstance->Params.VirtualizerOperatingMode      = LVM_MODE_OFF;
+    pInstance->NewParams.VirtualizerOperatingMode   = LVM_MODE_OFF;
+
+    pInstance->hDBEInstance                         = LVM_NULL;
+    pInstance->DBE_Active                           = LVM_FALSE;
+    pInstance->Params.BE_OperatingMode              = LVM_BE_OFF;
+    pInstance->NewParams.BE_OperatingMode           = LVM_BE_OFF;
+
+#ifdef BUILD_FLOAT
+    LVM_CascadeRelease(pInstance);
+#endif
+
+    pInstance->hEQNBInstance                        = LVM_NULL;
+    pInstance->EQNB_Active                          = LVM_FALSE;
+    pInstance->Params.EQNB_OperatingMode            = LVM_EQNB_OFF;
+    pInstance->NewParams.EQNB_OperatingMode         = LVM_EQNB_OFF;
+
+    pInstance->hPSAInstance                         = LVM_NULL;
+    pInstance->Params.PSA_Enable                    = LVM_PSA_OFF;
+    pInstance->NewParams.PSA_Enable                 = LVM_PSA_OFF;
+
+    /*
+     * Drop the shared equaliser coefficients and a copy not yet in use
+     */
+    pRegion = &pInstance->ModuleMemoryTable[LVM_MODULE_EQNB].Region[LVM_MEMREGION_PERSISTENT_FAST_COEF];
+    pCoefs  = atomic_exchange_explicit(&pInstance->pEQNB_CoefCopy, LVM_NULL, memory_order_acquire);
+    if (pCoefs != LVM_NULL)
+    {
+        pAllocator->pFree(pAllocator->pAllocHandle, pCoefs);
+    }
+    if ((pInstance->pEQNB_CoefBlock != LVM_NULL) &&
+        (pRegion->pBaseAddress == pInstance->pEQNB_CoefBlock->pCoefs))
+    {
+        pRegion->pBaseAddress = LVM_NULL;
+    }
+    LVM_CoefRelease(pInstance);
+
+    /*
+     * Free the persistent module memory
+     */
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
+    {
+        for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+        {
+            if (pInstance->ModuleMemoryTable[Module].Region[i].pBaseAddress != LVM_NULL)
+            {
+                pAllocator->pFree(pAllocator->pAllocHandle,
+                                  pInstance->ModuleMemoryTable[Module].Region[i].pBaseAddress);
+                pInstance->ModuleMemoryTable[Module].Region[i].pBaseAddress = LVM_NULL;
+            }
+        }
+        atomic_store_explicit(&pInstance->ModuleState[Module], LVM_MODULE_UNALLOCATED, memory_order_relaxed);
+    }
+
+    return(LVM_SUCCESS);
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_RelocateAddress                                         */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Moves an address inside one of the regions of a list of memory tables to the same   */
+/*  offset in the matching region of a second list of memory tables. Addresses outside  */
+/*  all of the regions are returned unchanged.                                          */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pAddress                Address to move                                             */
+/*  pFromTables             Memory tables the address belongs to                        */
+/*  pToTables               Memory tables to move the address to                        */
+/*  NrTables                Number of tables in each list                               */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  The moved address                                                                   */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. An address at the end of a region is treated as part of it, this is the address  */
+/*     the InstAlloc functions return for a zero size member. It is only used when the  */
+/*     address is not inside another region, regions may directly follow each other.   */
+/*                                                                                      */
+/****************************************************************************************/
+
+void *LVM_RelocateAddress(void                *pAddress,
+                          const LVM_MemTab_t  *pFromTables,
+                          const LVM_MemTab_t  *pToTables,
+                          LVM_INT16           NrTables)
+{
+    LVM_INT16   Pass;
+    LVM_INT16   Table;
+    LVM_INT16   i;
+    LVM_UINT8   *pBase;
+    LVM_UINT8   *pEnd;
+
+    if (pAddress == LVM_NULL)
+    {
+        return LVM_NULL;
+    }
+
+    /*
+     * First look inside the regions, then at their ends
+     */
+    for (Pass = 0; Pass < 2; Pass++)
+    {
+        for (Table = 0; Table < NrTables; Table++)
+        {
+            for (i = 0; i < LVM_NR_MEMORY_REGIONS; i++)
+            {
+                pBase = (LVM_UINT8 *)pFromTables[Table].Region[i].pBaseAddress;
+                pEnd  = pBase + pFromTables[Table].Region[i].Size;
+                if ((pBase != LVM_NULL) &&
+                    ((LVM_UINT8 *)pAddress >= pBase) &&
+                    (((LVM_UINT8 *)pAddress < pEnd) ||
+                     ((Pass == 1) && ((LVM_UINT8 *)pAddress == pEnd))))
+                {
+                    return (LVM_UINT8 *)pToTables[Table].Region[i].pBaseAddress + ((LVM_UINT8 *)pAddress - pBase);
+                }
+            }
+        }
+    }
+
+    return pAddress;
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_CloneInstance                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  This function is used to create a bundle instance as a copy of an existing,        */
+/*  fully initialised template instance. The persistent memory of the template is       */
+/*  copied to the regions given in the memory table and all internal pointers are       */
+/*  moved to the new regions.                                                           */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hTemplate               Template instance handle                                    */
+/*  phInstance              Pointer to the new instance handle                          */
+/*  pMemoryTable            Pointer to the memory definition table of the new instance  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS             Clone succeeded                                             */
+/*  LVM_NULLADDRESS         When one of hTemplate, phInstance or pMemoryTable is NULL   */
+/*                          or a memory region has a NULL pointer                       */
+/*  LVM_OUTOFRANGE          When the region sizes differ from those of the template     */
+/*  LVM_ALIGNMENTERROR      When a region is not at the 64-bit alignment of the region  */
+/*                          of the template                                             */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. This function must not be interrupted by the LVM_Process function of the         */
+/*     template                                                                         */
+/*  2. Every pointer held in the persistent memory of the bundle or of one of its       */
+/*     modules must be moved here. The filter instances all start with the pointer      */
+/*     to their taps.                                                                   */
+/*  3. Module memory allocated on demand is allocated for the new instance with the     */
+/*     module allocator of the template                                                 */
+/*                                                                                      */
+/****************************************************************************************/
+
+#define LVM_RELOCATE(Address)   ((Address) = LVM_RelocateAddress((Address), FromTables, ToTables, NrTables))
+
+LVM_ReturnStatus_en LVM_CloneInstance(LVM_Handle_t        hTemplate,
+                                      LVM_Handle_t        *phInstance,
+                                      LVM_MemTab_t        *pMemoryTable)
+{
+    LVM_Instance_t          *pTemplate = (LVM_Instance_t  *)hTemplate;
+    LVM_Instance_t          *pInstance;
+    LVM_ModuleAllocator_t   *pAllocator;
+    LVM_CoefBlock_t         *pBlock = LVM_NULL;                 /* Shared equaliser coefficients */
+    LVM_MemTab_t            FromTables[1 + LVM_NR_MODULES];   /* Bundle and module tables of the template */
+    LVM_MemTab_t            ToTables[1 + LVM_NR_MODULES];     /* Matching tables of the new instance */
+    LVM_INT16               NrTables;
+    LVM_INT16               Module;
+    LVM_INT16               i;
+
+
+    /*
+     * Check valid points have been given
+     */
+    if ((hTemplate == LVM_NULL) || (phInstance == LVM_NULL) || (pMemoryTable == LVM_NULL))
+    {
+        return (LVM_NULLADDRESS);
+    }
+
+    /*
+     * Check the memory table against the template
+     */
+    for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+    {
+        if (pMemoryTable->Region[i].Size != pTemplate->MemoryTable.Region[i].Size)
+        {
+            return (LVM_OUTOFRANGE);
+        }
+        if ((pMemoryTable->Region[i].Size != 0) &&
+            (pMemoryTable->Region[i].pBaseAddress==LVM_NULL))
+        {
+            return(LVM_NULLADDRESS);
+        }
+        if ((pMemoryTable->Region[i].Size != 0) &&
+            ((((uintptr_t)pMemoryTable->Region[i].pBaseAddress -
+               (uintptr_t)pTemplate->MemoryTable.Region[i].pBaseAddress) & (LVM_MEMBER_ALIGN - 1)) != 0))
+        {
+            return(LVM_ALIGNMENTERROR);     /* The copied members would lose their alignment */
+        }
+    }
+
+    /*
+     * Copy the module memory allocated on demand, the template tables are kept for
+     * the relocation
+     */
+    FromTables[0] = pTemplate->MemoryTable;
+    ToTables[0]   = *pMemoryTable;
+    NrTables      = 1;
+    pAllocator    = &pTemplate->InstParamsEx.ModuleAllocator;
+    if (pAllocator->pAlloc != LVM_NULL)
+    {
+        pBlock = LVM_CoefShare(pTemplate);
+        for (Module = 0; Module < LVM_NR_MODULES; Module++)
+        {
+            if (pTemplate->ModuleMemoryTable[Module].Region[LVM_MEMREGION_PERSISTENT_SLOW_DATA].pBaseAddress == LVM_NULL)
+            {
+                continue;
+            }
+            /* The module scratch memory is part of the bundle scratch memory */
+            FromTables[NrTables] = pTemplate->ModuleMemoryTable[Module];
+            FromTables[NrTables].Region[LVM_MEMREGION_TEMPORARY_FAST].pBaseAddress = LVM_NULL;
+            ToTables[NrTables]   = FromTables[NrTables];
+            for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+            {
+                ToTables[NrTables].Region[i].pBaseAddress = LVM_NULL;
+            }
+            for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+            {
+                if ((pBlock != LVM_NULL) &&
+                    (FromTables[NrTables].Region[i].pBaseAddress == pBlock->pCoefs))
+                {
+                    /* The shared coefficients stay where they are */
+                    ToTables[NrTables].Region[i].pBaseAddress = pBlock->pCoefs;
+                }
+                else if (FromTables[NrTables].Region[i].pBaseAddress != LVM_NULL)
+                {
+                    ToTables[NrTables].Region[i].pBaseAddress = pAllocator->pAlloc(pAllocator->pAllocHandle,
+                                                                                   FromTables[NrTables].Region[i].Size);
+                    if (ToTables[NrTables].Region[i].pBaseAddress == LVM_NULL)
+                    {
+                        /* Free what was allocated so far, this table included */
+                        for (NrTables++; NrTables > 1; NrTables--)
+                        {
+                            for (i=0; i<LVM_MEMREGION_TEMPORARY_FAST; i++)
+                            {
+                                if ((ToTables[NrTables - 1].Region[i].pBaseAddress != LVM_NULL) &&
+                                    (ToTables[NrTables - 1].Region[i].pBaseAddress !=
+                                     FromTables[NrTables - 1].Region[i].pBaseAddress))
+                                {
+                                    pAllocator->pFree(pAllocator->pAllocHandle,
+                                                      ToTables[NrTables - 1].Region[i].pBaseAddress);
+                                }
+                            }
+                        }
+                        return (LVM_NULLADDRESS);
+                    }
+                    memcpy(ToTables[NrTables].Region[i].pBaseAddress,
+                           FromTables[NrTables].Region[i].pBaseAddress,
+                           FromTables[NrTables].Region[i].Size);
+                }
+            }
+            NrTables++;
+        }
+    }
+
+    /*
+     * Copy the persistent memory, the scratch memory holds no state between calls
+     */
+    for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+    {
+        if ((i != LVM_MEMREGION_TEMPORARY_FAST) &&
+            (pMemoryTable->Region[i].Size != 0))
+        {
+            memcpy(pMemoryTable->Region[i].pBaseAddress,
+                   pTemplate->MemoryTable.Region[i].pBaseAddress,
+                   pMemoryTable->Region[i].Size);
+        }
+    }
+
+    pInstance = (LVM_Instance_t *)LVM_RelocateAddress(pTemplate, FromTables, ToTables, NrTables);
+
+    /*
+     * Save the new memory table, the clone holds the shared coefficients of the template
+     */
+    pInstance->MemoryTable = *pMemoryTable;
+    pInstance->pEQNB_CoefBlock = pBlock;
+    pInstance->EQNB_CoefCopied = LVM_FALSE;
+    atomic_init(&pInstance->pEQNB_CoefCopy, LVM_NULL);
+    if (pBlock != LVM_NULL)
+    {
+        atomic_fetch_add_explicit(&pBlock->RefCount, 1, memory_order_relaxed);
+    }
+    for (Module = 0; Module < LVM_NR_MODULES; Module++)
+    {
+        for (i=0; i<LVM_NR_MEMORY_REGIONS; i++)
+        {
+            LVM_RELOCATE(pInstance->ModuleMemoryTable[Module].Region[i].pBaseAddress);
+        }
+    }
+
+    /*
+     * Bundle pointers
+     */
+    if (pInstance->InstParams.BufferMode == LVM_MANAGED_BUFFERS)   /* Not set for unmanaged buffers */
+    {
+        LVM_RELOCATE(pInstance->pBufferManagement);
+        LVM_RELOCATE(pInstance->pBufferManagement->pScratch);
+    }
+    LVM_RELOCATE(pInstance->Params.pEQNB_BandDefinition);
+    LVM_RELOCATE(pInstance->NewParams.pEQNB_BandDefinition);
+    LVM_RELOCATE(pInstance->pEQNB_BandDefs);
+    LVM_RELOCATE(pInstance->pEQNB_UserDefs);
+    LVM_RELOCATE(pInstance->VC_Volume.MixerStream[0].pCallbackHandle);
+    LVM_RELOCATE(pInstance->VC_BalanceMix.MixerStream[0].pCallbackHandle);
+    LVM_RELOCATE(pInstance->VC_BalanceMix.MixerStream[1].pCallbackHandle);
+    LVM_RELOCATE(pInstance->pTE_Taps);
+    LVM_RELOCATE(pInstance->pTE_State);
+    LVM_RELOCATE(*(void **)&pInstance->pTE_State->TrebleBoost_State);
+    LVM_RELOCATE(pInstance->NewHeadroomParams.pHeadroomDefinition);
+    LVM_RELOCATE(pInstance->HeadroomParams.pHeadroomDefinition);
+    LVM_RELOCATE(pInstance->pHeadroom_BandDefs);
+    LVM_RELOCATE(pInstance->pHeadroom_UserDefs);
+    LVM_RELOCATE(pInstance->pPSAInput);
+    LVM_RELOCATE(pInstance->pPSARing);
+#ifdef BUILD_FLOAT
+    LVM_RELOCATE(pInstance->pPSASnapshot);
+    if (pInstance->pPSASnapshot != LVM_NULL)
+    {
+        LVM_RELOCATE(pInstance->pPSASnapshot->pPeaks);
+        for (i = 0; i < LVM_PSA_SNAPSHOT_SLOTS; i++)
+        {
+            LVM_RELOCATE(pInstance->pPSASnapshot->Slots[i].pCurrentLevels);
+            LVM_RELOCATE(pInstance->pPSASnapshot->Slots[i].pPeakLevels);
+        }
+    }
+    LVM_RELOCATE(pInstance->pBlockBuffer);
+    LVM_RELOCATE(pInstance->pCascade);
+    if (pInstance->pCascade != LVM_NULL)
+    {
+        LVM_RELOCATE(pInstance->pCascade->pCoefs);
+        LVM_RELOCATE(pInstance->pCascade->pHistory);
+    }
+#endif
+
+    /*
+     * The queued blocks and the analyser handle belong to the template, the clone
+     * publishes its own snapshots
+     */
+    if (pInstance->pPSARing != LVM_NULL)
+    {
+        LVM_PSARingInit(pInstance->pPSARing);
+    }
+#ifdef BUILD_FLOAT
+    if (pInstance->pPSASnapshot != LVM_NULL)
+    {
+        LVM_PSASnapshotInit(pInstance->pPSASnapshot,
+                            pInstance->pPSASnapshot->NrBands);
+    }
+#endif
+
+    /*
+     * Concert Sound
+     */
+    if (pInstance->hCSInstance != LVM_NULL)
+    {
+        LVCS_Instance_t                 *pCS;
+        LVCS_Coefficient_t              *pCoefficients;
+        LVM_Timer_Instance_Private_t    *pTimer;
+
+        LVM_RELOCATE(pInstance->hCSInstance);
+        pCS    = (LVCS_Instance_t *)pInstance->hCSInstance;
+        pTimer = (LVM_Timer_Instance_Private_t *)&pCS->TimerInstance;
+        for (i=0; i<LVCS_NR_MEMORY_REGIONS; i++)
+        {
+            LVM_RELOCATE(pCS->MemoryTable.Region[i].pBaseAddress);
+        }
+        LVM_RELOCATE(pCS->Capabilities.pBundleInstance);
+        LVM_RELOCATE(pCS->BypassMix.Mixer_Instance.MixerStream[0].pCallbackHandle);
+        LVM_RELOCATE(pCS->BypassMix.Mixer_Instance.MixerStream[1].pCallbackHandle);
+        LVM_RELOCATE(pCS->TimerParams.pCallbackInstance);
+        LVM_RELOCATE(pTimer->pCallbackInstance);
+
+        pCoefficients = (LVCS_Coefficient_t *)pCS->MemoryTable.Region[LVCS_MEMREGION_PERSISTENT_FAST_COEF].pBaseAddress;
+        LVM_RELOCATE(*(void **)&pCoefficients->EqualiserBiquadInstance);
+        LVM_RELOCATE(*(void **)&pCoefficients->ReverbBiquadInstance);
+        LVM_RELOCATE(*(void **)&pCoefficients->SEBiquadInstanceMid);
+        LVM_RELOCATE(*(void **)&pCoefficients->SEBiquadInstanceSide);
+    }
+
+    /*
+     * N-Band Equaliser
+     */
+    if (pInstance->hEQNBInstance != LVM_NULL)
+    {
+        LVEQNB_Instance_t   *pEQNB;
+
+        LVM_RELOCATE(pInstance->hEQNBInstance);
+        pEQNB = (LVEQNB_Instance_t *)pInstance->hEQNBInstance;
+        for (i=0; i<LVEQNB_NR_MEMORY_REGIONS; i++)
+        {
+            LVM_RELOCATE(pEQNB->MemoryTable.Region[i].pBaseAddress);
+        }
+        LVM_RELOCATE(pEQNB->Params.pBandDefinition);
+        LVM_RELOCATE(pEQNB->Capabilities.pBundleInstance);
+        LVM_RELOCATE(pEQNB->pFastTemporary);
+#ifdef BUILD_FLOAT
+        LVM_RELOCATE(pEQNB->pEQNB_Taps_Float);
+        LVM_RELOCATE(pEQNB->pEQNB_FilterState_Float);
+        LVM_RELOCATE(pEQNB->pParallelTaps);
+        /* Points the filters at the moved taps and coefficients */
+        LVEQNB_SetCoefMemory(pInstance->hEQNBInstance,
+                             pEQNB->MemoryTable.Region[LVEQNB_MEMREGION_PERSISTENT_COEF].pBaseAddress);
+#else
+        LVM_RELOCATE(pEQNB->pEQNB_Taps);
+        LVM_RELOCATE(pEQNB->pEQNB_FilterState);
+        for (i=0; i<pEQNB->Capabilities.MaxBands; i++)
+        {
+            LVM_RELOCATE(*(void **)&pEQNB->pEQNB_FilterState[i]);
+        }
+#endif
+        LVM_RELOCATE(pEQNB->pBandDefinitions);
+        LVM_RELOCATE(pEQNB->pBiquadType);
+        LVM_RELOCATE(pEQNB->BypassMixer.MixerStream[0].pCallbackHandle);
+        LVM_RELOCATE(pEQNB->BypassMixer.MixerStream[1].pCallbackHandle);
+    }
+
+    /*
+     * Dynamic Bass Enhancement
+     */
+    if (pInstance->hDBEInstance != LVM_NULL)
+    {
+        LVDBE_Instance_t    *pDBE;
+
+        LVM_RELOCATE(pInstance->hDBEInstance);
+        pDBE = (LVDBE_Instance_t *)pInstance->hDBEInstance;
+        for (i=0; i<LVDBE_NR_MEMORY_REGIONS; i++)
+        {
+            LVM_RELOCATE(pDBE->MemoryTable.Region[i].pBaseAddress);
+        }
+        LVM_RELOCATE(pDBE->pData);
+        LVM_RELOCATE(pDBE->pCoef);
+        LVM_RELOCATE(*(void **)&pDBE->pCoef->HPFInstance);
+        LVM_RELOCATE(*(void **)&pDBE->pCoef->BPFInstance);
+    }
+
+    /*
+     * Spectrum Analyzer
+     */
+    if (pInstance->hPSAInstance != LVM_NULL)
+    {
+        LVPSA_InstancePr_t  *pPSA;
+
+        LVM_RELOCATE(pInstance->hPSAInstance);
+        pPSA = (LVPSA_InstancePr_t *)pInstance->hPSAInstance;
+        for (i=0; i<LVPSA_NR_MEMORY_REGIONS; i++)
+        {
+            LVM_RELOCATE(pPSA->MemoryTable.Region[i].pBaseAddress);
+        }
+        LVM_RELOCATE(pPSA->pBPFiltersPrecision);
+#ifdef BUILD_FLOAT
+        LVM_RELOCATE(pPSA->pBankCoefs);
+        LVM_RELOCATE(pPSA->pBankTaps);
+        LVM_RELOCATE(pPSA->pBankGroups);
+#else
+        LVM_RELOCATE(pPSA->pBP_Instances);
+        LVM_RELOCATE(pPSA->pBP_Taps);
+        LVM_RELOCATE(pPSA->pQPD_States);
+        LVM_RELOCATE(pPSA->pQPD_Taps);
+        for (i=0; i<pPSA->nBands; i++)
+        {
+            LVM_RELOCATE(*(void **)&pPSA->pBP_Instances[i]);
+            LVM_RELOCATE(pPSA->pQPD_States[i].pDelay);
+        }
+#endif
+        LVM_RELOCATE(pPSA->pPostGains);
+        LVM_RELOCATE(pPSA->pFiltersParams);
+#ifdef BUILD_FLOAT
+        LVM_RELOCATE(pPSA->pCoefBank);
+        LVM_RELOCATE(pPSA->pBPFiltersDecimation);
+        LVM_RELOCATE(pPSA->pDecimationTaps);
+        if (pPSA->pFFT != LVM_NULL)
+        {
+            LVM_RELOCATE(pPSA->pFFT);
+            LVM_RELOCATE(pPSA->pFFT->pWindow);
+            LVM_RELOCATE(pPSA->pFFT->pTwiddles);
+            LVM_RELOCATE(pPSA->pFFT->pBitReverse);
+            LVM_RELOCATE(pPSA->pFFT->pBands);
+            LVM_RELOCATE(pPSA->pFFT->pInput);
+            LVM_RELOCATE(pPSA->pFFT->pLevels);
+        }
+#endif
+        LVM_RELOCATE(pPSA->pSpectralDataBufferStart);
+        LVM_RELOCATE(pPSA->pSpectralDataBufferWritePointer);
+        LVM_RELOCATE(pPSA->pPreviousPeaks);
+    }
+
+    *phInstance = (LVM_Handle_t)pInstance;
+
+    return(LVM_SUCCESS);
+}
+
+#undef LVM_RELOCATE
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_PSARingInit                                             */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Empty the ring of the deferred Spectrum Analyzer. The analyser handle and settings  */
+/*  are taken from the first block committed after this call.                          */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pRing                   Pointer to the ring                                         */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Neither LVM_Process nor LVM_ProcessSpectrum may use the ring during this call    */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_PSARingInit(LVM_PSA_Ring_t  *pRing)
+{
+    atomic_init(&pRing->WriteBlock, 0);
+    atomic_init(&pRing->ReadBlock, 0);
+    atomic_init(&pRing->DroppedSamples, 0);
+    pRing->WriteSample     = 0;
+    pRing->hAnalyser       = LVM_NULL;
+    pRing->AnalysedSamples = 0;
+    pRing->SampleRate      = LVM_FS_INVALID;
+    pRing->PeakDecayRate   = LVM_PSA_SPEED_MEDIUM;
+}
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_PSASnapshotInit                                         */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Clear the spectrum snapshots and calculate the dBFS of the spectrum levels.         */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pSnapshot               Pointer to the snapshots                                    */
+/*  NrBands                 Number of bands of the analyser                             */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. No thread may publish or read a snapshot during this call                        */
+/*  2. A full scale sine reads the spectrum level 128 as the analyser input is halved   */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_PSASnapshotInit(LVM_PSA_Snapshot_t  *pSnapshot,
+                         LVM_UINT16          NrBands)
+{
+    LVM_INT16   ii;
+
+    atomic_init(&pSnapshot->Published, 0);
+    for (ii = 0; ii < LVM_PSA_SNAPSHOT_SLOTS; ii++)
+    {
+        atomic_init(&pSnapshot->Sequence[ii], 0);
+    }
+    pSnapshot->NrBands   = NrBands;
+    pSnapshot->ReadEntry = 0;
+    memset(pSnapshot->pPeaks, 0, NrBands * sizeof(LVM_UINT8));
+
+    pSnapshot->LevelTable[0] = LVM_PSA_SILENCE_DB;
+    for (ii = 1; ii <= LVPSA_MAXUNSIGNEDCHAR; ii++)
+    {
+        pSnapshot->LevelTable[ii] = (LVM_FLOAT)(20.0 * log10(ii / 128.0));
+    }
+}
+#endif
@@ -46,6 +46,7 @@ extern "C" {
 #include "LVDBE_Private.h"                      /* Dynamic Bass Enhancement */
 #include "LVEQNB_Private.h"                     /* N-Band equaliser */
 #include "LVPSA_Private.h"                      /* Parametric Spectrum Analyzer */
+#include <stdatomic.h>                          /* Spectrum Analyzer ring indices */
 
 
 /************************************************************************************/
@@ -59,11 +60,39 @@ extern "C" {
 
 /* Memory */
 #define LVM_INSTANCE_ALIGN              4         /* 32-bit for structures */
+#define LVM_MEMBER_ALIGN                8         /* 64-bit for structures holding pointers or atomics */
 #define LVM_FIRSTCALL                   0         /* First call to the buffer */
 #define LVM_MAXBLOCKCALL                1         /* Maximum block size calls to the buffer */
 #define LVM_LASTCALL                    2         /* Last call to the buffer */
 #define LVM_FIRSTLASTCALL               3         /* Single call for small number of samples */
 
+/* Modules with their own memory table */
+#define LVM_MODULE_CS                   0         /* Concert Sound */
+#define LVM_MODULE_DBE                  1         /* Dynamic Bass Enhancement */
+#define LVM_MODULE_EQNB                 2         /* N-Band Equaliser */
+#define LVM_MODULE_PSA                  3         /* Spectrum Analyzer */
+#define LVM_NR_MODULES                  4         /* Number of modules */
+
+/* Module memory states, see LVM_ModuleAlloc */
+#define LVM_MODULE_UNALLOCATED          0         /* No persistent module memory */
+#define LVM_MODULE_PENDING              1         /* Memory allocated, the module is not initialised */
+#define LVM_MODULE_READY                2         /* Module initialised in its memory */
+#define LVM_COEFBLOCK_ALIGN             16        /* Alignment of the coefficients in a shared block */
+
+/* Coefficient banks */
+#if defined(BUILD_FLOAT) && defined(HIGHER_FS)
+#define LVM_FS_BANK_ALL                 (LVM_FS_BANK(LVM_FS_192000 + 1) - 1)  /* All supported rates */
+#else
+#define LVM_FS_BANK_ALL                 (LVM_FS_BANK(LVM_FS_48000 + 1) - 1)   /* All supported rates */
+#endif
+
+/* Denormal protection */
+#define LVM_DENORMAL_OFFSET_LEVEL       1.0e-18f  /* Offset for LVM_DENORMAL_OFFSET, -360dB */
+
+/* Silence detection */
+#define LVM_SILENCE_LEVEL               1.0e-8f   /* Input and effect tail level taken as silence, -160dB */
+#define LVM_SILENCE_DC_LEVEL            5.0e-7f   /* Limit cycle of the DC removal, two DC steps */
+
 /* Block Size */
 #define LVM_MIN_MAXBLOCKSIZE            16        /* Minimum MaxBlockSize Limit*/
 #define LVM_MANAGED_MAX_MAXBLOCKSIZE    8191      /* Maximum MaxBlockSzie Limit for Managed Buffer Mode*/
@@ -77,6 +106,17 @@ extern "C" {
 
 #define LVM_PSA_DYNAMICRANGE            60        /* Spectral Dynamic range: used for offseting output*/
 #define LVM_PSA_BARHEIGHT               127       /* Spectral Bar Height*/
+#define LVM_PSA_RING_SAMPLES            16384     /* Mono samples in the deferred PSA ring, a power of 2 */
+#define LVM_PSA_RING_BLOCKS             256       /* Blocks in the deferred PSA ring, a power of 2 */
+#define LVM_PSA_FFT_SIZE                4096      /* Transform length of the FFT spectrum analyser */
+#define LVM_PSA_FFT_HOP                 1024      /* Samples between two transforms of the FFT spectrum analyser */
+#define LVM_PSA_NBANDS                  9         /* Bands of the filter bank spectrum analyser */
+#define LVM_PSA_SNAPSHOT_SLOTS          4         /* Spectrum snapshots kept for the readers, a power of 2 */
+#define LVM_PSA_SNAPSHOT_RETRIES        4         /* Reads of a snapshot before the reader returns LVM_BUSY */
+
+/* Bands of the spectrum snapshots, the ones of the FFT or of the filter bank analyser */
+#define LVM_PSA_SNAPSHOT_NBANDS(pInstParamsEx) \
+            (((pInstParamsEx)->PSA_FFTBands != 0) ? (pInstParamsEx)->PSA_FFTBands : LVM_PSA_NBANDS)
 
 #define LVM_TE_MIN_EFFECTLEVEL          0         /*TE Minimum EffectLevel*/
 #define LVM_TE_MAX_EFFECTLEVEL          15        /*TE Maximum Effect level*/
@@ -120,6 +160,15 @@ extern "C" {
 /*                                                                                  */
 /************************************************************************************/
 
+/* Buffer layouts of LVM_ProcessBlocks */
+typedef enum
+{
+    LVM_LAYOUT_INTERLEAVED  = 0,                /* Interleaved float, accumulated */
+    LVM_LAYOUT_PLANAR       = 1,                /* One float plane per channel */
+    LVM_LAYOUT_PCM          = 2,                /* Interleaved PCM */
+    LVM_LAYOUT_DUMMY        = LVM_MAXENUM
+} LVM_Layout_en;
+
 /* Memory region definition */
 typedef struct
 {
@@ -176,6 +225,89 @@ typedef struct
 } LVM_Buffer_t;
 #endif
 
+/* Block of the deferred Spectrum Analyzer ring */
+typedef struct
+{
+    pLVPSA_Handle_t         hPSAInstance;       /* Spectrum Analyzer of the block */
+    LVM_UINT32              Start;              /* Sample index of the first sample */
+    LVM_UINT32              AudioTime;          /* Audio time given to LVM_Process */
+    LVM_UINT16              SampleCount;        /* Number of mono samples */
+    LVM_Fs_en               SampleRate;         /* Sample rate of the block */
+    LVM_PSA_DecaySpeed_en   PeakDecayRate;      /* Peak decay rate of the block */
+} LVM_PSA_RingBlock_t;
+
+/*
+ * Single producer, single consumer ring of the deferred Spectrum Analyzer. LVM_Process
+ * writes the blocks and publishes them with WriteBlock, LVM_ProcessSpectrum analyses
+ * them and releases them with ReadBlock. A block is never split, when it does not fit
+ * before the end of the samples it starts at the beginning.
+ */
+typedef struct
+{
+    atomic_uint             WriteBlock;         /* Number of blocks written */
+    atomic_uint             ReadBlock;          /* Number of blocks analysed */
+    atomic_uint             DroppedSamples;     /* Samples dropped because the ring was full */
+    LVM_UINT32              WriteSample;        /* Sample index of the next block, producer only */
+    pLVPSA_Handle_t         hAnalyser;          /* Spectrum Analyzer of the last block, consumer only */
+    LVM_UINT32              AnalysedSamples;    /* Samples analysed, consumer only */
+    LVM_Fs_en               SampleRate;         /* Sample rate of the analyser, consumer only */
+    LVM_PSA_DecaySpeed_en   PeakDecayRate;      /* Peak decay rate of the analyser, consumer only */
+    LVM_PSA_RingBlock_t     Blocks[LVM_PSA_RING_BLOCKS];
+#ifdef BUILD_FLOAT
+    LVM_FLOAT               Samples[LVM_PSA_RING_SAMPLES];
+#else
+    LVM_INT16               Samples[LVM_PSA_RING_SAMPLES];
+#endif
+} LVM_PSA_Ring_t;
+
+#ifdef BUILD_FLOAT
+/* Spectrum snapshot of a slot, read while it may be rewritten so all relaxed atomics */
+typedef struct
+{
+    atomic_int              AudioTime;          /* Audio time of the last spectrum entry */
+    atomic_ushort           NrBands;            /* Number of bands */
+    _Atomic LVM_FLOAT       *pCurrentLevels;    /* Current levels in dBFS of each band */
+    _Atomic LVM_FLOAT       *pPeakLevels;       /* Peak levels in dBFS of each band */
+} LVM_PSA_SnapshotSlot_t;
+
+/*
+ * Spectrum snapshots for any number of readers. The thread running the Spectrum Analyzer
+ * publishes snapshot n in slot n % LVM_PSA_SNAPSHOT_SLOTS: the sequence of the slot is odd
+ * while it is written and 2n once it is complete. A reader copies the slot of the last
+ * published snapshot and keeps the copy when the sequence did not change meanwhile, the
+ * publisher never waits for the readers.
+ */
+typedef struct
+{
+    atomic_uint             Published;          /* Number of snapshots published */
+    atomic_uint             Sequence[LVM_PSA_SNAPSHOT_SLOTS]; /* Sequence of each slot */
+    LVM_UINT16              NrBands;            /* Bands of the analyser */
+    LVM_UINT32              ReadEntry;          /* Next spectrum entry to take, publisher only */
+    LVM_UINT8               *pPeaks;            /* Peak levels of the bands, publisher only */
+    LVM_FLOAT               LevelTable[LVPSA_MAXUNSIGNEDCHAR + 1]; /* dBFS of each spectrum level */
+    LVM_PSA_SnapshotSlot_t  Slots[LVM_PSA_SNAPSHOT_SLOTS];
+} LVM_PSA_Snapshot_t;
+
+/*
+ * Adjacent linear filters merged into one cascade of direct form second order sections,
+ * section n reads history n and writes history n + 1. The history of a channel holds
+ * x(n-1) and x(n-2) of the input of each section and of the output of the last one.
+ * While the cascade runs the modules hold no valid history, it is given back to them
+ * before their parameters change.
+ */
+typedef struct
+{
+    LVM_FLOAT               *pCoefs;            /* 5 coefficients per section */
+    LVM_FLOAT               *pHistory;          /* Histories of the channels, see LVM_CascadeProcess */
+    LVM_UINT16              MaxSections;        /* Equaliser bands and the treble boost */
+    LVM_UINT16              NrSections;         /* Sections of the cascade, 0 when not running */
+    LVM_UINT16              NrEQSections;       /* Leading sections of the N-Band Equaliser */
+    LVM_INT16               TE_Merged;          /* The treble boost is the last section */
+    LVM_INT16               NrChannels;         /* Channels of the history */
+    LVM_INT16               Pending;            /* Compile the cascade in the next block */
+} LVM_Cascade_t;
+#endif
+
 /* Filter taps */
 typedef struct
 {
@@ -191,17 +323,40 @@ typedef struct
 {
 #ifdef BUILD_FLOAT
     Biquad_FLOAT_Instance_t       TrebleBoost_State;  /* State for the treble boost filter */
+    FO_FLOAT_LShx_Coefs_t         TrebleBoost_Coefs;  /* Coefficients of the treble boost filter */
 #else
     Biquad_Instance_t       TrebleBoost_State;  /* State for the treble boost filter */
 #endif
 } LVM_TE_Coefs_t;
 
+/*
+ * Equaliser coefficients shared by a template and its clones, see LVM_CoefShare. The block
+ * is followed by the band definitions and the coefficient region of the equaliser. It is
+ * read only, an instance whose parameters change moves to a private copy.
+ */
+typedef struct
+{
+    atomic_int              RefCount;           /* Instances holding the block */
+    LVM_Fs_en               SampleRate;         /* Parameters the coefficients were calculated for */
+    LVM_Format_en           SourceFormat;
+    LVM_UINT16              NBands;
+    LVM_EQNB_BandDef_t      *pBandDefs;         /* Band definitions */
+    void                    *pCoefs;            /* Coefficient region of the equaliser */
+} LVM_CoefBlock_t;
+
 typedef struct
 {
     /* Public parameters */
     LVM_MemTab_t            MemoryTable;        /* Instance memory allocation table */
     LVM_ControlParams_t     Params;             /* Control parameters */
     LVM_InstParams_t        InstParams;         /* Instance parameters */
+    LVM_InstParamsEx_t      InstParamsEx;       /* Extended instance parameters, complete with Size */
+    LVM_MemTab_t            ModuleMemoryTable[LVM_NR_MODULES]; /* Module memory, persistent regions are
+                                                                  NULL until a module allocated on demand
+                                                                  is first enabled */
+    atomic_int              ModuleState[LVM_NR_MODULES];       /* Module memory states, published by the
+                                                                  control thread once a module has its
+                                                                  memory */
 
     /* Private parameters */
     LVM_UINT16              ControlPending;     /* Control flag to indicate update pending */
@@ -232,19 +387,19 @@ typedef struct
 
     /* Concert Sound */
     LVCS_Handle_t           hCSInstance;        /* Concert Sound instance handle */
-    LVCS_Instance_t         CS_Instance;        /* Concert Sound instance */
     LVM_INT16               CS_Active;          /* Control flag */
 
     /* Equalizer */
     LVEQNB_Handle_t         hEQNBInstance;      /* N-Band Equaliser instance handle */
-    LVEQNB_Instance_t       EQNB_Instance;      /* N-Band Equaliser instance */
     LVM_EQNB_BandDef_t      *pEQNB_BandDefs;    /* Local storage for new definitions */
     LVM_EQNB_BandDef_t      *pEQNB_UserDefs;    /* Local storage for the user's definitions */
     LVM_INT16               EQNB_Active;        /* Control flag */
+    LVM_CoefBlock_t         *pEQNB_CoefBlock;   /* Shared coefficients, LVM_NULL when private */
+    LVM_INT16               EQNB_CoefCopied;    /* A private copy replaces the shared coefficients */
+    void * _Atomic          pEQNB_CoefCopy;     /* Private copy waiting for the audio thread */
 
     /* Dynamic Bass Enhancement */
     LVDBE_Handle_t          hDBEInstance;       /* Dynamic Bass Enhancement instance handle */
-    LVDBE_Instance_t        DBE_Instance;       /* Dynamic Bass Enhancement instance */
     LVM_INT16               DBE_Active;         /* Control flag */
 
     /* Volume Control */
@@ -267,6 +422,11 @@ typedef struct
     LVM_TE_Coefs_t          *pTE_State;         /* State for the treble boost filter */
     LVM_INT16               TE_Active;          /* Control flag */
 
+#ifdef BUILD_FLOAT
+    /* Filter merging */
+    LVM_Cascade_t           *pCascade;          /* Merged linear filters, LVM_NULL without FilterMerge */
+#endif
+
     /* Headroom */
     LVM_HeadroomParams_t    NewHeadroomParams;   /* New headroom parameters pending update */
     LVM_HeadroomParams_t    HeadroomParams;      /* Headroom parameters */
@@ -280,18 +440,38 @@ typedef struct
     LVPSA_InitParams_t      PSA_InitParams;     /* Spectrum Analyzer initialization parameters */
     LVPSA_ControlParams_t   PSA_ControlParams;  /* Spectrum Analyzer control parameters */
     LVM_INT16               PSA_GainOffset;     /* Tone control flag */
+    LVM_PSA_Ring_t          *pPSARing;          /* Deferred PSA ring, LVM_NULL when not deferred */
+#ifdef BUILD_FLOAT
+    LVM_PSA_Snapshot_t      *pPSASnapshot;      /* Spectrum snapshots, LVM_NULL without the PSA */
+#endif
     LVM_Callback            CallBack;
 #ifdef BUILD_FLOAT
     LVM_FLOAT               *pPSAInput;         /* PSA input pointer */
 #else
     LVM_INT16               *pPSAInput;         /* PSA input pointer */
 #endif
+#ifdef BUILD_FLOAT
+    LVM_FLOAT               *pBlockBuffer;      /* Float block of the planar, PCM and accumulate processing */
+    void                    *pPcmOut;           /* PCM output of the DC removal, LVM_NULL for float */
+    LVM_PcmFormat_en        PcmFormat;          /* Sample format of pPcmOut */
+    LVM_FLOAT               *pAccOut;           /* Accumulated output of the DC removal */
+    LVM_INT16               OutStored;          /* The DC removal has stored pPcmOut or pAccOut */
+    LVM_PcmStats_t          PcmStats;           /* PCM saturation counters */
+#endif
 
     LVM_INT16              NoSmoothVolume;      /* Enable or disable smooth volume changes*/
 
+    /* Denormal protection */
+    LVM_DenormalStats_t    DenormalStats;       /* Denormal detection counters */
+    LVM_INT32              DenormalPhase;       /* Offset pattern position of the next frame */
+
+    /* Silence detection */
+    LVM_INT16              SilenceIdle;         /* Effect tails have decayed, silent input is not processed */
+
 #ifdef SUPPORT_MC
     LVM_INT16              NrChannels;
     LVM_INT32              ChMask;
+    LVM_INT16              VC_BalanceChMap[LVM_MAX_CHANNELS];  /* Balance mixer stream of each channel */
 #endif
 
 } LVM_Instance_t;
@@ -344,6 +524,72 @@ LVM_INT32 LVM_AlgoCallBack(     void          *pBundleHandle,
                                 void          *pData,
                                 LVM_INT16     callbackId);
 
+LVM_ReturnStatus_en LVM_InitInstance(LVM_Handle_t        *phInstance,
+                                     LVM_MemTab_t        *pMemoryTable,
+                                     LVM_InstParams_t    *pInstParams,
+                                     LVM_InstParamsEx_t  *pInstParamsEx,
+                                     LVM_INT16           KeepAnalyser);
+
+LVM_ReturnStatus_en LVM_ModuleInit(LVM_Instance_t      *pInstance,
+                                   LVM_InstParams_t    *pInstParams,
+                                   LVM_InstParamsEx_t  *pInstParamsEx,
+                                   LVM_INT16           Module,
+                                   LVM_MemTab_t        *pModuleTable);
+
+LVM_ReturnStatus_en LVM_ModuleAlloc(LVM_Instance_t      *pInstance,
+                                    LVM_INT16           Module);
+
+void    LVM_ModuleAttach(       LVM_Instance_t      *pInstance);
+
+LVM_ReturnStatus_en LVM_CoefCopy(LVM_Instance_t            *pInstance,
+                                 const LVM_ControlParams_t *pParams);
+
+void    LVM_CoefAttach(         LVM_Instance_t      *pInstance);
+
+#ifdef BUILD_FLOAT
+LVM_FLOAT LVM_GetTailLevel(     LVM_Instance_t      *pInstance);
+
+LVM_ReturnStatus_en LVM_ProcessBlocks(LVM_Instance_t        *pInstance,
+                                      LVM_Layout_en         Layout,
+                                      const void            *pInData,
+                                      void                  *pOutData,
+                                      const LVM_FLOAT * const *ppInPlanes,
+                                      LVM_FLOAT * const     *ppOutPlanes,
+                                      LVM_PcmFormat_en      PcmFormat,
+                                      LVM_UINT16            NumSamples,
+                                      LVM_UINT32            AudioTime);
+#endif
+
+void    LVM_PSARingInit(       LVM_PSA_Ring_t      *pRing);
+
+void    *LVM_PSARingAcquire(    LVM_Instance_t      *pInstance,
+                                LVM_UINT16          SampleCount);
+
+void    LVM_PSARingCommit(      LVM_Instance_t      *pInstance,
+                                LVM_UINT16          SampleCount,
+                                LVM_UINT32          AudioTime);
+
+#ifdef BUILD_FLOAT
+void    LVM_PSASnapshotInit(    LVM_PSA_Snapshot_t  *pSnapshot,
+                                LVM_UINT16          NrBands);
+
+void    LVM_PSASnapshotPublish( LVM_PSA_Snapshot_t  *pSnapshot,
+                                pLVPSA_Handle_t     hPSAInstance);
+
+void    LVM_CascadeCompile(     LVM_Instance_t      *pInstance);
+
+void    LVM_CascadeRelease(     LVM_Instance_t      *pInstance);
+
+void    LVM_CascadeProcess(     LVM_Cascade_t       *pCascade,
+                                LVM_FLOAT           *pData,
+                                LVM_INT16           NrFrames);
+#endif
+
+void    *LVM_RelocateAddress(   void                *pAddress,
+                                const LVM_MemTab_t  *pFromTables,
+                                const LVM_MemTab_t  *pToTables,
+                                LVM_INT16           NrTables);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -66,9 +66,14 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
     LVM_FLOAT           *pToProcess = (LVM_FLOAT *)pInData;
     LVM_FLOAT           *pProcessed = pOutData;
     LVM_ReturnStatus_en  Status;
+    LVM_UINT32          FpuState    = 0;
+    LVM_UINT32          Denormals   = 0;
+    LVM_INT16           SilentInput = LVM_FALSE;
+    LVM_INT32           NrInSamples;
+    const LVM_FLOAT     *pMonoInput = LVM_NULL; /* Mono input of the next block */
+    const LVM_FLOAT     *pMono;
 #ifdef SUPPORT_MC
     LVM_INT32           NrChannels  = pInstance->NrChannels;
-    LVM_INT32           ChMask      = pInstance->ChMask;
 #define NrFrames SampleCount  // alias for clarity
 #endif
 
@@ -111,6 +116,23 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
         }
     }
 
+    /*
+     * Accumulate mode processes into the block buffer, which comes back here
+     */
+    if ((pInstance->InstParamsEx.OutputMode == LVM_OUTPUT_ACCUMULATE) &&
+        (pOutData != pInstance->pBlockBuffer))
+    {
+        return LVM_ProcessBlocks(pInstance,
+                                 LVM_LAYOUT_INTERLEAVED,
+                                 pInData,
+                                 pOutData,
+                                 LVM_NULL,
+                                 LVM_NULL,
+                                 LVM_PCM_DUMMY,
+                                 NumSamples,
+                                 AudioTime);
+    }
+
 
     /*
      * Update new parameters if necessary
@@ -121,8 +143,8 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
 #ifdef SUPPORT_MC
         /* Update the local variable NrChannels from pInstance->NrChannels value */
         NrChannels = pInstance->NrChannels;
-        ChMask     = pInstance->ChMask;
 #endif
+        pInstance->SilenceIdle = LVM_FALSE;
 
         if(Status != LVM_SUCCESS)
         {
@@ -130,12 +152,77 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
         }
     }
 
+    /*
+     * Skip the processing of a silent input once the effect tails have decayed
+     */
+    if ((pInstance->InstParamsEx.SilenceDetect == LVM_MODE_ON) &&
+        (pInstance->InstParams.BufferMode == LVM_UNMANAGED_BUFFERS))
+    {
+#ifdef SUPPORT_MC
+        NrInSamples = (LVM_INT32)NrChannels * NumSamples;
+#else
+        NrInSamples = 2 * (LVM_INT32)NumSamples;
+#endif
+        if (pInstance->Params.SourceFormat == LVM_MONO)
+        {
+            NrInSamples = NumSamples;
+        }
+        SilentInput = (PeakAbs_Float(pInData, NrInSamples) <= LVM_SILENCE_LEVEL) ?
+                                                                    LVM_TRUE : LVM_FALSE;
+        if (SilentInput == LVM_FALSE)
+        {
+            pInstance->SilenceIdle = LVM_FALSE;
+        }
+        else if (pInstance->SilenceIdle == LVM_TRUE)
+        {
+            LVM_FLOAT   *pClear = pOutData;
+            LVM_INT16   ClearCount;
+
+            /* A mono input gives a stereo output */
+            if (pInstance->Params.SourceFormat == LVM_MONO)
+            {
+                NrInSamples = 2 * (LVM_INT32)NumSamples;
+            }
+
+            /* Clear in blocks the 16-bit count can hold, a multichannel call can be longer */
+            while (NrInSamples > 0)
+            {
+                ClearCount = (LVM_INT16)((NrInSamples > LVM_MAXINT_16) ? LVM_MAXINT_16 : NrInSamples);
+                LoadConst_Float(0.0f, pClear, ClearCount);
+                pClear      += ClearCount;
+                NrInSamples -= ClearCount;
+            }
+            if (pInstance->InstParamsEx.DenormalDetect == LVM_MODE_ON)
+            {
+                pInstance->DenormalStats.ProcessCalls++;
+            }
+            return(LVM_SUCCESS);
+        }
+    }
+
+    /*
+     * Flush denormals to zero for the rest of the call
+     */
+    if (pInstance->InstParamsEx.DenormalMode == LVM_DENORMAL_FTZ)
+    {
+        FpuState = LVM_FlushToZeroSet();
+    }
+
 
     /*
      * Convert from Mono if necessary
      */
     if (pInstance->Params.SourceFormat == LVM_MONO)
     {
+        /*
+         * The unmanaged mono input is the mono mix of its blocks, unless the stereo
+         * output overwrites it
+         */
+        if ((pInstance->InstParams.BufferMode == LVM_UNMANAGED_BUFFERS) &&
+            ((pInData + NumSamples <= pOutData) || (pOutData + 2 * NumSamples <= pInData)))
+        {
+            pMonoInput = pInData;
+        }
         MonoTo2I_Float(pInData,                                /* Source */
                        pOutData,                               /* Destination */
                        (LVM_INT16)NumSamples);                 /* Number of input samples */
@@ -143,11 +230,20 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
         pToProcess = pOutData;
 #ifdef SUPPORT_MC
         NrChannels = 2;
-        ChMask     = AUDIO_CHANNEL_OUT_STEREO;
 #endif
     }
 
 
+    /*
+     * Merge the filters once their new settings are steady
+     */
+    if ((pInstance->pCascade != LVM_NULL) &&
+        (pInstance->pCascade->Pending == LVM_TRUE))
+    {
+        LVM_CascadeCompile(pInstance);
+    }
+
+
     /*
      * Process the data with managed buffers
      */
@@ -168,6 +264,29 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
          */
         if (SampleCount != 0)
         {
+            /*
+             * Add the denormal offset
+             */
+            if (pInstance->InstParamsEx.DenormalMode == LVM_DENORMAL_OFFSET)
+            {
+#ifdef SUPPORT_MC
+                pInstance->DenormalPhase = LVM_DenormalOffset_Float(pToProcess,
+                                                                    pProcessed,
+                                                                    NrFrames,
+                                                                    NrChannels,
+                                                                    LVM_DENORMAL_OFFSET_LEVEL,
+                                                                    pInstance->DenormalPhase);
+#else
+                pInstance->DenormalPhase = LVM_DenormalOffset_Float(pToProcess,
+                                                                    pProcessed,
+                                                                    SampleCount,
+                                                                    2,
+                                                                    LVM_DENORMAL_OFFSET_LEVEL,
+                                                                    pInstance->DenormalPhase);
+#endif
+                pToProcess = pProcessed;
+            }
+
             /*
              * Apply ConcertSound if required
              */
@@ -203,7 +322,37 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
             /*
              * Call N-Band equaliser if enabled
              */
-            if (pInstance->EQNB_Active == LVM_TRUE)
+            if ((pInstance->EQNB_Active == LVM_TRUE) &&
+                (pInstance->pCascade != LVM_NULL) &&
+                (pInstance->pCascade->NrSections != 0))
+            {
+                /*
+                 * The bands run in the cascade of the merged filters
+                 */
+                if (pToProcess != pProcessed)
+                {
+#ifdef SUPPORT_MC
+                    Copy_Float(pToProcess,                          /* Source */
+                               pProcessed,                          /* Destination */
+                               (LVM_INT16)(NrChannels * NrFrames)); /* Copy all samples */
+#else
+                    Copy_Float(pToProcess,                          /* Source */
+                               pProcessed,                          /* Destination */
+                               (LVM_INT16)(2 * SampleCount));       /* Left and right */
+#endif
+                }
+#ifdef SUPPORT_MC
+                LVM_CascadeProcess(pInstance->pCascade,
+                                   pProcessed,
+                                   (LVM_INT16)NrFrames);
+#else
+                LVM_CascadeProcess(pInstance->pCascade,
+                                   pProcessed,
+                                   (LVM_INT16)SampleCount);
+#endif
+                pToProcess = pProcessed;
+            }
+            else if (pInstance->EQNB_Active == LVM_TRUE)
             {
                 LVEQNB_Process(pInstance->hEQNBInstance,    /* N-Band equaliser instance handle */
                                pToProcess,
@@ -213,15 +362,26 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
             }
 
             /*
-             * Call bass enhancement if enabled
+             * Call bass enhancement if enabled. The mono input is the mono mix of the block
+             * when no module before changed it, the other mixes are calculated by the module.
              */
             if (pInstance->DBE_Active == LVM_TRUE)
             {
-                LVDBE_Process(pInstance->hDBEInstance,       /* Dynamic Bass Enhancement \
-                                                                instance handle */
-                              pToProcess,
-                              pProcessed,
-                              SampleCount);
+                pMono = LVM_NULL;
+                if ((pMonoInput != LVM_NULL) &&
+                    (pInstance->InstParamsEx.DenormalMode != LVM_DENORMAL_OFFSET) &&
+                    (pInstance->CS_Active == LVM_FALSE) &&
+                    (pInstance->VC_Active == 0) &&
+                    (pInstance->EQNB_Active == LVM_FALSE))
+                {
+                    pMono = pMonoInput;
+                }
+                LVDBE_ProcessWithMono(pInstance->hDBEInstance,  /* Dynamic Bass Enhancement \
+                                                                   instance handle */
+                                      pToProcess,
+                                      pMono,
+                                      pProcessed,
+                                      SampleCount);
                 pToProcess = pProcessed;
             }
 
@@ -242,9 +402,11 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
             }
 
             /*
-             * Apply treble boost if required
+             * Apply treble boost if required and not merged with the equaliser
              */
-            if (pInstance->TE_Active == LVM_TRUE)
+            if ((pInstance->TE_Active == LVM_TRUE) &&
+                ((pInstance->pCascade == LVM_NULL) ||
+                 (pInstance->pCascade->TE_Merged == LVM_FALSE)))
             {
                 /*
                  * Apply the filter
@@ -261,7 +423,6 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
                                            pProcessed,
                                            (LVM_INT16)SampleCount);
 #endif
-
             }
 #ifdef SUPPORT_MC
             /*
@@ -272,7 +433,7 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
                                           pProcessed,
                                           NrFrames,
                                           NrChannels,
-                                          ChMask);
+                                          pInstance->VC_BalanceChMap);
 #else
             /*
              * Volume balance
@@ -289,38 +450,120 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
             if ((pInstance->Params.PSA_Enable == LVM_PSA_ON) &&
                                             (pInstance->InstParams.PSA_Included == LVM_PSA_ON))
             {
+                /*
+                 * The deferred analysis only mixes down into the ring, the block is
+                 * dropped when the ring is full
+                 */
+                LVM_FLOAT   *pPSAInput = pInstance->pPSAInput;
+
+                if (pInstance->pPSARing != LVM_NULL)
+                {
+                    pPSAInput = LVM_PSARingAcquire(pInstance, SampleCount);
+                }
+                if (pPSAInput != LVM_NULL)
+                {
 #ifdef SUPPORT_MC
-                FromMcToMono_Float(pProcessed,
-                                   pInstance->pPSAInput,
-                                   (LVM_INT16)(NrFrames),
-                                   NrChannels);
+                    FromMcToMono_Float(pProcessed,
+                                       pPSAInput,
+                                       (LVM_INT16)(NrFrames),
+                                       NrChannels);
 #else
-                From2iToMono_Float(pProcessed,
-                                   pInstance->pPSAInput,
-                                   (LVM_INT16)(SampleCount));
+                    From2iToMono_Float(pProcessed,
+                                       pPSAInput,
+                                       (LVM_INT16)(SampleCount));
 #endif
 
-                LVPSA_Process(pInstance->hPSAInstance,
-                        pInstance->pPSAInput,
-                        (LVM_UINT16)(SampleCount),
-                        AudioTime);
+                    if (pInstance->pPSARing != LVM_NULL)
+                    {
+                        LVM_PSARingCommit(pInstance, SampleCount, AudioTime);
+                    }
+                    else
+                    {
+                        LVPSA_Process(pInstance->hPSAInstance,
+                                pPSAInput,
+                                (LVM_UINT16)(SampleCount),
+                                AudioTime);
+                        LVM_PSASnapshotPublish(pInstance->pPSASnapshot,
+                                               pInstance->hPSAInstance);
+                    }
+                }
             }
 
             /*
-             * DC removal
+             * Count the denormal samples, before the DC removal which steps them
+             * out of the denormal range
              */
+            if (pInstance->InstParamsEx.DenormalDetect == LVM_MODE_ON)
+            {
 #ifdef SUPPORT_MC
-            DC_Mc_D16_TRC_WRA_01(&pInstance->DC_RemovalInstance,
-                                 pProcessed,
-                                 pProcessed,
-                                 (LVM_INT16)NrFrames,
-                                 NrChannels);
+                Denormals += LVM_CountDenormals_Float(pProcessed, NrChannels * NrFrames);
 #else
-            DC_2I_D16_TRC_WRA_01(&pInstance->DC_RemovalInstance,
-                                 pProcessed,
-                                 pProcessed,
-                                 (LVM_INT16)SampleCount);
+                Denormals += LVM_CountDenormals_Float(pProcessed, 2 * SampleCount);
+#endif
+            }
+
+            /*
+             * DC removal, storing the PCM output of LVM_ProcessPcm or adding the
+             * output in accumulate mode
+             */
+            if (pInstance->pPcmOut != LVM_NULL)
+            {
+#ifdef SUPPORT_MC
+                pInstance->PcmStats.SaturatedSamples +=
+                    DC_Mc_D16_TRC_WRA_01_Pcm(&pInstance->DC_RemovalInstance,
+                                             pProcessed,
+                                             pInstance->pPcmOut,
+                                             pInstance->PcmFormat,
+                                             (LVM_INT16)NrFrames,
+                                             NrChannels);
+#else
+                pInstance->PcmStats.SaturatedSamples +=
+                    DC_2I_D16_TRC_WRA_01_Pcm(&pInstance->DC_RemovalInstance,
+                                             pProcessed,
+                                             pInstance->pPcmOut,
+                                             pInstance->PcmFormat,
+                                             (LVM_INT16)SampleCount);
+#endif
+                pInstance->pPcmOut   = LVM_NULL;
+                pInstance->OutStored = LVM_TRUE;
+            }
+            else if (pInstance->pAccOut != LVM_NULL)
+            {
+#ifdef SUPPORT_MC
+                DC_Mc_D16_TRC_WRA_01_Acc(&pInstance->DC_RemovalInstance,
+                                         pProcessed,
+                                         pInstance->pAccOut,
+                                         (LVM_INT16)NrFrames,
+                                         NrChannels);
+#else
+                DC_2I_D16_TRC_WRA_01_Acc(&pInstance->DC_RemovalInstance,
+                                         pProcessed,
+                                         pInstance->pAccOut,
+                                         (LVM_INT16)SampleCount);
 #endif
+                pInstance->pAccOut   = LVM_NULL;
+                pInstance->OutStored = LVM_TRUE;
+            }
+            else
+            {
+#ifdef SUPPORT_MC
+                DC_Mc_D16_TRC_WRA_01(&pInstance->DC_RemovalInstance,
+                                     pProcessed,
+                                     pProcessed,
+                                     (LVM_INT16)NrFrames,
+                                     NrChannels);
+#else
+                DC_2I_D16_TRC_WRA_01(&pInstance->DC_RemovalInstance,
+                                     pProcessed,
+                                     pProcessed,
+                                     (LVM_INT16)SampleCount);
+#endif
+            }
+
+            if (pMonoInput != LVM_NULL)
+            {
+                pMonoInput += SampleCount;
+            }
         }
         /*
          * Manage the output buffer
@@ -331,6 +574,32 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
 
     }
 
+    /*
+     * Go idle when the input was silent and all the effect tails have decayed
+     */
+    if (SilentInput == LVM_TRUE)
+    {
+        pInstance->SilenceIdle = (LVM_GetTailLevel(pInstance) <= LVM_SILENCE_LEVEL) ?
+                                                                    LVM_TRUE : LVM_FALSE;
+    }
+
+    /*
+     * Update the denormal counters and restore the floating point unit
+     */
+    if (pInstance->InstParamsEx.DenormalDetect == LVM_MODE_ON)
+    {
+        pInstance->DenormalStats.ProcessCalls++;
+        if (Denormals != 0)
+        {
+            pInstance->DenormalStats.DenormalCalls++;
+            pInstance->DenormalStats.DenormalSamples += Denormals;
+        }
+    }
+    if (pInstance->InstParamsEx.DenormalMode == LVM_DENORMAL_FTZ)
+    {
+        LVM_FlushToZeroRestore(FpuState);
+    }
+
     return(LVM_SUCCESS);
 }
 #else
@@ -522,14 +791,30 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
              */
             if ((pInstance->Params.PSA_Enable == LVM_PSA_ON)&&(pInstance->InstParams.PSA_Included==LVM_PSA_ON))
             {
+                LVM_INT16   *pPSAInput = pInstance->pPSAInput;
+
+                if (pInstance->pPSARing != LVM_NULL)
+                {
+                    pPSAInput = LVM_PSARingAcquire(pInstance, SampleCount);
+                }
+                if (pPSAInput != LVM_NULL)
+                {
                     From2iToMono_16(pProcessed,
-                             pInstance->pPSAInput,
+                             pPSAInput,
                             (LVM_INT16) (SampleCount));
 
-                    LVPSA_Process(pInstance->hPSAInstance,
-                            pInstance->pPSAInput,
-                            (LVM_UINT16) (SampleCount),
-                            AudioTime);
+                    if (pInstance->pPSARing != LVM_NULL)
+                    {
+                        LVM_PSARingCommit(pInstance, SampleCount, AudioTime);
+                    }
+                    else
+                    {
+                        LVPSA_Process(pInstance->hPSAInstance,
+                                pPSAInput,
+                                (LVM_UINT16) (SampleCount),
+                                AudioTime);
+                    }
+                }
             }
 
 
@@ -556,3 +841,730 @@ LVM_ReturnStatus_en LVM_Process(LVM_Handle_t                hInstance,
     return(LVM_SUCCESS);
 }
 #endif
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessPlanar                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function for the LifeVibes module with one buffer per channel.              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  ppInData                Pointer to the input channel planes                         */
+/*  ppOutData               Pointer to the output channel planes                        */
+/*  NumSamples              Number of samples per channel in the planes                 */
+/*  AudioTime               Audio Time of the current input buffer in ms                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS            Succeeded                                                    */
+/*  LVM_INVALIDNUMSAMPLES  When the NumSamples is not a valied multiple in unmanaged    */
+/*                         buffer mode                                                  */
+/*  LVM_ALIGNMENTERROR     When either the input our output buffers are not 32-bit      */
+/*                         aligned in unmanaged mode                                    */
+/*  LVM_NULLADDRESS        When one of hInstance, ppInData, ppOutData or a plane is     */
+/*                         NULL                                                         */
+/*  LVM_ALGORITHMDISABLED  When the instance was created without PlanarIO               */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The modules run interleaved, the planes are copied through the planar buffer in  */
+/*     blocks of the internal block size so the module blocks match LVM_Process.        */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessPlanar(LVM_Handle_t              hInstance,
+                                      const LVM_FLOAT * const   *ppInData,
+                                      LVM_FLOAT * const         *ppOutData,
+                                      LVM_UINT16                NumSamples,
+                                      LVM_UINT32                AudioTime)
+{
+    LVM_Instance_t      *pInstance = (LVM_Instance_t  *)hInstance;
+
+    /*
+     * Check if the number of samples is zero
+     */
+    if (NumSamples == 0)
+    {
+        return(LVM_SUCCESS);
+    }
+
+    /*
+     * Check valid points have been given
+     */
+    if ((hInstance == LVM_NULL) || (ppInData == LVM_NULL) || (ppOutData == LVM_NULL))
+    {
+        return (LVM_NULLADDRESS);
+    }
+    if (pInstance->pBlockBuffer == LVM_NULL)
+    {
+        return (LVM_ALGORITHMDISABLED);
+    }
+
+    return LVM_ProcessBlocks(pInstance,
+                             LVM_LAYOUT_PLANAR,
+                             LVM_NULL,
+                             LVM_NULL,
+                             ppInData,
+                             ppOutData,
+                             LVM_PCM_DUMMY,
+                             NumSamples,
+                             AudioTime);
+}
+#endif
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessPcm                                              */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function for the LifeVibes module with interleaved PCM data.                */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  pInData                 Pointer to the input data                                   */
+/*  pOutData                Pointer to the output data                                  */
+/*  PcmFormat               Sample format of the input and output data                  */
+/*  NumSamples              Number of samples in the input buffer                       */
+/*  AudioTime               Audio Time of the current input buffer in ms                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS            Succeeded                                                    */
+/*  LVM_INVALIDNUMSAMPLES  When the NumSamples is not a valied multiple in unmanaged    */
+/*                         buffer mode                                                  */
+/*  LVM_NULLADDRESS        When one of hInstance, pInData or pOutData is NULL           */
+/*  LVM_OUTOFRANGE         When PcmFormat is not supported or the instance was created  */
+/*                         with the LVM_OUTPUT_ACCUMULATE output mode                   */
+/*  LVM_ALGORITHMDISABLED  When the instance was created without PcmIO                  */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Each internal block is converted to float in the block buffer and processed in   */
+/*     place. In unmanaged mode the DC removal stores the PCM output, otherwise (and    */
+/*     for skipped silent blocks) the float output is converted afterwards.             */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessPcm(LVM_Handle_t                 hInstance,
+                                   const void                   *pInData,
+                                   void                         *pOutData,
+                                   LVM_PcmFormat_en             PcmFormat,
+                                   LVM_UINT16                   NumSamples,
+                                   LVM_UINT32                   AudioTime)
+{
+    LVM_Instance_t      *pInstance = (LVM_Instance_t  *)hInstance;
+    LVM_ReturnStatus_en Status;
+    LVM_UINT32          SaturatedBefore;
+
+    /*
+     * Check if the number of samples is zero
+     */
+    if (NumSamples == 0)
+    {
+        return(LVM_SUCCESS);
+    }
+
+    /*
+     * Check valid points have been given
+     */
+    if ((hInstance == LVM_NULL) || (pInData == LVM_NULL) || (pOutData == LVM_NULL))
+    {
+        return (LVM_NULLADDRESS);
+    }
+    if (pInstance->pBlockBuffer == LVM_NULL)
+    {
+        return (LVM_ALGORITHMDISABLED);
+    }
+    if ((LVM_PcmSampleSize(PcmFormat) == 0) ||
+        (pInstance->InstParamsEx.OutputMode == LVM_OUTPUT_ACCUMULATE))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    SaturatedBefore = pInstance->PcmStats.SaturatedSamples;
+    Status = LVM_ProcessBlocks(pInstance,
+                               LVM_LAYOUT_PCM,
+                               pInData,
+                               pOutData,
+                               LVM_NULL,
+                               LVM_NULL,
+                               PcmFormat,
+                               NumSamples,
+                               AudioTime);
+    if (Status != LVM_SUCCESS)
+    {
+        return Status;
+    }
+
+    /*
+     * Update the saturation counters
+     */
+    pInstance->PcmStats.ProcessCalls++;
+    if (pInstance->PcmStats.SaturatedSamples != SaturatedBefore)
+    {
+        pInstance->PcmStats.SaturatedCalls++;
+    }
+
+    return(LVM_SUCCESS);
+}
+#endif
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_ProcessBlocks                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Process function of the planar and PCM buffers and of the accumulate output mode.   */
+/*  The call is split in blocks of the internal block size, each block is converted to  */
+/*  interleaved float, processed by LVM_Process into the block buffer and converted     */
+/*  back to the layout of the output.                                                   */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Instance pointer                                            */
+/*  Layout                  Layout of the input and output buffers                      */
+/*  pInData                 Pointer to the input data, LVM_NULL for the planar layout   */
+/*  pOutData                Pointer to the output data, LVM_NULL for the planar layout  */
+/*  ppInPlanes              Pointers to the input planes of the planar layout           */
+/*  ppOutPlanes             Pointers to the output planes of the planar layout          */
+/*  PcmFormat               Sample format of the PCM layout                             */
+/*  NumSamples              Number of samples per channel                               */
+/*  AudioTime               Audio Time of the current input buffer in ms                */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_SUCCESS            Succeeded                                                    */
+/*  LVM_INVALIDNUMSAMPLES  When the NumSamples is not a valied multiple in unmanaged    */
+/*                         buffer mode                                                  */
+/*  LVM_NULLADDRESS        When a plane is NULL                                         */
+/*  LVM_OUTOFRANGE         When the channel count is not supported                      */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The interleaved layout is only used in the accumulate output mode, the planar    */
+/*     output is accumulated in that mode and the PCM layout does not support it        */
+/*  2. In unmanaged mode the DC removal adds the interleaved output to pOutData or      */
+/*     stores the PCM output, otherwise (and for skipped silent blocks) the block is    */
+/*     converted afterwards                                                             */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_ReturnStatus_en LVM_ProcessBlocks(LVM_Instance_t        *pInstance,
+                                      LVM_Layout_en         Layout,
+                                      const void            *pInData,
+                                      void                  *pOutData,
+                                      const LVM_FLOAT * const *ppInPlanes,
+                                      LVM_FLOAT * const     *ppOutPlanes,
+                                      LVM_PcmFormat_en      PcmFormat,
+                                      LVM_UINT16            NumSamples,
+                                      LVM_UINT32            AudioTime)
+{
+    LVM_ControlParams_t *pParams;
+    const LVM_UINT8     *pInput  = (const LVM_UINT8 *)pInData;
+    LVM_UINT8           *pOutput = (LVM_UINT8 *)pOutData;
+    const LVM_FLOAT     *pInPlane[LVM_MAX_CHANNELS];
+    LVM_FLOAT           *pOutPlane[LVM_MAX_CHANNELS];
+    const LVM_FLOAT     *pBlockIn;
+    LVM_FLOAT           *pBlock = pInstance->pBlockBuffer;
+    LVM_ReturnStatus_en Status;
+    LVM_INT32           SampleSize = sizeof(LVM_FLOAT);
+    LVM_INT32           NrInChannels;
+    LVM_INT32           NrOutChannels;
+    LVM_INT32           ch;
+    LVM_INT32           ii;
+    LVM_UINT16          BlockSize;
+
+    /*
+     * The channel counts follow the parameters LVM_Process is about to apply
+     */
+    pParams = (pInstance->ControlPending == LVM_TRUE) ? &pInstance->NewParams : &pInstance->Params;
+#ifdef SUPPORT_MC
+    NrInChannels  = pParams->NrChannels;
+#else
+    NrInChannels  = 2;
+#endif
+    NrOutChannels = NrInChannels;
+    if (pParams->SourceFormat == LVM_MONO)
+    {
+        NrInChannels  = 1;
+        NrOutChannels = 2;
+    }
+    if ((NrInChannels > LVM_MAX_CHANNELS) || (NrOutChannels > LVM_MAX_CHANNELS))
+    {
+        return (LVM_OUTOFRANGE);
+    }
+
+    if (Layout == LVM_LAYOUT_PLANAR)
+    {
+        for (ch = 0; ch < NrInChannels; ch++)
+        {
+            pInPlane[ch] = ppInPlanes[ch];
+            if (pInPlane[ch] == LVM_NULL)
+            {
+                return (LVM_NULLADDRESS);
+            }
+        }
+        for (ch = 0; ch < NrOutChannels; ch++)
+        {
+            pOutPlane[ch] = ppOutPlanes[ch];
+            if (pOutPlane[ch] == LVM_NULL)
+            {
+                return (LVM_NULLADDRESS);
+            }
+        }
+    }
+    else if (Layout == LVM_LAYOUT_PCM)
+    {
+        SampleSize = LVM_PcmSampleSize(PcmFormat);
+    }
+
+    /*
+     * Check the block multiple of the whole call, the blocks below keep it
+     */
+    if ((pInstance->InstParams.BufferMode == LVM_UNMANAGED_BUFFERS) &&
+        ((NumSamples % pInstance->BlickSizeMultiple) != 0))
+    {
+        return(LVM_INVALIDNUMSAMPLES);
+    }
+
+    /*
+     * Process in blocks of the internal block size
+     */
+    while (NumSamples > 0)
+    {
+        BlockSize = NumSamples;
+        if (BlockSize > (LVM_UINT16)pInstance->InternalBlockSize)
+        {
+            BlockSize = (LVM_UINT16)pInstance->InternalBlockSize;
+        }
+
+        pBlockIn = pBlock;
+        if (Layout == LVM_LAYOUT_INTERLEAVED)
+        {
+            pBlockIn = (const LVM_FLOAT *)pInput;
+        }
+        else if (Layout == LVM_LAYOUT_PLANAR)
+        {
+            Copy_Float_Planar_Mc(pInPlane,                      /* Source */
+                                 pBlock,                        /* Destination */
+                                 (LVM_INT16)BlockSize,          /* Number of frames */
+                                 NrInChannels);
+        }
+        else
+        {
+            LVM_PcmToFloat(pInput,                              /* Source */
+                           pBlock,                              /* Destination */
+                           NrInChannels * BlockSize,            /* Number of samples */
+                           PcmFormat);
+        }
+
+        /*
+         * The block is a single internal block, in unmanaged mode its interleaved
+         * output is stored by the DC removal. A reinitialisation by the new settings
+         * clears the output pointers and the block is stored below.
+         */
+        pInstance->pAccOut   = LVM_NULL;
+        pInstance->pPcmOut   = LVM_NULL;
+        pInstance->PcmFormat = PcmFormat;
+        pInstance->OutStored = LVM_FALSE;
+        if (pInstance->InstParams.BufferMode == LVM_UNMANAGED_BUFFERS)
+        {
+            if (Layout == LVM_LAYOUT_INTERLEAVED)
+            {
+                pInstance->pAccOut = (LVM_FLOAT *)pOutput;
+            }
+            else if (Layout == LVM_LAYOUT_PCM)
+            {
+                pInstance->pPcmOut = pOutput;
+            }
+        }
+        Status = LVM_Process((LVM_Handle_t)pInstance,
+                             pBlockIn,
+                             pBlock,
+                             BlockSize,
+                             AudioTime);
+        if (Status != LVM_SUCCESS)
+        {
+            pInstance->pAccOut = LVM_NULL;
+            pInstance->pPcmOut = LVM_NULL;
+            return Status;
+        }
+        if (pInstance->OutStored == LVM_FALSE)
+        {
+            if (Layout == LVM_LAYOUT_INTERLEAVED)
+            {
+                Add2_Float(pBlock,                                  /* Source */
+                           (LVM_FLOAT *)pOutput,                    /* Destination */
+                           (LVM_INT16)(NrOutChannels * BlockSize)); /* Number of samples */
+            }
+            else if ((Layout == LVM_LAYOUT_PLANAR) &&
+                     (pInstance->InstParamsEx.OutputMode == LVM_OUTPUT_ACCUMULATE))
+            {
+                for (ch = 0; ch < NrOutChannels; ch++)
+                {
+                    for (ii = 0; ii < BlockSize; ii++)
+                    {
+                        pOutPlane[ch][ii] += pBlock[ii * NrOutChannels + ch];
+                    }
+                }
+            }
+            else if (Layout == LVM_LAYOUT_PLANAR)
+            {
+                Copy_Float_Mc_Planar(pBlock,                        /* Source */
+                                     pOutPlane,                     /* Destination */
+                                     (LVM_INT16)BlockSize,          /* Number of frames */
+                                     NrOutChannels);
+            }
+            else
+            {
+                pInstance->PcmStats.SaturatedSamples +=
+                    LVM_FloatToPcm(pBlock,                          /* Source */
+                                   pOutput,                         /* Destination */
+                                   NrOutChannels * BlockSize,       /* Number of samples */
+                                   PcmFormat);
+            }
+            pInstance->pAccOut = LVM_NULL;
+            pInstance->pPcmOut = LVM_NULL;
+        }
+
+        if (Layout == LVM_LAYOUT_PLANAR)
+        {
+            for (ch = 0; ch < NrInChannels; ch++)
+            {
+                pInPlane[ch] += BlockSize;
+            }
+            for (ch = 0; ch < NrOutChannels; ch++)
+            {
+                pOutPlane[ch] += BlockSize;
+            }
+        }
+        else
+        {
+            pInput  += NrInChannels * BlockSize * SampleSize;
+            pOutput += NrOutChannels * BlockSize * SampleSize;
+        }
+        NumSamples = (LVM_UINT16)(NumSamples - BlockSize);
+    }
+
+    return(LVM_SUCCESS);
+}
+#endif
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_GetTailLevel                                            */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Get the peak level of the output the active effects still produce from a silent    */
+/*  input. This is the peak level of the filter and delay line histories, full scale    */
+/*  (1.0) is returned while a mixer ramp or module transition is in progress.           */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Instance pointer                                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  The tail level                                                                      */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. The DC removal limit cycle is not a tail, full scale is returned until the DC    */
+/*     level has settled below LVM_SILENCE_DC_LEVEL                                     */
+/*  2. The deferred Spectrum Analyzer is left out, it runs on the analysis thread       */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_FLOAT LVM_GetTailLevel(LVM_Instance_t      *pInstance)
+{
+    LVM_FLOAT           Level;
+    LVM_FLOAT           TailLevel   = 0.0f;
+#ifdef SUPPORT_MC
+    LVM_INT16           NrChannels  = pInstance->NrChannels;
+
+    if (pInstance->Params.SourceFormat == LVM_MONO)
+    {
+        NrChannels = 2;
+    }
+#endif
+
+    /*
+     * Volume and balance mixers
+     */
+    if (((pInstance->VC_Active != 0) &&
+         (LVC_Mixer_IsSteady(&pInstance->VC_Volume.MixerStream[0]) == LVM_FALSE)) ||
+        (LVC_Mixer_IsSteady(&pInstance->VC_BalanceMix.MixerStream[0]) == LVM_FALSE) ||
+        (LVC_Mixer_IsSteady(&pInstance->VC_BalanceMix.MixerStream[1]) == LVM_FALSE))
+    {
+        return 1.0f;
+    }
+
+    /*
+     * DC removal
+     */
+#ifdef SUPPORT_MC
+    if (DC_Mc_D16_TRC_WRA_01_GetLevel(&pInstance->DC_RemovalInstance,
+                                      NrChannels) > LVM_SILENCE_DC_LEVEL)
+#else
+    if (DC_2I_D16_TRC_WRA_01_GetLevel(&pInstance->DC_RemovalInstance) > LVM_SILENCE_DC_LEVEL)
+#endif
+    {
+        return 1.0f;
+    }
+
+    /*
+     * Effect modules
+     */
+    if (pInstance->CS_Active == LVM_TRUE)
+    {
+        (void)LVCS_GetTailLevel(pInstance->hCSInstance, &Level);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if ((pInstance->pCascade != LVM_NULL) &&
+        (pInstance->pCascade->NrSections != 0))
+    {
+        LVM_Cascade_t   *pCascade = pInstance->pCascade;
+        LVM_INT16       ch;
+
+        for (ch = 0; ch < pCascade->NrChannels; ch++)
+        {
+            Level = PeakAbs_Float(&pCascade->pHistory[ch * 2 * (pCascade->MaxSections + 1)],
+                                  (LVM_INT16)(2 * (pCascade->NrSections + 1)));
+            if (Level > TailLevel)
+            {
+                TailLevel = Level;
+            }
+        }
+    }
+    else if (pInstance->EQNB_Active == LVM_TRUE)
+    {
+        (void)LVEQNB_GetTailLevel(pInstance->hEQNBInstance, &Level);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if (pInstance->DBE_Active == LVM_TRUE)
+    {
+        (void)LVDBE_GetTailLevel(pInstance->hDBEInstance, &Level);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if ((pInstance->TE_Active == LVM_TRUE) &&
+        ((pInstance->pCascade == LVM_NULL) ||
+         (pInstance->pCascade->TE_Merged == LVM_FALSE)))
+    {
+#ifdef SUPPORT_MC
+        Level = PeakAbs_Float(pInstance->pTE_Taps->TrebleBoost_Taps.Storage, 2 * NrChannels);
+#else
+        Level = PeakAbs_Float(pInstance->pTE_Taps->TrebleBoost_Taps.Storage, 2 * 2);
+#endif
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if ((pInstance->Params.PSA_Enable == LVM_PSA_ON) &&
+        (pInstance->InstParams.PSA_Included == LVM_PSA_ON) &&
+        (pInstance->pPSARing == LVM_NULL))
+    {
+        (void)LVPSA_GetTailLevel(pInstance->hPSAInstance, &Level);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+
+    return TailLevel;
+}
+#endif
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_PSARingAcquire                                          */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Get the ring space of the next block of the deferred Spectrum Analyzer. The block   */
+/*  is written by the caller and then published with LVM_PSARingCommit.                */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Instance pointer                                            */
+/*  SampleCount             Number of mono samples in the block                         */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  Pointer to the block samples, LVM_NULL when the ring is full                        */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Only called by LVM_Process, the single producer of the ring                      */
+/*                                                                                      */
+/****************************************************************************************/
+void *LVM_PSARingAcquire(LVM_Instance_t     *pInstance,
+                         LVM_UINT16         SampleCount)
+{
+    LVM_PSA_Ring_t      *pRing = pInstance->pPSARing;
+    LVM_UINT32          WriteBlock;
+    LVM_UINT32          ReadBlock;
+    LVM_UINT32          Start;
+
+    /*
+     * The acquire load orders the analyser's reads of the released blocks before
+     * their samples are overwritten
+     */
+    WriteBlock = atomic_load_explicit(&pRing->WriteBlock, memory_order_relaxed);
+    ReadBlock  = atomic_load_explicit(&pRing->ReadBlock, memory_order_acquire);
+
+    /*
+     * Blocks are never split, start at the beginning when the end is too close
+     */
+    Start = pRing->WriteSample;
+    if (((Start & (LVM_PSA_RING_SAMPLES - 1)) + SampleCount) > LVM_PSA_RING_SAMPLES)
+    {
+        Start = (Start + LVM_PSA_RING_SAMPLES - 1) & ~(LVM_UINT32)(LVM_PSA_RING_SAMPLES - 1);
+    }
+
+    /*
+     * The space used runs from the first sample of the oldest unread block
+     */
+    if (((WriteBlock - ReadBlock) == LVM_PSA_RING_BLOCKS) ||
+        ((WriteBlock != ReadBlock) &&
+         ((Start + SampleCount - pRing->Blocks[ReadBlock & (LVM_PSA_RING_BLOCKS - 1)].Start) >
+          LVM_PSA_RING_SAMPLES)))
+    {
+        atomic_fetch_add_explicit(&pRing->DroppedSamples, SampleCount, memory_order_relaxed);
+        return LVM_NULL;
+    }
+
+    pRing->Blocks[WriteBlock & (LVM_PSA_RING_BLOCKS - 1)].Start = Start;
+
+    return &pRing->Samples[Start & (LVM_PSA_RING_SAMPLES - 1)];
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_PSARingCommit                                           */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Publish the block written after LVM_PSARingAcquire to the deferred Spectrum         */
+/*  Analyzer, together with the current analyser settings.                              */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Instance pointer                                            */
+/*  SampleCount             Number of mono samples in the block                         */
+/*  AudioTime               Audio time given to LVM_Process                             */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Only called by LVM_Process, the single producer of the ring                      */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_PSARingCommit(LVM_Instance_t       *pInstance,
+                       LVM_UINT16           SampleCount,
+                       LVM_UINT32           AudioTime)
+{
+    LVM_PSA_Ring_t          *pRing = pInstance->pPSARing;
+    LVM_UINT32              WriteBlock;
+    LVM_PSA_RingBlock_t     *pBlock;
+
+    WriteBlock = atomic_load_explicit(&pRing->WriteBlock, memory_order_relaxed);
+    pBlock     = &pRing->Blocks[WriteBlock & (LVM_PSA_RING_BLOCKS - 1)];
+
+    pBlock->hPSAInstance  = pInstance->hPSAInstance;
+    pBlock->AudioTime     = AudioTime;
+    pBlock->SampleCount   = SampleCount;
+    pBlock->SampleRate    = pInstance->Params.SampleRate;
+    pBlock->PeakDecayRate = pInstance->Params.PSA_PeakDecayRate;
+    pRing->WriteSample    = pBlock->Start + SampleCount;
+
+    /*
+     * The release store publishes the samples and the block
+     */
+    atomic_store_explicit(&pRing->WriteBlock, WriteBlock + 1, memory_order_release);
+}
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVM_PSASnapshotPublish                                      */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Take the spectrum entries written by the last call to the Spectrum Analyzer, update */
+/*  the peaks with them and publish the levels of the last entry as a new snapshot.     */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pSnapshot               Pointer to the snapshots                                    */
+/*  hPSAInstance            Spectrum Analyzer that wrote the entries                    */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1. Only called by the thread running the Spectrum Analyzer, after LVPSA_Process     */
+/*  2. Nothing is published when the analyser wrote no entry                            */
+/*                                                                                      */
+/****************************************************************************************/
+void LVM_PSASnapshotPublish(LVM_PSA_Snapshot_t  *pSnapshot,
+                            pLVPSA_Handle_t     hPSAInstance)
+{
+    LVPSA_InstancePr_t      *pPSA = (LVPSA_InstancePr_t *)hPSAInstance;
+    LVM_PSA_SnapshotSlot_t  *pSlot;
+    LVM_FLOAT               *pEntry = LVM_NULL;
+    LVM_UINT16              nBands = pPSA->nBands;
+    LVM_UINT32              WriteEntry;
+    LVM_UINT32              Number;
+    LVM_UINT32              Slot;
+    LVM_UINT16              ii;
+
+    WriteEntry = (LVM_UINT32)(pPSA->pSpectralDataBufferWritePointer -
+                              pPSA->pSpectralDataBufferStart) / nBands;
+    if (pSnapshot->ReadEntry >= pPSA->SpectralDataBufferLength)
+    {
+        pSnapshot->ReadEntry = 0;
+    }
+    if (pSnapshot->ReadEntry == WriteEntry)
+    {
+        return;
+    }
+
+    /*
+     * The peaks decay once per entry, the snapshot holds the levels of the last one
+     */
+    while (pSnapshot->ReadEntry != WriteEntry)
+    {
+        pEntry = pPSA->pSpectralDataBufferStart + pSnapshot->ReadEntry * nBands;
+        for (ii = 0; ii < nBands; ii++)
+        {
+            pSnapshot->pPeaks[ii] = LVPSA_UpdatePeak(pSnapshot->pPeaks[ii], LVPSA_LEVEL_BYTE(pEntry[ii]));
+        }
+        pSnapshot->ReadEntry++;
+        if (pSnapshot->ReadEntry == pPSA->SpectralDataBufferLength)
+        {
+            pSnapshot->ReadEntry = 0;
+        }
+    }
+
+    /*
+     * The odd sequence and the release fence mark the slot as being written before
+     * any of its levels change
+     */
+    Number = atomic_load_explicit(&pSnapshot->Published, memory_order_relaxed) + 1;
+    Slot   = Number & (LVM_PSA_SNAPSHOT_SLOTS - 1);
+    pSlot  = &pSnapshot->Slots[Slot];
+    atomic_store_explicit(&pSnapshot->Sequence[Slot], 2 * Number - 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&pSlot->AudioTime, (LVM_INT32)pPSA->SpectralDataBufferAudioTime,
+                          memory_order_relaxed);
+    atomic_store_explicit(&pSlot->NrBands, nBands, memory_order_relaxed);
+    for (ii = 0; ii < nBands; ii++)
+    {
+        atomic_store_explicit(&pSlot->pCurrentLevels[ii],
+                              pSnapshot->LevelTable[LVPSA_LEVEL_BYTE(pEntry[ii])],
+                              memory_order_relaxed);
+        atomic_store_explicit(&pSlot->pPeakLevels[ii],
+                              pSnapshot->LevelTable[pSnapshot->pPeaks[ii]],
+                              memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&pSnapshot->Sequence[Slot], 2 * Number, memory_order_release);
+    atomic_store_explicit(&pSnapshot->Published, Number, memory_order_release);
+}
+#endif
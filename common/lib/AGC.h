@@ -86,6 +86,7 @@ void AGC_MIX_VOL_Mc1Mon_D32_WRA(AGC_MIX_VOL_2St1Mon_FLOAT_t  *pInstance,  /* Ins
                                  LVM_UINT16                 NrFrames,     /* Number of frames */
                                  LVM_UINT16                 NrChannels);  /* Number of channels */
 #endif
+LVM_INT16 AGC_MIX_VOL_IsSteady(const AGC_MIX_VOL_2St1Mon_FLOAT_t *pInstance); /* Instance pointer */
 
 #else
 void AGC_MIX_VOL_2St1Mon_D32_WRA(AGC_MIX_VOL_2St1Mon_D32_t  *pInstance,     /* Instance pointer */
@@ -549,7 +549,7 @@ void PK_2I_D32F32C30G11_TRC_WRA_01 (        Biquad_Instance_t       *pInstance,
 #ifdef BUILD_FLOAT
 void PK_2I_D32F32CssGss_TRC_WRA_01_Init (   Biquad_FLOAT_Instance_t       *pInstance,
                                             Biquad_2I_Order2_FLOAT_Taps_t *pTaps,
-                                            PK_FLOAT_Coefs_t          *pCoef);
+                                            const PK_FLOAT_Coefs_t    *pCoef);
 #else
 void PK_2I_D32F32CssGss_TRC_WRA_01_Init (   Biquad_Instance_t       *pInstance,
                                             Biquad_2I_Order2_Taps_t *pTaps,
@@ -588,6 +588,22 @@ void DC_Mc_D16_TRC_WRA_01          (        Biquad_FLOAT_Instance_t       *pInst
                                             LVM_FLOAT               *pDataOut,
                                             LVM_INT16               NrFrames,
                                             LVM_INT16               NrChannels);
+
+LVM_FLOAT DC_Mc_D16_TRC_WRA_01_GetLevel(    Biquad_FLOAT_Instance_t       *pInstance,
+                                            LVM_INT16               NrChannels);
+
+LVM_UINT32 DC_Mc_D16_TRC_WRA_01_Pcm   (     Biquad_FLOAT_Instance_t       *pInstance,
+                                            LVM_FLOAT               *pDataIn,
+                                            void                    *pDataOut,
+                                            LVM_PcmFormat_en        PcmFormat,
+                                            LVM_INT16               NrFrames,
+                                            LVM_INT16               NrChannels);
+
+void DC_Mc_D16_TRC_WRA_01_Acc      (        Biquad_FLOAT_Instance_t       *pInstance,
+                                            LVM_FLOAT               *pDataIn,
+                                            LVM_FLOAT               *pDataOut,
+                                            LVM_INT16               NrFrames,
+                                            LVM_INT16               NrChannels);
 #else
 void DC_2I_D16_TRC_WRA_01_Init     (        Biquad_FLOAT_Instance_t       *pInstance);
 
@@ -595,6 +611,19 @@ void DC_2I_D16_TRC_WRA_01          (        Biquad_FLOAT_Instance_t       *pInst
                                             LVM_FLOAT               *pDataIn,
                                             LVM_FLOAT               *pDataOut,
                                             LVM_INT16               NrSamples);
+
+LVM_FLOAT DC_2I_D16_TRC_WRA_01_GetLevel(    Biquad_FLOAT_Instance_t       *pInstance);
+
+LVM_UINT32 DC_2I_D16_TRC_WRA_01_Pcm   (     Biquad_FLOAT_Instance_t       *pInstance,
+                                            LVM_FLOAT               *pDataIn,
+                                            void                    *pDataOut,
+                                            LVM_PcmFormat_en        PcmFormat,
+                                            LVM_INT16               NrSamples);
+
+void DC_2I_D16_TRC_WRA_01_Acc      (        Biquad_FLOAT_Instance_t       *pInstance,
+                                            LVM_FLOAT               *pDataIn,
+                                            LVM_FLOAT               *pDataOut,
+                                            LVM_INT16               NrSamples);
 #endif
 #else
 void DC_2I_D16_TRC_WRA_01_Init     (        Biquad_Instance_t       *pInstance);
@@ -62,6 +62,21 @@ void   InstAlloc_Init( INST_ALLOC *pms, void *StartAddr );
 
 void* InstAlloc_AddMember( INST_ALLOC *pms, LVM_UINT32 Size );
 
+/****************************************************************************************
+ *  Name        : InstAlloc_AddMemberAligned()
+ *  Input       : pms   - Pointer to the INST_ALLOC instance
+                  Size  - The size in bytes of the new added member
+                  Align - The alignment in bytes of the new member, a power of two of
+                          at least four
+ *  Returns     : A pointer to the new added member
+ *  Description : Allocates space for a new member as InstAlloc_AddMember does, with the
+                  start address of the member a multiple of Align.
+ *  Remarks     : The largest padding is added to the total size, so the size does not
+                  depend on the base address of the instance memory
+ ****************************************************************************************/
+
+void* InstAlloc_AddMemberAligned( INST_ALLOC *pms, LVM_UINT32 Size, LVM_UINT32 Align );
+
 /****************************************************************************************
  *  Name        : InstAlloc_GetTotal()
  *  Input       : pms  - Pointer to the INST_ALLOC instance
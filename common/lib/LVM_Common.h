@@ -37,6 +37,7 @@ extern "C" {
 /*  Includes                                                                            */
 /*                                                                                      */
 /****************************************************************************************/
+#include <math.h>
 #include "LVM_Types.h"
 
 
@@ -53,6 +54,116 @@ extern "C" {
 #define ALGORITHM_VC_ID        0x0500
 #define ALGORITHM_TE_ID        0x0600
 
+#ifdef BUILD_FLOAT
+/* Byte positions of a packed 24-bit sample */
+#if defined(HAVE_BIG_ENDIAN) && HAVE_BIG_ENDIAN
+#define LVM_P24_LSB            2
+#define LVM_P24_MSB            0
+#else
+#define LVM_P24_LSB            0
+#define LVM_P24_MSB            2
+#endif
+
+/*
+ * Store a float sample at Index of a PCM buffer and count it in Saturated when it is
+ * clipped. The rounding and clipping match the audio_utils memcpy_to_*_from_float
+ * conversions, 0.5 lsb is rounded away from zero.
+ */
+#define LVM_PCM_STORE(pPcm, Index, Format, Val, Saturated)                               \
+    {                                                                                   \
+        LVM_FLOAT Scaled_;                                                              \
+        LVM_INT32 Pcm_;                                                                 \
+        switch (Format)                                                                 \
+        {                                                                               \
+        case LVM_PCM_16BIT:                                                             \
+            Scaled_ = (Val) * 32768.0f;                                                 \
+            if ((Scaled_ > 32767.0f) || (Scaled_ < -32768.0f))                          \
+            {                                                                           \
+                (Saturated)++;                                                          \
+            }                                                                           \
+            ((LVM_INT16 *)(pPcm))[Index] =                                              \
+                (LVM_INT16)roundf(fmaxf(fminf(Scaled_, 32767.0f), -32768.0f));          \
+            break;                                                                      \
+        case LVM_PCM_32BIT:                                                             \
+            if ((Val) >= 1.0f)                                                          \
+            {                                                                           \
+                Pcm_ = 0x7fffffff;                                                      \
+                (Saturated)++;                                                          \
+            }                                                                           \
+            else if ((Val) <= -1.0f)                                                    \
+            {                                                                           \
+                Pcm_ = (LVM_INT32)0x80000000;                                           \
+                if ((Val) < -1.0f)                                                      \
+                {                                                                       \
+                    (Saturated)++;                                                      \
+                }                                                                       \
+            }                                                                           \
+            else                                                                        \
+            {                                                                           \
+                Scaled_ = (Val) * 2147483648.0f;                                        \
+                Pcm_ = (LVM_INT32)((Scaled_ > 0) ? Scaled_ + 0.5 : Scaled_ - 0.5);      \
+            }                                                                           \
+            ((LVM_INT32 *)(pPcm))[Index] = Pcm_;                                        \
+            break;                                                                      \
+        default:                                                                        \
+            Scaled_ = (Val) * 8388608.0f;                                               \
+            if ((Scaled_ > 8388607.0f) || (Scaled_ < -8388608.0f))                      \
+            {                                                                           \
+                (Saturated)++;                                                          \
+            }                                                                           \
+            Pcm_ = (LVM_INT32)roundf(fmaxf(fminf(Scaled_, 8388607.0f), -8388608.0f));   \
+            ((LVM_UINT8 *)(pPcm))[3 * (Index) + LVM_P24_LSB] = (LVM_UINT8)Pcm_;         \
+            ((LVM_UINT8 *)(pPcm))[3 * (Index) + 1] = (LVM_UINT8)(Pcm_ >> 8);            \
+            ((LVM_UINT8 *)(pPcm))[3 * (Index) + LVM_P24_MSB] = (LVM_UINT8)(Pcm_ >> 16); \
+            break;                                                                      \
+        }                                                                               \
+    }
+#endif
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/*  Function Prototypes                                                                 */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVM_INT16 LVM_FsBankSize(LVM_UINT32         BankRates);
+
+LVM_INT16 LVM_FsBankIndex(LVM_UINT32        BankRates,
+                          LVM_Fs_en         Fs);
+
+LVM_INT16 LVM_FsBankSwitch(LVM_UINT32       BankRates,
+                           LVM_Fs_en        FromFs,
+                           LVM_Fs_en        ToFs);
+
+LVM_UINT32 LVM_FlushToZeroSet(void);
+
+void LVM_FlushToZeroRestore(LVM_UINT32      State);
+
+#ifdef BUILD_FLOAT
+LVM_UINT32 LVM_CountDenormals_Float(const LVM_FLOAT *src,
+                                    LVM_INT32       n);
+
+LVM_INT32 LVM_DenormalOffset_Float(const LVM_FLOAT   *src,
+                                   LVM_FLOAT         *dst,
+                                   LVM_INT32         NrFrames,
+                                   LVM_INT32         NrChannels,
+                                   LVM_FLOAT         Offset,
+                                   LVM_INT32         Phase);
+
+LVM_INT32 LVM_PcmSampleSize(LVM_PcmFormat_en   Format);
+
+void LVM_PcmToFloat(const void          *src,
+                    LVM_FLOAT           *dst,
+                    LVM_INT32           n,
+                    LVM_PcmFormat_en    Format);
+
+LVM_UINT32 LVM_FloatToPcm(const LVM_FLOAT  *src,
+                          void             *dst,
+                          LVM_INT32        n,
+                          LVM_PcmFormat_en Format);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
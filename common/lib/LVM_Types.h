@@ -157,6 +157,16 @@ typedef enum
 } LVM_Format_en;
 
 
+/* PCM sample formats */
+typedef enum
+{
+    LVM_PCM_16BIT           = 0,                    /* Q0.15 in 16 bits */
+    LVM_PCM_32BIT           = 1,                    /* Q0.31 in 32 bits */
+    LVM_PCM_PACKED_24BIT    = 2,                    /* Q0.23 in 3 bytes, native byte order */
+    LVM_PCM_DUMMY           = LVM_MAXENUM
+} LVM_PcmFormat_en;
+
+
 /* LVM sampling rates */
 typedef enum
 {
@@ -179,6 +189,10 @@ typedef enum
     LVM_FS_DUMMY = LVM_MAXENUM
 } LVM_Fs_en;
 
+/* Sample rate sets for coefficient banks, one bit per sampling rate */
+#define LVM_FS_BANK(Fs)         ((LVM_UINT32)1 << (Fs))
+#define LVM_FS_BANK_NONE        0
+
 
 /* Memory Types */
 typedef enum
@@ -25,6 +25,18 @@ extern "C" {
 
 #include "LVM_Types.h"
 
+/**********************************************************************************
+    VECTOR TYPES
+***********************************************************************************/
+
+#if defined(BUILD_FLOAT) && defined(__GNUC__)
+/* Four lanes, the size of the SSE and NEON registers. The alignment is the one of the
+   LVM_FLOAT arrays, so any array of a multiple of four values can be accessed as vectors */
+typedef LVM_FLOAT LVM_FloatVector_t __attribute__((vector_size(4 * sizeof(LVM_FLOAT)),
+                                                   aligned(sizeof(LVM_FLOAT))));
+#define LVM_FLOAT_VECTOR_LANES      4
+#endif
+
 /**********************************************************************************
     VARIOUS FUNCTIONS
 ***********************************************************************************/
@@ -57,12 +69,25 @@ void Copy_Float_Stereo_Mc(       const LVM_FLOAT *src,
                                  LVM_INT16 NrFrames,
                                  LVM_INT32 NrChannels);
 #endif
+void Copy_Float_Planar_Mc(       const LVM_FLOAT * const *src,
+                                 LVM_FLOAT *dst,
+                                 LVM_INT16 NrFrames,
+                                 LVM_INT32 NrChannels);
+void Copy_Float_Mc_Planar(       const LVM_FLOAT *src,
+                                 LVM_FLOAT * const *dst,
+                                 LVM_INT16 NrFrames,
+                                 LVM_INT32 NrChannels);
 #else
 void Copy_16(                 const LVM_INT16 *src,
                                     LVM_INT16 *dst,
                                     LVM_INT16 n );
 #endif
 
+#ifdef BUILD_FLOAT
+LVM_FLOAT PeakAbs_Float(         const LVM_FLOAT *src,
+                                 LVM_INT32 n );
+#endif
+
 /*********************************************************************************
  * note: In Mult3s_16x16() saturation of result is not taken care when           *
  *       overflow occurs.                                                        *
@@ -119,6 +144,9 @@ void DelayWrite_32(           const LVM_INT32  *src,               /* Source 1,
 void Add2_Sat_Float(          const LVM_FLOAT *src,
                               LVM_FLOAT *dst,
                               LVM_INT16 n );
+void Add2_Float(              const LVM_FLOAT *src,
+                              LVM_FLOAT *dst,
+                              LVM_INT16 n );
 #else
 void Add2_Sat_16x16(          const LVM_INT16 *src,
                                     LVM_INT16 *dst,
@@ -36,6 +36,7 @@
 #ifdef BUILD_FLOAT
 #define VOL_TC_FLOAT                                      2.0f          /* As a power of 2 */
 #define DECAY_FAC_FLOAT                                  64.0f          /* As a power of 2 */
+#define VOL_STEADY_FLOAT                               1.0e-6f          /* Volume error of a settled volume */
 #endif
 
 /****************************************************************************************/
@@ -451,4 +452,35 @@ void AGC_MIX_VOL_Mc1Mon_D32_WRA(AGC_MIX_VOL_2St1Mon_FLOAT_t  *pInstance,
     return;
 }
 #endif /*SUPPORT_MC*/
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                  AGC_MIX_VOL_IsSteady                                      */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Checks whether the volume has settled on its target and the AGC gain has recovered  */
+/*  to its maximum. The gains of a steady instance no longer change with a silent input */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Instance pointer                                            */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVM_TRUE                The gains are steady                                        */
+/*  LVM_FALSE               The volume or AGC gain is still changing                    */
+/*                                                                                      */
+/****************************************************************************************/
+LVM_INT16 AGC_MIX_VOL_IsSteady(const AGC_MIX_VOL_2St1Mon_FLOAT_t *pInstance)
+{
+    LVM_FLOAT      AGC_Decay     = (pInstance->AGC_Decay * (1 << (DECAY_SHIFT)));
+
+    if (pInstance->AGC_Gain < (pInstance->AGC_MaxGain - AGC_Decay))
+    {
+        return LVM_FALSE;
+    }
+    if (Abs_Float(pInstance->Target - pInstance->Volume) > VOL_STEADY_FLOAT)
+    {
+        return LVM_FALSE;
+    }
+    return LVM_TRUE;
+}
 #endif /*BUILD_FLOAT*/
@@ -85,5 +85,19 @@ void Add2_Sat_Float( const LVM_FLOAT  *src,
     }
     return;
 }
+
+void Add2_Float(     const LVM_FLOAT  *src,
+                           LVM_FLOAT  *dst,
+                           LVM_INT16  n )
+{
+    LVM_INT16 ii;
+    for (ii = n; ii != 0; ii--)
+    {
+        *dst += *src;
+        src++;
+        dst++;
+    }
+    return;
+}
 #endif
 /**********************************************************************************/
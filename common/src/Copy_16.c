@@ -144,5 +144,72 @@ void Copy_Float_Stereo_Mc(const LVM_FLOAT *src,
     }
 }
 #endif
+
+// Interleave the channel planes of src to dst.
+void Copy_Float_Planar_Mc(const LVM_FLOAT * const *src,
+                 LVM_FLOAT *dst,
+                 LVM_INT16 NrFrames, /* Number of frames */
+                 LVM_INT32 NrChannels)
+{
+    LVM_INT16 ii;
+    LVM_INT32 jj;
+
+    if (NrChannels == 2)
+    {
+        const LVM_FLOAT *srcL = src[0];
+        const LVM_FLOAT *srcR = src[1];
+        for (ii = 0; ii < NrFrames; ii++)
+        {
+            dst[2 * ii]     = srcL[ii];
+            dst[2 * ii + 1] = srcR[ii];
+        }
+    }
+    else
+    {
+        // one channel at a time, each plane is read sequentially
+        for (jj = 0; jj < NrChannels; jj++)
+        {
+            const LVM_FLOAT *srcCh = src[jj];
+            LVM_FLOAT *dstCh = dst + jj;
+            for (ii = 0; ii < NrFrames; ii++)
+            {
+                dstCh[ii * NrChannels] = srcCh[ii];
+            }
+        }
+    }
+}
+
+// Deinterleave src to the channel planes of dst.
+void Copy_Float_Mc_Planar(const LVM_FLOAT *src,
+                 LVM_FLOAT * const *dst,
+                 LVM_INT16 NrFrames, /* Number of frames */
+                 LVM_INT32 NrChannels)
+{
+    LVM_INT16 ii;
+    LVM_INT32 jj;
+
+    if (NrChannels == 2)
+    {
+        LVM_FLOAT *dstL = dst[0];
+        LVM_FLOAT *dstR = dst[1];
+        for (ii = 0; ii < NrFrames; ii++)
+        {
+            dstL[ii] = src[2 * ii];
+            dstR[ii] = src[2 * ii + 1];
+        }
+    }
+    else
+    {
+        for (jj = 0; jj < NrChannels; jj++)
+        {
+            const LVM_FLOAT *srcCh = src + jj;
+            LVM_FLOAT *dstCh = dst[jj];
+            for (ii = 0; ii < NrFrames; ii++)
+            {
+                dstCh[ii] = srcCh[ii * NrChannels];
+            }
+        }
+    }
+}
 #endif
 /**********************************************************************************/
@@ -17,7 +17,10 @@
 
 #include "BIQUAD.h"
 #include "DC_2I_D16_TRC_WRA_01_Private.h"
+#include "ScalarArithmetic.h"
+#include "VectorArithmetic.h"
 #include "LVM_Macros.h"
+#include "LVM_Common.h"
 #ifdef BUILD_FLOAT
 void DC_2I_D16_TRC_WRA_01( Biquad_FLOAT_Instance_t       *pInstance,
                            LVM_FLOAT               *pDataIn,
@@ -63,6 +66,153 @@ void DC_2I_D16_TRC_WRA_01( Biquad_FLOAT_Instance_t       *pInstance,
         pBiquadState->RightDC = RightDC;
 
 
+    }
+/*
+ * FUNCTION:       DC_2I_D16_TRC_WRA_01_GetLevel
+ *
+ * DESCRIPTION:
+ *  Get the largest absolute DC level removed from the left and right channels
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *
+ * RETURNS:
+ *  The DC level
+ *
+ */
+LVM_FLOAT DC_2I_D16_TRC_WRA_01_GetLevel(Biquad_FLOAT_Instance_t       *pInstance)
+    {
+        PFilter_FLOAT_State pBiquadState = (PFilter_FLOAT_State) pInstance;
+        LVM_FLOAT LeftDC  = Abs_Float(pBiquadState->LeftDC);
+        LVM_FLOAT RightDC = Abs_Float(pBiquadState->RightDC);
+
+        return (LeftDC > RightDC) ? LeftDC : RightDC;
+    }
+/*
+ * FUNCTION:       DC_2I_D16_TRC_WRA_01_Pcm
+ *
+ * DESCRIPTION:
+ *  DC removal from the left and right channels, the output is stored as PCM
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *  pDataIn        Input/Source
+ *  pDataOut       Output/Destination, PcmFormat samples
+ *  PcmFormat      Sample format of the output
+ *  NrSamples      Number of stereo samples
+ *
+ * RETURNS:
+ *  The number of saturated output samples
+ *
+ */
+LVM_UINT32 DC_2I_D16_TRC_WRA_01_Pcm( Biquad_FLOAT_Instance_t       *pInstance,
+                                     LVM_FLOAT               *pDataIn,
+                                     void                    *pDataOut,
+                                     LVM_PcmFormat_en        PcmFormat,
+                                     LVM_INT16               NrSamples)
+    {
+        LVM_FLOAT LeftDC,RightDC;
+        LVM_FLOAT Diff;
+        LVM_INT32 j;
+        LVM_INT32 Index = 0;
+        LVM_UINT32 Saturated = 0;
+        PFilter_FLOAT_State pBiquadState = (PFilter_FLOAT_State) pInstance;
+
+        LeftDC = pBiquadState->LeftDC;
+        RightDC = pBiquadState->RightDC;
+        for(j = NrSamples-1; j >= 0; j--)
+        {
+            /* Subtract DC and saturate */
+            Diff =* (pDataIn++) - (LeftDC);
+            if (Diff > 1.0f) {
+                Diff = 1.0f; }
+            else if (Diff < -1.0f) {
+                Diff = -1.0f; }
+            LVM_PCM_STORE(pDataOut, Index, PcmFormat, Diff, Saturated);
+            Index++;
+            if (Diff < 0) {
+                LeftDC -= DC_FLOAT_STEP; }
+            else {
+                LeftDC += DC_FLOAT_STEP; }
+
+
+            /* Subtract DC an saturate */
+            Diff =* (pDataIn++) - (RightDC);
+            if (Diff > 1.0f) {
+                Diff = 1.0f; }
+            else if (Diff < -1.0f) {
+                Diff = -1.0f; }
+            LVM_PCM_STORE(pDataOut, Index, PcmFormat, Diff, Saturated);
+            Index++;
+            if (Diff < 0) {
+                RightDC -= DC_FLOAT_STEP; }
+            else {
+                RightDC += DC_FLOAT_STEP; }
+
+        }
+        pBiquadState->LeftDC = LeftDC;
+        pBiquadState->RightDC = RightDC;
+
+        return Saturated;
+    }
+/*
+ * FUNCTION:       DC_2I_D16_TRC_WRA_01_Acc
+ *
+ * DESCRIPTION:
+ *  DC removal from the left and right channels, the output is added to pDataOut
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *  pDataIn        Input/Source
+ *  pDataOut       Output/Destination, accumulated
+ *  NrSamples      Number of stereo samples
+ *
+ * RETURNS:
+ *  void
+ *
+ */
+void DC_2I_D16_TRC_WRA_01_Acc( Biquad_FLOAT_Instance_t       *pInstance,
+                               LVM_FLOAT               *pDataIn,
+                               LVM_FLOAT               *pDataOut,
+                               LVM_INT16               NrSamples)
+    {
+        LVM_FLOAT LeftDC,RightDC;
+        LVM_FLOAT Diff;
+        LVM_INT32 j;
+        PFilter_FLOAT_State pBiquadState = (PFilter_FLOAT_State) pInstance;
+
+        LeftDC = pBiquadState->LeftDC;
+        RightDC = pBiquadState->RightDC;
+        for(j = NrSamples-1; j >= 0; j--)
+        {
+            /* Subtract DC and saturate */
+            Diff =* (pDataIn++) - (LeftDC);
+            if (Diff > 1.0f) {
+                Diff = 1.0f; }
+            else if (Diff < -1.0f) {
+                Diff = -1.0f; }
+            *(pDataOut++) += Diff;
+            if (Diff < 0) {
+                LeftDC -= DC_FLOAT_STEP; }
+            else {
+                LeftDC += DC_FLOAT_STEP; }
+
+
+            /* Subtract DC an saturate */
+            Diff =* (pDataIn++) - (RightDC);
+            if (Diff > 1.0f) {
+                Diff = 1.0f; }
+            else if (Diff < -1.0f) {
+                Diff = -1.0f; }
+            *(pDataOut++) += Diff;
+            if (Diff < 0) {
+                RightDC -= DC_FLOAT_STEP; }
+            else {
+                RightDC += DC_FLOAT_STEP; }
+
+        }
+        pBiquadState->LeftDC = LeftDC;
+        pBiquadState->RightDC = RightDC;
     }
 #ifdef SUPPORT_MC
 /*
@@ -114,6 +264,134 @@ void DC_Mc_D16_TRC_WRA_01(Biquad_FLOAT_Instance_t       *pInstance,
 
         }
 
+    }
+/*
+ * FUNCTION:       DC_Mc_D16_TRC_WRA_01_GetLevel
+ *
+ * DESCRIPTION:
+ *  Get the largest absolute DC level removed from the channels
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *  NrChannels     Number of channels
+ *
+ * RETURNS:
+ *  The DC level
+ *
+ */
+LVM_FLOAT DC_Mc_D16_TRC_WRA_01_GetLevel(Biquad_FLOAT_Instance_t       *pInstance,
+                                        LVM_INT16               NrChannels)
+    {
+        PFilter_FLOAT_State_Mc pBiquadState = (PFilter_FLOAT_State_Mc) pInstance;
+
+        return PeakAbs_Float(pBiquadState->ChDC, NrChannels);
+    }
+/*
+ * FUNCTION:       DC_Mc_D16_TRC_WRA_01_Pcm
+ *
+ * DESCRIPTION:
+ *  DC removal from all channels of a multichannel input, the output is stored as PCM
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *  pDataIn        Input/Source
+ *  pDataOut       Output/Destination, PcmFormat samples
+ *  PcmFormat      Sample format of the output
+ *  NrFrames       Number of frames
+ *  NrChannels     Number of channels
+ *
+ * RETURNS:
+ *  The number of saturated output samples
+ *
+ */
+LVM_UINT32 DC_Mc_D16_TRC_WRA_01_Pcm(Biquad_FLOAT_Instance_t       *pInstance,
+                                    LVM_FLOAT               *pDataIn,
+                                    void                    *pDataOut,
+                                    LVM_PcmFormat_en        PcmFormat,
+                                    LVM_INT16               NrFrames,
+                                    LVM_INT16               NrChannels)
+    {
+        LVM_FLOAT *ChDC;
+        LVM_FLOAT Diff;
+        LVM_INT32 j;
+        LVM_INT32 i;
+        LVM_INT32 Index = 0;
+        LVM_UINT32 Saturated = 0;
+        PFilter_FLOAT_State_Mc pBiquadState = (PFilter_FLOAT_State_Mc) pInstance;
+
+        ChDC = &pBiquadState->ChDC[0];
+        for (j = NrFrames - 1; j >= 0; j--)
+        {
+            /* Subtract DC and saturate */
+            for (i = NrChannels - 1; i >= 0; i--)
+            {
+                Diff = *(pDataIn++) - (ChDC[i]);
+                if (Diff > 1.0f) {
+                    Diff = 1.0f;
+                } else if (Diff < -1.0f) {
+                    Diff = -1.0f; }
+                LVM_PCM_STORE(pDataOut, Index, PcmFormat, Diff, Saturated);
+                Index++;
+                if (Diff < 0) {
+                    ChDC[i] -= DC_FLOAT_STEP;
+                } else {
+                    ChDC[i] += DC_FLOAT_STEP; }
+            }
+
+        }
+
+        return Saturated;
+    }
+/*
+ * FUNCTION:       DC_Mc_D16_TRC_WRA_01_Acc
+ *
+ * DESCRIPTION:
+ *  DC removal from all channels of a multichannel input, the output is added to
+ *  pDataOut
+ *
+ * PARAMETERS:
+ *  pInstance      Instance pointer
+ *  pDataIn        Input/Source
+ *  pDataOut       Output/Destination, accumulated
+ *  NrFrames       Number of frames
+ *  NrChannels     Number of channels
+ *
+ * RETURNS:
+ *  void
+ *
+ */
+void DC_Mc_D16_TRC_WRA_01_Acc(Biquad_FLOAT_Instance_t       *pInstance,
+                              LVM_FLOAT               *pDataIn,
+                              LVM_FLOAT               *pDataOut,
+                              LVM_INT16               NrFrames,
+                              LVM_INT16               NrChannels)
+    {
+        LVM_FLOAT *ChDC;
+        LVM_FLOAT Diff;
+        LVM_INT32 j;
+        LVM_INT32 i;
+        PFilter_FLOAT_State_Mc pBiquadState = (PFilter_FLOAT_State_Mc) pInstance;
+
+        ChDC = &pBiquadState->ChDC[0];
+        for (j = NrFrames - 1; j >= 0; j--)
+        {
+            /* Subtract DC and saturate */
+            for (i = NrChannels - 1; i >= 0; i--)
+            {
+                Diff = *(pDataIn++) - (ChDC[i]);
+                if (Diff > 1.0f) {
+                    Diff = 1.0f;
+                } else if (Diff < -1.0f) {
+                    Diff = -1.0f; }
+                *(pDataOut++) += Diff;
+                if (Diff < 0) {
+                    ChDC[i] -= DC_FLOAT_STEP;
+                } else {
+                    ChDC[i] += DC_FLOAT_STEP; }
+            }
+
+        }
+
     }
 #endif
 #else
@@ -60,6 +60,34 @@ void*   InstAlloc_AddMember( INST_ALLOC         *pms,
 }
 
 
+/****************************************************************************************
+ *  Name        : InstAlloc_AddMemberAligned()
+ *  Input       : pms   - Pointer to the INST_ALLOC instance
+                  Size  - The size in bytes of the new added member
+                  Align - The alignment in bytes of the new member, a power of two of
+                          at least four
+ *  Returns     : A pointer to the new added member
+ *  Description : Allocates space for a new member as InstAlloc_AddMember does, with the
+                  start address of the member a multiple of Align.
+ *  Remarks     : The largest padding is added to the total size, so the size does not
+                  depend on the base address of the instance memory
+ ****************************************************************************************/
+
+void*   InstAlloc_AddMemberAligned( INST_ALLOC      *pms,
+                                    LVM_UINT32      Size,
+                                    LVM_UINT32      Align )
+{
+    uintptr_t AlignedMember; /* Start address of the new member */
+
+    AlignedMember = (pms->pNextMember + Align - 1) & ~(uintptr_t)(Align - 1);
+
+    pms->TotalSize += Align - 4;
+    pms->pNextMember = AlignedMember;
+
+    return(InstAlloc_AddMember(pms, Size));
+}
+
+
 /****************************************************************************************
  *  Name        : InstAlloc_GetTotal()
  *  Input       : pms  - Pointer to the INST_ALLOC instance
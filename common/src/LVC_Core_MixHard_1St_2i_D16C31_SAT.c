@@ -60,7 +60,7 @@ void LVC_Core_MixHard_1St_2i_D16C31_SAT( LVMixer3_FLOAT_st        *ptrInstance1,
 
 }
 #ifdef SUPPORT_MC
-void LVC_Core_MixHard_1St_MC_float_SAT (Mix_Private_FLOAT_st **ptrInstance,
+void LVC_Core_MixHard_1St_MC_float_SAT (const LVM_FLOAT      *pGains,
                                          const LVM_FLOAT      *src,
                                          LVM_FLOAT            *dst,
                                          LVM_INT16            NrFrames,
@@ -72,14 +72,13 @@ void LVC_Core_MixHard_1St_MC_float_SAT (Mix_Private_FLOAT_st **ptrInstance,
     {
         for (jj = 0; jj < NrChannels; jj++)
         {
-            Mix_Private_FLOAT_st  *pInstance1 = (Mix_Private_FLOAT_st *)(ptrInstance[jj]);
-            Temp = ((LVM_FLOAT)*(src++) * (LVM_FLOAT)pInstance1->Current);
+            Temp = *(src++) * pGains[jj];
             if (Temp > 1.0f)
                 *dst++ = 1.0f;
             else if (Temp < -1.0f)
                 *dst++ = -1.0f;
             else
-                *dst++ = (LVM_FLOAT)Temp;
+                *dst++ = Temp;
         }
     }
 }
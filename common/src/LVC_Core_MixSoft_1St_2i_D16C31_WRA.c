@@ -155,7 +155,7 @@ void LVC_Core_MixSoft_1St_MC_float_WRA (Mix_Private_FLOAT_st **ptrInstance,
 {
     LVM_INT32   ii, ch;
     LVM_FLOAT   Temp =0.0f;
-    LVM_FLOAT   tempCurrent[NrChannels];
+    LVM_FLOAT   tempCurrent[LVM_MAX_CHANNELS];
     for (ch = 0; ch < NrChannels; ch++)
     {
         tempCurrent[ch] = ptrInstance[ch]->Current;
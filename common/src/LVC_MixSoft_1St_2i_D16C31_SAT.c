@@ -43,35 +43,43 @@
  * front center and back center channels
  */
 #define LVM_VOL_BAL_THR (0.000016f)
-void LVC_MixSoft_1St_MC_float_SAT (LVMixer3_2St_FLOAT_st *ptrInstance,
-                                    const LVM_FLOAT       *src,
-                                    LVM_FLOAT             *dst,
-                                    LVM_INT16             NrFrames,
-                                    LVM_INT32             NrChannels,
-                                    LVM_INT32             ChMask)
+
+/* Balance mixer instance of a channel */
+#define LVC_MC_MIX_LEFT     0       /* MixerStream[0] */
+#define LVC_MC_MIX_RIGHT    1       /* MixerStream[1] */
+#define LVC_MC_MIX_CENTER   2       /* Unity, muted when either side is muted */
+#define LVC_MC_MIX_UNITY    3       /* Unity */
+#define LVC_MC_MIX_COUNT    4
+
+/*
+ * FUNCTION:       LVC_MixSoft_1St_MC_float_SetChMap
+ *
+ * DESCRIPTION:
+ *  Build the channel map of LVC_MixSoft_1St_MC_float_SAT, the mixer instance applied
+ *  to each channel of the channel mask. The map only changes with the channel mask
+ *  and is built when the channel configuration is set, not on every process call.
+ *
+ * PARAMETERS:
+ *  pChMap         Channel map, LVM_MAX_CHANNELS entries
+ *  NrChannels     Number of channels
+ *  ChMask         Channel mask
+ *
+ * RETURNS:
+ *  void
+ *
+ */
+void LVC_MixSoft_1St_MC_float_SetChMap(LVM_INT16             *pChMap,
+                                       LVM_INT32             NrChannels,
+                                       LVM_INT32             ChMask)
 {
-    char        HardMixing = TRUE;
-    LVM_FLOAT   TargetGain;
-    Mix_Private_FLOAT_st  Target_lfe = {LVM_MAXFLOAT, LVM_MAXFLOAT, LVM_MAXFLOAT};
-    Mix_Private_FLOAT_st  Target_ctr = {LVM_MAXFLOAT, LVM_MAXFLOAT, LVM_MAXFLOAT};
-    Mix_Private_FLOAT_st  *pInstance1 = \
-                              (Mix_Private_FLOAT_st *)(ptrInstance->MixerStream[0].PrivateParams);
-    Mix_Private_FLOAT_st  *pInstance2 = \
-                              (Mix_Private_FLOAT_st *)(ptrInstance->MixerStream[1].PrivateParams);
-    Mix_Private_FLOAT_st  *pMixPrivInst[4] = {pInstance1, pInstance2, &Target_ctr, &Target_lfe};
-    Mix_Private_FLOAT_st  *pInstance[NrChannels];
-    // printf("mask :%d",audio_channel_mask_get_representation(ChMask));
+    LVM_INT32 i;
+
     if (audio_channel_mask_get_representation(ChMask)
             == AUDIO_CHANNEL_REPRESENTATION_INDEX)
     {
-        // printf("mask :%d",audio_channel_mask_get_representation(ChMask));
-        for (int i = 0; i < 2; i++)
+        for (i = 0; i < NrChannels; i++)
         {
-            pInstance[i] = pMixPrivInst[i];
-        }
-        for (int i = 2; i < NrChannels; i++)
-        {
-            pInstance[i] = pMixPrivInst[2];
+            pChMap[i] = (i < 2) ? (LVM_INT16)i : LVC_MC_MIX_UNITY;
         }
     }
     else
@@ -101,31 +109,79 @@ void LVC_MixSoft_1St_MC_float_SAT (LVMixer3_2St_FLOAT_st *ptrInstance,
             0, // AUDIO_CHANNEL_OUT_TOP_SIDE_LEFT         = 0x40000u,
             1, // AUDIO_CHANNEL_OUT_TOP_SIDE_RIGHT        = 0x80000u
         };
-        if (pInstance1->Target <= LVM_VOL_BAL_THR ||
-            pInstance2->Target <= LVM_VOL_BAL_THR)
-        {
-            Target_ctr.Target  = 0.0f;
-            Target_ctr.Current = 0.0f;
-            Target_ctr.Delta   = 0.0f;
-        }
         const unsigned int idxArrSize = ARRAY_SIZE(mixInstIdx);
-        for (unsigned int i = 0, channel = ChMask; channel !=0 ; ++i)
+        unsigned int channel = ChMask;
+        for (i = 0; i < NrChannels; i++)
         {
-            const unsigned int idx = __builtin_ctz(channel);
-            if (idx < idxArrSize)
-            {
-                pInstance[i] = pMixPrivInst[mixInstIdx[idx]];
-            }
-            else
+            pChMap[i] = LVC_MC_MIX_CENTER;
+            if (channel != 0)
             {
-                pInstance[i] = pMixPrivInst[2];
+                const unsigned int idx = __builtin_ctz(channel);
+                if (idx < idxArrSize)
+                {
+                    pChMap[i] = (LVM_INT16)mixInstIdx[idx];
+                }
+                channel &= ~(1 << idx);
             }
-            channel &= ~(1 << idx);
         }
     }
+}
+
+/*
+ * FUNCTION:       LVC_MixSoft_1St_MC_float_SAT
+ *
+ * DESCRIPTION:
+ *  Balance mixer of a multichannel input. A block without gain ramp is passed
+ *  through at unity gain or scaled by a constant gain per channel, the ramp is only
+ *  applied while a target is not reached.
+ *
+ * PARAMETERS:
+ *  ptrInstance    Instance pointer
+ *  src            Source
+ *  dst            Destination
+ *  NrFrames       Number of frames
+ *  NrChannels     Number of channels
+ *  pChMap         Channel map built with LVC_MixSoft_1St_MC_float_SetChMap
+ *
+ * RETURNS:
+ *  void
+ *
+ */
+void LVC_MixSoft_1St_MC_float_SAT (LVMixer3_2St_FLOAT_st *ptrInstance,
+                                    const LVM_FLOAT       *src,
+                                    LVM_FLOAT             *dst,
+                                    LVM_INT16             NrFrames,
+                                    LVM_INT32             NrChannels,
+                                    const LVM_INT16       *pChMap)
+{
+    char        HardMixing = TRUE;
+    LVM_FLOAT   TargetGain;
+    Mix_Private_FLOAT_st  Target_lfe = {LVM_MAXFLOAT, LVM_MAXFLOAT, LVM_MAXFLOAT};
+    Mix_Private_FLOAT_st  Target_ctr = {LVM_MAXFLOAT, LVM_MAXFLOAT, LVM_MAXFLOAT};
+    Mix_Private_FLOAT_st  *pInstance1 = \
+                              (Mix_Private_FLOAT_st *)(ptrInstance->MixerStream[0].PrivateParams);
+    Mix_Private_FLOAT_st  *pInstance2 = \
+                              (Mix_Private_FLOAT_st *)(ptrInstance->MixerStream[1].PrivateParams);
+    Mix_Private_FLOAT_st  *pMixPrivInst[LVC_MC_MIX_COUNT] = {pInstance1, pInstance2,
+                                                             &Target_ctr, &Target_lfe};
+    Mix_Private_FLOAT_st  *pInstance[LVM_MAX_CHANNELS];
+    LVM_FLOAT             Gains[LVM_MAX_CHANNELS];
+    LVM_INT32             ch;
 
     if (NrFrames <= 0)    return;
 
+    if (pInstance1->Target <= LVM_VOL_BAL_THR ||
+        pInstance2->Target <= LVM_VOL_BAL_THR)
+    {
+        Target_ctr.Target  = 0.0f;
+        Target_ctr.Current = 0.0f;
+        Target_ctr.Delta   = 0.0f;
+    }
+    for (ch = 0; ch < NrChannels; ch++)
+    {
+        pInstance[ch] = pMixPrivInst[pChMap[ch]];
+    }
+
     /******************************************************************************
        SOFT MIXING
     *******************************************************************************/
@@ -187,7 +243,11 @@ void LVC_MixSoft_1St_MC_float_SAT (LVMixer3_2St_FLOAT_st *ptrInstance,
         }
         else
         {
-            LVC_Core_MixHard_1St_MC_float_SAT(&(pInstance[0]),
+            for (ch = 0; ch < NrChannels; ch++)
+            {
+                Gains[ch] = pInstance[ch]->Current;
+            }
+            LVC_Core_MixHard_1St_MC_float_SAT(Gains,
                                                src, dst, NrFrames, NrChannels);
         }
     }
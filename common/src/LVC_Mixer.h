@@ -120,6 +120,10 @@ LVM_FLOAT LVC_Mixer_GetCurrent( LVMixer3_FLOAT_st *pStream);
 LVM_INT32 LVC_Mixer_GetCurrent( LVMixer3_st *pStream);
 #endif
 
+#ifdef BUILD_FLOAT
+LVM_INT16 LVC_Mixer_IsSteady( LVMixer3_FLOAT_st *pStream);
+#endif
+
 #ifdef BUILD_FLOAT
 void LVC_Mixer_Init( LVMixer3_FLOAT_st *pStream,
                      LVM_FLOAT           TargetGain,
@@ -225,12 +229,16 @@ void LVC_MixSoft_2St_D16C31_SAT( LVMixer3_2St_st *pInstance,
 /**********************************************************************************/
 #ifdef BUILD_FLOAT
 #ifdef SUPPORT_MC
+void LVC_MixSoft_1St_MC_float_SetChMap(LVM_INT16         *pChMap, /* LVM_MAX_CHANNELS entries */
+                                   LVM_INT32             NrChannels,
+                                   LVM_INT32             ChMask);
+
 void LVC_MixSoft_1St_MC_float_SAT(LVMixer3_2St_FLOAT_st *pInstance,
                                    const   LVM_FLOAT     *src,
                                    LVM_FLOAT             *dst,   /* dst can be equal to src */
                                    LVM_INT16             NrFrames,
                                    LVM_INT32             NrChannels,
-                                   LVM_INT32             ChMask);
+                                   const   LVM_INT16     *pChMap);
 #endif
 void LVC_MixSoft_1St_2i_D16C31_SAT(LVMixer3_2St_FLOAT_st *pInstance,
                                    const   LVM_FLOAT     *src,
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVM_Types.h"
+#include "LVM_Macros.h"
+#include "LVC_Mixer_Private.h"
+
+
+/************************************************************************/
+/* FUNCTION:                                                            */
+/*   LVMixer3_IsSteady                                                  */
+/*                                                                      */
+/* DESCRIPTION:                                                         */
+/*  This function checks whether the stream has reached its target gain */
+/*                                                                      */
+/* RETURNS:                                                             */
+/*  LVM_TRUE         - The gain no longer changes                       */
+/*  LVM_FALSE        - A gain ramp is in progress                       */
+/*                                                                      */
+/* NOTES:                                                               */
+/*  The soft mixers call back in the call that reaches the target, a    */
+/*  call back still set on a steady stream only fires after a new ramp  */
+/*                                                                      */
+/************************************************************************/
+#ifdef BUILD_FLOAT
+LVM_INT16 LVC_Mixer_IsSteady( LVMixer3_FLOAT_st *pStream)
+{
+    Mix_Private_FLOAT_st  *pInstance = (Mix_Private_FLOAT_st *)pStream->PrivateParams;
+
+    if (pInstance->Current != pInstance->Target)
+    {
+        return LVM_FALSE;
+    }
+    return LVM_TRUE;
+}
+#endif
+/**********************************************************************************/
@@ -144,7 +144,7 @@ void LVC_Core_MixSoft_1St_2i_D16C31_WRA( LVMixer3_st        *ptrInstance1,
 /**********************************************************************************/
 #ifdef BUILD_FLOAT
 #ifdef SUPPORT_MC
-void LVC_Core_MixHard_1St_MC_float_SAT(Mix_Private_FLOAT_st **ptrInstance,
+void LVC_Core_MixHard_1St_MC_float_SAT(const LVM_FLOAT      *pGains,
                                          const LVM_FLOAT      *src,
                                          LVM_FLOAT            *dst,
                                          LVM_INT16            NrFrames,
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVM_Types.h"
+#include "LVM_Common.h"
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define LVM_FTZ_DAZ_MASK        0x8040          /* MXCSR flush-to-zero and denormals-are-zero bits */
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_FP))
+#define LVM_FTZ_FZ_MASK         0x01000000      /* FPCR / FPSCR flush-to-zero bit */
+#endif
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FlushToZeroSet                                                    */
+/*                                                                         */
+/* LVM_UINT32 LVM_FlushToZeroSet(void)                                     */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function makes the floating point unit of the calling thread     */
+/*   flush denormal results and operands to zero. It does nothing on       */
+/*   targets without such a mode.                                          */
+/*                                                                         */
+/* RETURNS:                                                                */
+/*   The previous floating point state, for LVM_FlushToZeroRestore         */
+/*-------------------------------------------------------------------------*/
+LVM_UINT32 LVM_FlushToZeroSet(void)
+{
+    LVM_UINT32  State = 0;
+
+#if defined(LVM_FTZ_DAZ_MASK)
+    State = (LVM_UINT32)_mm_getcsr();
+    _mm_setcsr(State | LVM_FTZ_DAZ_MASK);
+#elif defined(__aarch64__)
+    unsigned long Fpcr;
+
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(Fpcr));
+    State = (LVM_UINT32)Fpcr;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(Fpcr | LVM_FTZ_FZ_MASK));
+#elif defined(LVM_FTZ_FZ_MASK)
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(State));
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(State | LVM_FTZ_FZ_MASK));
+#endif
+    return State;
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FlushToZeroRestore                                                */
+/*                                                                         */
+/* void LVM_FlushToZeroRestore(LVM_UINT32       State)                     */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function restores the floating point state saved by             */
+/*   LVM_FlushToZeroSet                                                    */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  LVM_UINT32          State      State returned by LVM_FlushToZeroSet    */
+/*-------------------------------------------------------------------------*/
+void LVM_FlushToZeroRestore(LVM_UINT32      State)
+{
+#if defined(LVM_FTZ_DAZ_MASK)
+    _mm_setcsr((unsigned int)State);
+#elif defined(__aarch64__)
+    unsigned long Fpcr = State;
+
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(Fpcr));
+#elif defined(LVM_FTZ_FZ_MASK)
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(State));
+#else
+    (void)State;
+#endif
+}
+
+#ifdef BUILD_FLOAT
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_CountDenormals_Float                                              */
+/*                                                                         */
+/* LVM_UINT32 LVM_CountDenormals_Float(const LVM_FLOAT  *src,              */
+/*                                     LVM_INT32        n)                 */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function counts the denormal samples of a buffer. The exponent   */
+/*   bits are tested directly so the count is not affected by a flush to   */
+/*   zero mode.                                                            */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  const LVM_FLOAT     *src       Samples to test                         */
+/*  LVM_INT32           n          Number of samples                       */
+/* RETURNS:                                                                */
+/*   Number of denormal samples                                            */
+/*-------------------------------------------------------------------------*/
+LVM_UINT32 LVM_CountDenormals_Float(const LVM_FLOAT *src,
+                                    LVM_INT32       n)
+{
+    union
+    {
+        LVM_FLOAT   Value;
+        LVM_UINT32  Bits;
+    }                   Sample;
+    LVM_UINT32          Count = 0;
+    LVM_INT32           ii;
+
+    for (ii = n; ii != 0; ii--)
+    {
+        Sample.Value = *src++;
+
+        /* Zero exponent with a non zero mantissa */
+        Count += (LVM_UINT32)(((Sample.Bits & 0x7FFFFFFF) - 1) < 0x007FFFFF);
+    }
+    return Count;
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_DenormalOffset_Float                                              */
+/*                                                                         */
+/* LVM_INT32 LVM_DenormalOffset_Float(const LVM_FLOAT   *src,              */
+/*                                    LVM_FLOAT         *dst,              */
+/*                                    LVM_INT32         NrFrames,          */
+/*                                    LVM_INT32         NrChannels,        */
+/*                                    LVM_FLOAT         Offset,            */
+/*                                    LVM_INT32         Phase)             */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function adds an offset far below the audible level to an       */
+/*   interleaved buffer. The offset follows the +,+,-,- frame pattern, a   */
+/*   quarter sampling rate signal that is not removed by the DC, high pass */
+/*   and band pass filters. It keeps the recursive filters fed by the      */
+/*   buffer out of the denormal range when the signal becomes silent       */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  const LVM_FLOAT     *src       Source samples                          */
+/*  LVM_FLOAT           *dst       Destination samples, may equal src      */
+/*  LVM_INT32           NrFrames   Number of frames                        */
+/*  LVM_INT32           NrChannels Number of channels per frame            */
+/*  LVM_FLOAT           Offset     Offset level                            */
+/*  LVM_INT32           Phase      Pattern position of the first frame     */
+/*                                                                         */
+/* RETURNS:                                                                */
+/*   Pattern position of the frame following the buffer                    */
+/*-------------------------------------------------------------------------*/
+LVM_INT32 LVM_DenormalOffset_Float(const LVM_FLOAT   *src,
+                                   LVM_FLOAT         *dst,
+                                   LVM_INT32         NrFrames,
+                                   LVM_INT32         NrChannels,
+                                   LVM_FLOAT         Offset,
+                                   LVM_INT32         Phase)
+{
+    LVM_FLOAT   FrameOffset;
+    LVM_INT32   ii, jj;
+
+    for (ii = NrFrames; ii != 0; ii--)
+    {
+        FrameOffset = ((Phase & 2) == 0) ? Offset : -Offset;
+        for (jj = NrChannels; jj != 0; jj--)
+        {
+            *dst++ = *src++ + FrameOffset;
+        }
+        Phase = (Phase + 1) & 3;
+    }
+    return Phase;
+}
+#endif
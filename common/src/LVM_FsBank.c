@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVM_Types.h"
+#include "LVM_Common.h"
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FsBankSize                                                        */
+/*                                                                         */
+/* LVM_INT16 LVM_FsBankSize(LVM_UINT32          BankRates)                 */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function returns the number of sample rates in a coefficient     */
+/*   bank set                                                              */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  LVM_UINT32          BankRates  Set of LVM_FS_BANK() sample rate bits   */
+/* RETURNS:                                                                */
+/*   Number of banked sample rates                                         */
+/*-------------------------------------------------------------------------*/
+LVM_INT16 LVM_FsBankSize(LVM_UINT32         BankRates)
+{
+    LVM_INT16   Size = 0;
+
+    while (BankRates != 0)
+    {
+        BankRates &= BankRates - 1;             /* Clear the lowest rate bit */
+        Size++;
+    }
+    return Size;
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FsBankIndex                                                       */
+/*                                                                         */
+/* LVM_INT16 LVM_FsBankIndex(LVM_UINT32         BankRates,                 */
+/*                           LVM_Fs_en          Fs)                        */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function returns the position of a sample rate in a coefficient  */
+/*   bank. Banks store one entry per banked rate in ascending rate order.  */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  LVM_UINT32          BankRates  Set of LVM_FS_BANK() sample rate bits   */
+/*  LVM_Fs_en           Fs         The SampleRate                          */
+/* RETURNS:                                                                */
+/*   Bank index of the rate, -1 when the rate is not banked                */
+/*-------------------------------------------------------------------------*/
+LVM_INT16 LVM_FsBankIndex(LVM_UINT32        BankRates,
+                          LVM_Fs_en         Fs)
+{
+    if (((LVM_UINT32)Fs >= 32) ||
+        ((BankRates & LVM_FS_BANK(Fs)) == 0))
+    {
+        return -1;
+    }
+    return LVM_FsBankSize(BankRates & (LVM_FS_BANK(Fs) - 1));
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FsBankSwitch                                                      */
+/*                                                                         */
+/* LVM_INT16 LVM_FsBankSwitch(LVM_UINT32        BankRates,                 */
+/*                            LVM_Fs_en         FromFs,                    */
+/*                            LVM_Fs_en         ToFs)                      */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function checks for a sample rate change between two banked     */
+/*   rates. Filters keep their history over such a change and only swap   */
+/*   their coefficients.                                                   */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  LVM_UINT32          BankRates  Set of LVM_FS_BANK() sample rate bits   */
+/*  LVM_Fs_en           FromFs     The current SampleRate                  */
+/*  LVM_Fs_en           ToFs       The new SampleRate                      */
+/* RETURNS:                                                                */
+/*   LVM_TRUE for a change between two banked rates, LVM_FALSE otherwise   */
+/*-------------------------------------------------------------------------*/
+LVM_INT16 LVM_FsBankSwitch(LVM_UINT32       BankRates,
+                           LVM_Fs_en        FromFs,
+                           LVM_Fs_en        ToFs)
+{
+    if ((FromFs != ToFs) &&
+        (LVM_FsBankIndex(BankRates, FromFs) >= 0) &&
+        (LVM_FsBankIndex(BankRates, ToFs) >= 0))
+    {
+        return LVM_TRUE;
+    }
+    return LVM_FALSE;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LVM_Types.h"
+#include "LVM_Common.h"
+
+#ifdef BUILD_FLOAT
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_PcmSampleSize                                                     */
+/*                                                                         */
+/* LVM_INT32 LVM_PcmSampleSize(LVM_PcmFormat_en   Format)                  */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function returns the size of one sample in bytes                 */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  LVM_PcmFormat_en    Format     PCM sample format                       */
+/*                                                                         */
+/* RETURNS:                                                                */
+/*   The sample size, 0 for an unknown format                              */
+/*-------------------------------------------------------------------------*/
+LVM_INT32 LVM_PcmSampleSize(LVM_PcmFormat_en   Format)
+{
+    switch (Format)
+    {
+    case LVM_PCM_16BIT:
+        return sizeof(LVM_INT16);
+    case LVM_PCM_32BIT:
+        return sizeof(LVM_INT32);
+    case LVM_PCM_PACKED_24BIT:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_PcmToFloat                                                        */
+/*                                                                         */
+/* void LVM_PcmToFloat(const void          *src,                           */
+/*                     LVM_FLOAT           *dst,                           */
+/*                     LVM_INT32           n,                              */
+/*                     LVM_PcmFormat_en    Format)                         */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function converts PCM samples to float, with the same scaling   */
+/*   as the audio_utils memcpy_to_float_from_* conversions                 */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  const void          *src       Source PCM samples                      */
+/*  LVM_FLOAT           *dst       Destination                             */
+/*  LVM_INT32           n          Number of samples                       */
+/*  LVM_PcmFormat_en    Format     Sample format of the source             */
+/*-------------------------------------------------------------------------*/
+void LVM_PcmToFloat(const void          *src,
+                    LVM_FLOAT           *dst,
+                    LVM_INT32           n,
+                    LVM_PcmFormat_en    Format)
+{
+    const LVM_INT16 *src16 = (const LVM_INT16 *)src;
+    const LVM_INT32 *src32 = (const LVM_INT32 *)src;
+    const LVM_UINT8 *src24 = (const LVM_UINT8 *)src;
+    LVM_INT32       Pcm;
+    LVM_INT32       ii;
+
+    switch (Format)
+    {
+    case LVM_PCM_16BIT:
+        for (ii = 0; ii < n; ii++)
+        {
+            dst[ii] = src16[ii] * (1.0f / 32768.0f);
+        }
+        break;
+    case LVM_PCM_32BIT:
+        for (ii = 0; ii < n; ii++)
+        {
+            dst[ii] = src32[ii] * (1.0f / 2147483648.0f);
+        }
+        break;
+    default:
+        for (ii = 0; ii < n; ii++)
+        {
+            Pcm = (LVM_INT32)(((LVM_UINT32)src24[LVM_P24_LSB] << 8) |
+                              ((LVM_UINT32)src24[1] << 16) |
+                              ((LVM_UINT32)src24[LVM_P24_MSB] << 24));
+            dst[ii] = Pcm * (1.0f / 2147483648.0f);
+            src24 += 3;
+        }
+        break;
+    }
+}
+
+/*-------------------------------------------------------------------------*/
+/* FUNCTION:                                                               */
+/*   LVM_FloatToPcm                                                        */
+/*                                                                         */
+/* LVM_UINT32 LVM_FloatToPcm(const LVM_FLOAT  *src,                        */
+/*                           void             *dst,                        */
+/*                           LVM_INT32        n,                           */
+/*                           LVM_PcmFormat_en Format)                      */
+/*                                                                         */
+/* DESCRIPTION:                                                            */
+/*   This function converts float samples to PCM, see LVM_PCM_STORE       */
+/*                                                                         */
+/* PARAMETERS:                                                             */
+/*                                                                         */
+/*  const LVM_FLOAT     *src       Source                                  */
+/*  void                *dst       Destination PCM samples                 */
+/*  LVM_INT32           n          Number of samples                       */
+/*  LVM_PcmFormat_en    Format     Sample format of the destination        */
+/*                                                                         */
+/* RETURNS:                                                                */
+/*   The number of saturated samples                                       */
+/*-------------------------------------------------------------------------*/
+LVM_UINT32 LVM_FloatToPcm(const LVM_FLOAT  *src,
+                          void             *dst,
+                          LVM_INT32        n,
+                          LVM_PcmFormat_en Format)
+{
+    LVM_UINT32      Saturated = 0;
+    LVM_INT32       ii;
+
+    for (ii = 0; ii < n; ii++)
+    {
+        LVM_PCM_STORE(dst, ii, Format, src[ii], Saturated);
+    }
+    return Saturated;
+}
+#endif
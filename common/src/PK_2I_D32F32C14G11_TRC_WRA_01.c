@@ -57,18 +57,18 @@ void PK_2I_D32F32C14G11_TRC_WRA_01 ( Biquad_FLOAT_Instance_t       *pInstance,
             ***************************************************************************/
             /* ynL= (A0  * (x(n)L - x(n-2)L  ) )*/
             templ = (*pDataIn) - pBiquadState->pDelays[2];
-            ynL = templ * pBiquadState->coefs[0];
+            ynL = templ * pBiquadState->pCoefs[0];
 
             /* ynL+= ((-B2  * y(n-2)L  )) */
-            templ = pBiquadState->pDelays[6] * pBiquadState->coefs[1];
+            templ = pBiquadState->pDelays[6] * pBiquadState->pCoefs[1];
             ynL += templ;
 
             /* ynL+= ((-B1 * y(n-1)L  ) ) */
-            templ = pBiquadState->pDelays[4] * pBiquadState->coefs[2];
+            templ = pBiquadState->pDelays[4] * pBiquadState->pCoefs[2];
             ynL += templ;
 
             /* ynLO= ((Gain * ynL )) */
-            ynLO = ynL * pBiquadState->coefs[3];
+            ynLO = ynL * pBiquadState->pCoefs[3];
 
             /* ynLO=( ynLO + x(n)L  )*/
             ynLO += (*pDataIn);
@@ -78,18 +78,18 @@ void PK_2I_D32F32C14G11_TRC_WRA_01 ( Biquad_FLOAT_Instance_t       *pInstance,
             ***************************************************************************/
             /* ynR= (A0  * (x(n)R  - x(n-2)R  ) ) */
             templ = (*(pDataIn + 1)) - pBiquadState->pDelays[3];
-            ynR = templ * pBiquadState->coefs[0];
+            ynR = templ * pBiquadState->pCoefs[0];
 
             /* ynR+= ((-B2  * y(n-2)R  ) )  */
-            templ = pBiquadState->pDelays[7] * pBiquadState->coefs[1];
+            templ = pBiquadState->pDelays[7] * pBiquadState->pCoefs[1];
             ynR += templ;
 
             /* ynR+= ((-B1  * y(n-1)R  ) )   */
-            templ = pBiquadState->pDelays[5] * pBiquadState->coefs[2];
+            templ = pBiquadState->pDelays[5] * pBiquadState->pCoefs[2];
             ynR += templ;
 
             /* ynRO= ((Gain  * ynR )) */
-            ynRO = ynR * pBiquadState->coefs[3];
+            ynRO = ynR * pBiquadState->pCoefs[3];
 
             /* ynRO=( ynRO + x(n)R  )*/
             ynRO += (*(pDataIn+1));
@@ -156,18 +156,18 @@ void PK_Mc_D32F32C14G11_TRC_WRA_01 (Biquad_FLOAT_Instance_t       *pInstance,
                 ***************************************************************************/
                 /* yn= (A0  * (x(n) - x(n-2)))*/
                 temp = (*pDataIn) - pBiquadState->pDelays[NrChannels + jj];
-                yn = temp * pBiquadState->coefs[0];
+                yn = temp * pBiquadState->pCoefs[0];
 
                 /* yn+= ((-B2  * y(n-2))) */
-                temp = pBiquadState->pDelays[NrChannels*3 + jj] * pBiquadState->coefs[1];
+                temp = pBiquadState->pDelays[NrChannels*3 + jj] * pBiquadState->pCoefs[1];
                 yn += temp;
 
                 /* yn+= ((-B1 * y(n-1))) */
-                temp = pBiquadState->pDelays[NrChannels*2 + jj] * pBiquadState->coefs[2];
+                temp = pBiquadState->pDelays[NrChannels*2 + jj] * pBiquadState->pCoefs[2];
                 yn += temp;
 
                 /* ynO= ((Gain * yn)) */
-                ynO = yn * pBiquadState->coefs[3];
+                ynO = yn * pBiquadState->pCoefs[3];
 
                 /* ynO=(ynO + x(n))*/
                 ynO += (*pDataIn);
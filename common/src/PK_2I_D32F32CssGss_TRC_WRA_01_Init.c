@@ -18,20 +18,15 @@
 #include "BIQUAD.h"
 #include "PK_2I_D32F32CssGss_TRC_WRA_01_Private.h"
 #ifdef BUILD_FLOAT
+/* The filter reads the coefficients in place, they must stay valid while it is used */
 void  PK_2I_D32F32CssGss_TRC_WRA_01_Init(Biquad_FLOAT_Instance_t         *pInstance,
                                          Biquad_2I_Order2_FLOAT_Taps_t   *pTaps,
-                                         PK_FLOAT_Coefs_t            *pCoef)
+                                         const PK_FLOAT_Coefs_t      *pCoef)
 {
     PFilter_State_Float pBiquadState = (PFilter_State_Float) pInstance;
     pBiquadState->pDelays       = (LVM_FLOAT *) pTaps;
 
-    pBiquadState->coefs[0] = pCoef->A0;
-
-    pBiquadState->coefs[1] = pCoef->B2;
-
-    pBiquadState->coefs[2] = pCoef->B1;
-
-    pBiquadState->coefs[3] = pCoef->G;
+    pBiquadState->pCoefs        = (const LVM_FLOAT *) pCoef;
 }
 #else
 void  PK_2I_D32F32CssGss_TRC_WRA_01_Init(Biquad_Instance_t         *pInstance,
@@ -26,7 +26,7 @@
 typedef struct _Filter_State_Float_
 {
     LVM_FLOAT *       pDelays;        /* pointer to the delayed samples (data of 32 bits)   */
-    LVM_FLOAT         coefs[5];       /* pointer to the filter coefficients */
+    const LVM_FLOAT * pCoefs;         /* pointer to the filter coefficients, A0, -B2, -B1, Gain */
 }Filter_State_Float;
 
 typedef Filter_State_Float * PFilter_State_Float ;
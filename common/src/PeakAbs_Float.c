@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**********************************************************************************
+   INCLUDE FILES
+***********************************************************************************/
+
+#include "VectorArithmetic.h"
+
+/**********************************************************************************
+   FUNCTION PEAKABS_FLOAT
+***********************************************************************************/
+#ifdef BUILD_FLOAT
+LVM_FLOAT PeakAbs_Float( const LVM_FLOAT *src,
+                         LVM_INT32  n )
+{
+    LVM_FLOAT Peak = 0.0f;
+    LVM_FLOAT Temp;
+    LVM_INT32 ii;
+
+    for (ii = n; ii != 0; ii--)
+    {
+        Temp = *src++;
+        if (Temp < 0.0f)
+        {
+            Temp = -Temp;
+        }
+        if (Temp > Peak)
+        {
+            Peak = Temp;
+        }
+    }
+
+    return Peak;
+}
+#endif
+/**********************************************************************************/
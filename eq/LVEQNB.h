@@ -131,6 +131,15 @@ typedef enum
 } LVEQNB_FilterMode_en;
 
 
+/* Filter engines */
+typedef enum
+{
+    LVEQNB_ENGINE_CASCADE  = 0,                         /* One section per band, in series */
+    LVEQNB_ENGINE_PARALLEL = 1,                         /* Sections in parallel form, float build only */
+    LVEQNB_ENGINE_DUMMY    = LVM_MAXINT_32
+} LVEQNB_Engine_en;
+
+
 /* Memory Types */
 typedef enum
 {
@@ -289,6 +298,8 @@ typedef struct
     LVM_UINT16                  SourceFormat;
     LVM_UINT16                  MaxBlockSize;
     LVM_UINT16                  MaxBands;
+    LVM_UINT32                  CoefBankRates;          /* Rates with precomputed coefficients */
+    LVEQNB_Engine_en            Engine;                 /* Filter engine of the bands */
 
     /* Callback parameters */
     LVM_Callback                CallBack;               /* Bundle callback */
@@ -380,6 +391,35 @@ LVEQNB_ReturnStatus_en LVEQNB_Init(LVEQNB_Handle_t          *phInstance,
                                    LVEQNB_Capabilities_t    *pCapabilities);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVEQNB_SetCoefMemory                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Moves the instance to a copy of its persistent coefficient region, the filters      */
+/*  read their coefficients from the new region.                                        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  pCoefMemory             Base address of the copy of the coefficient region          */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVEQNB_SUCCESS          Succeeded                                                   */
+/*  LVEQNB_NULLADDRESS      When hInstance or pCoefMemory is NULL                       */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The coefficient region holds no addresses, it can be moved or shared by         */
+/*      instances with the same capabilities and parameters. The filters only write it  */
+/*      when their parameters change                                                    */
+/*  2.  This function must not be interrupted by the LVEQNB_Process function            */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVEQNB_ReturnStatus_en LVEQNB_SetCoefMemory(LVEQNB_Handle_t     hInstance,
+                                            void                *pCoefMemory);
+#endif
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                 LVEQNB_GetParameters                                       */
@@ -430,6 +470,101 @@ LVEQNB_ReturnStatus_en LVEQNB_GetCapabilities(LVEQNB_Handle_t           hInstanc
                                               LVEQNB_Capabilities_t     *pCapabilities);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                 LVEQNB_GetTailLevel                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Returns the peak level of the filter history, the output produced by a silent input */
+/*  stays below this level times the band gains.                                        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                Instance handle                                            */
+/*  pTailLevel               Pointer to the tail level                                  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVEQNB_SUCCESS           Succeeds                                                   */
+/*  LVEQNB_NULLADDRESS       hInstance or pTailLevel is NULL                            */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The level is full scale (1.0) during an operating mode transition               */
+/*  2.  This function must not be interrupted by the LVEQNB_Process function            */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVEQNB_ReturnStatus_en LVEQNB_GetTailLevel(LVEQNB_Handle_t           hInstance,
+                                           LVM_FLOAT                 *pTailLevel);
+#endif
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                 LVEQNB_GetSections                                         */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Returns the bands being processed as direct form second order sections with their   */
+/*  history, for a caller running them in its own cascade instead of LVEQNB_Process.    */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                Instance handle                                            */
+/*  pCoefs                   Pointer to 5 coefficients per band, section n computes     */
+/*                           y = c0*x + c1*x(n-1) + c2*x(n-2) + c3*y(n-1) + c4*y(n-2)   */
+/*  pHistory                 Pointer to the history, the input of section n is its      */
+/*                           output history n, entry k of history n of channel ch is    */
+/*                           pHistory[ch * HistoryStride + 2 * n + k] for x or y(n-1-k) */
+/*  HistoryStride            Distance between the histories of two channels             */
+/*  pNrSections              Pointer to the number of sections                          */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVEQNB_SUCCESS           Succeeds                                                   */
+/*  LVEQNB_NULLADDRESS       hInstance, pCoefs, pHistory or pNrSections is NULL         */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  pHistory holds NrSections + 1 histories, pCoefs room for the maximum number of  */
+/*      bands                                                                           */
+/*  2.  No sections are returned when the equaliser is off or in an operating mode      */
+/*      transition                                                                      */
+/*  3.  This function must not be interrupted by the LVEQNB_Process function            */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVEQNB_ReturnStatus_en LVEQNB_GetSections(LVEQNB_Handle_t           hInstance,
+                                          LVM_FLOAT                 *pCoefs,
+                                          LVM_FLOAT                 *pHistory,
+                                          LVM_UINT16                HistoryStride,
+                                          LVM_UINT16                *pNrSections);
+#endif
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                 LVEQNB_SetSectionHistory                                   */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Sets the history of the bands from the sections returned by LVEQNB_GetSections,     */
+/*  before LVEQNB_Process or LVEQNB_Control is called again.                            */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                Instance handle                                            */
+/*  pHistory                 Pointer to the history of the sections                     */
+/*  HistoryStride            Distance between the histories of two channels             */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVEQNB_SUCCESS           Succeeds                                                   */
+/*  LVEQNB_NULLADDRESS       hInstance or pHistory is NULL                              */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The bands and their parameters must not have changed since LVEQNB_GetSections   */
+/*  2.  This function must not be interrupted by the LVEQNB_Process function            */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVEQNB_ReturnStatus_en LVEQNB_SetSectionHistory(LVEQNB_Handle_t     hInstance,
+                                                const LVM_FLOAT     *pHistory,
+                                                LVM_UINT16          HistoryStride);
+#endif
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVEQNB_Control                                              */
@@ -449,6 +584,9 @@ LVEQNB_ReturnStatus_en LVEQNB_GetCapabilities(LVEQNB_Handle_t           hInstanc
 /*                                                                                      */
 /* NOTES:                                                                               */
 /*  1.  This function may be interrupted by the LVEQNB_Process function                 */
+/*  2.  With the parallel engine a change of any band converts all the bands being      */
+/*      processed again, at a cost growing with the square of their number. Changing    */
+/*      one band of N costs about as much as changing all of them                       */
 /*                                                                                      */
 /****************************************************************************************/
 
@@ -476,6 +614,8 @@ LVEQNB_ReturnStatus_en LVEQNB_Control(LVEQNB_Handle_t       hInstance,
 /*  LVEQNB_TOOMANYSAMPLES   NumSamples was larger than the maximum block size           */
 /*                                                                                      */
 /* NOTES:                                                                               */
+/*  1.  With the parallel engine the bands run as parallel sections, or in series when  */
+/*      their parallel form is ill-conditioned                                          */
 /*                                                                                      */
 /****************************************************************************************/
 #ifdef BUILD_FLOAT
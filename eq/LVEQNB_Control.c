@@ -116,6 +116,96 @@ LVEQNB_ReturnStatus_en LVEQNB_GetCapabilities(LVEQNB_Handle_t           hInstanc
 }
 
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:                 LVEQNB_GetTailLevel                                    */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the peak level of the history of the bands being processed.            */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance                Instance handle                                        */
+/*  pTailLevel               Pointer to the tail level                              */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVEQNB_Success           Succeeds                                               */
+/*  LVEQNB_NULLADDRESS       hInstance or pTailLevel is NULL                        */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1.  The level is full scale (1.0) during an operating mode transition           */
+/*                                                                                  */
+/************************************************************************************/
+
+LVEQNB_ReturnStatus_en LVEQNB_GetTailLevel(LVEQNB_Handle_t           hInstance,
+                                           LVM_FLOAT                 *pTailLevel)
+{
+
+    LVEQNB_Instance_t    *pInstance =(LVEQNB_Instance_t  *)hInstance;
+    LVM_FLOAT            Level;
+    LVM_FLOAT            TailLevel = 0.0f;
+#ifdef SUPPORT_MC
+    LVM_INT32            NrTaps = 4 * pInstance->Params.NrChannels;
+#else
+    LVM_INT32            NrTaps = 2 * 4;
+#endif
+    LVM_UINT16           i;
+
+    if((hInstance == LVM_NULL) || (pTailLevel == LVM_NULL))
+    {
+        return LVEQNB_NULLADDRESS;
+    }
+
+    if (pInstance->bInOperatingModeTransition == LVM_TRUE)
+    {
+        *pTailLevel = 1.0f;
+        return(LVEQNB_SUCCESS);
+    }
+
+    /*
+     * The parallel sections hold the history of all the bands
+     */
+    if (pInstance->ParallelGroups != 0)
+    {
+        LVM_INT32   MaxGroups = LVEQNB_PARALLEL_GROUPS(pInstance->Capabilities.MaxBands);
+        LVM_INT32   ch;
+
+        for (ch = 0; ch < NrTaps / 4; ch++)
+        {
+            Level = PeakAbs_Float((LVM_FLOAT *)&pInstance->pParallelTaps[ch * MaxGroups],
+                                  (LVM_INT32)(pInstance->ParallelGroups * \
+                                              sizeof(LVEQNB_ParallelTaps_t) / sizeof(LVM_FLOAT)));
+            if (Level > TailLevel)
+            {
+                TailLevel = Level;
+            }
+        }
+        *pTailLevel = TailLevel;
+        return(LVEQNB_SUCCESS);
+    }
+
+    /*
+     * Only the bands being processed hold a history
+     */
+    for (i = 0; i < pInstance->NBands; i++)
+    {
+        if ((pInstance->pBandDefinitions[i].Gain != 0) &&
+            (pInstance->pBiquadType[i] == LVEQNB_SinglePrecision_Float))
+        {
+            Level = PeakAbs_Float(pInstance->pEQNB_Taps_Float[i].Storage, NrTaps);
+            if (Level > TailLevel)
+            {
+                TailLevel = Level;
+            }
+        }
+    }
+    *pTailLevel = TailLevel;
+
+    return(LVEQNB_SUCCESS);
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVEQNB_SetFilters                                           */
@@ -135,6 +225,8 @@ LVEQNB_ReturnStatus_en LVEQNB_GetCapabilities(LVEQNB_Handle_t           hInstanc
 /*          Double precision    if (fc <= fs/110)                                   */
 /*          Double precision    if (fs/110 < fc < fs/85) & (Q>3)                    */
 /*          Single precision    otherwise                                           */
+/*  2. The bands whose definition or biquad type change are marked stale, all of    */
+/*     them when the number of bands changes                                        */
 /*                                                                                  */
 /************************************************************************************/
 
@@ -153,6 +245,15 @@ void    LVEQNB_SetFilters(LVEQNB_Instance_t     *pInstance,
     LVM_INT16           QFactor;                                /* Filter Q factor */
 
 
+#ifdef BUILD_FLOAT
+    LVEQNB_BiquadType_en    BiquadType;                 /* Previous biquad type */
+
+    if (pInstance->NBands != pParams->NBands)
+    {
+        pInstance->BankStale  = LVEQNB_ALL_BANDS;
+        pInstance->CoefsStale = LVEQNB_ALL_BANDS;
+    }
+#endif
     pInstance->NBands = pParams->NBands;
 
     for (i=0; i<pParams->NBands; i++)
@@ -164,6 +265,7 @@ void    LVEQNB_SetFilters(LVEQNB_Instance_t     *pInstance,
         QFactor = (LVM_INT16)pParams->pBandDefinition[i].QFactor;   /* Get the band Q factor */
 
 #ifdef BUILD_FLOAT
+        BiquadType = pInstance->pBiquadType[i];
         pInstance->pBiquadType[i] = LVEQNB_SinglePrecision_Float; /* Default to single precision */
 #else
         /*
@@ -200,12 +302,67 @@ void    LVEQNB_SetFilters(LVEQNB_Instance_t     *pInstance,
         /*
          * Copy the filter definition to persistant memory
          */
+#ifdef BUILD_FLOAT
+        if ((pInstance->pBandDefinitions[i].Frequency != pParams->pBandDefinition[i].Frequency) ||
+            (pInstance->pBandDefinitions[i].Gain      != pParams->pBandDefinition[i].Gain)      ||
+            (pInstance->pBandDefinitions[i].QFactor   != pParams->pBandDefinition[i].QFactor))
+        {
+            pInstance->BankStale  |= LVEQNB_BAND_BIT(i);
+            pInstance->CoefsStale |= LVEQNB_BAND_BIT(i);
+        }
+        if (pInstance->pBiquadType[i] != BiquadType)
+        {
+            pInstance->CoefsStale |= LVEQNB_BAND_BIT(i);
+        }
+#endif
         pInstance->pBandDefinitions[i] = pParams->pBandDefinition[i];
 
     }
 }
 
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_BandCoefs                                            */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Gets the single precision coefficients of a band, from the coefficient bank at  */
+/*  a banked sample rate.                                                           */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInstance           Pointer to the instance                                     */
+/*  Slot                Bank slot of the sample rate, -1 when not banked            */
+/*  Band                Band index                                                  */
+/*  pCoefficients       Pointer to the coefficients                                 */
+/*                                                                                  */
+/************************************************************************************/
+
+static void LVEQNB_BandCoefs(LVEQNB_Instance_t     *pInstance,
+                             LVM_INT16             Slot,
+                             LVM_UINT16            Band,
+                             PK_FLOAT_Coefs_t      *pCoefficients)
+{
+    if (Slot >= 0)
+    {
+        /*
+         * Take the precomputed coefficients from the bank
+         */
+        *pCoefficients = pInstance->pCoefBank[Slot * pInstance->Capabilities.MaxBands + Band];
+    }
+    else
+    {
+        /*
+         * Calculate the single precision coefficients
+         */
+        LVEQNB_SinglePrecCoefs((LVM_UINT16)pInstance->Params.SampleRate,
+                               &pInstance->pBandDefinitions[Band],
+                               pCoefficients);
+    }
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVEQNB_SetCoefficients                                      */
@@ -218,6 +375,15 @@ void    LVEQNB_SetFilters(LVEQNB_Instance_t     *pInstance,
 /*  pInstance           Pointer to the instance                                     */
 /*  pParams             Initialisation parameters                                   */
 /*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. At a banked sample rate the coefficients are taken from the coefficient      */
+/*     bank, the stale bands of the bank are filled first                           */
+/*  2. With the parallel engine the bands are then converted to the parallel form   */
+/*  3. In the float build only the stale bands are set, so changing one band of a   */
+/*     graphic equaliser costs one coefficient calculation                          */
+/*  4. The coefficient memory is not written when no band is stale, see             */
+/*     LVEQNB_SetCoefMemory                                                         */
+/*                                                                                  */
 /************************************************************************************/
 
 void    LVEQNB_SetCoefficients(LVEQNB_Instance_t     *pInstance)
@@ -225,6 +391,16 @@ void    LVEQNB_SetCoefficients(LVEQNB_Instance_t     *pInstance)
 
     LVM_UINT16              i;                          /* Filter band index */
     LVEQNB_BiquadType_en    BiquadType;                 /* Filter biquad type */
+#ifdef BUILD_FLOAT
+    LVM_INT16               Slot;                       /* Coefficient bank slot */
+
+    Slot = LVM_FsBankIndex(pInstance->Capabilities.CoefBankRates,
+                           (LVM_Fs_en)pInstance->Params.SampleRate);
+    if ((Slot >= 0) && (pInstance->BankStale != 0))
+    {
+        LVEQNB_SetCoefBank(pInstance);
+    }
+#endif
 
 
     /*
@@ -232,6 +408,12 @@ void    LVEQNB_SetCoefficients(LVEQNB_Instance_t     *pInstance)
      */
     for (i=0; i<pInstance->Params.NBands; i++)
     {
+#ifdef BUILD_FLOAT
+        if ((pInstance->CoefsStale & LVEQNB_BAND_BIT(i)) == 0)
+        {
+            continue;
+        }
+#endif
 
         /*
          * Check band type for correct initialisation method and recalculate the coefficients
@@ -242,19 +424,31 @@ void    LVEQNB_SetCoefficients(LVEQNB_Instance_t     *pInstance)
 #ifdef BUILD_FLOAT
             case    LVEQNB_SinglePrecision_Float:
             {
-                PK_FLOAT_Coefs_t      Coefficients;
-                /*
-                 * Calculate the single precision coefficients
-                 */
-                LVEQNB_SinglePrecCoefs((LVM_UINT16)pInstance->Params.SampleRate,
-                                       &pInstance->pBandDefinitions[i],
-                                       &Coefficients);
+                PK_FLOAT_Coefs_t      *pCoefficients = &pInstance->pBandCoefs[i];
+
+                LVEQNB_BandCoefs(pInstance,
+                                 Slot,
+                                 i,
+                                 pCoefficients);
                 /*
                  * Set the coefficients
                  */
                 PK_2I_D32F32CssGss_TRC_WRA_01_Init(&pInstance->pEQNB_FilterState_Float[i],
                                                    &pInstance->pEQNB_Taps_Float[i],
-                                                   &Coefficients);
+                                                   pCoefficients);
+
+                /*
+                 * Keep them for the parallel form
+                 */
+                if (pInstance->pParallelCoefs != LVM_NULL)
+                {
+                    LVEQNB_ParallelCoefs_t *pGroup = &pInstance->pParallelCoefs[i / LVEQNB_PARALLEL_LANES];
+
+                    pGroup->BandA0[i % LVEQNB_PARALLEL_LANES] = pCoefficients->A0;
+                    pGroup->BandG[i % LVEQNB_PARALLEL_LANES]  = pCoefficients->G;
+                    pGroup->A1[i % LVEQNB_PARALLEL_LANES]     = pCoefficients->B1;
+                    pGroup->A2[i % LVEQNB_PARALLEL_LANES]     = pCoefficients->B2;
+                }
                 break;
             }
 #else
@@ -303,9 +497,255 @@ void    LVEQNB_SetCoefficients(LVEQNB_Instance_t     *pInstance)
         }
     }
 
+#ifdef BUILD_FLOAT
+    /*
+     * Convert the bands to the parallel form, unless none of them changed
+     */
+    if ((pInstance->CoefsStale != 0) ||
+        (pInstance->ParallelBands != pInstance->NBands))
+    {
+        LVEQNB_SetParallel(pInstance);
+    }
+    pInstance->CoefsStale = 0;
+#endif
+}
+
+
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:                 LVEQNB_GetSections                                     */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the bands being processed as direct form second order sections with     */
+/*  their history.                                                                  */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance                Instance handle                                        */
+/*  pCoefs                   Pointer to 5 coefficients per band                     */
+/*  pHistory                 Pointer to the history of the sections                 */
+/*  HistoryStride            Distance between the histories of two channels         */
+/*  pNrSections              Pointer to the number of sections                      */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVEQNB_Success           Succeeds                                               */
+/*  LVEQNB_NULLADDRESS       hInstance, pCoefs, pHistory or pNrSections is NULL     */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1.  A band y = x + G * A0 * (x - x(n-2)) / (1 - B1 z^-1 - B2 z^-2) has the      */
+/*      section coefficients 1 + G*A0, -B1, -B2 - G*A0, B1 and B2. The band keeps   */
+/*      the history yb of the filtered part, the output history is x + G * yb       */
+/*  2.  There are no sections while the bands run in parallel form                  */
+/*                                                                                  */
+/************************************************************************************/
+
+LVEQNB_ReturnStatus_en LVEQNB_GetSections(LVEQNB_Handle_t           hInstance,
+                                          LVM_FLOAT                 *pCoefs,
+                                          LVM_FLOAT                 *pHistory,
+                                          LVM_UINT16                HistoryStride,
+                                          LVM_UINT16                *pNrSections)
+{
+
+    LVEQNB_Instance_t    *pInstance =(LVEQNB_Instance_t  *)hInstance;
+    PK_FLOAT_Coefs_t     Coefficients;
+    LVM_FLOAT            *pTaps;
+    LVM_FLOAT            *pSection;
+    LVM_INT32            NrChannels;
+    LVM_INT32            ch;
+    LVM_INT16            Slot;
+    LVM_UINT16           NrSections = 0;
+    LVM_UINT16           i;
+
+    if((hInstance == LVM_NULL) || (pCoefs == LVM_NULL) ||
+       (pHistory == LVM_NULL) || (pNrSections == LVM_NULL))
+    {
+        return LVEQNB_NULLADDRESS;
+    }
+
+    *pNrSections = 0;
+    if ((pInstance->Params.OperatingMode != LVEQNB_ON) ||
+        (pInstance->bInOperatingModeTransition == LVM_TRUE) ||
+        (pInstance->ParallelGroups != 0))
+    {
+        return(LVEQNB_SUCCESS);
+    }
+
+#ifdef SUPPORT_MC
+    /* Mono is processed as stereo */
+    NrChannels = (pInstance->Params.NrChannels == 1) ? 2 : pInstance->Params.NrChannels;
+#else
+    NrChannels = 2;
+#endif
+    Slot = LVM_FsBankIndex(pInstance->Capabilities.CoefBankRates,
+                           (LVM_Fs_en)pInstance->Params.SampleRate);
+
+    for (i = 0; i < pInstance->NBands; i++)
+    {
+        if ((pInstance->pBandDefinitions[i].Gain == 0) ||
+            (pInstance->pBiquadType[i] != LVEQNB_SinglePrecision_Float))
+        {
+            continue;
+        }
+
+        LVEQNB_BandCoefs(pInstance,
+                         Slot,
+                         i,
+                         &Coefficients);
+        pCoefs[0] = 1.0f + Coefficients.G * Coefficients.A0;
+        pCoefs[1] = -Coefficients.B1;
+        pCoefs[2] = -Coefficients.B2 - Coefficients.G * Coefficients.A0;
+        pCoefs[3] = Coefficients.B1;
+        pCoefs[4] = Coefficients.B2;
+        pCoefs += 5;
+
+        /*
+         * The taps are x(n-1), x(n-2), yb(n-1) and yb(n-2) of all the channels
+         */
+        pTaps = pInstance->pEQNB_Taps_Float[i].Storage;
+        for (ch = 0; ch < NrChannels; ch++)
+        {
+            pSection = &pHistory[ch * HistoryStride + 2 * NrSections];
+            pSection[0] = pTaps[ch];
+            pSection[1] = pTaps[NrChannels + ch];
+            pSection[2] = pTaps[ch] + Coefficients.G * pTaps[2 * NrChannels + ch];
+            pSection[3] = pTaps[NrChannels + ch] + Coefficients.G * pTaps[3 * NrChannels + ch];
+        }
+        NrSections++;
+    }
+    *pNrSections = NrSections;
+
+    return(LVEQNB_SUCCESS);
+}
+
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:                 LVEQNB_SetSectionHistory                               */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Sets the history of the bands from the sections returned by LVEQNB_GetSections. */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance                Instance handle                                        */
+/*  pHistory                 Pointer to the history of the sections                 */
+/*  HistoryStride            Distance between the histories of two channels         */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVEQNB_Success           Succeeds                                               */
+/*  LVEQNB_NULLADDRESS       hInstance or pHistory is NULL                          */
+/*                                                                                  */
+/************************************************************************************/
+
+LVEQNB_ReturnStatus_en LVEQNB_SetSectionHistory(LVEQNB_Handle_t     hInstance,
+                                                const LVM_FLOAT     *pHistory,
+                                                LVM_UINT16          HistoryStride)
+{
+
+    LVEQNB_Instance_t    *pInstance =(LVEQNB_Instance_t  *)hInstance;
+    PK_FLOAT_Coefs_t     Coefficients;
+    LVM_FLOAT            *pTaps;
+    const LVM_FLOAT      *pSection;
+    LVM_INT32            NrChannels;
+    LVM_INT32            ch;
+    LVM_INT16            Slot;
+    LVM_UINT16           NrSections = 0;
+    LVM_UINT16           i;
+
+    if((hInstance == LVM_NULL) || (pHistory == LVM_NULL))
+    {
+        return LVEQNB_NULLADDRESS;
+    }
+
+    if (pInstance->ParallelGroups != 0)
+    {
+        return(LVEQNB_SUCCESS);
+    }
+
+#ifdef SUPPORT_MC
+    NrChannels = (pInstance->Params.NrChannels == 1) ? 2 : pInstance->Params.NrChannels;
+#else
+    NrChannels = 2;
+#endif
+    Slot = LVM_FsBankIndex(pInstance->Capabilities.CoefBankRates,
+                           (LVM_Fs_en)pInstance->Params.SampleRate);
+
+    for (i = 0; i < pInstance->NBands; i++)
+    {
+        if ((pInstance->pBandDefinitions[i].Gain == 0) ||
+            (pInstance->pBiquadType[i] != LVEQNB_SinglePrecision_Float))
+        {
+            continue;
+        }
+
+        /*
+         * The filtered part is the output less the input over the band gain
+         */
+        LVEQNB_BandCoefs(pInstance,
+                         Slot,
+                         i,
+                         &Coefficients);
+        pTaps = pInstance->pEQNB_Taps_Float[i].Storage;
+        for (ch = 0; ch < NrChannels; ch++)
+        {
+            pSection = &pHistory[ch * HistoryStride + 2 * NrSections];
+            pTaps[ch]                  = pSection[0];
+            pTaps[NrChannels + ch]     = pSection[1];
+            pTaps[2 * NrChannels + ch] = (pSection[2] - pSection[0]) / Coefficients.G;
+            pTaps[3 * NrChannels + ch] = (pSection[3] - pSection[1]) / Coefficients.G;
+        }
+        NrSections++;
+    }
+
+    return(LVEQNB_SUCCESS);
 }
 
 
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_SetCoefBank                                          */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Calculates the single precision coefficients of the stale bands for every       */
+/*  banked sample rate.                                                             */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInstance           Pointer to the instance                                     */
+/*                                                                                  */
+/************************************************************************************/
+
+void    LVEQNB_SetCoefBank(LVEQNB_Instance_t     *pInstance)
+{
+
+    LVM_UINT32              BankRates = pInstance->Capabilities.CoefBankRates;
+    PK_FLOAT_Coefs_t        *pCoefficients = pInstance->pCoefBank;
+    LVM_UINT16              Fs;                         /* Banked sample rate */
+    LVM_UINT16              i;                          /* Filter band index */
+
+
+    for (Fs=0; BankRates != LVM_FS_BANK_NONE; Fs++)
+    {
+        if ((BankRates & LVM_FS_BANK(Fs)) != 0)
+        {
+            for (i=0; i<pInstance->NBands; i++)
+            {
+                if ((pInstance->BankStale & LVEQNB_BAND_BIT(i)) == 0)
+                {
+                    continue;
+                }
+                LVEQNB_SinglePrecCoefs(Fs,
+                                       &pInstance->pBandDefinitions[i],
+                                       &pCoefficients[i]);
+            }
+            pCoefficients += pInstance->Capabilities.MaxBands;
+            BankRates &= ~LVM_FS_BANK(Fs);
+        }
+    }
+    pInstance->BankStale = 0;
+
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVEQNB_ClearFilterHistory                                   */
@@ -350,6 +790,7 @@ void    LVEQNB_ClearFilterHistory(LVEQNB_Instance_t     *pInstance)
                         pTapAddress,                       /* Destination */
                         NumTaps);                          /* Number of words */
     }
+    LVEQNB_ClearParallelHistory(pInstance);
 }
 #endif
 /****************************************************************************************/
@@ -426,6 +867,7 @@ LVEQNB_ReturnStatus_en LVEQNB_Control(LVEQNB_Handle_t        hInstance,
             {
 
                 bChange = LVM_TRUE;
+                break;
             }
         }
     }
@@ -442,12 +884,21 @@ LVEQNB_ReturnStatus_en LVEQNB_Control(LVEQNB_Handle_t        hInstance,
     if (bChange || modeChange) {
 
         /*
-         * If the sample rate has changed clear the history
+         * If the sample rate has changed clear the history, unless both rates are banked
          */
-        if (pInstance->Params.SampleRate != pParams->SampleRate)
+        if ((pInstance->Params.SampleRate != pParams->SampleRate) &&
+            (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                              (LVM_Fs_en)pInstance->Params.SampleRate,
+                              (LVM_Fs_en)pParams->SampleRate) == LVM_FALSE))
         {
             LVEQNB_ClearFilterHistory(pInstance);           /* Clear the history */
         }
+#ifdef BUILD_FLOAT
+        if (pInstance->Params.SampleRate != pParams->SampleRate)
+        {
+            pInstance->CoefsStale = LVEQNB_ALL_BANDS;       /* The bank stays valid */
+        }
+#endif
 
         /*
          * Update the instance parameters
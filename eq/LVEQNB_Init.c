@@ -111,6 +111,16 @@ LVEQNB_ReturnStatus_en LVEQNB_Memory(LVEQNB_Handle_t            hInstance,
         /* Biquad types */
         InstAlloc_AddMember(&AllocMem,
                             (pCapabilities->MaxBands * sizeof(LVEQNB_BiquadType_en)));
+        /* Equaliser Biquad Instance */
+        InstAlloc_AddMember(&AllocMem,
+                            pCapabilities->MaxBands * sizeof(Biquad_FLOAT_Instance_t));
+        /* Parallel section history */
+        if (pCapabilities->Engine == LVEQNB_ENGINE_PARALLEL)
+        {
+            InstAlloc_AddMember(&AllocMem,
+                                LVEQNB_PARALLEL_GROUPS(pCapabilities->MaxBands) * \
+                                LVM_MAX_CHANNELS * sizeof(LVEQNB_ParallelTaps_t));
+        }
 #else
         InstAlloc_AddMember(&AllocMem,                              /* Low pass filter */
                             sizeof(Biquad_2I_Order2_Taps_t));
@@ -138,9 +148,20 @@ LVEQNB_ReturnStatus_en LVEQNB_Memory(LVEQNB_Handle_t            hInstance,
                             sizeof(Biquad_FLOAT_Instance_t));
         InstAlloc_AddMember(&AllocMem,                              /* High pass filter */
                             sizeof(Biquad_FLOAT_Instance_t));
-        /* Equaliser Biquad Instance */
+        /* Band coefficients */
         InstAlloc_AddMember(&AllocMem,
-                            pCapabilities->MaxBands * sizeof(Biquad_FLOAT_Instance_t));
+                            pCapabilities->MaxBands * sizeof(PK_FLOAT_Coefs_t));
+        /* Coefficient bank */
+        InstAlloc_AddMember(&AllocMem,
+                            LVM_FsBankSize(pCapabilities->CoefBankRates) * \
+                            pCapabilities->MaxBands * sizeof(PK_FLOAT_Coefs_t));
+        /* Parallel sections */
+        if (pCapabilities->Engine == LVEQNB_ENGINE_PARALLEL)
+        {
+            InstAlloc_AddMember(&AllocMem,
+                                LVEQNB_PARALLEL_GROUPS(pCapabilities->MaxBands) * \
+                                sizeof(LVEQNB_ParallelCoefs_t));
+        }
 #else
         InstAlloc_AddMember(&AllocMem,                              /* Low pass filter */
                             sizeof(Biquad_Instance_t));
@@ -277,15 +298,17 @@ LVEQNB_ReturnStatus_en LVEQNB_Init(LVEQNB_Handle_t          *phInstance,
     /*
      * Allocate coefficient memory
      */
+#ifdef BUILD_FLOAT
+    LVEQNB_MapCoefMemory(pInstance);
+    pInstance->BankStale  = LVEQNB_ALL_BANDS;
+    pInstance->CoefsStale = LVEQNB_ALL_BANDS;
+    pInstance->ParallelDirect = 1.0f;
+    pInstance->ParallelGroups = 0;
+    pInstance->ParallelBands  = 0;
+#else
     InstAlloc_Init(&AllocMem,
                    pMemoryTable->Region[LVEQNB_MEMREGION_PERSISTENT_COEF].pBaseAddress);
 
-#ifdef BUILD_FLOAT
-    /* Equaliser Biquad Instance */
-    pInstance->pEQNB_FilterState_Float = InstAlloc_AddMember(&AllocMem,
-                                                             pCapabilities->MaxBands * \
-                                                             sizeof(Biquad_FLOAT_Instance_t));
-#else
     pInstance->pEQNB_FilterState = InstAlloc_AddMember(&AllocMem,
                                                        pCapabilities->MaxBands * sizeof(Biquad_Instance_t)); /* Equaliser Biquad Instance */
 #endif
@@ -316,6 +339,20 @@ LVEQNB_ReturnStatus_en LVEQNB_Init(LVEQNB_Handle_t          *phInstance,
     MemSize = (pCapabilities->MaxBands * sizeof(LVEQNB_BiquadType_en));
     pInstance->pBiquadType = (LVEQNB_BiquadType_en *)InstAlloc_AddMember(&AllocMem,
                                                                          MemSize);
+#ifdef BUILD_FLOAT
+    /* Equaliser Biquad Instance, it reads the band coefficients */
+    MemSize = (pCapabilities->MaxBands * sizeof(Biquad_FLOAT_Instance_t));
+    pInstance->pEQNB_FilterState_Float = (Biquad_FLOAT_Instance_t *)InstAlloc_AddMember(&AllocMem,
+                                                                                        MemSize);
+    pInstance->pParallelTaps = LVM_NULL;
+    if (pCapabilities->Engine == LVEQNB_ENGINE_PARALLEL)
+    {
+        MemSize = (LVEQNB_PARALLEL_GROUPS(pCapabilities->MaxBands) * \
+                   LVM_MAX_CHANNELS * sizeof(LVEQNB_ParallelTaps_t));
+        pInstance->pParallelTaps = (LVEQNB_ParallelTaps_t *)InstAlloc_AddMember(&AllocMem,
+                                                                                MemSize);
+    }
+#endif
 
 
     /*
@@ -380,3 +417,102 @@ LVEQNB_ReturnStatus_en LVEQNB_Init(LVEQNB_Handle_t          *phInstance,
     return(LVEQNB_SUCCESS);
 }
 
+
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVEQNB_MapCoefMemory                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Sets the pointers to the band coefficients, the coefficient bank and the parallel   */
+/*  sections in the coefficient region of the memory table.                             */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  pInstance               Pointer to the instance                                     */
+/*                                                                                      */
+/****************************************************************************************/
+
+void LVEQNB_MapCoefMemory(LVEQNB_Instance_t     *pInstance)
+{
+
+    LVEQNB_Capabilities_t   *pCapabilities = &pInstance->Capabilities;
+    INST_ALLOC              AllocMem;
+
+    InstAlloc_Init(&AllocMem,
+                   pInstance->MemoryTable.Region[LVEQNB_MEMREGION_PERSISTENT_COEF].pBaseAddress);
+
+    /* Band coefficients, set with the filters */
+    pInstance->pBandCoefs = InstAlloc_AddMember(&AllocMem,
+                                                pCapabilities->MaxBands * sizeof(PK_FLOAT_Coefs_t));
+    /* Coefficient bank, filled when the band definitions are set */
+    pInstance->pCoefBank = LVM_NULL;
+    if (LVM_FsBankSize(pCapabilities->CoefBankRates) != 0)
+    {
+        pInstance->pCoefBank = InstAlloc_AddMember(&AllocMem,
+                                                   LVM_FsBankSize(pCapabilities->CoefBankRates) * \
+                                                   pCapabilities->MaxBands * sizeof(PK_FLOAT_Coefs_t));
+    }
+    /* Parallel sections, set with the coefficients */
+    pInstance->pParallelCoefs = LVM_NULL;
+    if (pCapabilities->Engine == LVEQNB_ENGINE_PARALLEL)
+    {
+        pInstance->pParallelCoefs = InstAlloc_AddMember(&AllocMem,
+                                                        LVEQNB_PARALLEL_GROUPS(pCapabilities->MaxBands) * \
+                                                        sizeof(LVEQNB_ParallelCoefs_t));
+    }
+}
+
+
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                LVEQNB_SetCoefMemory                                        */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Moves the instance to a copy of its persistent coefficient region, the filters      */
+/*  read their coefficients from the new region.                                        */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance               Instance handle                                             */
+/*  pCoefMemory             Base address of the copy of the coefficient region          */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVEQNB_SUCCESS          Succeeded                                                   */
+/*  LVEQNB_NULLADDRESS      When hInstance or pCoefMemory is NULL                       */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The coefficient region holds no addresses, it can be moved or shared by         */
+/*      instances with the same capabilities and parameters. The filters only write it  */
+/*      when their parameters change                                                    */
+/*  2.  This function must not be interrupted by the LVEQNB_Process function            */
+/*                                                                                      */
+/****************************************************************************************/
+
+LVEQNB_ReturnStatus_en LVEQNB_SetCoefMemory(LVEQNB_Handle_t      hInstance,
+                                            void                 *pCoefMemory)
+{
+
+    LVEQNB_Instance_t   *pInstance = (LVEQNB_Instance_t *)hInstance;
+    LVM_UINT16          i;
+
+    if ((hInstance == LVM_NULL) || (pCoefMemory == LVM_NULL))
+    {
+        return LVEQNB_NULLADDRESS;
+    }
+
+    pInstance->MemoryTable.Region[LVEQNB_MEMREGION_PERSISTENT_COEF].pBaseAddress = pCoefMemory;
+    LVEQNB_MapCoefMemory(pInstance);
+
+    /*
+     * Point the filters at their taps and the moved coefficients
+     */
+    for (i = 0; i < pInstance->Capabilities.MaxBands; i++)
+    {
+        PK_2I_D32F32CssGss_TRC_WRA_01_Init(&pInstance->pEQNB_FilterState_Float[i],
+                                           &pInstance->pEQNB_Taps_Float[i],
+                                           &pInstance->pBandCoefs[i]);
+    }
+
+    return(LVEQNB_SUCCESS);
+}
+#endif
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/****************************************************************************************/
+/*                                                                                      */
+/*  Includes                                                                            */
+/*                                                                                      */
+/****************************************************************************************/
+
+#include <math.h>
+#include "LVEQNB.h"
+#include "LVEQNB_Private.h"
+#include "VectorArithmetic.h"
+
+#ifdef BUILD_FLOAT
+/****************************************************************************************/
+/*                                                                                      */
+/*  Types                                                                               */
+/*                                                                                      */
+/****************************************************************************************/
+
+/* Complex value of the conversion */
+typedef struct
+{
+    double      Re;
+    double      Im;
+} LVEQNB_Complex_t;
+
+#if defined(__GNUC__)
+/* Vectors of a group */
+#define LVEQNB_PARALLEL_VECTORS     (LVEQNB_PARALLEL_LANES / LVM_FLOAT_VECTOR_LANES)
+#endif
+
+/* Lane of a band in the groups */
+#define LVEQNB_LANE(pCoefs, Field, Band) \
+            ((pCoefs)[(Band) / LVEQNB_PARALLEL_LANES].Field[(Band) % LVEQNB_PARALLEL_LANES])
+
+
+static LVEQNB_Complex_t LVEQNB_ComplexMul(LVEQNB_Complex_t     a,
+                                          LVEQNB_Complex_t     b)
+{
+    LVEQNB_Complex_t    Product;
+
+    Product.Re = a.Re * b.Re - a.Im * b.Im;
+    Product.Im = a.Re * b.Im + a.Im * b.Re;
+    return Product;
+}
+
+
+static LVEQNB_Complex_t LVEQNB_ComplexDiv(LVEQNB_Complex_t     a,
+                                          LVEQNB_Complex_t     b)
+{
+    LVEQNB_Complex_t    Quotient;
+    double              Norm = b.Re * b.Re + b.Im * b.Im;
+
+    Quotient.Re = (a.Re * b.Re + a.Im * b.Im) / Norm;
+    Quotient.Im = (a.Im * b.Re - a.Re * b.Im) / Norm;
+    return Quotient;
+}
+
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_BandResponse                                         */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the response 1 + G * A0 * (1 - q^2) / (1 - B1 q - B2 q^2) of a band at  */
+/*  the point q = z^-1.                                                             */
+/*                                                                                  */
+/************************************************************************************/
+
+static LVEQNB_Complex_t LVEQNB_BandResponse(const LVEQNB_ParallelCoefs_t  *pCoefs,
+                                            LVM_UINT16                    Band,
+                                            LVEQNB_Complex_t              q)
+{
+    LVEQNB_Complex_t    q2 = LVEQNB_ComplexMul(q, q);
+    LVEQNB_Complex_t    Numerator;
+    LVEQNB_Complex_t    Denominator;
+    LVEQNB_Complex_t    Response;
+    double              GA0 = (double)LVEQNB_LANE(pCoefs, BandG, Band) * LVEQNB_LANE(pCoefs, BandA0, Band);
+    double              B1 = LVEQNB_LANE(pCoefs, A1, Band);
+    double              B2 = LVEQNB_LANE(pCoefs, A2, Band);
+
+    Numerator.Re   = GA0 * (1.0 - q2.Re);
+    Numerator.Im   = -GA0 * q2.Im;
+    Denominator.Re = 1.0 - B1 * q.Re - B2 * q2.Re;
+    Denominator.Im = -B1 * q.Im - B2 * q2.Im;
+    Response = LVEQNB_ComplexDiv(Numerator, Denominator);
+    Response.Re += 1.0;
+    return Response;
+}
+
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_SetParallel                                          */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Converts the cascade of the bands being processed to a direct path and one      */
+/*  parallel section per band by partial fractions.                                 */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInstance           Pointer to the instance                                     */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. LVEQNB_SetCoefficients leaves the peaking coefficients of each band in its   */
+/*     lane first. The conversion is done in double precision from them, so the     */
+/*     parallel form has the response of the single precision cascade               */
+/*  2. Each band k contributes the residues of its poles p1 and p2,                 */
+/*          R1 = G*A0 * (1 - p1^-2) / (1 - p2/p1) * (other bands at p1)             */
+/*     and its section numerator is B0 = R1 + R2, B1 = -(R1*p2 + R2*p1). The direct */
+/*     path is the product of the band gains at z = infinity less the sum of B0     */
+/*  3. Bands with the same poles make the form ill-conditioned, the bands then run  */
+/*     in series. The history is cleared when the bands change between the forms    */
+/*  4. Every residue depends on all the bands, so the whole form is converted again */
+/*     whenever a band changes. The cost is O(N^2) band responses for N bands being */
+/*     processed, 1860 for 31 bands, whether one band or all of them changed        */
+/*                                                                                  */
+/************************************************************************************/
+
+void    LVEQNB_SetParallel(LVEQNB_Instance_t     *pInstance)
+{
+
+    LVEQNB_ParallelCoefs_t  *pCoefs = pInstance->pParallelCoefs;
+    LVM_UINT16              Groups = (LVM_UINT16)LVEQNB_PARALLEL_GROUPS(pInstance->NBands);
+    LVM_UINT16              Active = 0;                 /* Number of bands being processed */
+    LVM_INT16               Valid = LVM_TRUE;
+    LVEQNB_Complex_t        Pole[2];
+    LVEQNB_Complex_t        q;
+    LVEQNB_Complex_t        Residue[2];
+    double                  GA0;
+    double                  B1;
+    double                  B2;
+    double                  Root;
+    double                  Direct = 1.0;
+    double                  Sum = 0.0;
+    double                  Numerator[2];
+    LVM_UINT16              i;
+    LVM_UINT16              j;
+    LVM_UINT16              k;
+    LVM_UINT16              n;
+
+    if (pCoefs == LVM_NULL)
+    {
+        return;
+    }
+
+    /*
+     * Leave the lanes of the bands not processed out of the form
+     */
+    for (i = 0; i < Groups * LVEQNB_PARALLEL_LANES; i++)
+    {
+        if ((i >= pInstance->NBands) ||
+            (pInstance->pBandDefinitions[i].Gain == 0) ||
+            (pInstance->pBiquadType[i] != LVEQNB_SinglePrecision_Float))
+        {
+            LVEQNB_LANE(pCoefs, BandA0, i) = 0.0f;
+            LVEQNB_LANE(pCoefs, BandG, i)  = 0.0f;
+            LVEQNB_LANE(pCoefs, A1, i)     = 0.0f;
+            LVEQNB_LANE(pCoefs, A2, i)     = 0.0f;
+            LVEQNB_LANE(pCoefs, B0, i)     = 0.0f;
+            LVEQNB_LANE(pCoefs, B1, i)     = 0.0f;
+        }
+    }
+
+    for (k = 0; k < pInstance->NBands; k++)
+    {
+        if (LVEQNB_LANE(pCoefs, BandG, k) == 0.0f)
+        {
+            continue;
+        }
+        Active++;
+
+        /*
+         * Poles of the band, the roots of z^2 - B1 z - B2
+         */
+        GA0 = (double)LVEQNB_LANE(pCoefs, BandG, k) * LVEQNB_LANE(pCoefs, BandA0, k);
+        B1  = LVEQNB_LANE(pCoefs, A1, k);
+        B2  = LVEQNB_LANE(pCoefs, A2, k);
+        Direct *= 1.0 + GA0;
+        Root = B1 * B1 + 4.0 * B2;
+        if (Root < 0.0)
+        {
+            Pole[0].Re = 0.5 * B1;
+            Pole[0].Im = 0.5 * sqrt(-Root);
+            Pole[1].Re = Pole[0].Re;
+            Pole[1].Im = -Pole[0].Im;
+        }
+        else
+        {
+            Pole[0].Re = 0.5 * (B1 + sqrt(Root));
+            Pole[0].Im = 0.0;
+            Pole[1].Re = 0.5 * (B1 - sqrt(Root));
+            Pole[1].Im = 0.0;
+        }
+
+        /*
+         * Residue of each pole
+         */
+        for (n = 0; n < 2; n++)
+        {
+            LVEQNB_Complex_t    One = {1.0, 0.0};
+            LVEQNB_Complex_t    Numer;
+            LVEQNB_Complex_t    Denom;
+            LVEQNB_Complex_t    q2;
+
+            q = LVEQNB_ComplexDiv(One, Pole[n]);
+            q2 = LVEQNB_ComplexMul(q, q);
+            Numer.Re = GA0 * (1.0 - q2.Re);
+            Numer.Im = -GA0 * q2.Im;
+            Denom = LVEQNB_ComplexMul(Pole[1 - n], q);
+            Denom.Re = 1.0 - Denom.Re;
+            Denom.Im = -Denom.Im;
+            Residue[n] = LVEQNB_ComplexDiv(Numer, Denom);
+
+            for (j = 0; j < pInstance->NBands; j++)
+            {
+                if ((j != k) && (LVEQNB_LANE(pCoefs, BandG, j) != 0.0f))
+                {
+                    Residue[n] = LVEQNB_ComplexMul(Residue[n],
+                                                   LVEQNB_BandResponse(pCoefs, j, q));
+                }
+            }
+        }
+
+        Numerator[0] = Residue[0].Re + Residue[1].Re;
+        Numerator[1] = -(LVEQNB_ComplexMul(Residue[0], Pole[1]).Re +
+                         LVEQNB_ComplexMul(Residue[1], Pole[0]).Re);
+        if (!(fabs(Numerator[0]) < LVEQNB_PARALLEL_MAXCOEF) ||
+            !(fabs(Numerator[1]) < LVEQNB_PARALLEL_MAXCOEF))
+        {
+            Valid = LVM_FALSE;
+        }
+        LVEQNB_LANE(pCoefs, B0, k) = (LVM_FLOAT)Numerator[0];
+        LVEQNB_LANE(pCoefs, B1, k) = (LVM_FLOAT)Numerator[1];
+        Sum += Numerator[0];
+    }
+    Direct -= Sum;
+    if (!(fabs(Direct) < LVEQNB_PARALLEL_MAXCOEF))
+    {
+        Valid = LVM_FALSE;
+    }
+
+    if ((Valid == LVM_FALSE) || (Active == 0))
+    {
+        Groups = 0;
+    }
+
+    /*
+     * The history of the other form does not carry over
+     */
+    if ((Groups != 0) && (pInstance->ParallelGroups == 0))
+    {
+        LVEQNB_ClearParallelHistory(pInstance);
+    }
+    else if ((Groups == 0) && (pInstance->ParallelGroups != 0))
+    {
+        LVEQNB_ClearFilterHistory(pInstance);
+    }
+    pInstance->ParallelDirect = (LVM_FLOAT)Direct;
+    pInstance->ParallelGroups = Groups;
+    pInstance->ParallelBands  = pInstance->NBands;
+}
+
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_ClearParallelHistory                                 */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Clears the history of the parallel sections                                     */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInstance           Pointer to the instance                                     */
+/*                                                                                  */
+/************************************************************************************/
+
+void    LVEQNB_ClearParallelHistory(LVEQNB_Instance_t *pInstance)
+{
+    if (pInstance->pParallelTaps != LVM_NULL)
+    {
+        LoadConst_Float(0,                              /* Clear the history, value 0 */
+                        (LVM_FLOAT *)pInstance->pParallelTaps,
+                        (LVM_INT16)(LVEQNB_PARALLEL_GROUPS(pInstance->Capabilities.MaxBands) * \
+                                    LVM_MAX_CHANNELS * sizeof(LVEQNB_ParallelTaps_t) / sizeof(LVM_FLOAT)));
+    }
+}
+
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVEQNB_ParallelProcess                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Filters a block with the parallel form, the output is the direct path plus the  */
+/*  sum of the sections. The sections of a group run in the lanes of the vectors    */
+/*  on the same input sample.                                                       */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInstance           Pointer to the instance                                     */
+/*  pInData             Pointer to the interleaved input                            */
+/*  pOutData            Pointer to the interleaved output, not the input            */
+/*  NrFrames            Number of frames                                            */
+/*  NrChannels          Number of channels                                          */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. Each group runs over the whole channel block with its coefficients and       */
+/*     history held in registers, its output is added to the output block           */
+/*                                                                                  */
+/************************************************************************************/
+
+void    LVEQNB_ParallelProcess(LVEQNB_Instance_t    *pInstance,
+                               const LVM_FLOAT      *pInData,
+                               LVM_FLOAT            *pOutData,
+                               LVM_INT16            NrFrames,
+                               LVM_INT16            NrChannels)
+{
+    LVM_INT32               MaxGroups = LVEQNB_PARALLEL_GROUPS(pInstance->Capabilities.MaxBands);
+    LVEQNB_ParallelCoefs_t  *pCoefs;
+    LVEQNB_ParallelTaps_t   *pTaps;
+    const LVM_FLOAT         *pIn;
+    LVM_FLOAT               *pOut;
+    LVM_FLOAT               x;
+#if defined(__GNUC__)
+    LVM_FloatVector_t       B0[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       B1[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       A1[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       A2[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       W0;
+    LVM_FloatVector_t       W1[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       W2[LVEQNB_PARALLEL_VECTORS];
+    LVM_FloatVector_t       Sum;
+    const LVM_FloatVector_t Zero = {0.0f, 0.0f, 0.0f, 0.0f};
+    LVM_INT16               Vector;
+#else
+    LVM_FLOAT               W0;
+    LVM_FLOAT               Sum;
+    LVM_INT16               Lane;
+#endif
+    LVM_INT16               ch;
+    LVM_INT16               Group;
+    LVM_INT16               ii;
+
+    /*
+     * Direct path
+     */
+    Mult3s_Float(pInData,
+                 pInstance->ParallelDirect,
+                 pOutData,
+                 (LVM_INT16)(NrChannels * NrFrames));
+
+    for (ch = 0; ch < NrChannels; ch++)
+    {
+        for (Group = 0; Group < (LVM_INT16)pInstance->ParallelGroups; Group++)
+        {
+            pCoefs = &pInstance->pParallelCoefs[Group];
+            pTaps  = &pInstance->pParallelTaps[ch * MaxGroups + Group];
+            pIn    = &pInData[ch];
+            pOut   = &pOutData[ch];
+#if defined(__GNUC__)
+            for (Vector = 0; Vector < LVEQNB_PARALLEL_VECTORS; Vector++)
+            {
+                B0[Vector] = ((LVM_FloatVector_t *)pCoefs->B0)[Vector];
+                B1[Vector] = ((LVM_FloatVector_t *)pCoefs->B1)[Vector];
+                A1[Vector] = ((LVM_FloatVector_t *)pCoefs->A1)[Vector];
+                A2[Vector] = ((LVM_FloatVector_t *)pCoefs->A2)[Vector];
+                W1[Vector] = ((LVM_FloatVector_t *)pTaps->W1)[Vector];
+                W2[Vector] = ((LVM_FloatVector_t *)pTaps->W2)[Vector];
+            }
+            for (ii = NrFrames; ii != 0; ii--)
+            {
+                x = *pIn;
+                Sum = Zero;
+                for (Vector = 0; Vector < LVEQNB_PARALLEL_VECTORS; Vector++)
+                {
+                    W0 = x + A1[Vector] * W1[Vector] + A2[Vector] * W2[Vector];
+                    Sum += B0[Vector] * W0 + B1[Vector] * W1[Vector];
+                    W2[Vector] = W1[Vector];
+                    W1[Vector] = W0;
+                }
+                *pOut += (Sum[0] + Sum[1]) + (Sum[2] + Sum[3]);
+                pIn  += NrChannels;
+                pOut += NrChannels;
+            }
+            for (Vector = 0; Vector < LVEQNB_PARALLEL_VECTORS; Vector++)
+            {
+                ((LVM_FloatVector_t *)pTaps->W1)[Vector] = W1[Vector];
+                ((LVM_FloatVector_t *)pTaps->W2)[Vector] = W2[Vector];
+            }
+#else
+            for (ii = NrFrames; ii != 0; ii--)
+            {
+                x = *pIn;
+                Sum = 0.0f;
+                for (Lane = 0; Lane < LVEQNB_PARALLEL_LANES; Lane++)
+                {
+                    W0 = x + pCoefs->A1[Lane] * pTaps->W1[Lane] + pCoefs->A2[Lane] * pTaps->W2[Lane];
+                    Sum += pCoefs->B0[Lane] * W0 + pCoefs->B1[Lane] * pTaps->W1[Lane];
+                    pTaps->W2[Lane] = pTaps->W1[Lane];
+                    pTaps->W1[Lane] = W0;
+                }
+                *pOut += Sum;
+                pIn  += NrChannels;
+                pOut += NrChannels;
+            }
+#endif
+        }
+    }
+}
+#endif
@@ -32,6 +32,7 @@ extern "C" {
 #include "LVEQNB.h"                                     /* Calling or Application layer definitions */
 #include "BIQUAD.h"
 #include "LVC_Mixer.h"
+#include "LVM_Common.h"
 
 /****************************************************************************************/
 /*                                                                                      */
@@ -56,6 +57,18 @@ extern "C" {
 
 #define LVEQNB_BYPASS_MIXER_TC      100                 /* Bypass Mixer TC */
 
+#ifdef BUILD_FLOAT
+/* Stale band masks, one bit per band, the bands from 31 on share the last bit */
+#define LVEQNB_BAND_BIT(Band)       ((LVM_UINT32)1 << ((Band) < 31 ? (Band) : 31))
+#define LVEQNB_ALL_BANDS            0xFFFFFFFF
+
+/* Parallel engine */
+#define LVEQNB_PARALLEL_LANES       8                   /* Number of sections filtered together */
+#define LVEQNB_PARALLEL_GROUPS(MaxBands) \
+            (((MaxBands) + LVEQNB_PARALLEL_LANES - 1) / LVEQNB_PARALLEL_LANES)
+#define LVEQNB_PARALLEL_MAXCOEF     1.0e4               /* Largest section coefficient of a usable form */
+#endif
+
 /****************************************************************************************/
 /*                                                                                      */
 /*  Types                                                                               */
@@ -83,6 +96,28 @@ typedef enum
 
 
 
+#ifdef BUILD_FLOAT
+/* Parallel sections of a group of bands, one lane per band. The section of a lane is
+   w = x + A1 * w(n-1) + A2 * w(n-2), y = B0 * w + B1 * w(n-1). The lanes of the bands
+   not processed have zero coefficients */
+typedef struct
+{
+    LVM_FLOAT   B0[LVEQNB_PARALLEL_LANES];              /* Numerator of the section */
+    LVM_FLOAT   B1[LVEQNB_PARALLEL_LANES];
+    LVM_FLOAT   A1[LVEQNB_PARALLEL_LANES];              /* Negated denominator */
+    LVM_FLOAT   A2[LVEQNB_PARALLEL_LANES];
+    LVM_FLOAT   BandA0[LVEQNB_PARALLEL_LANES];          /* Peaking filter A0 and gain of each band, */
+    LVM_FLOAT   BandG[LVEQNB_PARALLEL_LANES];           /* kept for the conversion */
+} LVEQNB_ParallelCoefs_t;
+
+/* Parallel section history of a group of bands for one channel */
+typedef struct
+{
+    LVM_FLOAT   W1[LVEQNB_PARALLEL_LANES];              /* w(n-1) of each section */
+    LVM_FLOAT   W2[LVEQNB_PARALLEL_LANES];              /* w(n-2) of each section */
+} LVEQNB_ParallelTaps_t;
+#endif
+
 /* Instance structure */
 typedef struct
 {
@@ -111,6 +146,19 @@ typedef struct
     LVM_UINT16                      NBands;             /* Number of bands */
     LVEQNB_BandDef_t                *pBandDefinitions;  /* Filter band definitions */
     LVEQNB_BiquadType_en            *pBiquadType;       /* Filter biquad types */
+#ifdef BUILD_FLOAT
+    PK_FLOAT_Coefs_t                *pBandCoefs;        /* Coefficients of each band, read by the filters */
+    PK_FLOAT_Coefs_t                *pCoefBank;         /* Coefficients per banked rate and band */
+    LVM_UINT32                      BankStale;          /* Bands whose bank coefficients are out of date */
+    LVM_UINT32                      CoefsStale;         /* Bands whose filter coefficients are out of date */
+
+    /* Parallel engine */
+    LVEQNB_ParallelCoefs_t          *pParallelCoefs;    /* Sections per group, LVM_NULL for the cascade */
+    LVEQNB_ParallelTaps_t           *pParallelTaps;     /* History per channel and group */
+    LVM_FLOAT                       ParallelDirect;     /* Gain of the direct path */
+    LVM_UINT16                      ParallelGroups;     /* Groups in use, 0 when the bands run in series */
+    LVM_UINT16                      ParallelBands;      /* Number of bands of the last conversion */
+#endif
 
     /* Bypass variable */
 #ifdef BUILD_FLOAT
@@ -135,6 +183,22 @@ void    LVEQNB_SetFilters(LVEQNB_Instance_t   *pInstance,
 
 void    LVEQNB_SetCoefficients(LVEQNB_Instance_t    *pInstance);
 
+#ifdef BUILD_FLOAT
+void    LVEQNB_MapCoefMemory(LVEQNB_Instance_t      *pInstance);
+
+void    LVEQNB_SetCoefBank(LVEQNB_Instance_t        *pInstance);
+
+void    LVEQNB_SetParallel(LVEQNB_Instance_t        *pInstance);
+
+void    LVEQNB_ClearParallelHistory(LVEQNB_Instance_t *pInstance);
+
+void    LVEQNB_ParallelProcess(LVEQNB_Instance_t    *pInstance,
+                               const LVM_FLOAT      *pInData,
+                               LVM_FLOAT            *pOutData,
+                               LVM_INT16            NrFrames,
+                               LVM_INT16            NrChannels);
+#endif
+
 void    LVEQNB_ClearFilterHistory(LVEQNB_Instance_t *pInstance);
 #ifdef BUILD_FLOAT
 LVEQNB_ReturnStatus_en LVEQNB_SinglePrecCoefs(LVM_UINT16        Fs,
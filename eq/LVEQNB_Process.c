@@ -54,6 +54,8 @@
 /*  LVEQNB_TOOMANYSAMPLES   NumSamples was larger than the maximum block size           */
 /*                                                                                      */
 /* NOTES:                                                                               */
+/*  1.  With the parallel engine the bands run as parallel sections, or in series when  */
+/*      their parallel form is ill-conditioned                                          */
 /*                                                                                      */
 /****************************************************************************************/
 #ifdef BUILD_FLOAT
@@ -97,17 +99,33 @@ LVEQNB_ReturnStatus_en LVEQNB_Process(LVEQNB_Handle_t       hInstance,
 
     if (pInstance->Params.OperatingMode == LVEQNB_ON)
     {
-        /*
-         * Copy input data in to scratch buffer
-         */
-        Copy_Float(pInData,     /* Source */
-                   pScratch,    /* Destination */
-                   (LVM_INT16)NrSamples);
+        if (pInstance->ParallelGroups != 0)
+        {
+            /*
+             * Filter with the parallel form in to the scratch buffer
+             */
+            LVEQNB_ParallelProcess(pInstance,
+                                   pInData,
+                                   pScratch,
+                                   (LVM_INT16)NrFrames,
+                                   (LVM_INT16)NrChannels);
+        }
+        else
+        {
+            /*
+             * Copy input data in to scratch buffer
+             */
+            Copy_Float(pInData,     /* Source */
+                       pScratch,    /* Destination */
+                       (LVM_INT16)NrSamples);
+        }
 
         /*
-         * For each section execte the filter unless the gain is 0dB
+         * For each section execte the filter unless the gain is 0dB or the bands run in
+         * parallel form
          */
-        if (pInstance->NBands != 0)
+        if ((pInstance->NBands != 0) &&
+            (pInstance->ParallelGroups == 0))
         {
             for (LVM_UINT16 i = 0; i < pInstance->NBands; i++)
             {
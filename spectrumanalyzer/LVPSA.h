@@ -59,6 +59,14 @@ typedef enum
     LVPSA_SPEED_DUMMY = LVM_MAXINT_32                       /* Force 32 bits enum, don't use it!                                 */
 } LVPSA_LevelDetectSpeed_en;
 
+/* Spectrum analyzer engines */
+typedef enum
+{
+    LVPSA_ENGINE_FILTERBANK,                                /* Band pass filters and quasi peak detectors                        */
+    LVPSA_ENGINE_FFT,                                       /* Windowed FFT with logarithmic bands, float build only             */
+    LVPSA_ENGINE_DUMMY = LVM_MAXINT_32                      /* Force 32 bits enum, don't use it!                                 */
+} LVPSA_Engine_en;
+
 /* Filter control parameters */
 typedef struct
 {
@@ -74,7 +82,13 @@ typedef struct
     LVM_UINT16                 SpectralDataBufferDuration;  /* Spectral data buffer duration in time (ms in Q16.0)               */
     LVM_UINT16                 MaxInputBlockSize;           /* Maximum expected input block size (in samples)                    */
     LVM_UINT16                 nBands;                      /* Number of bands of the SA                                         */
-    LVPSA_FilterParam_t       *pFiltersParams;              /* Points to nBands filter param structures for filters settings     */
+    LVPSA_FilterParam_t       *pFiltersParams;              /* Points to nBands filter param structures for filters settings,
+                                                               may be NULL with the FFT engine                                   */
+    LVM_UINT32                 CoefBankRates;               /* Rates with precomputed band pass coefficients                     */
+    LVM_Mode_en                Decimation;                  /* Filter the low bands at decimated rates, float build only         */
+    LVPSA_Engine_en            Engine;                      /* Analyzer engine                                                   */
+    LVM_UINT16                 FFTSize;                     /* Transform length of the FFT engine, a power of 2 (in samples)     */
+    LVM_UINT16                 HopSize;                     /* Input samples between two transforms of the FFT engine            */
 
 } LVPSA_InitParams_t, *pLVPSA_InitParams_t;
 
@@ -284,10 +298,35 @@ LVPSA_RETURN LVPSA_GetControlParams  (    pLVPSA_Handle_t            hInstance,
 /*  LVPSA_OK            Succeeds                                                                                                 */
 /*  otherwise           Error due to bad parameters                                                                              */
 /*                                                                                                                               */
+/* NOTES:                                                                                                                        */
+/*  1. With the FFT engine pFiltersParams holds the geometric center frequency and the Q factor of each band at the current      */
+/*     sampling frequency, the post gains are 0 dB                                                                               */
+/*                                                                                                                               */
 /*********************************************************************************************************************************/
 LVPSA_RETURN LVPSA_GetInitParams     (    pLVPSA_Handle_t            hInstance,
                                           LVPSA_InitParams_t        *pParams      );
 
+/*********************************************************************************************************************************/
+/*                                                                                                                               */
+/* FUNCTION:            LVPSA_GetTailLevel                                                                                       */
+/*                                                                                                                               */
+/* DESCRIPTION:                                                                                                                  */
+/*  Get the peak level of the band pass filter history and of the quasi peak detectors. Once it is below the level displayed     */
+/*  as silence the process calls of a silent input can be skipped, LVPSA_GetSpectrum returns zero levels for the skipped time.   */
+/*                                                                                                                               */
+/* PARAMETERS:                                                                                                                   */
+/*  hInstance           Instance Handle                                                                                          */
+/*  pTailLevel          Pointer to the tail level                                                                                */
+/* RETURNS:                                                                                                                      */
+/*  LVPSA_OK            Succeeds                                                                                                 */
+/*  otherwise           Error due to bad parameters                                                                              */
+/*                                                                                                                               */
+/*********************************************************************************************************************************/
+#ifdef BUILD_FLOAT
+LVPSA_RETURN LVPSA_GetTailLevel      (    pLVPSA_Handle_t            hInstance,
+                                          LVM_FLOAT                 *pTailLevel   );
+#endif
+
 
 #ifdef __cplusplus
 }
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include    <math.h>
 #include    "LVPSA.h"
 #include    "LVPSA_Private.h"
 #include    "VectorArithmetic.h"
@@ -159,11 +160,129 @@ LVPSA_RETURN LVPSA_GetInitParams         (    pLVPSA_Handle_t            hInstan
     pParams->MaxInputBlockSize            = pLVPSA_Inst->MaxInputBlockSize;
     pParams->nBands                       = pLVPSA_Inst->nBands;
     pParams->pFiltersParams               = pLVPSA_Inst->pFiltersParams;
+    pParams->CoefBankRates                = pLVPSA_Inst->CoefBankRates;
+#ifdef BUILD_FLOAT
+    pParams->Decimation                   = (pLVPSA_Inst->pBPFiltersDecimation != LVM_NULL) ? LVM_MODE_ON : LVM_MODE_OFF;
+    if (pLVPSA_Inst->pFFT != LVM_NULL)
+    {
+        pParams->Engine                   = LVPSA_ENGINE_FFT;
+        pParams->FFTSize                  = pLVPSA_Inst->pFFT->FFTSize;
+        pParams->HopSize                  = pLVPSA_Inst->pFFT->HopSize;
+    }
+    else
+    {
+        pParams->Engine                   = LVPSA_ENGINE_FILTERBANK;
+        pParams->FFTSize                  = 0;
+        pParams->HopSize                  = 0;
+    }
+#else
+    pParams->Decimation                   = LVM_MODE_OFF;
+    pParams->Engine                       = LVPSA_ENGINE_FILTERBANK;
+    pParams->FFTSize                      = 0;
+    pParams->HopSize                      = 0;
+#endif
 
     return(LVPSA_OK);
 }
 
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_GetTailLevel                                          */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Get the peak level of the relevant band pass filters and quasi peak detectors,  */
+/*  or of the input ring and the band levels of the FFT engine                      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance       Pointer to the instance                                         */
+/*  pTailLevel      Pointer to the tail level                                       */
+/* RETURNS:                                                                         */
+/*  LVPSA_OK            Succeeds                                                    */
+/*  otherwise           Error due to bad parameters                                 */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The level is full scale (1.0) while new settings are pending                 */
+/*                                                                                  */
+/************************************************************************************/
+LVPSA_RETURN LVPSA_GetTailLevel          (    pLVPSA_Handle_t            hInstance,
+                                              LVM_FLOAT                 *pTailLevel )
+{
+    LVPSA_InstancePr_t     *pLVPSA_Inst    = (LVPSA_InstancePr_t*)hInstance;
+    LVPSA_BankTaps_t       *pTaps;
+    LVM_FLOAT               Level;
+    LVM_FLOAT               TailLevel      = 0.0f;
+    LVM_INT32               nLanes;
+    LVM_UINT16              ii;
+
+    if((hInstance == LVM_NULL) || (pTailLevel == LVM_NULL))
+    {
+        return(LVPSA_ERROR_NULLADDRESS);
+    }
+
+    if (pLVPSA_Inst->bControlPending == LVM_TRUE)
+    {
+        *pTailLevel = 1.0f;
+        return(LVPSA_OK);
+    }
+
+    for (ii = 0; ii < pLVPSA_Inst->nBankGroups; ii++)
+    {
+        pTaps  = &pLVPSA_Inst->pBankTaps[ii];
+        nLanes = (LVM_INT32)pLVPSA_Inst->pBankGroups[ii].nLanes;
+        /* The filters run on the unscaled input */
+        Level = PeakAbs_Float(pTaps->X, (LVM_INT32)(sizeof(pTaps->X) / sizeof(LVM_FLOAT))) * LVPSA_INPUTSCALE;
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+        Level = PeakAbs_Float(pTaps->Y1, nLanes) * LVPSA_INPUTSCALE;
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+        Level = PeakAbs_Float(pTaps->Y2, nLanes) * LVPSA_INPUTSCALE;
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+        Level = PeakAbs_Float(pTaps->Level, nLanes);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if (pLVPSA_Inst->pFFT != LVM_NULL)
+    {
+        Level = PeakAbs_Float(pLVPSA_Inst->pFFT->pInput, (LVM_INT32)pLVPSA_Inst->pFFT->FFTSize);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+        Level = PeakAbs_Float(pLVPSA_Inst->pFFT->pLevels, (LVM_INT32)pLVPSA_Inst->nBands);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    if (pLVPSA_Inst->nDecimationStages != 0)
+    {
+        Level = PeakAbs_Float(pLVPSA_Inst->pDecimationTaps,
+                              (LVM_INT32)(pLVPSA_Inst->nDecimationStages * LVPSA_HALFBAND_HISTORY)) *
+                LVPSA_INPUTSCALE;
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    *pTailLevel = TailLevel;
+
+    return(LVPSA_OK);
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_ApplyNewSettings                                      */
@@ -184,15 +303,9 @@ LVPSA_RETURN LVPSA_GetInitParams         (    pLVPSA_Handle_t            hInstan
 /************************************************************************************/
 LVPSA_RETURN LVPSA_ApplyNewSettings (LVPSA_InstancePr_t     *pInst)
 {
-    LVM_UINT16 ii;
-    LVM_UINT16 Freq;
+    LVM_UINT32 ii;
     LVPSA_ControlParams_t   Params;
     extern LVM_INT16        LVPSA_nSamplesBufferUpdate[];
-#ifndef HIGHER_FS
-    extern LVM_UINT16       LVPSA_SampleRateTab[];
-#else
-    extern LVM_UINT32       LVPSA_SampleRateTab[];
-#endif
     extern LVM_UINT16       LVPSA_DownSamplingFactor[];
 
 
@@ -209,27 +322,28 @@ LVPSA_RETURN LVPSA_ApplyNewSettings (LVPSA_InstancePr_t     *pInst)
     {
         pInst->CurrentParams.Fs = Params.Fs;
 
-        /* Initialize the center freqeuncies as a function of the sample rate */
-        Freq = (LVM_UINT16) ((LVPSA_SampleRateTab[pInst->CurrentParams.Fs]>>1) / (pInst->nBands + 1));
-        for(ii = pInst->nBands; ii > 0; ii--)
+#ifdef BUILD_FLOAT
+        if (pInst->pFFT != LVM_NULL)
         {
-            pInst->pFiltersParams[ii-1].CenterFrequency = (LVM_UINT16) (Freq * ii);
+            LVPSA_SetFFTBands(pInst, Params.Fs);
+            LVPSA_SetFFTBallistics(pInst, &Params);
         }
-
-        /* Count the number of relevant filters. If the center frequency of the filter is
-           bigger than the nyquist frequency, then the filter is not relevant and doesn't
-           need to be used */
-        for(ii = pInst->nBands; ii > 0; ii--)
+        else
         {
-            if(pInst->pFiltersParams[ii-1].CenterFrequency < (LVPSA_SampleRateTab[pInst->CurrentParams.Fs]>>1))
-            {
-                pInst->nRelevantFilters = ii;
-                break;
-            }
+            LVPSA_SetCenterFrequencies(pInst, Params.Fs);
+            LVPSA_SetDecimation(pInst, Params.Fs);
+            LVPSA_SetBankGroups(pInst);
+            pInst->DecimationCount = 0;
+            LVPSA_SetBPFiltersType(pInst, &Params);
+            LVPSA_SetBPFCoefficients(pInst, &Params);
+            LVPSA_SetQPFCoefficients(pInst, &Params);
         }
+#else
+        LVPSA_SetCenterFrequencies(pInst, Params.Fs);
         LVPSA_SetBPFiltersType(pInst, &Params);
         LVPSA_SetBPFCoefficients(pInst, &Params);
         LVPSA_SetQPFCoefficients(pInst, &Params);
+#endif
         LVPSA_ClearFilterHistory(pInst);
         pInst->nSamplesBufferUpdate = (LVM_UINT16)LVPSA_nSamplesBufferUpdate[Params.Fs];
         pInst->BufferUpdateSamplesCount = 0;
@@ -248,7 +362,16 @@ LVPSA_RETURN LVPSA_ApplyNewSettings (LVPSA_InstancePr_t     *pInst)
     {
         if(Params.LevelDetectionSpeed != pInst->CurrentParams.LevelDetectionSpeed)
         {
-            LVPSA_SetQPFCoefficients(pInst, &Params);
+#ifdef BUILD_FLOAT
+            if (pInst->pFFT != LVM_NULL)
+            {
+                LVPSA_SetFFTBallistics(pInst, &Params);
+            }
+            else
+#endif
+            {
+                LVPSA_SetQPFCoefficients(pInst, &Params);
+            }
         }
     }
 
@@ -256,6 +379,377 @@ LVPSA_RETURN LVPSA_ApplyNewSettings (LVPSA_InstancePr_t     *pInst)
 
     return (LVPSA_OK);
 }
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetCenterFrequencies                                  */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Spreads the center frequencies of the filters up to the nyquist frequency and   */
+/*  counts the relevant filters.                                                    */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetCenterFrequencies (LVPSA_InstancePr_t     *pInst,
+                                 LVM_Fs_en              Fs)
+{
+    LVM_UINT16 ii;
+    LVM_UINT16 Freq;
+#ifndef HIGHER_FS
+    extern LVM_UINT16       LVPSA_SampleRateTab[];
+#else
+    extern LVM_UINT32       LVPSA_SampleRateTab[];
+#endif
+
+    /* Initialize the center freqeuncies as a function of the sample rate */
+    Freq = (LVM_UINT16) ((LVPSA_SampleRateTab[Fs]>>1) / (pInst->nBands + 1));
+    for(ii = pInst->nBands; ii > 0; ii--)
+    {
+        pInst->pFiltersParams[ii-1].CenterFrequency = (LVM_UINT16) (Freq * ii);
+    }
+
+    /* Count the number of relevant filters. If the center frequency of the filter is
+       bigger than the nyquist frequency, then the filter is not relevant and doesn't
+       need to be used */
+    for(ii = pInst->nBands; ii > 0; ii--)
+    {
+        if(pInst->pFiltersParams[ii-1].CenterFrequency < (LVPSA_SampleRateTab[Fs]>>1))
+        {
+            pInst->nRelevantFilters = ii;
+            break;
+        }
+    }
+}
+
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetCoefBank                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Calculates the band pass filter coefficients for every banked sampling          */
+/*  frequency.                                                                      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVPSA_OK            Always succeeds                                             */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The center frequencies, decimation and filter types are left set for the     */
+/*     last banked rate, they are set again when the sampling frequency is applied  */
+/*                                                                                  */
+/************************************************************************************/
+LVPSA_RETURN LVPSA_SetCoefBank (LVPSA_InstancePr_t     *pInst)
+{
+    LVM_UINT16              ii;
+    LVM_UINT16              Fs;
+    LVM_UINT32              BankRates = pInst->CoefBankRates;
+    BP_FLOAT_Coefs_t        *pCoefficients = pInst->pCoefBank;
+    LVPSA_ControlParams_t   Params = pInst->CurrentParams;
+
+    for (Fs = 0; BankRates != LVM_FS_BANK_NONE; Fs++)
+    {
+        if ((BankRates & LVM_FS_BANK(Fs)) != 0)
+        {
+            Params.Fs = (LVM_Fs_en)Fs;
+            LVPSA_SetCenterFrequencies(pInst, Params.Fs);
+            LVPSA_SetDecimation(pInst, Params.Fs);
+            LVPSA_SetBPFiltersType(pInst, &Params);
+
+            for (ii = 0; ii < pInst->nRelevantFilters; ii++)
+            {
+                if (pInst->pBPFiltersPrecision[ii] == LVPSA_DoublePrecisionFilter)
+                {
+                    LVPSA_BPDoublePrecCoefs((LVM_UINT16)LVPSA_GetBandFs(pInst, ii, Params.Fs),
+                                            &pInst->pFiltersParams[ii],
+                                            &pCoefficients[ii]);
+                }
+                else
+                {
+                    LVPSA_BPSinglePrecCoefs((LVM_UINT16)LVPSA_GetBandFs(pInst, ii, Params.Fs),
+                                            &pInst->pFiltersParams[ii],
+                                            &pCoefficients[ii]);
+                }
+            }
+            pCoefficients += pInst->nBands;
+            BankRates &= ~LVM_FS_BANK(Fs);
+        }
+    }
+
+    return(LVPSA_OK);
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetDecimation                                         */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Selects the number of half-band decimation stages before each relevant filter   */
+/*  and counts the stages to run.                                                   */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The quasi peak detectors take every DownSamplingFactor-th input sample, a    */
+/*     band is only decimated by a divisor of the factor so that the decimated      */
+/*     band keeps these samples                                                     */
+/*  2. A band is not decimated more than the band below it, the center frequencies  */
+/*     can wrap around at the highest sampling frequencies                          */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetDecimation (LVPSA_InstancePr_t     *pInst,
+                          LVM_Fs_en              Fs)
+{
+    LVM_UINT16 ii;
+    LVM_UINT16 Shift;
+    LVM_UINT16 MaxShift = LVPSA_MAXDECIMATION;
+    LVM_Fs_en  BandFs;
+#ifndef HIGHER_FS
+    extern LVM_UINT16       LVPSA_SampleRateTab[];
+#else
+    extern LVM_UINT32       LVPSA_SampleRateTab[];
+#endif
+    extern LVM_UINT16       LVPSA_DownSamplingFactor[];
+    extern LVM_Fs_en        LVPSA_HalfRateTab[];
+
+    pInst->nDecimationStages = 0;
+    if (pInst->pBPFiltersDecimation == LVM_NULL)
+    {
+        return;
+    }
+
+    for (ii = 0; ii < pInst->nRelevantFilters; ii++)
+    {
+        Shift  = 0;
+        BandFs = Fs;
+        while ((Shift < MaxShift) &&
+               (LVPSA_HalfRateTab[BandFs] != LVM_FS_INVALID) &&
+               ((LVPSA_DownSamplingFactor[Fs] % (2 << Shift)) == 0) &&
+               (((LVM_UINT32)pInst->pFiltersParams[ii].CenterFrequency * LVPSA_DECIMATION_BANDLIMIT) <
+                (LVM_UINT32)LVPSA_SampleRateTab[LVPSA_HalfRateTab[BandFs]]))
+        {
+            BandFs = LVPSA_HalfRateTab[BandFs];
+            Shift++;
+        }
+        pInst->pBPFiltersDecimation[ii] = (LVM_UINT8)Shift;
+        if (Shift > pInst->nDecimationStages)
+        {
+            pInst->nDecimationStages = Shift;
+        }
+        MaxShift = Shift;
+    }
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetBankGroups                                         */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Splits the relevant filters in groups of up to LVPSA_BANK_LANES consecutive     */
+/*  bands of the same decimation and clears the coefficients of the groups.         */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The decimation does not increase with the band index, so each decimation     */
+/*     starts at most one new group                                                 */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetBankGroups (LVPSA_InstancePr_t     *pInst)
+{
+    LVM_UINT16          ii;
+    LVM_UINT16          Shift;
+    LVPSA_BankGroup_t   *pGroup = LVM_NULL;
+
+    pInst->nBankGroups = 0;
+    for (ii = 0; ii < pInst->nRelevantFilters; ii++)
+    {
+        Shift = 0;
+        if (pInst->pBPFiltersDecimation != LVM_NULL)
+        {
+            Shift = pInst->pBPFiltersDecimation[ii];
+        }
+        if ((pGroup == LVM_NULL) ||
+            (pGroup->nLanes == LVPSA_BANK_LANES) ||
+            (pGroup->Shift != Shift))
+        {
+            pGroup = &pInst->pBankGroups[pInst->nBankGroups];
+            pGroup->FirstBand = ii;
+            pGroup->nLanes    = 0;
+            pGroup->Shift     = Shift;
+            LoadConst_Float(0,
+                            (LVM_FLOAT *)&pInst->pBankCoefs[pInst->nBankGroups],
+                            (LVM_UINT16)(sizeof(LVPSA_BankCoefs_t) / sizeof(LVM_FLOAT)));
+            pInst->nBankGroups++;
+        }
+        pGroup->nLanes++;
+    }
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_GetBandFs                                             */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the sampling frequency a band pass filter runs at.                      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  BandIndex           Index of the band                                           */
+/*  Fs                  Input sampling frequency                                    */
+/*                                                                                  */
+/************************************************************************************/
+LVM_Fs_en LVPSA_GetBandFs (LVPSA_InstancePr_t     *pInst,
+                           LVM_UINT16             BandIndex,
+                           LVM_Fs_en              Fs)
+{
+    LVM_UINT16 Shift;
+    extern LVM_Fs_en        LVPSA_HalfRateTab[];
+
+    if (pInst->pBPFiltersDecimation != LVM_NULL)
+    {
+        for (Shift = pInst->pBPFiltersDecimation[BandIndex]; Shift != 0; Shift--)
+        {
+            Fs = LVPSA_HalfRateTab[Fs];
+        }
+    }
+
+    return(Fs);
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetFFTBands                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Spreads the bands of the FFT engine logarithmically from LVPSA_FFT_MINFREQ to   */
+/*  LVPSA_FFT_MAXFREQ or the nyquist frequency and sets the bins of each band.      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. A band takes at least one bin, the narrow low bands can share a bin          */
+/*  2. The filters parameters are set to the center frequency and the Q factor of   */
+/*     each band so the bands can be labelled                                      */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetFFTBands (LVPSA_InstancePr_t     *pInst,
+                        LVM_Fs_en              Fs)
+{
+    LVPSA_FFT_Instance_t    *pFFT = pInst->pFFT;
+    LVM_UINT16              ii;
+    LVM_INT32               HalfSize = pFFT->FFTSize >> 1;
+    LVM_INT32               FirstBin;
+    LVM_INT32               EndBin;
+    double                  BinsPerHz;
+    double                  MaxFreq;
+    double                  Ratio;
+    double                  Low;
+    double                  High;
+    double                  Center;
+    double                  QFactor;
+#ifndef HIGHER_FS
+    extern LVM_UINT16       LVPSA_SampleRateTab[];
+#else
+    extern LVM_UINT32       LVPSA_SampleRateTab[];
+#endif
+
+    BinsPerHz = (double)pFFT->FFTSize / LVPSA_SampleRateTab[Fs];
+    MaxFreq = LVPSA_FFT_MAXFREQ;
+    if (MaxFreq > (double)(LVPSA_SampleRateTab[Fs] >> 1))
+    {
+        MaxFreq = (double)(LVPSA_SampleRateTab[Fs] >> 1);
+    }
+    Ratio = pow(MaxFreq / LVPSA_FFT_MINFREQ, 1.0 / pInst->nBands);
+
+    Low = LVPSA_FFT_MINFREQ;
+    for (ii = 0; ii < pInst->nBands; ii++)
+    {
+        High = LVPSA_FFT_MINFREQ * pow(Ratio, ii + 1);
+
+        /* The band sums the bins centered from its lower edge up to its upper edge */
+        FirstBin = (LVM_INT32)(Low * BinsPerHz + 0.5);
+        EndBin   = (LVM_INT32)(High * BinsPerHz + 0.5);
+        if (FirstBin < 1)
+        {
+            FirstBin = 1;
+        }
+        if (FirstBin > HalfSize - 1)
+        {
+            FirstBin = HalfSize - 1;
+        }
+        if (EndBin <= FirstBin)
+        {
+            EndBin = FirstBin + 1;
+        }
+        if (EndBin > HalfSize)
+        {
+            EndBin = HalfSize;
+        }
+        pFFT->pBands[ii].FirstBin = (LVM_UINT16)FirstBin;
+        pFFT->pBands[ii].EndBin   = (LVM_UINT16)EndBin;
+
+        /* Geometric center and Q factor (x100) of the band */
+        Center  = sqrt(Low * High);
+        QFactor = 100.0 * Center / (High - Low) + 0.5;
+        if (QFactor > 65535.0)
+        {
+            QFactor = 65535.0;
+        }
+        pInst->pFiltersParams[ii].CenterFrequency = (LVM_UINT16)(Center + 0.5);
+        pInst->pFiltersParams[ii].QFactor         = (LVM_UINT16)QFactor;
+        pInst->pFiltersParams[ii].PostGain        = 0;
+
+        Low = High;
+    }
+
+    pInst->nRelevantFilters = pInst->nBands;
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetFFTBallistics                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Sets the attack and release of the FFT engine levels per transform from the     */
+/*  quasi peak detector coefficients of the level detection speed.                  */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  pParams             Control parameters                                          */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. A quasi peak detector step moves the level towards its input by the factor   */
+/*     -KP - KM/2 on attack and -KP + KM/2 on release, it steps every               */
+/*     DownSamplingFactor samples so a transform stands for several steps           */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetFFTBallistics (LVPSA_InstancePr_t     *pInst,
+                             LVPSA_ControlParams_t  *pParams)
+{
+    QPD_FLOAT_Coefs         *pCoefficients;
+    double                  Steps;
+    extern LVM_UINT16       LVPSA_DownSamplingFactor[];
+    extern QPD_FLOAT_Coefs  LVPSA_QPD_Float_Coefs[];
+
+    pCoefficients = &LVPSA_QPD_Float_Coefs[(pParams->LevelDetectionSpeed * \
+                                    LVPSA_NR_SUPPORTED_RATE) + pParams->Fs];
+
+    Steps = (double)pInst->pFFT->HopSize / LVPSA_DownSamplingFactor[pParams->Fs];
+    pInst->pFFT->Attack  = (LVM_FLOAT)pow(-pCoefficients->KP - pCoefficients->KM / 2, Steps);
+    pInst->pFFT->Release = (LVM_FLOAT)pow(-pCoefficients->KP + pCoefficients->KM / 2, Steps);
+}
+#endif
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_SetBPFiltersType                                      */
@@ -295,6 +789,9 @@ LVPSA_RETURN LVPSA_SetBPFiltersType (   LVPSA_InstancePr_t        *pInst,
         /*
          * Get the filter settings
          */
+#ifdef BUILD_FLOAT
+        fs = (LVM_UINT32)LVPSA_SampleRateTab[LVPSA_GetBandFs(pInst, ii, pParams->Fs)];   /* Rate of the band */
+#endif
         fc = (LVM_UINT32)pInst->pFiltersParams[ii].CenterFrequency;     /* Get the band centre frequency */
         QFactor =(LVM_INT16) pInst->pFiltersParams[ii].QFactor;                    /* Get the band Q factor */
 
@@ -341,6 +838,7 @@ LVPSA_RETURN LVPSA_SetBPFiltersType (   LVPSA_InstancePr_t        *pInst,
 /*  LVPSA_OK            Always succeeds                                             */
 /*                                                                                  */
 /* NOTES:                                                                           */
+/*  1. At a banked sampling frequency the coefficients are taken from the bank      */
 /*                                                                                  */
 /************************************************************************************/
 LVPSA_RETURN LVPSA_SetBPFCoefficients(  LVPSA_InstancePr_t        *pInst,
@@ -348,33 +846,72 @@ LVPSA_RETURN LVPSA_SetBPFCoefficients(  LVPSA_InstancePr_t        *pInst,
 {
 
     LVM_UINT16                      ii;
+#ifdef BUILD_FLOAT
+    LVM_UINT16                      Group;
+    LVM_UINT16                      Lane;
+    LVPSA_BankCoefs_t               *pBankCoefs;
+    BP_FLOAT_Coefs_t                Coefficients;
+    BP_FLOAT_Coefs_t                *pBank = LVM_NULL;
+    LVM_INT16                       Slot;
+
+    Slot = LVM_FsBankIndex(pInst->CoefBankRates, pParams->Fs);
+    if (Slot >= 0)
+    {
+        pBank = &pInst->pCoefBank[Slot * pInst->nBands];
+    }
 
     /*
-     * Set the coefficients for each band by the init function
+     * Set the coefficients of each band in its lane of the bank
      */
-    for (ii = 0; ii < pInst->nRelevantFilters; ii++)
+    for (Group = 0; Group < pInst->nBankGroups; Group++)
     {
-        switch  (pInst->pBPFiltersPrecision[ii])
+        pBankCoefs = &pInst->pBankCoefs[Group];
+        for (Lane = 0; Lane < pInst->pBankGroups[Group].nLanes; Lane++)
         {
-            case    LVPSA_DoublePrecisionFilter:
+            ii = (LVM_UINT16)(pInst->pBankGroups[Group].FirstBand + Lane);
+            if (pBank != LVM_NULL)
+            {
+                /*
+                 * Take the precomputed coefficients from the bank
+                 */
+                Coefficients = pBank[ii];
+            }
+            else if (pInst->pBPFiltersPrecision[ii] == LVPSA_DoublePrecisionFilter)
             {
-#ifndef BUILD_FLOAT
-                BP_C32_Coefs_t      Coefficients;
-
                 /*
                  * Calculate the double precision coefficients
                  */
-                LVPSA_BPDoublePrecCoefs((LVM_UINT16)pParams->Fs,
+                LVPSA_BPDoublePrecCoefs((LVM_UINT16)LVPSA_GetBandFs(pInst, ii, pParams->Fs),
                                         &pInst->pFiltersParams[ii],
                                         &Coefficients);
+            }
+            else
+            {
                 /*
-                 * Set the coefficients
+                 * Calculate the single precision coefficients
                  */
-                BP_1I_D16F32Cll_TRC_WRA_01_Init ( &pInst->pBP_Instances[ii],
-                                                  &pInst->pBP_Taps[ii],
-                                                  &Coefficients);
+                LVPSA_BPSinglePrecCoefs((LVM_UINT16)LVPSA_GetBandFs(pInst, ii, pParams->Fs),
+                                        &pInst->pFiltersParams[ii],
+                                        &Coefficients);
+            }
+            pBankCoefs->A0[Lane] = Coefficients.A0;
+            pBankCoefs->B2[Lane] = Coefficients.B2;
+            pBankCoefs->B1[Lane] = Coefficients.B1;
+        }
+    }
 #else
-                BP_FLOAT_Coefs_t      Coefficients;
+
+    /*
+     * Set the coefficients for each band by the init function
+     */
+    for (ii = 0; ii < pInst->nRelevantFilters; ii++)
+    {
+        switch  (pInst->pBPFiltersPrecision[ii])
+        {
+            case    LVPSA_DoublePrecisionFilter:
+            {
+                BP_C32_Coefs_t      Coefficients;
+
                 /*
                  * Calculate the double precision coefficients
                  */
@@ -387,13 +924,11 @@ LVPSA_RETURN LVPSA_SetBPFCoefficients(  LVPSA_InstancePr_t        *pInst,
                 BP_1I_D16F32Cll_TRC_WRA_01_Init ( &pInst->pBP_Instances[ii],
                                                   &pInst->pBP_Taps[ii],
                                                   &Coefficients);
-#endif
                 break;
             }
 
             case    LVPSA_SimplePrecisionFilter:
             {
-#ifndef BUILD_FLOAT
                 BP_C16_Coefs_t      Coefficients;
 
                 /*
@@ -409,27 +944,11 @@ LVPSA_RETURN LVPSA_SetBPFCoefficients(  LVPSA_InstancePr_t        *pInst,
                 BP_1I_D16F16Css_TRC_WRA_01_Init (&pInst->pBP_Instances[ii],
                                                   &pInst->pBP_Taps[ii],
                                                   &Coefficients);
-#else
-                BP_FLOAT_Coefs_t      Coefficients;
-
-                /*
-                 * Calculate the single precision coefficients
-                 */
-                LVPSA_BPSinglePrecCoefs((LVM_UINT16)pParams->Fs,
-                                        &pInst->pFiltersParams[ii],
-                                        &Coefficients);
-
-                /*
-                 * Set the coefficients
-                 */
-                BP_1I_D16F16Css_TRC_WRA_01_Init (&pInst->pBP_Instances[ii],
-                                                  &pInst->pBP_Taps[ii],
-                                                  &Coefficients);
-#endif
                 break;
             }
         }
     }
+#endif
 
     return(LVPSA_OK);
 }
@@ -451,6 +970,7 @@ LVPSA_RETURN LVPSA_SetBPFCoefficients(  LVPSA_InstancePr_t        *pInst,
 /*  LVPSA_OK            Always succeeds                                             */
 /*                                                                                  */
 /* NOTES:                                                                           */
+/*  1. In the floating point build the post gains are set with the coefficients     */
 /*                                                                                  */
 /************************************************************************************/
 LVPSA_RETURN LVPSA_SetQPFCoefficients(   LVPSA_InstancePr_t        *pInst,
@@ -464,6 +984,8 @@ LVPSA_RETURN LVPSA_SetQPFCoefficients(   LVPSA_InstancePr_t        *pInst,
 
     pCoefficients = &LVPSA_QPD_Coefs[(pParams->LevelDetectionSpeed * LVPSA_NR_SUPPORTED_RATE) + Fs];
 #else
+    LVM_UINT16     Lane;
+    LVPSA_BankCoefs_t *pBankCoefs;
     QPD_FLOAT_Coefs  *pCoefficients;
     extern         QPD_FLOAT_Coefs     LVPSA_QPD_Float_Coefs[];
 
@@ -472,18 +994,28 @@ LVPSA_RETURN LVPSA_SetQPFCoefficients(   LVPSA_InstancePr_t        *pInst,
 #endif
 
 
+#ifndef BUILD_FLOAT
     for (ii = 0; ii < pInst->nRelevantFilters; ii++)
     {
-#ifndef BUILD_FLOAT
         LVPSA_QPD_Init (&pInst->pQPD_States[ii],
                         &pInst->pQPD_Taps[ii],
                         pCoefficients );
+    }
 #else
-        LVPSA_QPD_Init_Float (&pInst->pQPD_States[ii],
-                              &pInst->pQPD_Taps[ii],
-                              pCoefficients );
-#endif
+    for (ii = 0; ii < pInst->nBankGroups; ii++)
+    {
+        pBankCoefs = &pInst->pBankCoefs[ii];
+        for (Lane = 0; Lane < pInst->pBankGroups[ii].nLanes; Lane++)
+        {
+            /* The input scaling is exact, it is applied with the post gain instead of
+               on every input sample */
+            pBankCoefs->PostGain[Lane] = pInst->pPostGains[pInst->pBankGroups[ii].FirstBand + Lane] *
+                                         LVPSA_INPUTSCALE;
+            pBankCoefs->Kp[Lane]       = pCoefficients->KP;
+            pBankCoefs->Km[Lane]       = pCoefficients->KM;
+        }
     }
+#endif
 
     return(LVPSA_OK);
 
@@ -915,25 +1447,52 @@ LVPSA_RETURN LVPSA_ClearFilterHistory(LVPSA_InstancePr_t        *pInst)
     LVM_INT8       *pTapAddress;
     LVM_UINT32       i;
 
-    /* Band Pass filters taps */
-    pTapAddress = (LVM_INT8 *)pInst->pBP_Taps;
 #ifdef BUILD_FLOAT
-    for(i = 0; i < pInst->nBands * sizeof(Biquad_1I_Order2_FLOAT_Taps_t); i++)
+    /* Band Pass and quasi-peak filters taps of the bank */
+    pTapAddress = (LVM_INT8 *)pInst->pBankTaps;
+    for(i = 0; i < pInst->nBankGroups * sizeof(LVPSA_BankTaps_t); i++)
     {
         pTapAddress[i] = 0;
     }
 #else
+    /* Band Pass filters taps */
+    pTapAddress = (LVM_INT8 *)pInst->pBP_Taps;
     for(i = 0; i < pInst->nBands * sizeof(Biquad_1I_Order2_Taps_t); i++)
     {
         pTapAddress[i] = 0;
     }
-#endif
     /* Quasi-peak filters taps */
     pTapAddress = (LVM_INT8 *)pInst->pQPD_Taps;
     for(i = 0; i < pInst->nBands * sizeof(QPD_Taps_t); i++)
     {
         pTapAddress[i] = 0;
     }
+#endif
+#ifdef BUILD_FLOAT
+    /* Input ring and band levels of the FFT engine */
+    if (pInst->pFFT != LVM_NULL)
+    {
+        for(i = 0; i < pInst->pFFT->FFTSize; i++)
+        {
+            pInst->pFFT->pInput[i] = 0;
+        }
+        for(i = 0; i < pInst->nBands; i++)
+        {
+            pInst->pFFT->pLevels[i] = 0;
+        }
+        pInst->pFFT->InputIndex = 0;
+        pInst->pFFT->HopCount   = 0;
+    }
+
+    /* Half-band decimation filters taps */
+    if (pInst->pDecimationTaps != LVM_NULL)
+    {
+        for(i = 0; i < LVPSA_MAXDECIMATION * LVPSA_HALFBAND_HISTORY; i++)
+        {
+            pInst->pDecimationTaps[i] = 0;
+        }
+    }
+#endif
 
     return(LVPSA_OK);
 }
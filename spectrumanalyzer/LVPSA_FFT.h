@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LVPSA_FFT_H_
+#define _LVPSA_FFT_H_
+
+#include "LVM_Types.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#ifdef BUILD_FLOAT
+/* Bins of a band, the band sums the power of the bins FirstBin to EndBin - 1 */
+typedef struct
+{
+    LVM_UINT16          FirstBin;
+    LVM_UINT16          EndBin;
+} LVPSA_FFT_Band_t;
+
+typedef struct
+{
+    LVM_UINT16          FFTSize;        /* Transform length                                     */
+    LVM_UINT16          HopSize;        /* Input samples between two transforms                 */
+    LVM_UINT16          InputIndex;     /* Position of the oldest sample in the input ring      */
+    LVM_UINT16          HopCount;       /* Input samples since the last transform               */
+    LVM_FLOAT           PowerScale;     /* Scales the power of a band to its squared level      */
+    LVM_FLOAT           Attack;         /* Level attack factor per transform                    */
+    LVM_FLOAT           Release;        /* Level release factor per transform                   */
+    LVM_FLOAT          *pWindow;        /* FFTSize coefficients of the Hann window              */
+    LVM_FLOAT          *pTwiddles;      /* FFTSize/2 cosine and sine pairs of 2*pi*k/FFTSize    */
+    LVM_UINT16         *pBitReverse;    /* FFTSize/2 bit reversed indices                       */
+    LVPSA_FFT_Band_t   *pBands;         /* Bins of each band                                    */
+    LVM_FLOAT          *pInput;         /* FFTSize input samples ring                           */
+    LVM_FLOAT          *pLevels;        /* Level of each band                                   */
+} LVPSA_FFT_Instance_t;
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_Init                                              */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Calculates the window, the twiddle factors and the bit reversed indices of the  */
+/*  transform and clears the input ring.                                            */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pFFT                Pointer to the FFT engine, with its size and memory set     */
+/*                                                                                  */
+/* RETURNS:     void                                                                */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_Init (   LVPSA_FFT_Instance_t    *pFFT   );
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_PowerSpectrum                                     */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Transforms FFTSize real samples and calculates the power of the bins.           */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pFFT                Pointer to the FFT engine                                   */
+/*  pData               Pointer to the FFTSize samples, the power of bin k is left  */
+/*                      in pData[2*k] for 0 < k < FFTSize/2                         */
+/*                                                                                  */
+/* RETURNS:     void                                                                */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The samples are transformed as FFTSize/2 complex values by a radix-2         */
+/*     complex FFT, the spectrum of the real signal is then split from it           */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_PowerSpectrum (  LVPSA_FFT_Instance_t    *pFFT,
+                                LVM_FLOAT               *pData  );
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif
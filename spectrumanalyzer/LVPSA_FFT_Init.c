@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include "LVPSA_FFT.h"
+
+#ifdef BUILD_FLOAT
+#define TWO_PI 6.28318530717958647692
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_Init                                              */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Calculates the window, the twiddle factors and the bit reversed indices of the  */
+/*  transform and clears the input ring.                                            */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pFFT                Pointer to the FFT engine, with its size and memory set     */
+/*                                                                                  */
+/* RETURNS:     void                                                                */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The window is the periodic Hann window, a sine of amplitude A at the center  */
+/*     of a bin sums to a band power of 3/32 * (A * FFTSize)^2                      */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_Init (   LVPSA_FFT_Instance_t    *pFFT   )
+{
+    LVM_UINT16  FFTSize = pFFT->FFTSize;
+    LVM_UINT16  HalfSize = (LVM_UINT16)(FFTSize >> 1);
+    LVM_UINT16  ii;
+    LVM_UINT16  Bit;
+    LVM_UINT16  Reversed;
+    LVM_UINT16  nBits = 0;
+    double      Angle;
+    double      WindowPower = 0;
+
+    while ((1 << nBits) < HalfSize)
+    {
+        nBits++;
+    }
+
+    for (ii = 0; ii < FFTSize; ii++)
+    {
+        pFFT->pWindow[ii] = (LVM_FLOAT)(0.5 - 0.5 * cos(TWO_PI * ii / FFTSize));
+        WindowPower += (double)pFFT->pWindow[ii] * pFFT->pWindow[ii];
+        pFFT->pInput[ii] = 0;
+    }
+
+    for (ii = 0; ii < HalfSize; ii++)
+    {
+        Angle = TWO_PI * ii / FFTSize;
+        pFFT->pTwiddles[2 * ii]     = (LVM_FLOAT)cos(Angle);
+        pFFT->pTwiddles[2 * ii + 1] = (LVM_FLOAT)sin(Angle);
+
+        Reversed = 0;
+        for (Bit = 0; Bit < nBits; Bit++)
+        {
+            Reversed = (LVM_UINT16)((Reversed << 1) | ((ii >> Bit) & 1));
+        }
+        pFFT->pBitReverse[ii] = Reversed;
+    }
+
+    /* A sine of amplitude A reads A/2, the input is halved for the band pass filters
+       of the filter bank engine. The bins 0 < k < FFTSize/2 hold half the power */
+    pFFT->PowerScale = (LVM_FLOAT)(1.0 / (FFTSize * WindowPower));
+
+    pFFT->InputIndex = 0;
+    pFFT->HopCount = 0;
+}
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2004-2010 NXP Software
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include "LVPSA_FFT.h"
+#include "LVPSA_Private.h"
+#include "VectorArithmetic.h"
+
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_PowerSpectrum                                     */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Transforms FFTSize real samples and calculates the power of the bins.           */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pFFT                Pointer to the FFT engine                                   */
+/*  pData               Pointer to the FFTSize samples, the power of bin k is left  */
+/*                      in pData[2*k] for 0 < k < FFTSize/2                         */
+/*                                                                                  */
+/* RETURNS:     void                                                                */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The samples are transformed as FFTSize/2 complex values by a radix-2         */
+/*     complex FFT, the spectrum of the real signal is then split from it           */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_PowerSpectrum (  LVPSA_FFT_Instance_t    *pFFT,
+                                LVM_FLOAT               *pData  )
+{
+    LVM_FLOAT   *pTwiddles = pFFT->pTwiddles;
+    LVM_INT32   HalfSize = pFFT->FFTSize >> 1;      /* Complex transform length */
+    LVM_INT32   Size;
+    LVM_INT32   Half;
+    LVM_INT32   Step;
+    LVM_INT32   Start;
+    LVM_INT32   ii;
+    LVM_INT32   jj;
+    LVM_INT32   k;
+    LVM_FLOAT   Cos;
+    LVM_FLOAT   Sin;
+    LVM_FLOAT   Temp;
+    LVM_FLOAT   Tr, Ti;
+    LVM_FLOAT   Er, Ei;
+    LVM_FLOAT   Or, Oi;
+
+    /* Bit reversed order */
+    for (ii = 0; ii < HalfSize; ii++)
+    {
+        jj = pFFT->pBitReverse[ii];
+        if (jj > ii)
+        {
+            Temp = pData[2 * ii];
+            pData[2 * ii] = pData[2 * jj];
+            pData[2 * jj] = Temp;
+            Temp = pData[2 * ii + 1];
+            pData[2 * ii + 1] = pData[2 * jj + 1];
+            pData[2 * jj + 1] = Temp;
+        }
+    }
+
+    /* Butterflies, the twiddle factor of a butterfly is exp(-2*pi*k/Size) */
+    for (Size = 2; Size <= HalfSize; Size <<= 1)
+    {
+        Half = Size >> 1;
+        Step = pFFT->FFTSize / Size;
+        for (k = 0; k < Half; k++)
+        {
+            Cos = pTwiddles[2 * k * Step];
+            Sin = pTwiddles[2 * k * Step + 1];
+            for (Start = k; Start < HalfSize; Start += Size)
+            {
+                ii = 2 * Start;
+                jj = 2 * (Start + Half);
+                Tr = Cos * pData[jj]     + Sin * pData[jj + 1];
+                Ti = Cos * pData[jj + 1] - Sin * pData[jj];
+                pData[jj]     = pData[ii]     - Tr;
+                pData[jj + 1] = pData[ii + 1] - Ti;
+                pData[ii]     += Tr;
+                pData[ii + 1] += Ti;
+            }
+        }
+    }
+
+    /* Split the even and odd samples spectra E and O of the bins k and HalfSize - k,
+       X(k) = E(k) + exp(-2*pi*k/FFTSize) * O(k) and X(HalfSize - k) is the conjugate of
+       E(k) - exp(-2*pi*k/FFTSize) * O(k) */
+    for (k = 1; k <= (HalfSize >> 1); k++)
+    {
+        ii = 2 * k;
+        jj = 2 * (HalfSize - k);
+        Er = 0.5f * (pData[ii] + pData[jj]);
+        Ei = 0.5f * (pData[ii + 1] - pData[jj + 1]);
+        Or = 0.5f * (pData[ii + 1] + pData[jj + 1]);
+        Oi = 0.5f * (pData[jj] - pData[ii]);
+        Cos = pTwiddles[ii];
+        Sin = pTwiddles[ii + 1];
+        Tr = Cos * Or + Sin * Oi;
+        Ti = Cos * Oi - Sin * Or;
+        pData[ii] = (Er + Tr) * (Er + Tr) + (Ei + Ti) * (Ei + Ti);
+        pData[jj] = (Er - Tr) * (Er - Tr) + (Ei - Ti) * (Ei - Ti);
+    }
+}
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_Process                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Adds the input samples to the input ring of the FFT engine, updates the band    */
+/*  levels every HopSize samples and writes them in the buffer every 20 ms.         */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  pInSamps            Pointer to the input samples                                */
+/*  numSamples          Number of input samples                                     */
+/*                                                                                  */
+/* RETURNS:             void                                                        */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The transforms do not depend on the input block size, a block can hold no or */
+/*     several transforms                                                           */
+/*  2. The level of a band follows the square root of the power of its bins with    */
+/*     the attack and release of the quasi peak detectors                           */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_Process (LVPSA_InstancePr_t     *pInst,
+                        LVM_FLOAT              *pInSamps,
+                        LVM_INT16              numSamples)
+{
+    LVPSA_FFT_Instance_t    *pFFT = pInst->pFFT;
+    LVPSA_FFT_Band_t        *pBand;
+    LVM_FLOAT               *pData = (LVM_FLOAT *)pInst->MemoryTable.Region[LVPSA_MEMREGION_SCRATCH].pBaseAddress;
+    LVM_FLOAT               *pLevel = pFFT->pLevels;
+    LVM_FLOAT               *pWrite = pInst->pSpectralDataBufferWritePointer;
+    LVM_INT32               BufferUpdateSamplesCount = pInst->BufferUpdateSamplesCount;
+    LVM_INT32               FFTSize = pFFT->FFTSize;
+    LVM_INT32               Count;
+    LVM_INT32               Part;
+    LVM_INT32               ii;
+    LVM_INT32               k;
+    LVM_INT16               n = 0;                  /* Next input sample */
+    LVM_FLOAT               Power;
+    LVM_FLOAT               Level;
+
+    while (n < numSamples)
+    {
+        /* Take the samples up to the next transform or the next buffer update */
+        Count = numSamples - n;
+        if (Count > (LVM_INT32)(pFFT->HopSize - pFFT->HopCount))
+        {
+            Count = (LVM_INT32)(pFFT->HopSize - pFFT->HopCount);
+        }
+        if (Count > (LVM_INT32)pInst->nSamplesBufferUpdate - BufferUpdateSamplesCount)
+        {
+            Count = (LVM_INT32)pInst->nSamplesBufferUpdate - BufferUpdateSamplesCount;
+        }
+
+        Part = FFTSize - pFFT->InputIndex;
+        if (Part > Count)
+        {
+            Part = Count;
+        }
+        Copy_Float(&pInSamps[n], &pFFT->pInput[pFFT->InputIndex], (LVM_INT16)Part);
+        Copy_Float(&pInSamps[n + Part], pFFT->pInput, (LVM_INT16)(Count - Part));
+        pFFT->InputIndex = (LVM_UINT16)((pFFT->InputIndex + Count) & (FFTSize - 1));
+        pFFT->HopCount = (LVM_UINT16)(pFFT->HopCount + Count);
+        BufferUpdateSamplesCount += Count;
+        n = (LVM_INT16)(n + Count);
+
+        if (pFFT->HopCount == pFFT->HopSize)
+        {
+            pFFT->HopCount = 0;
+
+            /* Window the last FFTSize samples, the oldest first */
+            Part = FFTSize - pFFT->InputIndex;
+            for (ii = 0; ii < Part; ii++)
+            {
+                pData[ii] = pFFT->pInput[pFFT->InputIndex + ii] * pFFT->pWindow[ii];
+            }
+            for ( ; ii < FFTSize; ii++)
+            {
+                pData[ii] = pFFT->pInput[ii - Part] * pFFT->pWindow[ii];
+            }
+
+            LVPSA_FFT_PowerSpectrum(pFFT, pData);
+
+            for (ii = 0; ii < pInst->nBands; ii++)
+            {
+                pBand = &pFFT->pBands[ii];
+                Power = 0;
+                for (k = pBand->FirstBin; k < pBand->EndBin; k++)
+                {
+                    Power += pData[2 * k];
+                }
+                Level = sqrtf(Power * pFFT->PowerScale);
+                if (Level > LVPSA_FFT_MAXLEVEL)
+                {
+                    Level = LVPSA_FFT_MAXLEVEL;
+                }
+
+                if (Level > pLevel[ii])
+                {
+                    pLevel[ii] = Level - pFFT->Attack * (Level - pLevel[ii]);
+                }
+                else
+                {
+                    pLevel[ii] = Level + pFFT->Release * (pLevel[ii] - Level);
+                }
+            }
+        }
+
+        if (BufferUpdateSamplesCount == (LVM_INT32)pInst->nSamplesBufferUpdate)
+        {
+            LVPSA_QPD_WritePeaks_Float( pInst,
+                                        &pWrite,
+                                        0,
+                                        pLevel,
+                                        (LVM_INT16)pInst->nBands);
+            BufferUpdateSamplesCount = 0;
+            pInst->LocalSamplesCount = (LVM_UINT16)(n - 1);
+        }
+    }
+
+    pInst->pSpectralDataBufferWritePointer = pWrite;
+    pInst->BufferUpdateSamplesCount = BufferUpdateSamplesCount;
+}
+#endif
@@ -53,6 +53,9 @@ LVPSA_RETURN LVPSA_Init              ( pLVPSA_Handle_t             *phInstance,
     extern LVM_FLOAT            LVPSA_Float_GainTable[];
 #endif
     LVM_UINT32                  BufferLength = 0;
+#ifdef BUILD_FLOAT
+    LVPSA_FFT_Instance_t        *pFFT;
+#endif
 
     /* Ints_Alloc instances, needed for memory alignment management */
     INST_ALLOC          Instance;
@@ -70,21 +73,46 @@ LVPSA_RETURN LVPSA_Init              ( pLVPSA_Handle_t             *phInstance,
         (pInitParams->MaxInputBlockSize > LVPSA_MAXINPUTBLOCKSIZE)      ||
         (pInitParams->MaxInputBlockSize == 0)                           ||
         (pInitParams->nBands < LVPSA_NBANDSMIN)                         ||
-        (pInitParams->nBands > LVPSA_NBANDSMAX)                         ||
-        (pInitParams->pFiltersParams == 0))
+        ((pInitParams->CoefBankRates & ~LVPSA_FS_BANK_ALL) != 0)        ||
+        (pInitParams->Decimation > LVM_MODE_ON)                         ||
+#ifdef BUILD_FLOAT
+        (pInitParams->Engine > LVPSA_ENGINE_FFT))
+#else
+        (pInitParams->Engine != LVPSA_ENGINE_FILTERBANK))
+#endif
     {
         return(LVPSA_ERROR_INVALIDPARAM);
     }
-    for(ii = 0; ii < pInitParams->nBands; ii++)
+    if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+    {
+        if((pInitParams->nBands > LVPSA_FFT_NBANDSMAX)                  ||
+           (pInitParams->FFTSize < LVPSA_FFT_MINSIZE)                   ||
+           (pInitParams->FFTSize > LVPSA_FFT_MAXSIZE)                   ||
+           ((pInitParams->FFTSize & (pInitParams->FFTSize - 1)) != 0)   ||
+           (pInitParams->HopSize == 0)                                  ||
+           (pInitParams->HopSize > pInitParams->FFTSize))
+        {
+            return(LVPSA_ERROR_INVALIDPARAM);
+        }
+    }
+    else
     {
-        if((pInitParams->pFiltersParams[ii].CenterFrequency > LVPSA_MAXCENTERFREQ) ||
-           (pInitParams->pFiltersParams[ii].PostGain        > LVPSA_MAXPOSTGAIN)   ||
-           (pInitParams->pFiltersParams[ii].PostGain        < LVPSA_MINPOSTGAIN)   ||
-           (pInitParams->pFiltersParams[ii].QFactor < LVPSA_MINQFACTOR)            ||
-           (pInitParams->pFiltersParams[ii].QFactor > LVPSA_MAXQFACTOR))
-           {
-                return(LVPSA_ERROR_INVALIDPARAM);
-           }
+        if((pInitParams->nBands > LVPSA_NBANDSMAX)                      ||
+           (pInitParams->pFiltersParams == 0))
+        {
+            return(LVPSA_ERROR_INVALIDPARAM);
+        }
+        for(ii = 0; ii < pInitParams->nBands; ii++)
+        {
+            if((pInitParams->pFiltersParams[ii].CenterFrequency > LVPSA_MAXCENTERFREQ) ||
+               (pInitParams->pFiltersParams[ii].PostGain        > LVPSA_MAXPOSTGAIN)   ||
+               (pInitParams->pFiltersParams[ii].PostGain        < LVPSA_MINPOSTGAIN)   ||
+               (pInitParams->pFiltersParams[ii].QFactor < LVPSA_MINQFACTOR)            ||
+               (pInitParams->pFiltersParams[ii].QFactor > LVPSA_MAXQFACTOR))
+               {
+                    return(LVPSA_ERROR_INVALIDPARAM);
+               }
+        }
     }
 
 
@@ -148,49 +176,115 @@ LVPSA_RETURN LVPSA_Init              ( pLVPSA_Handle_t             *phInstance,
 #ifndef BUILD_FLOAT
     pLVPSA_Inst->pPostGains                 = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT16) );
 #else
-    pLVPSA_Inst->pPostGains             = InstAlloc_AddMember( &Instance, pInitParams->nBands * \
-                                                               sizeof(LVM_FLOAT) );
+    pLVPSA_Inst->pFFT                       = LVM_NULL;
+    pLVPSA_Inst->pPostGains                 = LVM_NULL;
+    if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+    {
+        pLVPSA_Inst->pFFT                   = InstAlloc_AddMemberAligned( &Instance, sizeof(LVPSA_FFT_Instance_t),
+                                                                          LVPSA_FFT_ALIGN );
+    }
+    else
+    {
+        pLVPSA_Inst->pPostGains             = InstAlloc_AddMember( &Instance, pInitParams->nBands * \
+                                                                   sizeof(LVM_FLOAT) );
+    }
 #endif
     pLVPSA_Inst->pFiltersParams             = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_FilterParam_t) );
+#ifndef BUILD_FLOAT
     pLVPSA_Inst->pSpectralDataBufferStart   = InstAlloc_AddMember( &Instance, pInitParams->nBands * pLVPSA_Inst->SpectralDataBufferLength * sizeof(LVM_UINT8) );
+#else
+    pLVPSA_Inst->pSpectralDataBufferStart   = InstAlloc_AddMember( &Instance, pInitParams->nBands * pLVPSA_Inst->SpectralDataBufferLength * sizeof(LVM_FLOAT) );
+#endif
     pLVPSA_Inst->pPreviousPeaks             = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT8) );
-    pLVPSA_Inst->pBPFiltersPrecision        = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_BPFilterPrecision_en) );
 #ifndef BUILD_FLOAT
+    pLVPSA_Inst->pBPFiltersPrecision        = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_BPFilterPrecision_en) );
+
     pLVPSA_Inst->pBP_Instances          = InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(Biquad_Instance_t) );
     pLVPSA_Inst->pQPD_States            = InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(QPD_State_t) );
-#else
-    pLVPSA_Inst->pBP_Instances          = InstAlloc_AddMember( &Coef, pInitParams->nBands * \
-                                                               sizeof(Biquad_FLOAT_Instance_t) );
-    pLVPSA_Inst->pQPD_States            = InstAlloc_AddMember( &Coef, pInitParams->nBands * \
-                                                               sizeof(QPD_FLOAT_State_t) );
-#endif
 
-#ifndef BUILD_FLOAT
     pLVPSA_Inst->pBP_Taps               = InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(Biquad_1I_Order2_Taps_t) );
     pLVPSA_Inst->pQPD_Taps              = InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(QPD_Taps_t) );
-
 #else
-    pLVPSA_Inst->pBP_Taps               = InstAlloc_AddMember( &Data,
-                                                               pInitParams->nBands * \
-                                                               sizeof(Biquad_1I_Order2_FLOAT_Taps_t));
-    pLVPSA_Inst->pQPD_Taps              = InstAlloc_AddMember( &Data, pInitParams->nBands * \
-                                                               sizeof(QPD_FLOAT_Taps_t) );
-#endif
+    pLVPSA_Inst->pBPFiltersPrecision        = LVM_NULL;
+    pLVPSA_Inst->pBPFiltersDecimation       = LVM_NULL;
+    pLVPSA_Inst->pBankGroups                = LVM_NULL;
+    pLVPSA_Inst->nBankGroups                = 0;
+    pLVPSA_Inst->pBankCoefs                 = LVM_NULL;
+    pLVPSA_Inst->pCoefBank                  = LVM_NULL;
+    pLVPSA_Inst->pBankTaps                  = LVM_NULL;
+    pLVPSA_Inst->pDecimationTaps            = LVM_NULL;
+    pLVPSA_Inst->nDecimationStages          = 0;
+    pLVPSA_Inst->DecimationCount            = 0;
 
-    /* Copy filters parameters in the private instance */
-    for(ii = 0; ii < pLVPSA_Inst->nBands; ii++)
+    if (pInitParams->Engine == LVPSA_ENGINE_FFT)
     {
-        pLVPSA_Inst->pFiltersParams[ii] = pInitParams->pFiltersParams[ii];
+        pFFT = pLVPSA_Inst->pFFT;
+        pFFT->FFTSize                       = pInitParams->FFTSize;
+        pFFT->HopSize                       = pInitParams->HopSize;
+        pFFT->pWindow                       = InstAlloc_AddMember( &Coef, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+        pFFT->pTwiddles                     = InstAlloc_AddMember( &Coef, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+        pFFT->pBitReverse                   = InstAlloc_AddMember( &Coef, (pInitParams->FFTSize >> 1) * sizeof(LVM_UINT16) );
+        pFFT->pBands                        = InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(LVPSA_FFT_Band_t) );
+        pFFT->pInput                        = InstAlloc_AddMember( &Data, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+        pFFT->pLevels                       = InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(LVM_FLOAT) );
+        LVPSA_FFT_Init(pFFT);
     }
+    else
+    {
+        pLVPSA_Inst->pBPFiltersPrecision    = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_BPFilterPrecision_en) );
+        if (pInitParams->Decimation == LVM_MODE_ON)
+        {
+            pLVPSA_Inst->pBPFiltersDecimation = InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT8) );
+        }
+        pLVPSA_Inst->pBankGroups            = InstAlloc_AddMember( &Instance, \
+                                                                   LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                                                   sizeof(LVPSA_BankGroup_t) );
+
+        pLVPSA_Inst->pBankCoefs             = InstAlloc_AddMember( &Coef, \
+                                                                   LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                                                   sizeof(LVPSA_BankCoefs_t) );
+        if (pInitParams->CoefBankRates != LVM_FS_BANK_NONE)
+        {
+            pLVPSA_Inst->pCoefBank          = InstAlloc_AddMember( &Coef, pInitParams->nBands * \
+                                                                   LVM_FsBankSize(pInitParams->CoefBankRates) * \
+                                                                   sizeof(BP_FLOAT_Coefs_t) );
+        }
 
-    /* Set Post filters gains*/
-    for(ii = 0; ii < pLVPSA_Inst->nBands; ii++)
+        pLVPSA_Inst->pBankTaps              = InstAlloc_AddMember( &Data, \
+                                                                   LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                                                   sizeof(LVPSA_BankTaps_t) );
+        if (pInitParams->Decimation == LVM_MODE_ON)
+        {
+            pLVPSA_Inst->pDecimationTaps    = InstAlloc_AddMember( &Data, LVPSA_MAXDECIMATION * \
+                                                                   LVPSA_HALFBAND_HISTORY * sizeof(LVM_FLOAT) );
+        }
+    }
+#endif
+    pLVPSA_Inst->CoefBankRates          = pInitParams->CoefBankRates;
+
+    /* The bands of the FFT engine are set with the sampling frequency */
+    if (pInitParams->Engine == LVPSA_ENGINE_FILTERBANK)
     {
+        /* Copy filters parameters in the private instance */
+        for(ii = 0; ii < pLVPSA_Inst->nBands; ii++)
+        {
+            pLVPSA_Inst->pFiltersParams[ii] = pInitParams->pFiltersParams[ii];
+        }
+
+        /* Set Post filters gains*/
+        for(ii = 0; ii < pLVPSA_Inst->nBands; ii++)
+        {
 #ifndef BUILD_FLOAT
-        pLVPSA_Inst->pPostGains[ii] =(LVM_UINT16) LVPSA_GainTable[pInitParams->pFiltersParams[ii].PostGain + 15];
+            pLVPSA_Inst->pPostGains[ii] =(LVM_UINT16) LVPSA_GainTable[pInitParams->pFiltersParams[ii].PostGain + 15];
 #else
-        pLVPSA_Inst->pPostGains[ii] = LVPSA_Float_GainTable[15 + \
-                                                        pInitParams->pFiltersParams[ii].PostGain];
+            pLVPSA_Inst->pPostGains[ii] = LVPSA_Float_GainTable[15 + \
+                                                            pInitParams->pFiltersParams[ii].PostGain];
+#endif
+        }
+
+#ifdef BUILD_FLOAT
+        /* Precompute the band pass coefficients of the banked sampling frequencies */
+        LVPSA_SetCoefBank(pLVPSA_Inst);
 #endif
     }
     pLVPSA_Inst->pSpectralDataBufferWritePointer = pLVPSA_Inst->pSpectralDataBufferStart;
@@ -84,21 +84,46 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
             (pInitParams->MaxInputBlockSize > LVPSA_MAXINPUTBLOCKSIZE)      ||
             (pInitParams->MaxInputBlockSize == 0)                           ||
             (pInitParams->nBands < LVPSA_NBANDSMIN)                         ||
-            (pInitParams->nBands > LVPSA_NBANDSMAX)                         ||
-            (pInitParams->pFiltersParams == 0))
+            ((pInitParams->CoefBankRates & ~LVPSA_FS_BANK_ALL) != 0)        ||
+            (pInitParams->Decimation > LVM_MODE_ON)                         ||
+#ifdef BUILD_FLOAT
+            (pInitParams->Engine > LVPSA_ENGINE_FFT))
+#else
+            (pInitParams->Engine != LVPSA_ENGINE_FILTERBANK))
+#endif
         {
             return(LVPSA_ERROR_INVALIDPARAM);
         }
-        for(ii = 0; ii < pInitParams->nBands; ii++)
+        if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+        {
+            if((pInitParams->nBands > LVPSA_FFT_NBANDSMAX)                  ||
+               (pInitParams->FFTSize < LVPSA_FFT_MINSIZE)                   ||
+               (pInitParams->FFTSize > LVPSA_FFT_MAXSIZE)                   ||
+               ((pInitParams->FFTSize & (pInitParams->FFTSize - 1)) != 0)   ||
+               (pInitParams->HopSize == 0)                                  ||
+               (pInitParams->HopSize > pInitParams->FFTSize))
+            {
+                return(LVPSA_ERROR_INVALIDPARAM);
+            }
+        }
+        else
         {
-            if((pInitParams->pFiltersParams[ii].CenterFrequency > LVPSA_MAXCENTERFREQ) ||
-               (pInitParams->pFiltersParams[ii].PostGain        > LVPSA_MAXPOSTGAIN)   ||
-               (pInitParams->pFiltersParams[ii].PostGain        < LVPSA_MINPOSTGAIN)   ||
-               (pInitParams->pFiltersParams[ii].QFactor < LVPSA_MINQFACTOR)            ||
-               (pInitParams->pFiltersParams[ii].QFactor > LVPSA_MAXQFACTOR))
-               {
-                    return(LVPSA_ERROR_INVALIDPARAM);
-               }
+            if((pInitParams->nBands > LVPSA_NBANDSMAX)                      ||
+               (pInitParams->pFiltersParams == 0))
+            {
+                return(LVPSA_ERROR_INVALIDPARAM);
+            }
+            for(ii = 0; ii < pInitParams->nBands; ii++)
+            {
+                if((pInitParams->pFiltersParams[ii].CenterFrequency > LVPSA_MAXCENTERFREQ) ||
+                   (pInitParams->pFiltersParams[ii].PostGain        > LVPSA_MAXPOSTGAIN)   ||
+                   (pInitParams->pFiltersParams[ii].PostGain        < LVPSA_MINPOSTGAIN)   ||
+                   (pInitParams->pFiltersParams[ii].QFactor < LVPSA_MINQFACTOR)            ||
+                   (pInitParams->pFiltersParams[ii].QFactor > LVPSA_MAXQFACTOR))
+                   {
+                        return(LVPSA_ERROR_INVALIDPARAM);
+                   }
+            }
         }
 
         /*
@@ -107,7 +132,14 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
 
         InstAlloc_AddMember( &Instance, sizeof(LVPSA_InstancePr_t) );
 #ifdef BUILD_FLOAT
-        InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_FLOAT) );
+        if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+        {
+            InstAlloc_AddMemberAligned( &Instance, sizeof(LVPSA_FFT_Instance_t), LVPSA_FFT_ALIGN );
+        }
+        else
+        {
+            InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_FLOAT) );
+        }
 #else
         InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT16) );
 #endif
@@ -128,9 +160,26 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
         {
             BufferLength++;
         }
+#ifndef BUILD_FLOAT
         InstAlloc_AddMember( &Instance, pInitParams->nBands * BufferLength * sizeof(LVM_UINT8) );
+#else
+        InstAlloc_AddMember( &Instance, pInitParams->nBands * BufferLength * sizeof(LVM_FLOAT) );
+#endif
         InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT8) );
+#ifdef BUILD_FLOAT
+        if (pInitParams->Engine != LVPSA_ENGINE_FFT)
+        {
+            InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_BPFilterPrecision_en) );
+            if (pInitParams->Decimation == LVM_MODE_ON)
+            {
+                InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVM_UINT8) );
+            }
+            InstAlloc_AddMember( &Instance, LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                            sizeof(LVPSA_BankGroup_t) );
+        }
+#else
         InstAlloc_AddMember( &Instance, pInitParams->nBands * sizeof(LVPSA_BPFilterPrecision_en) );
+#endif
         pMemoryTable->Region[LVPSA_MEMREGION_INSTANCE].Size         = InstAlloc_GetTotal(&Instance);
         pMemoryTable->Region[LVPSA_MEMREGION_INSTANCE].Type         = LVPSA_PERSISTENT;
         pMemoryTable->Region[LVPSA_MEMREGION_INSTANCE].pBaseAddress = LVM_NULL;
@@ -141,7 +190,22 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
 #ifndef BUILD_FLOAT
         InstAlloc_AddMember( &Scratch, 2 * pInitParams->MaxInputBlockSize * sizeof(LVM_INT16) );
 #else
-        InstAlloc_AddMember( &Scratch, 2 * pInitParams->MaxInputBlockSize * sizeof(LVM_FLOAT) );
+        if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+        {
+            /* The transform works in place */
+            InstAlloc_AddMember( &Scratch, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+        }
+        else if (pInitParams->Decimation == LVM_MODE_ON)
+        {
+            /* The decimated signals follow the input, each after its input history */
+            InstAlloc_AddMember( &Scratch, (2 * pInitParams->MaxInputBlockSize + \
+                                            (LVPSA_MAXDECIMATION + 1) * (LVPSA_HALFBAND_HISTORY + 1)) * \
+                                            sizeof(LVM_FLOAT) );
+        }
+        else
+        {
+            InstAlloc_AddMember( &Scratch, pInitParams->MaxInputBlockSize * sizeof(LVM_FLOAT) );
+        }
 #endif
         pMemoryTable->Region[LVPSA_MEMREGION_SCRATCH].Size         = InstAlloc_GetTotal(&Scratch);
         pMemoryTable->Region[LVPSA_MEMREGION_SCRATCH].Type         = LVPSA_SCRATCH;
@@ -154,8 +218,20 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
         InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(Biquad_Instance_t) );
         InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(QPD_State_t) );
 #else
-        InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(Biquad_FLOAT_Instance_t) );
-        InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(QPD_FLOAT_State_t) );
+        if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+        {
+            InstAlloc_AddMember( &Coef, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+            InstAlloc_AddMember( &Coef, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+            InstAlloc_AddMember( &Coef, (pInitParams->FFTSize >> 1) * sizeof(LVM_UINT16) );
+            InstAlloc_AddMember( &Coef, pInitParams->nBands * sizeof(LVPSA_FFT_Band_t) );
+        }
+        else
+        {
+            InstAlloc_AddMember( &Coef, LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                        sizeof(LVPSA_BankCoefs_t) );
+            InstAlloc_AddMember( &Coef, pInitParams->nBands * LVM_FsBankSize(pInitParams->CoefBankRates) * \
+                                        sizeof(BP_FLOAT_Coefs_t) );
+        }
 #endif
         pMemoryTable->Region[LVPSA_MEMREGION_PERSISTENT_COEF].Size         = InstAlloc_GetTotal(&Coef);
         pMemoryTable->Region[LVPSA_MEMREGION_PERSISTENT_COEF].Type         = LVPSA_PERSISTENT_COEF;
@@ -168,8 +244,20 @@ LVPSA_RETURN LVPSA_Memory            ( pLVPSA_Handle_t             hInstance,
         InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(Biquad_1I_Order2_Taps_t) );
         InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(QPD_Taps_t) );
 #else
-        InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(Biquad_1I_Order2_FLOAT_Taps_t) );
-        InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(QPD_FLOAT_Taps_t) );
+        if (pInitParams->Engine == LVPSA_ENGINE_FFT)
+        {
+            InstAlloc_AddMember( &Data, pInitParams->FFTSize * sizeof(LVM_FLOAT) );
+            InstAlloc_AddMember( &Data, pInitParams->nBands * sizeof(LVM_FLOAT) );
+        }
+        else
+        {
+            InstAlloc_AddMember( &Data, LVPSA_BANK_GROUPS(pInitParams->nBands, pInitParams->Decimation) * \
+                                        sizeof(LVPSA_BankTaps_t) );
+            if (pInitParams->Decimation == LVM_MODE_ON)
+            {
+                InstAlloc_AddMember( &Data, LVPSA_MAXDECIMATION * LVPSA_HALFBAND_HISTORY * sizeof(LVM_FLOAT) );
+            }
+        }
 #endif
         pMemoryTable->Region[LVPSA_MEMREGION_PERSISTENT_DATA].Size         = InstAlloc_GetTotal(&Data);
         pMemoryTable->Region[LVPSA_MEMREGION_PERSISTENT_DATA].Type         = LVPSA_PERSISTENT_DATA;
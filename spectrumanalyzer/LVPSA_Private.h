@@ -21,7 +21,9 @@
 #include "LVPSA.h"
 #include "BIQUAD.h"
 #include "LVPSA_QPD.h"
+#include "LVPSA_FFT.h"
 #include "LVM_Macros.h"
+#include "LVM_Common.h"
 
 
 
@@ -38,6 +40,7 @@ extern "C" {
 #define LVPSA_SCRATCH_ALIGN              4      /* 32-bit alignment for long data                                   */
 #define LVPSA_COEF_ALIGN                 4      /* 32-bit alignment for long words                                  */
 #define LVPSA_DATA_ALIGN                 4      /* 32-bit alignment for long data                                   */
+#define LVPSA_FFT_ALIGN                  8      /* 64-bit alignment for the FFT instance, it holds pointers         */
 
 #define LVPSA_MEMREGION_INSTANCE         0      /* Offset to instance memory region in memory table                 */
 #define LVPSA_MEMREGION_PERSISTENT_COEF  1      /* Offset to persistent coefficients  memory region in memory table */
@@ -49,6 +52,7 @@ extern "C" {
 #define LVPSA_NR_SUPPORTED_RATE          13      /* From 8000Hz to 192000Hz*/
 #endif
 #define LVPSA_NR_SUPPORTED_SPEED         3      /* LOW, MEDIUM, HIGH                                                */
+#define LVPSA_FS_BANK_ALL                (LVM_FS_BANK(LVPSA_NR_SUPPORTED_RATE) - 1) /* Rates that can be banked            */
 
 #define LVPSA_MAXBUFFERDURATION          4000   /* Maximum length in ms of the levels buffer                        */
 #define LVPSA_MAXINPUTBLOCKSIZE          5000   /* Maximum length in mono samples of the block to process           */
@@ -60,10 +64,31 @@ extern "C" {
 #define LVPSA_MINQFACTOR                 25     /* Minimum possible Q factor                                        */
 #define LVPSA_MAXQFACTOR                 1200   /* Maximum possible Q factor                                        */
 
+#define LVPSA_MAXDECIMATION              4      /* Maximum number of half-band decimation stages                    */
+#define LVPSA_HALFBAND_PAIRS             3      /* Number of non-zero symmetric coefficient pairs of the half-band  */
+#define LVPSA_HALFBAND_HISTORY           (4 * LVPSA_HALFBAND_PAIRS - 2) /* Input history of the half-band filter   */
+#define LVPSA_DECIMATION_BANDLIMIT       4      /* A band is decimated while its center is below the decimated Fs/4 */
+
+#define LVPSA_BANK_LANES                 8       /* Number of bands filtered together by the band pass bank          */
+/* Maximum number of band groups, a group only holds bands of one decimation */
+#define LVPSA_BANK_GROUPS(nBands, Decimation) \
+            (((nBands) + LVPSA_BANK_LANES - 1) / LVPSA_BANK_LANES + (((Decimation) == LVM_MODE_ON) ? LVPSA_MAXDECIMATION : 0))
+
+#define LVPSA_FFT_NBANDSMAX              512    /* Maximum number of frequency band of the FFT engine               */
+#define LVPSA_FFT_MINSIZE                64     /* Minimum transform length of the FFT engine                       */
+#define LVPSA_FFT_MAXSIZE                16384  /* Maximum transform length of the FFT engine                       */
+#define LVPSA_FFT_MINFREQ                20     /* Lower edge of the first band of the FFT engine                   */
+#define LVPSA_FFT_MAXFREQ                20000  /* Upper edge of the last band, below the nyquist frequency         */
+#define LVPSA_FFT_MAXLEVEL               (255.0f / 256.0f) /* Maximum level of a band of the FFT engine            */
+
 #define LVPSA_MAXLEVELDECAYFACTOR        0x4111 /* Decay factor for the maximum values calculation                  */
 #define LVPSA_MAXLEVELDECAYSHIFT         14     /* Decay shift for the maximum values calculation                   */
 
 #define LVPSA_MAXUNSIGNEDCHAR            0xFF
+#ifdef BUILD_FLOAT
+#define LVPSA_INPUTSCALE                 0.5f   /* Input scaling of the band pass filters, folded in the post gains */
+#define LVPSA_LEVEL_BYTE(Level)          ((LVM_UINT8)((Level) * 256)) /* Spectrum level of a float level  */
+#endif
 
 #define LVPSA_FsInvertShift              31
 #define LVPSA_GAINSHIFT                  11
@@ -85,6 +110,37 @@ typedef enum
     LVPSA_DoublePrecisionFilter     /* Double precision */
 } LVPSA_BPFilterPrecision_en;
 
+#ifdef BUILD_FLOAT
+/* Band pass and quasi peak coefficients of a group of bands, one lane per band. The
+   unused lanes have zero coefficients */
+typedef struct
+{
+    LVM_FLOAT   A0[LVPSA_BANK_LANES];                               /* Band pass A0                                                         */
+    LVM_FLOAT   B2[LVPSA_BANK_LANES];                               /* Band pass -B2                                                        */
+    LVM_FLOAT   B1[LVPSA_BANK_LANES];                               /* Band pass -B1                                                        */
+    LVM_FLOAT   PostGain[LVPSA_BANK_LANES];                         /* Post filter gain                                                     */
+    LVM_FLOAT   Kp[LVPSA_BANK_LANES];                               /* Quasi peak KP                                                        */
+    LVM_FLOAT   Km[LVPSA_BANK_LANES];                               /* Quasi peak KM                                                        */
+} LVPSA_BankCoefs_t;
+
+/* Filter history of a group of bands, the bands of a group share their input */
+typedef struct
+{
+    LVM_FLOAT   X[2];                                               /* x(n-1) and x(n-2)                                                    */
+    LVM_FLOAT   Y1[LVPSA_BANK_LANES];                               /* y(n-1) of each band                                                  */
+    LVM_FLOAT   Y2[LVPSA_BANK_LANES];                               /* y(n-2) of each band                                                  */
+    LVM_FLOAT   Level[LVPSA_BANK_LANES];                            /* Quasi peak level of each band                                        */
+} LVPSA_BankTaps_t;
+
+/* Consecutive relevant bands filtered at the same decimation */
+typedef struct
+{
+    LVM_UINT16  FirstBand;                                          /* Index of the band in the first lane                                  */
+    LVM_UINT16  nLanes;                                             /* Number of bands in the group                                         */
+    LVM_UINT16  Shift;                                              /* Number of decimation stages before the group                         */
+} LVPSA_BankGroup_t;
+#endif
+
 typedef struct
 {
     LVM_CHAR                    bControlPending;                    /* Flag incating a change of the control parameters                                             */
@@ -102,13 +158,13 @@ typedef struct
     QPD_State_t                *pQPD_States;                        /* Points a nBands elements array that contains the QPD filter instance for each band           */
     QPD_Taps_t                 *pQPD_Taps;                          /* Points a nBands elements array that contains the QPD filter taps for each band               */
 #else
-    Biquad_FLOAT_Instance_t          *pBP_Instances;
-    /* Points a nBands elements array that contains the band pass filter taps for each band */
-    Biquad_1I_Order2_FLOAT_Taps_t    *pBP_Taps;
-    /* Points a nBands elements array that contains the QPD filter instance for each band */
-    QPD_FLOAT_State_t                *pQPD_States;
-    /* Points a nBands elements array that contains the QPD filter taps for each band */
-    QPD_FLOAT_Taps_t                 *pQPD_Taps;
+    /* Points the coefficients of each band group */
+    LVPSA_BankCoefs_t          *pBankCoefs;
+    /* Points the filter taps of each band group */
+    LVPSA_BankTaps_t           *pBankTaps;
+    /* Points the bands of each group */
+    LVPSA_BankGroup_t          *pBankGroups;
+    LVM_UINT16                  nBankGroups;                        /* Number of band groups of the relevant filters                                                */
 #endif
 
 #ifndef BUILD_FLOAT
@@ -118,6 +174,21 @@ typedef struct
     LVM_FLOAT                  *pPostGains;
 #endif
     LVPSA_FilterParam_t        *pFiltersParams;                     /* Copy of the filters parameters from the input parameters                                     */
+#ifdef BUILD_FLOAT
+    /* Points a nBands elements array per banked rate that contains the band pass filter coefficients */
+    BP_FLOAT_Coefs_t           *pCoefBank;
+#endif
+    LVM_UINT32                  CoefBankRates;                      /* Sampling frequencies with precomputed band pass coefficients                                 */
+#ifdef BUILD_FLOAT
+    /* Points a nBands elements array that contains the number of decimation stages before each band, LVM_NULL without decimation */
+    LVM_UINT8                  *pBPFiltersDecimation;
+    /* Points the input history of each half-band decimation stage */
+    LVM_FLOAT                  *pDecimationTaps;
+    LVM_UINT16                  nDecimationStages;                  /* Number of decimation stages used by the relevant filters                                     */
+    LVM_UINT16                  DecimationCount;                    /* Input samples counter, modulo the largest decimation factor                                  */
+    /* Points the FFT engine, LVM_NULL with the filter bank engine */
+    LVPSA_FFT_Instance_t       *pFFT;
+#endif
 
 
     LVM_UINT16                  nSamplesBufferUpdate;               /* Number of samples to make 20ms                                                               */
@@ -129,8 +200,14 @@ typedef struct
     LVM_UINT16                  DownSamplingCount;                  /* Counter used for the downsampling handling                                                   */
 
     LVM_UINT16                  SpectralDataBufferDuration;         /* Length of the buffer in time (ms) defined by the application                                 */
+#ifndef BUILD_FLOAT
     LVM_UINT8                  *pSpectralDataBufferStart;           /* Starting address of the buffer                                                               */
     LVM_UINT8                  *pSpectralDataBufferWritePointer;    /* Current position of the writting pointer of the buffer                                       */
+#else
+    /* Starting address of the buffer, the levels are kept as floats and LVPSA_GetSpectrum returns their LVPSA_LEVEL_BYTE */
+    LVM_FLOAT                  *pSpectralDataBufferStart;
+    LVM_FLOAT                  *pSpectralDataBufferWritePointer;    /* Current position of the writting pointer of the buffer                                       */
+#endif
     LVPSA_Time                  SpectralDataBufferAudioTime;        /* AudioTime at which the last value save occured in the buffer                                 */
     LVM_UINT32                  SpectralDataBufferLength;           /* Number of spectrum data value that the buffer can contain (per band)
                                                                        = SpectralDataBufferDuration/20ms                                                            */
@@ -162,6 +239,238 @@ typedef struct
 /************************************************************************************/
 LVPSA_RETURN LVPSA_ApplyNewSettings (LVPSA_InstancePr_t     *pInst);
 
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetCenterFrequencies                                  */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Spreads the center frequencies of the filters up to the nyquist frequency and   */
+/*  counts the relevant filters.                                                    */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetCenterFrequencies (LVPSA_InstancePr_t     *pInst,
+                                 LVM_Fs_en              Fs);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_UpdatePeak                                            */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Holds the peak of a band at its level or lets it decay towards 0.               */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  Peak                Previous peak of the band                                   */
+/*  Level               Current level of the band                                   */
+/*                                                                                  */
+/* RETURNS:             The new peak of the band                                    */
+/*                                                                                  */
+/************************************************************************************/
+LVM_UINT8 LVPSA_UpdatePeak (LVM_UINT8              Peak,
+                            LVM_UINT8              Level);
+
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetCoefBank                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Calculates the band pass filter coefficients for every banked sampling          */
+/*  frequency.                                                                      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVPSA_OK            Always succeeds                                             */
+/*                                                                                  */
+/************************************************************************************/
+LVPSA_RETURN LVPSA_SetCoefBank (LVPSA_InstancePr_t     *pInst);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetDecimation                                         */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Selects the number of half-band decimation stages before each relevant filter   */
+/*  and counts the stages to run.                                                   */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. A band is decimated while the decimated rate is supported, the decimation    */
+/*     divides the quasi peak downsampling factor and the band center frequency is  */
+/*     below a quarter of the decimated rate                                        */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetDecimation (LVPSA_InstancePr_t     *pInst,
+                          LVM_Fs_en              Fs);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetBankGroups                                         */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Splits the relevant filters in groups of up to LVPSA_BANK_LANES consecutive     */
+/*  bands of the same decimation and clears the coefficients of the groups.         */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetBankGroups (LVPSA_InstancePr_t     *pInst);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_GetBandFs                                             */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the sampling frequency a band pass filter runs at.                      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  BandIndex           Index of the band                                           */
+/*  Fs                  Input sampling frequency                                    */
+/*                                                                                  */
+/************************************************************************************/
+LVM_Fs_en LVPSA_GetBandFs (LVPSA_InstancePr_t     *pInst,
+                           LVM_UINT16             BandIndex,
+                           LVM_Fs_en              Fs);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_HalfBandDecimate                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Low pass filters a block with the half-band filter and keeps every other        */
+/*  sample.                                                                         */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pTaps               Pointer to the input history of the stage                   */
+/*  pIn                 Pointer to the input samples, LVPSA_HALFBAND_HISTORY        */
+/*                      samples before it are overwritten with the history          */
+/*  pOut                Pointer to the decimated samples                            */
+/*  NrSamples           Number of input samples                                     */
+/*  First               Index of the first input sample to keep, 0 or 1             */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  The number of decimated samples                                                 */
+/*                                                                                  */
+/************************************************************************************/
+LVM_INT16 LVPSA_HalfBandDecimate (LVM_FLOAT              *pTaps,
+                                  LVM_FLOAT              *pIn,
+                                  LVM_FLOAT              *pOut,
+                                  LVM_INT16              NrSamples,
+                                  LVM_INT16              First);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_QPD_Process_Bank                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Applies the band pass filters of a group of bands to their input signal and     */
+/*  the downsampling, post gain and quasi peak filtering to the filter outputs.     */
+/*  Writes the levels values in the buffer every 20 ms.                             */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  GroupIndex          Index of the band group                                     */
+/*  pInSamps            Pointer to the input signal, decimated by 2^Shift of the    */
+/*                      group                                                       */
+/*  NrSamples           Number of samples of the decimated signal                   */
+/*  numSamples          Number of input samples of the block                        */
+/*  DecimationOffset    Index in the block of the input sample of the first sample  */
+/*                      of the decimated signal                                     */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1. The filters of all the lanes run on every sample, the quasi peak filters     */
+/*     run on the downsampled outputs of the lanes in use                           */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_QPD_Process_Bank (LVPSA_InstancePr_t     *pInst,
+                             LVM_UINT16             GroupIndex,
+                             LVM_FLOAT              *pInSamps,
+                             LVM_INT16              NrSamples,
+                             LVM_INT16              numSamples,
+                             LVM_INT16              DecimationOffset);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_QPD_WritePeaks_Float                                  */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Write the level values of consecutive bands in the spectrum data buffer.        */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pLVPSA_Inst         Pointer to the LVPSA instance                               */
+/*  ppWrite             Pointer to pointer to the buffer                            */
+/*  BandIndex           Number of the band the first value should be written in     */
+/*  pValues             Values to write in the spectrum data buffer                 */
+/*  nValues             Number of values                                            */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_QPD_WritePeaks_Float(  pLVPSA_InstancePr_t       pLVPSA_Inst,
+                                  LVM_FLOAT             **ppWrite,
+                                  LVM_INT16               BandIndex,
+                                  LVM_FLOAT              *pValues,
+                                  LVM_INT16               nValues );
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetFFTBands                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Spreads the bands of the FFT engine logarithmically from LVPSA_FFT_MINFREQ to   */
+/*  LVPSA_FFT_MAXFREQ or the nyquist frequency and sets the bins of each band.      */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  Fs                  Sampling frequency                                          */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetFFTBands (LVPSA_InstancePr_t     *pInst,
+                        LVM_Fs_en              Fs);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_SetFFTBallistics                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Sets the attack and release of the FFT engine levels per transform from the     */
+/*  quasi peak detector coefficients of the level detection speed.                  */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  pParams             Control parameters                                          */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_SetFFTBallistics (LVPSA_InstancePr_t     *pInst,
+                             LVPSA_ControlParams_t  *pParams);
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_FFT_Process                                           */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Adds the input samples to the input ring of the FFT engine, updates the band    */
+/*  levels every HopSize samples and writes them in the buffer every 20 ms.         */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pInst               Pointer to the instance                                     */
+/*  pInSamps            Pointer to the input samples                                */
+/*  numSamples          Number of input samples                                     */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_FFT_Process (LVPSA_InstancePr_t     *pInst,
+                        LVM_FLOAT              *pInSamps,
+                        LVM_INT16              numSamples);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
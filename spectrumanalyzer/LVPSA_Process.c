@@ -40,7 +40,9 @@ static LVM_INT32 mult32x32in32_shiftr(LVM_INT32 a, LVM_INT32 b, LVM_INT32 c) {
 /*                                                                                  */
 /* DESCRIPTION:                                                                     */
 /*  The process applies band pass filters to the signal. Each output                */
-/*  feeds a quasi peak filter for level detection.                                  */
+/*  feeds a quasi peak filter for level detection. In the floating point build the  */
+/*  bands are filtered by groups, a group at a time, or the levels are taken from   */
+/*  the transforms of the FFT engine.                                               */
 /*                                                                                  */
 /* PARAMETERS:                                                                      */
 /*  hInstance           Pointer to the instance                                     */
@@ -63,11 +65,15 @@ LVPSA_RETURN LVPSA_Process           ( pLVPSA_Handle_t      hInstance,
 {
     LVPSA_InstancePr_t     *pLVPSA_Inst = (LVPSA_InstancePr_t*)hInstance;
     LVM_FLOAT               *pScratch;
-    LVM_INT16               ii;
+    LVM_UINT16              ii;
+    LVM_INT16               Shift;
     LVM_INT32               AudioTimeInc;
     extern LVM_UINT32       LVPSA_SampleRateInvTab[];
-    LVM_UINT8               *pWrite_Save;         /* Position of the write pointer
+    LVM_FLOAT               *pWrite_Save;         /* Position of the write pointer
                                                      at the beginning of the process  */
+    LVM_FLOAT               *pLevel[LVPSA_MAXDECIMATION + 1];   /* Signal of each decimation */
+    LVM_INT16               nLevel[LVPSA_MAXDECIMATION + 1];    /* Number of samples */
+    LVM_INT16               Offset[LVPSA_MAXDECIMATION + 1];    /* Input index of the first sample */
 
     /******************************************************************************
        CHECK PARAMETERS
@@ -96,36 +102,55 @@ LVPSA_RETURN LVPSA_Process           ( pLVPSA_Handle_t      hInstance,
     /******************************************************************************
        PROCESS SAMPLES
     *******************************************************************************/
-    /* Put samples in range [-0.5;0.5[ for BP filters (see Biquads documentation) */
-    Copy_Float(pLVPSA_InputSamples, pScratch, (LVM_INT16)InputBlockSize);
-    Shift_Sat_Float(-1, pScratch, pScratch, (LVM_INT16)InputBlockSize);
-
-    for (ii = 0; ii < pLVPSA_Inst->nRelevantFilters; ii++)
+    /* The FFT engine takes the samples as they are, its ring keeps them between the
+       transforms */
+    if (pLVPSA_Inst->pFFT != LVM_NULL)
     {
-        switch(pLVPSA_Inst->pBPFiltersPrecision[ii])
+        LVPSA_FFT_Process(pLVPSA_Inst, pLVPSA_InputSamples, (LVM_INT16)InputBlockSize);
+    }
+    else
+    {
+        /* The band pass filters take the samples as they are, the scaling to the range
+           [-0.5;0.5[ of the fixed point filters is folded in the post gains. Only the
+           decimation stages need a copy, with the input history before the samples */
+        pLevel[0] = pLVPSA_InputSamples;
+        if (pLVPSA_Inst->nDecimationStages != 0)
         {
-            case LVPSA_SimplePrecisionFilter:
-                BP_1I_D16F16C14_TRC_WRA_01  ( &pLVPSA_Inst->pBP_Instances[ii],
-                                              pScratch,
-                                              pScratch + InputBlockSize,
-                                              (LVM_INT16)InputBlockSize);
-                break;
-
-            case LVPSA_DoublePrecisionFilter:
-                BP_1I_D16F32C30_TRC_WRA_01  ( &pLVPSA_Inst->pBP_Instances[ii],
-                                              pScratch,
-                                              pScratch + InputBlockSize,
-                                              (LVM_INT16)InputBlockSize);
-                break;
-            default:
-                break;
+            pScratch += LVPSA_HALFBAND_HISTORY;
+            Copy_Float(pLVPSA_InputSamples, pScratch, (LVM_INT16)InputBlockSize);
+            pLevel[0] = pScratch;
         }
 
+        /******************************************************************************
+           DECIMATE FOR THE LOW BANDS
+        *******************************************************************************/
+        /* Each stage keeps the samples at multiples of its decimation factor since the
+           last sampling frequency change, the quasi peak downsampling takes a subset */
+        nLevel[0] = (LVM_INT16)InputBlockSize;
+        Offset[0] = 0;
+        for (Shift = 1; Shift <= (LVM_INT16)pLVPSA_Inst->nDecimationStages; Shift++)
+        {
+            Offset[Shift] = (LVM_INT16)((LVM_UINT16)(-pLVPSA_Inst->DecimationCount) & ((1 << Shift) - 1));
+            pLevel[Shift] = pLevel[Shift - 1] + nLevel[Shift - 1] + LVPSA_HALFBAND_HISTORY;
+            nLevel[Shift] = LVPSA_HalfBandDecimate(&pLVPSA_Inst->pDecimationTaps[(Shift - 1) * LVPSA_HALFBAND_HISTORY],
+                                                   pLevel[Shift - 1],
+                                                   pLevel[Shift],
+                                                   nLevel[Shift - 1],
+                                                   (LVM_INT16)((Offset[Shift] - Offset[Shift - 1]) >> (Shift - 1)));
+        }
+        pLVPSA_Inst->DecimationCount = (LVM_UINT16)((pLVPSA_Inst->DecimationCount + InputBlockSize) &
+                                                    ((1 << LVPSA_MAXDECIMATION) - 1));
 
-        LVPSA_QPD_Process_Float   ( pLVPSA_Inst,
-                                    pScratch + InputBlockSize,
-                                    (LVM_INT16)InputBlockSize,
-                                    ii);
+        for (ii = 0; ii < pLVPSA_Inst->nBankGroups; ii++)
+        {
+            Shift = (LVM_INT16)pLVPSA_Inst->pBankGroups[ii].Shift;
+            LVPSA_QPD_Process_Bank  ( pLVPSA_Inst,
+                                      ii,
+                                      pLevel[Shift],
+                                      nLevel[Shift],
+                                      (LVM_INT16)InputBlockSize,
+                                      Offset[Shift]);
+        }
     }
 
     /******************************************************************************
@@ -233,6 +258,60 @@ LVPSA_RETURN LVPSA_Process           ( pLVPSA_Handle_t      hInstance,
 }
 #endif
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_HalfBandDecimate                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Low pass filters a block with the half-band filter and keeps every other        */
+/*  sample. Only the kept samples are calculated.                                   */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pTaps               Pointer to the input history of the stage                   */
+/*  pIn                 Pointer to the input samples, LVPSA_HALFBAND_HISTORY        */
+/*                      samples before it are overwritten with the history          */
+/*  pOut                Pointer to the decimated samples                            */
+/*  NrSamples           Number of input samples                                     */
+/*  First               Index of the first input sample to keep, 0 or 1             */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  The number of decimated samples                                                 */
+/*                                                                                  */
+/************************************************************************************/
+LVM_INT16 LVPSA_HalfBandDecimate (LVM_FLOAT              *pTaps,
+                                  LVM_FLOAT              *pIn,
+                                  LVM_FLOAT              *pOut,
+                                  LVM_INT16              NrSamples,
+                                  LVM_INT16              First)
+{
+    extern LVM_FLOAT        LVPSA_Float_HalfBandCoefs[];
+    LVM_FLOAT               *pX = pIn - LVPSA_HALFBAND_HISTORY;   /* x(n-HISTORY) of the first sample */
+    LVM_FLOAT               Acc;
+    LVM_INT16               n;
+    LVM_INT16               k;
+    LVM_INT16               Count = 0;
+
+    Copy_Float(pTaps, pX, LVPSA_HALFBAND_HISTORY);
+
+    for (n = First; n < NrSamples; n += 2)
+    {
+        /* Centre tap and symmetric pairs, the other taps are zero */
+        Acc = 0.5f * pX[n + LVPSA_HALFBAND_HISTORY / 2];
+        for (k = 0; k < LVPSA_HALFBAND_PAIRS; k++)
+        {
+            Acc += LVPSA_Float_HalfBandCoefs[k] * (pX[n + 2 * k] + pX[n + LVPSA_HALFBAND_HISTORY - 2 * k]);
+        }
+        pOut[Count++] = Acc;
+    }
+
+    /* Keep the last input samples for the next block */
+    Copy_Float(&pX[NrSamples], pTaps, LVPSA_HALFBAND_HISTORY);
+
+    return(Count);
+}
+#endif
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_GetSpectrum                                           */
@@ -262,7 +341,12 @@ LVPSA_RETURN LVPSA_GetSpectrum       ( pLVPSA_Handle_t      hInstance,
 
     LVPSA_InstancePr_t      *pLVPSA_Inst = (LVPSA_InstancePr_t*)hInstance;
     LVM_INT32               StatusDelta, ii;
+#ifndef BUILD_FLOAT
     LVM_UINT8               *pRead;
+#else
+    LVM_FLOAT               *pRead;
+    LVM_UINT8               Level;
+#endif
 
     if(hInstance == LVM_NULL || pCurrentValues == LVM_NULL || pPeakValues == LVM_NULL)
     {
@@ -324,30 +408,59 @@ LVPSA_RETURN LVPSA_GetSpectrum       ( pLVPSA_Handle_t      hInstance,
     /* Read the status buffer and fill the output buffers */
     for(ii = 0; ii < pLVPSA_Inst->nBands; ii++)
     {
+#ifndef BUILD_FLOAT
         pCurrentValues[ii] = pRead[ii];
-        if(pLVPSA_Inst->pPreviousPeaks[ii] <= pRead[ii])
-        {
-            pLVPSA_Inst->pPreviousPeaks[ii] = pRead[ii];
-        }
-        else if(pLVPSA_Inst->pPreviousPeaks[ii] != 0)
-        {
-            LVM_INT32 temp;
-            /*Re-compute max values for decay */
-            temp = (LVM_INT32)(LVPSA_MAXUNSIGNEDCHAR - pLVPSA_Inst->pPreviousPeaks[ii]);
-            temp = ((temp * LVPSA_MAXLEVELDECAYFACTOR)>>LVPSA_MAXLEVELDECAYSHIFT);
-            /* If the gain has no effect, "help" the value to increase */
-            if(temp == (LVPSA_MAXUNSIGNEDCHAR - pLVPSA_Inst->pPreviousPeaks[ii]))
-            {
-                temp += 1;
-            }
-            /* Saturate */
-            temp = (temp > LVPSA_MAXUNSIGNEDCHAR) ? LVPSA_MAXUNSIGNEDCHAR : temp;
-            /* Store new max level */
-            pLVPSA_Inst->pPreviousPeaks[ii] =  (LVM_UINT8)(LVPSA_MAXUNSIGNEDCHAR - temp);
-        }
+        pLVPSA_Inst->pPreviousPeaks[ii] = LVPSA_UpdatePeak(pLVPSA_Inst->pPreviousPeaks[ii], pRead[ii]);
+#else
+        Level = LVPSA_LEVEL_BYTE(pRead[ii]);
+        pCurrentValues[ii] = Level;
+        pLVPSA_Inst->pPreviousPeaks[ii] = LVPSA_UpdatePeak(pLVPSA_Inst->pPreviousPeaks[ii], Level);
+#endif
 
         pPeakValues[ii] = pLVPSA_Inst->pPreviousPeaks[ii];
     }
 
     return(LVPSA_OK);
 }
+
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_UpdatePeak                                            */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Holds the peak of a band at its level or lets it decay towards 0.               */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  Peak                Previous peak of the band                                   */
+/*  Level               Current level of the band                                   */
+/*                                                                                  */
+/* RETURNS:             The new peak of the band                                    */
+/*                                                                                  */
+/************************************************************************************/
+LVM_UINT8 LVPSA_UpdatePeak (LVM_UINT8              Peak,
+                            LVM_UINT8              Level)
+{
+    LVM_INT32 temp;
+
+    if(Peak <= Level)
+    {
+        return(Level);
+    }
+    if(Peak == 0)
+    {
+        return(Peak);
+    }
+
+    /*Re-compute max values for decay */
+    temp = (LVM_INT32)(LVPSA_MAXUNSIGNEDCHAR - Peak);
+    temp = ((temp * LVPSA_MAXLEVELDECAYFACTOR)>>LVPSA_MAXLEVELDECAYSHIFT);
+    /* If the gain has no effect, "help" the value to increase */
+    if(temp == (LVPSA_MAXUNSIGNEDCHAR - Peak))
+    {
+        temp += 1;
+    }
+    /* Saturate */
+    temp = (temp > LVPSA_MAXUNSIGNEDCHAR) ? LVPSA_MAXUNSIGNEDCHAR : temp;
+
+    return((LVM_UINT8)(LVPSA_MAXUNSIGNEDCHAR - temp));
+}
@@ -31,14 +31,6 @@ typedef struct
   LVM_INT32                            Coefs[2];       /* pointer to the filter coefficients */
 }QPD_State_t, *pQPD_State_t;
 
-#ifdef BUILD_FLOAT
-typedef struct
-{
-    /* pointer to the delayed samples (data of 32 bits)   */
-    LVM_FLOAT                            *pDelay;
-    LVM_FLOAT                            Coefs[2];       /* pointer to the filter coefficients */
-}QPD_FLOAT_State_t, *pQPD_FLOAT_State_t;
-#endif
 
 typedef struct
 {
@@ -63,14 +55,6 @@ typedef struct
 
 } QPD_Taps_t, *pQPD_Taps_t;
 
-#ifdef BUILD_FLOAT
-typedef struct
-{
-    LVM_FLOAT Storage[1];
-
-} QPD_FLOAT_Taps_t, *pQPD_FLOAT_Taps_t;
-
-#endif
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_QPD_Process                                           */
@@ -89,12 +73,6 @@ void LVPSA_QPD_Process (            void                               *hInstanc
                                     LVM_INT16                           numSamples,
                                     LVM_INT16                           BandIndex);
 
-#ifdef BUILD_FLOAT
-void LVPSA_QPD_Process_Float (      void                               *hInstance,
-                                    LVM_FLOAT                          *pInSamps,
-                                    LVM_INT16                           numSamples,
-                                    LVM_INT16                           BandIndex);
-#endif
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_QPD_Init                                              */
@@ -113,12 +91,6 @@ void LVPSA_QPD_Process_Float (      void                               *hInstanc
 void LVPSA_QPD_Init (   QPD_State_t       *pInstance,
                         QPD_Taps_t        *pTaps,
                         QPD_C32_Coefs     *pCoef     );
-#ifdef BUILD_FLOAT
-
-void LVPSA_QPD_Init_Float (   QPD_FLOAT_State_t       *pInstance,
-                              QPD_FLOAT_Taps_t        *pTaps,
-                              QPD_FLOAT_Coefs         *pCoef     );
-#endif
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -17,7 +17,9 @@
 
 #include "LVPSA_QPD.h"
 #include "LVPSA_Private.h"
+#include "VectorArithmetic.h"
 
+#ifndef BUILD_FLOAT
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_QPD_WritePeak                                         */
@@ -38,12 +40,13 @@ void LVPSA_QPD_WritePeak(   pLVPSA_InstancePr_t       pLVPSA_Inst,
                             LVM_UINT8                 **ppWrite,
                             LVM_INT16                 BandIndex,
                             LVM_INT16                 Value   );
+#endif
 
 #ifdef BUILD_FLOAT
-void LVPSA_QPD_WritePeak_Float(   pLVPSA_InstancePr_t       pLVPSA_Inst,
-                                  LVM_UINT8             **ppWrite,
-                                  LVM_INT16               BandIndex,
-                                  LVM_FLOAT               Value   );
+#if defined(__GNUC__)
+/* Vectors of a band group */
+#define LVPSA_BANK_VECTORS          (LVPSA_BANK_LANES / LVM_FLOAT_VECTOR_LANES)
+#endif
 #endif
 /************************************************************************************/
 /*                                                                                  */
@@ -179,92 +182,166 @@ void LVPSA_QPD_Process (            void                               *hInstanc
     }
 }
 #else
-void LVPSA_QPD_Process_Float (      void                               *hInstance,
-                                    LVM_FLOAT                          *pInSamps,
-                                    LVM_INT16                           numSamples,
-                                    LVM_INT16                           BandIndex)
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_QPD_Process_Bank                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Apply the band pass filters of a band group, then downsampling, post gain and   */
+/*  quasi peak filtering, and write the levels values in the buffer every 20 ms.    */
+/*  The filters run up to each down sampled sample, the detectors take it from      */
+/*  the lanes and the filters go on.                                                */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*                                                                                  */
+/* RETURNS:             void                                                        */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_QPD_Process_Bank (LVPSA_InstancePr_t     *pLVPSA_Inst,
+                             LVM_UINT16             GroupIndex,
+                             LVM_FLOAT              *pInSamps,
+                             LVM_INT16              NrSamples,
+                             LVM_INT16              numSamples,
+                             LVM_INT16              DecimationOffset)
 {
 
     /******************************************************************************
        PARAMETERS
     *******************************************************************************/
-    LVPSA_InstancePr_t     *pLVPSA_Inst = (LVPSA_InstancePr_t*)hInstance;
-    QPD_FLOAT_State_t *pQPDState =  (QPD_FLOAT_State_t*)&pLVPSA_Inst->pQPD_States[BandIndex];
-
-    /* Pointer to taps */
-    LVM_FLOAT* pDelay  = pQPDState->pDelay;
+    LVPSA_BankGroup_t   *pGroup = &pLVPSA_Inst->pBankGroups[GroupIndex];
+    LVPSA_BankCoefs_t   *pCoefs = &pLVPSA_Inst->pBankCoefs[GroupIndex];
+    LVPSA_BankTaps_t    *pTaps  = &pLVPSA_Inst->pBankTaps[GroupIndex];
+
+    /* Band pass filters, the input history is the same in every lane */
+    LVM_FLOAT   X1 = pTaps->X[0];
+    LVM_FLOAT   X2 = pTaps->X[1];
+    LVM_FLOAT   Diff;
+#if defined(__GNUC__)
+    LVM_FloatVector_t   A0[LVPSA_BANK_VECTORS];
+    LVM_FloatVector_t   B2[LVPSA_BANK_VECTORS];
+    LVM_FloatVector_t   B1[LVPSA_BANK_VECTORS];
+    LVM_FloatVector_t   Y0;
+    LVM_FloatVector_t   Y1[LVPSA_BANK_VECTORS];
+    LVM_FloatVector_t   Y2[LVPSA_BANK_VECTORS];
+    LVM_INT16           Vector;
+#else
+    LVM_FLOAT   *pY1 = pTaps->Y1;
+    LVM_FLOAT   *pY2 = pTaps->Y2;
+    LVM_FLOAT   Y0;
+#endif
+    LVM_FLOAT   Out[LVPSA_BANK_LANES];      /* Filter outputs at the downsampled sample */
 
     /* Parameters needed during quasi peak calculations */
     LVM_FLOAT   X0;
-    LVM_FLOAT   temp,temp2;
+    LVM_FLOAT   temp;
     LVM_FLOAT   accu;
     LVM_FLOAT   Xg0;
     LVM_FLOAT   D0;
-    LVM_FLOAT   V0 = (LVM_FLOAT)(*pDelay);
-
-    /* Filter's coef */
-    LVM_FLOAT   Kp = ((LVM_FLOAT)(pQPDState->Coefs[0]));
-    LVM_FLOAT   Km = ((LVM_FLOAT)(pQPDState->Coefs[1]));
+    LVM_FLOAT   *pLevel = pTaps->Level;
 
     LVM_INT16   ii = numSamples;
+    LVM_INT16   n = 0;                      /* Next sample to filter */
+    LVM_INT16   Index;                      /* Sample taken by the downsampling */
+    LVM_INT16   Lane;
 
-    LVM_UINT8  *pWrite = pLVPSA_Inst->pSpectralDataBufferWritePointer;
+    LVM_FLOAT  *pWrite = pLVPSA_Inst->pSpectralDataBufferWritePointer;
     LVM_INT32   BufferUpdateSamplesCount = pLVPSA_Inst->BufferUpdateSamplesCount;
     LVM_UINT16  DownSamplingFactor = pLVPSA_Inst->DownSamplingFactor;
+    LVM_UINT16  InputStep = (LVM_UINT16)(DownSamplingFactor >> pGroup->Shift);
 
     /******************************************************************************
        INITIALIZATION
     *******************************************************************************/
-    /* Correct the pointer to take the first down sampled signal sample */
-    pInSamps += pLVPSA_Inst->DownSamplingCount;
+#if defined(__GNUC__)
+    for (Vector = 0; Vector < LVPSA_BANK_VECTORS; Vector++)
+    {
+        A0[Vector] = ((LVM_FloatVector_t *)pCoefs->A0)[Vector];
+        B2[Vector] = ((LVM_FloatVector_t *)pCoefs->B2)[Vector];
+        B1[Vector] = ((LVM_FloatVector_t *)pCoefs->B1)[Vector];
+        Y1[Vector] = ((LVM_FloatVector_t *)pTaps->Y1)[Vector];
+        Y2[Vector] = ((LVM_FloatVector_t *)pTaps->Y2)[Vector];
+    }
+#endif
+    /* Find the first down sampled signal sample, the downsampling keeps decimated
+       samples only */
+    Index = (LVM_INT16)(((LVM_INT16)pLVPSA_Inst->DownSamplingCount - DecimationOffset) >> pGroup->Shift);
     /* Correct also the number of samples */
     ii = (LVM_INT16)(ii - (LVM_INT16)pLVPSA_Inst->DownSamplingCount);
 
     while (ii > 0)
     {
-        /* Apply post gain */
-        /* - 1 to compensate scaling in process function*/
-        X0 = (*pInSamps) * pLVPSA_Inst->pPostGains[BandIndex];
-        pInSamps = pInSamps + DownSamplingFactor;
-
-        /* Saturate and take absolute value */
-        if(X0 < 0.0f)
-            X0 = -X0;
-        if (X0 > 1.0f)
-            Xg0 = 1.0f;
-        else
-            Xg0 =X0;
-
+        /* Band pass filter every lane up to the down sampled sample */
+        for ( ; n <= Index; n++)
+        {
+            Diff = pInSamps[n] - X2;
+#if defined(__GNUC__)
+            for (Vector = 0; Vector < LVPSA_BANK_VECTORS; Vector++)
+            {
+                Y0 = A0[Vector] * Diff + B2[Vector] * Y2[Vector] + B1[Vector] * Y1[Vector];
+                Y2[Vector] = Y1[Vector];
+                Y1[Vector] = Y0;
+            }
+#else
+            for (Lane = 0; Lane < LVPSA_BANK_LANES; Lane++)
+            {
+                Y0 = pCoefs->A0[Lane] * Diff + pCoefs->B2[Lane] * pY2[Lane] + pCoefs->B1[Lane] * pY1[Lane];
+                pY2[Lane] = pY1[Lane];
+                pY1[Lane] = Y0;
+            }
+#endif
+            X2 = X1;
+            X1 = pInSamps[n];
+        }
+#if defined(__GNUC__)
+        for (Vector = 0; Vector < LVPSA_BANK_VECTORS; Vector++)
+        {
+            ((LVM_FloatVector_t *)Out)[Vector] = Y1[Vector];
+        }
+#else
+        Copy_Float(pY1, Out, LVPSA_BANK_LANES);
+#endif
 
-        /* Quasi peak filter calculation */
-        D0  = Xg0 - V0;
+        for (Lane = 0; Lane < (LVM_INT16)pGroup->nLanes; Lane++)
+        {
+            /* Apply post gain, it includes the input scaling */
+            X0 = Out[Lane] * pCoefs->PostGain[Lane];
+
+            /* Saturate and take absolute value */
+            if(X0 < 0.0f)
+                X0 = -X0;
+            if (X0 > 1.0f)
+                Xg0 = 1.0f;
+            else
+                Xg0 =X0;
 
-        temp2 = D0;
 
-        accu = temp2 * Kp;
-        D0    = D0 / 2.0f;
-        if (D0 < 0.0f){
-            D0 = -D0;
-        }
+            /* Quasi peak filter calculation */
+            D0  = Xg0 - pLevel[Lane];
 
-        temp2 = D0;
+            accu = D0 * pCoefs->Kp[Lane];
+            D0    = D0 / 2.0f;
+            if (D0 < 0.0f){
+                D0 = -D0;
+            }
 
-        temp = D0 * Km;
-        accu += temp + Xg0;
+            temp = D0 * pCoefs->Km[Lane];
+            accu += temp + Xg0;
 
-        if (accu > 1.0f)
-            accu = 1.0f;
-        else if(accu < 0.0f)
-            accu = 0.0f;
+            if (accu > 1.0f)
+                accu = 1.0f;
+            else if(accu < 0.0f)
+                accu = 0.0f;
 
-        V0 = accu;
+            pLevel[Lane] = accu;
+        }
 
         if(((pLVPSA_Inst->nSamplesBufferUpdate - BufferUpdateSamplesCount) < DownSamplingFactor))
         {
-            LVPSA_QPD_WritePeak_Float( pLVPSA_Inst,
-                                       &pWrite,
-                                       BandIndex,
-                                       V0);
+            LVPSA_QPD_WritePeaks_Float( pLVPSA_Inst,
+                                        &pWrite,
+                                        (LVM_INT16)pGroup->FirstBand,
+                                        pLevel,
+                                        (LVM_INT16)pGroup->nLanes);
 
             BufferUpdateSamplesCount -= pLVPSA_Inst->nSamplesBufferUpdate;
             pLVPSA_Inst->LocalSamplesCount = (LVM_UINT16)(numSamples - ii);
@@ -272,15 +349,46 @@ void LVPSA_QPD_Process_Float (      void                               *hInstanc
         BufferUpdateSamplesCount += DownSamplingFactor;
 
         ii = (LVM_INT16)(ii - DownSamplingFactor);
+        Index = (LVM_INT16)(Index + InputStep);
+    }
 
+    /* Filter the samples after the last down sampled one */
+    for ( ; n < NrSamples; n++)
+    {
+        Diff = pInSamps[n] - X2;
+#if defined(__GNUC__)
+        for (Vector = 0; Vector < LVPSA_BANK_VECTORS; Vector++)
+        {
+            Y0 = A0[Vector] * Diff + B2[Vector] * Y2[Vector] + B1[Vector] * Y1[Vector];
+            Y2[Vector] = Y1[Vector];
+            Y1[Vector] = Y0;
+        }
+#else
+        for (Lane = 0; Lane < LVPSA_BANK_LANES; Lane++)
+        {
+            Y0 = pCoefs->A0[Lane] * Diff + pCoefs->B2[Lane] * pY2[Lane] + pCoefs->B1[Lane] * pY1[Lane];
+            pY2[Lane] = pY1[Lane];
+            pY1[Lane] = Y0;
+        }
+#endif
+        X2 = X1;
+        X1 = pInSamps[n];
     }
 
     /* Store last taps in memory */
-    *pDelay = V0;
+    pTaps->X[0] = X1;
+    pTaps->X[1] = X2;
+#if defined(__GNUC__)
+    for (Vector = 0; Vector < LVPSA_BANK_VECTORS; Vector++)
+    {
+        ((LVM_FloatVector_t *)pTaps->Y1)[Vector] = Y1[Vector];
+        ((LVM_FloatVector_t *)pTaps->Y2)[Vector] = Y2[Vector];
+    }
+#endif
 
-    /* If this is the last call to the function after last band processing,
+    /* If this is the last call to the function after last group processing,
        update the parameters. */
-    if(BandIndex == (pLVPSA_Inst->nRelevantFilters - 1))
+    if(GroupIndex == (pLVPSA_Inst->nBankGroups - 1))
     {
         pLVPSA_Inst->pSpectralDataBufferWritePointer = pWrite;
         /* Adjustment for 11025Hz input, 220,5 is normally
@@ -303,6 +411,8 @@ void LVPSA_QPD_Process_Float (      void                               *hInstanc
     }
 }
 #endif
+
+#ifndef BUILD_FLOAT
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:            LVPSA_QPD_WritePeak                                         */
@@ -338,16 +448,34 @@ void LVPSA_QPD_WritePeak(   pLVPSA_InstancePr_t       pLVPSA_Inst,
     *ppWrite = pWrite;
 
 }
-#ifdef BUILD_FLOAT
-void LVPSA_QPD_WritePeak_Float(   pLVPSA_InstancePr_t     pLVPSA_Inst,
-                                  LVM_UINT8               **ppWrite,
+#else
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:            LVPSA_QPD_WritePeaks_Float                                  */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Write the level values of consecutive bands in the spectrum data buffer.        */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  pLVPSA_Inst         Pointer to the LVPSA instance                               */
+/*  ppWrite             Pointer to pointer to the buffer                            */
+/*  BandIndex           Number of the band the first value should be written in     */
+/*  pValues             Values to write in the spectrum data buffer                 */
+/*  nValues             Number of values                                            */
+/*                                                                                  */
+/* RETURNS:             void                                                        */
+/*                                                                                  */
+/************************************************************************************/
+void LVPSA_QPD_WritePeaks_Float(  pLVPSA_InstancePr_t     pLVPSA_Inst,
+                                  LVM_FLOAT               **ppWrite,
                                   LVM_INT16               BandIndex,
-                                  LVM_FLOAT               Value   )
+                                  LVM_FLOAT               *pValues,
+                                  LVM_INT16               nValues )
 {
-    LVM_UINT8 *pWrite = *ppWrite;
+    LVM_FLOAT *pWrite = *ppWrite;
 
-    /* Write the value and update the write pointer */
-    *(pWrite + BandIndex) = (LVM_UINT8)(Value * 256);
+    /* Write the values and update the write pointer */
+    Copy_Float(pValues, pWrite + BandIndex, nValues);
     pWrite += pLVPSA_Inst->nBands;
     if (pWrite == (pLVPSA_Inst->pSpectralDataBufferStart + pLVPSA_Inst->nBands * \
                                     pLVPSA_Inst->SpectralDataBufferLength))
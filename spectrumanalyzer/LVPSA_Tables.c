@@ -142,6 +142,40 @@ const LVM_UINT16    LVPSA_DownSamplingFactor[]  = {     5,                    /*
                                                   };
 
 
+#ifdef BUILD_FLOAT
+/*
+ * Table for converting a sampling rate to half of it, LVM_FS_INVALID when half of the
+ * rate is not supported
+ */
+const LVM_Fs_en     LVPSA_HalfRateTab[] = {     LVM_FS_INVALID,       /* 8000  S/s  */
+                                                LVM_FS_INVALID,       /* 11025 S/s  */
+                                                LVM_FS_INVALID,       /* 12000 S/s  */
+                                                LVM_FS_8000,          /* 16000 S/s  */
+                                                LVM_FS_11025,         /* 22050 S/s  */
+                                                LVM_FS_12000,         /* 24000 S/s  */
+                                                LVM_FS_16000,         /* 32000 S/s  */
+                                                LVM_FS_22050,         /* 44100 S/s  */
+                                                LVM_FS_24000          /* 48000 S/s  */
+#ifdef HIGHER_FS
+                                               ,LVM_FS_44100          /* 88200 S/s  */
+                                               ,LVM_FS_48000          /* 96000 S/s  */
+                                               ,LVM_FS_88200          /* 176400 S/s */
+                                               ,LVM_FS_96000          /* 192000 S/s */
+#endif
+                                          };
+
+/*
+ * Half-band decimation filter, Kaiser windowed (beta 2.6) 11 taps. The symmetric pairs
+ * from the outer taps in, the centre tap is 0.5 and the odd taps are zero. The stop band
+ * starts at 0.35 Fs with 48dB attenuation.
+ */
+const LVM_FLOAT     LVPSA_Float_HalfBandCoefs[] = {     0.017806163f,
+                                                       -0.071571707f,
+                                                        0.303765544f
+                                                  };
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /*  Coefficient calculation tables                                                  */
@@ -221,6 +221,9 @@ typedef struct
     LVM_Callback            CallBack;               /* Bundle callback */
     void                    *pBundleInstance;       /* Bundle instance handle */
 
+    /* Coefficient banks */
+    LVM_UINT32              CoefBankRates;          /* Rates switched without clearing the history */
+
 } LVCS_Capabilities_t;
 
 
@@ -333,6 +336,32 @@ LVCS_ReturnStatus_en LVCS_GetParameters(LVCS_Handle_t   hInstance,
                                         LVCS_Params_t   *pParams);
 
 
+/****************************************************************************************/
+/*                                                                                      */
+/* FUNCTION:                 LVCS_GetTailLevel                                          */
+/*                                                                                      */
+/* DESCRIPTION:                                                                         */
+/*  Returns the peak level of the filter history and of the reverberation delay line,  */
+/*  the output produced by a silent input stays below this level times the gains.       */
+/*                                                                                      */
+/* PARAMETERS:                                                                          */
+/*  hInstance                Instance handle                                            */
+/*  pTailLevel               Pointer to the tail level                                  */
+/*                                                                                      */
+/* RETURNS:                                                                             */
+/*  LVCS_Success             Always succeeds                                            */
+/*                                                                                      */
+/* NOTES:                                                                               */
+/*  1.  The level is full scale (1.0) during an operating mode transition               */
+/*  2.  This function must not be interrupted by the LVCS_Process function              */
+/*                                                                                      */
+/****************************************************************************************/
+#ifdef BUILD_FLOAT
+LVCS_ReturnStatus_en LVCS_GetTailLevel(LVCS_Handle_t   hInstance,
+                                       LVM_FLOAT       *pTailLevel);
+#endif
+
+
 /****************************************************************************************/
 /*                                                                                      */
 /* FUNCTION:                LVCS_Control                                                */
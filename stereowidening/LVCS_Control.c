@@ -24,6 +24,7 @@
 #include "LVCS.h"
 #include "LVCS_Private.h"
 #include "LVCS_Tables.h"
+#include "VectorArithmetic.h"
 // #include "stdio.h"
 
 /************************************************************************************/
@@ -58,6 +59,112 @@ LVCS_ReturnStatus_en LVCS_GetParameters(LVCS_Handle_t   hInstance,
 }
 
 
+#ifdef BUILD_FLOAT
+/************************************************************************************/
+/*                                                                                  */
+/* FUNCTION:                 LVCS_GetTailLevel                                      */
+/*                                                                                  */
+/* DESCRIPTION:                                                                     */
+/*  Returns the peak level of the history of the enabled sub-blocks, including the  */
+/*  reverberation delay line.                                                       */
+/*                                                                                  */
+/* PARAMETERS:                                                                      */
+/*  hInstance                Instance handle                                        */
+/*  pTailLevel               Pointer to the tail level                              */
+/*                                                                                  */
+/* RETURNS:                                                                         */
+/*  LVCS_Success             Always succeeds                                        */
+/*                                                                                  */
+/* NOTES:                                                                           */
+/*  1.  The level is full scale (1.0) while the operating mode transition timer     */
+/*      runs or the bypass mixer ramps, neither would progress with a skipped       */
+/*      process call                                                                */
+/*                                                                                  */
+/************************************************************************************/
+
+LVCS_ReturnStatus_en LVCS_GetTailLevel(LVCS_Handle_t   hInstance,
+                                       LVM_FLOAT       *pTailLevel)
+{
+
+    LVCS_Instance_t         *pInstance = (LVCS_Instance_t  *)hInstance;
+    LVCS_ReverbGenerator_t  *pConfig   = (LVCS_ReverbGenerator_t  *)&pInstance->Reverberation;
+    LVCS_Data_t             *pData;
+    LVM_FLOAT               Level;
+    LVM_FLOAT               TailLevel  = 0.0f;
+
+    if (pInstance->Params.OperatingMode == LVCS_OFF)
+    {
+        *pTailLevel = 0.0f;
+        return(LVCS_SUCCESS);
+    }
+
+    if (((pInstance->bInOperatingModeTransition == LVM_TRUE) &&
+         (pInstance->bTimerDone == LVM_FALSE)) ||
+        (((pInstance->Params.OperatingMode & LVCS_BYPASSMIXSWITCH) != 0) &&
+         ((LVC_Mixer_IsSteady(&pInstance->BypassMix.Mixer_Instance.MixerStream[0]) == LVM_FALSE) ||
+          (LVC_Mixer_IsSteady(&pInstance->BypassMix.Mixer_Instance.MixerStream[1]) == LVM_FALSE))))
+    {
+        *pTailLevel = 1.0f;
+        return(LVCS_SUCCESS);
+    }
+
+    pData = (LVCS_Data_t *)pInstance->MemoryTable.Region[LVCS_MEMREGION_PERSISTENT_FAST_DATA].pBaseAddress;
+
+    /*
+     * Stereo enhancer
+     */
+    if ((pInstance->Params.OperatingMode & LVCS_STEREOENHANCESWITCH) != 0)
+    {
+        TailLevel = PeakAbs_Float(pData->SEBiquadTapsMid.Storage,
+                                  (LVM_INT32)(sizeof(pData->SEBiquadTapsMid) / sizeof(LVM_FLOAT)));
+        Level = PeakAbs_Float(pData->SEBiquadTapsSide.Storage,
+                              (LVM_INT32)(sizeof(pData->SEBiquadTapsSide) / sizeof(LVM_FLOAT)));
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+
+    /*
+     * Reverberation, the delay line holds the pending echoes
+     */
+    if (((pInstance->Params.SpeakerType == LVCS_HEADPHONE) ||
+         (pInstance->Params.SpeakerType == LVCS_EX_HEADPHONES) ||
+         (pInstance->Params.SourceFormat != LVCS_STEREO)) &&
+        ((pInstance->Params.OperatingMode & LVCS_REVERBSWITCH) != 0))
+    {
+        Level = PeakAbs_Float(pData->ReverbBiquadTaps.Storage,
+                              (LVM_INT32)(sizeof(pData->ReverbBiquadTaps) / sizeof(LVM_FLOAT)));
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+        Level = PeakAbs_Float(pConfig->StereoSamples, pConfig->DelaySize);
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+
+    /*
+     * Equaliser
+     */
+    if ((pInstance->Params.OperatingMode & LVCS_EQUALISERSWITCH) != 0)
+    {
+        Level = PeakAbs_Float(pData->EqualiserBiquadTaps.Storage,
+                              (LVM_INT32)(sizeof(pData->EqualiserBiquadTaps) / sizeof(LVM_FLOAT)));
+        if (Level > TailLevel)
+        {
+            TailLevel = Level;
+        }
+    }
+    *pTailLevel = TailLevel;
+
+    return(LVCS_SUCCESS);
+}
+#endif
+
+
 /************************************************************************************/
 /*                                                                                  */
 /* FUNCTION:                LVCS_Control                                            */
@@ -105,11 +212,23 @@ LVCS_ReturnStatus_en LVCS_Control(LVCS_Handle_t      hInstance,
        (pInstance->Params.SpeakerType != pParams->SpeakerType))
     {
         const LVCS_VolCorrect_t *pLVCS_VolCorrectTable;
+        LVM_INT16               KeepState;
+
+        /*
+         * A switch between banked rates keeps the compressor and bypass mixer state
+         */
+        KeepState = (LVM_INT16)((pInstance->Params.SpeakerType == pParams->SpeakerType) &&
+                                (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                  pInstance->Params.SampleRate,
+                                                  pParams->SampleRate) == LVM_TRUE));
 
         /*
          * Output device
          */
-        pInstance->OutputDevice = LVCS_HEADPHONE;
+        if (KeepState == LVM_FALSE)
+        {
+            pInstance->OutputDevice = LVCS_HEADPHONE;
+        }
 
         /*
          * Get the volume correction parameters
@@ -120,12 +239,15 @@ LVCS_ReturnStatus_en LVCS_Control(LVCS_Handle_t      hInstance,
 
         pInstance->VolCorrect = pLVCS_VolCorrectTable[Offset];
 
-        pInstance->CompressGain = pInstance->VolCorrect.CompMin;
+        if (KeepState == LVM_FALSE)
+        {
+            pInstance->CompressGain = pInstance->VolCorrect.CompMin;
 #ifdef BUILD_FLOAT
-        LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[0], 0, 0);
+            LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[0], 0, 0);
 #else
-        LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[0],0,0);
+            LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[0],0,0);
 #endif
+        }
         {
 #ifndef BUILD_FLOAT
             LVM_UINT32          Gain;
@@ -138,7 +260,10 @@ LVCS_ReturnStatus_en LVCS_Control(LVCS_Handle_t      hInstance,
              */
             Gain = (Gain * pInstance->VolCorrect.GainMin) >>12;
 
-            LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[1],0,Gain);
+            if (KeepState == LVM_FALSE)
+            {
+                LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[1],0,Gain);
+            }
             LVC_Mixer_VarSlope_SetTimeConstant(&pInstance->BypassMix.Mixer_Instance.MixerStream[0],
                     LVCS_BYPASS_MIXER_TC,pParams->SampleRate,2);
             LVC_Mixer_VarSlope_SetTimeConstant(&pInstance->BypassMix.Mixer_Instance.MixerStream[1],
@@ -154,7 +279,10 @@ LVCS_ReturnStatus_en LVCS_Control(LVCS_Handle_t      hInstance,
              */
             Gain = (Gain * pInstance->VolCorrect.GainMin);
 
-            LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[1], 0, Gain);
+            if (KeepState == LVM_FALSE)
+            {
+                LVC_Mixer_Init(&pInstance->BypassMix.Mixer_Instance.MixerStream[1], 0, Gain);
+            }
             LVC_Mixer_VarSlope_SetTimeConstant(&pInstance->BypassMix.Mixer_Instance.MixerStream[0],
                     LVCS_BYPASS_MIXER_TC, pParams->SampleRate, 2);
             LVC_Mixer_VarSlope_SetTimeConstant(&pInstance->BypassMix.Mixer_Instance.MixerStream[1],
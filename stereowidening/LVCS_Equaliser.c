@@ -39,6 +39,7 @@
 /*  history. It is also used for re-initialisation when one of the system control   */
 /*  parameters changes but will only change the coefficients and clear the history  */
 /*  if the sample rate or speaker type has changed.                                 */
+/*  The history is kept when the sample rate changes between two banked rates.      */
 /*                                                                                  */
 /*  To avoid excessive testing during the sample processing the biquad type is      */
 /*  set as a callback function in the init routine.                                 */
@@ -77,6 +78,11 @@ LVCS_ReturnStatus_en LVCS_EqualiserInit(LVCS_Handle_t       hInstance,
     if ((pInstance->Params.SampleRate != pParams->SampleRate) ||
         (pInstance->Params.SpeakerType != pParams->SpeakerType))
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!((pInstance->Params.SpeakerType == pParams->SpeakerType) &&
+                                                     (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                       pInstance->Params.SampleRate,
+                                                                       pParams->SampleRate) == LVM_TRUE));
+
         /*
          * Setup the filter coefficients and clear the history
          */
@@ -91,11 +97,14 @@ LVCS_ReturnStatus_en LVCS_EqualiserInit(LVCS_Handle_t       hInstance,
         Coeffs.B1 = (LVM_FLOAT)-pEqualiserCoefTable[Offset].B1;
         Coeffs.B2 = (LVM_FLOAT)-pEqualiserCoefTable[Offset].B2;
 
-        LoadConst_Float((LVM_INT16)0,                                         /* Value */
-                        (void *)&pData->EqualiserBiquadTaps,   /* Destination Cast to void:\
-                                                                  no dereferencing in function*/
-                        /* Number of words */
-                        (LVM_UINT16)(sizeof(pData->EqualiserBiquadTaps) / sizeof(LVM_FLOAT)));
+        if (ClearTaps)
+        {
+            LoadConst_Float((LVM_INT16)0,                                         /* Value */
+                            (void *)&pData->EqualiserBiquadTaps,   /* Destination Cast to void:\
+                                                                      no dereferencing in function*/
+                            /* Number of words */
+                            (LVM_UINT16)(sizeof(pData->EqualiserBiquadTaps) / sizeof(LVM_FLOAT)));
+        }
 
         BQ_2I_D16F32Css_TRC_WRA_01_Init(&pCoefficients->EqualiserBiquadInstance,
                                         &pData->EqualiserBiquadTaps,
@@ -137,6 +146,11 @@ LVCS_ReturnStatus_en LVCS_EqualiserInit(LVCS_Handle_t       hInstance,
     if ((pInstance->Params.SampleRate != pParams->SampleRate) ||
         (pInstance->Params.SpeakerType != pParams->SpeakerType))
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!((pInstance->Params.SpeakerType == pParams->SpeakerType) &&
+                                                     (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                       pInstance->Params.SampleRate,
+                                                                       pParams->SampleRate) == LVM_TRUE));
+
         /*
          * Setup the filter coefficients and clear the history
          */
@@ -151,10 +165,13 @@ LVCS_ReturnStatus_en LVCS_EqualiserInit(LVCS_Handle_t       hInstance,
         Coeffs.B1 = (LVM_INT16)-pEqualiserCoefTable[Offset].B1;
         Coeffs.B2 = (LVM_INT16)-pEqualiserCoefTable[Offset].B2;
 
-        LoadConst_16((LVM_INT16)0,                                                       /* Value */
-                     (void *)&pData->EqualiserBiquadTaps,   /* Destination Cast to void:\
-                                                               no dereferencing in function*/
-                     (LVM_UINT16)(sizeof(pData->EqualiserBiquadTaps)/sizeof(LVM_INT16)));    /* Number of words */
+        if (ClearTaps)
+        {
+            LoadConst_16((LVM_INT16)0,                                                       /* Value */
+                         (void *)&pData->EqualiserBiquadTaps,   /* Destination Cast to void:\
+                                                                   no dereferencing in function*/
+                         (LVM_UINT16)(sizeof(pData->EqualiserBiquadTaps)/sizeof(LVM_INT16)));    /* Number of words */
+        }
 
         BQ_2I_D16F32Css_TRC_WRA_01_Init(&pCoefficients->EqualiserBiquadInstance,
                                         &pData->EqualiserBiquadTaps,
@@ -42,7 +42,8 @@
 /*  re-initialised if one of the following two conditions is met:                   */
 /*      -   the sample rate has changed                                             */
 /*      -   the speaker type changes to/from the mobile speaker                     */
-/*                                                                                  */
+/*  The delay line and filter history are kept when the sample rate changes between */
+/*  two banked rates.                                                               */
 /*                                                                                  */
 /* PARAMETERS:                                                                      */
 /*  hInstance               Instance Handle                                         */
@@ -86,6 +87,10 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
     if(pInstance->Params.SampleRate != pParams->SampleRate )      /* Sample rate change test */
 
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                 pInstance->Params.SampleRate,
+                                                                 pParams->SampleRate);
+
         /*
          * Setup the delay
          */
@@ -93,11 +98,18 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
 
 
         pConfig->DelaySize      = (LVM_INT16)(2 * Delay);
-        pConfig->DelayOffset    = 0;
-        LoadConst_Float(0,                                            /* Value */
-                        (LVM_FLOAT *)&pConfig->StereoSamples[0],      /* Destination */
-                        /* Number of words */
-                        (LVM_UINT16)(sizeof(pConfig->StereoSamples) / sizeof(LVM_FLOAT)));
+        if (ClearTaps)
+        {
+            pConfig->DelayOffset    = 0;
+            LoadConst_Float(0,                                            /* Value */
+                            (LVM_FLOAT *)&pConfig->StereoSamples[0],      /* Destination */
+                            /* Number of words */
+                            (LVM_UINT16)(sizeof(pConfig->StereoSamples) / sizeof(LVM_FLOAT)));
+        }
+        else if (pConfig->DelayOffset >= pConfig->DelaySize)
+        {
+            pConfig->DelayOffset    = 0;                    /* Keep the offset inside the new delay */
+        }
         /*
          * Setup the filters
          */
@@ -111,11 +123,14 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
         Coeffs.B1 = (LVM_FLOAT)-pReverbCoefTable[Offset].B1;
         Coeffs.B2 = (LVM_FLOAT)-pReverbCoefTable[Offset].B2;
 
-        LoadConst_Float(0,                                 /* Value */
-                        (void *)&pData->ReverbBiquadTaps,  /* Destination Cast to void:
-                                                             no dereferencing in function*/
-                        /* Number of words */
-                        (LVM_UINT16)(sizeof(pData->ReverbBiquadTaps) / sizeof(LVM_FLOAT)));
+        if (ClearTaps)
+        {
+            LoadConst_Float(0,                                 /* Value */
+                            (void *)&pData->ReverbBiquadTaps,  /* Destination Cast to void:
+                                                                 no dereferencing in function*/
+                            /* Number of words */
+                            (LVM_UINT16)(sizeof(pData->ReverbBiquadTaps) / sizeof(LVM_FLOAT)));
+        }
 
         BQ_2I_D16F16Css_TRC_WRA_01_Init(&pCoefficients->ReverbBiquadInstance,
                                         &pData->ReverbBiquadTaps,
@@ -173,6 +188,10 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
     if(pInstance->Params.SampleRate != pParams->SampleRate )      /* Sample rate change test */
 
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                 pInstance->Params.SampleRate,
+                                                                 pParams->SampleRate);
+
         /*
          * Setup the delay
          */
@@ -180,10 +199,17 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
 
 
         pConfig->DelaySize      = (LVM_INT16)(2 * Delay);
-        pConfig->DelayOffset    = 0;
-        LoadConst_16(0,                                                                 /* Value */
-                     (LVM_INT16 *)&pConfig->StereoSamples[0],                           /* Destination */
-                     (LVM_UINT16)(sizeof(pConfig->StereoSamples)/sizeof(LVM_INT16)));   /* Number of words */
+        if (ClearTaps)
+        {
+            pConfig->DelayOffset    = 0;
+            LoadConst_16(0,                                                                 /* Value */
+                         (LVM_INT16 *)&pConfig->StereoSamples[0],                           /* Destination */
+                         (LVM_UINT16)(sizeof(pConfig->StereoSamples)/sizeof(LVM_INT16)));   /* Number of words */
+        }
+        else if (pConfig->DelayOffset >= pConfig->DelaySize)
+        {
+            pConfig->DelayOffset    = 0;                    /* Keep the offset inside the new delay */
+        }
 
         /*
          * Setup the filters
@@ -198,9 +224,12 @@ LVCS_ReturnStatus_en LVCS_ReverbGeneratorInit(LVCS_Handle_t     hInstance,
         Coeffs.B1 = (LVM_INT16)-pReverbCoefTable[Offset].B1;
         Coeffs.B2 = (LVM_INT16)-pReverbCoefTable[Offset].B2;
 
-        LoadConst_16(0,                                                                 /* Value */
-                     (void *)&pData->ReverbBiquadTaps,                             /* Destination Cast to void: no dereferencing in function*/
-                     (LVM_UINT16)(sizeof(pData->ReverbBiquadTaps)/sizeof(LVM_INT16)));  /* Number of words */
+        if (ClearTaps)
+        {
+            LoadConst_16(0,                                                                 /* Value */
+                         (void *)&pData->ReverbBiquadTaps,                             /* Destination Cast to void: no dereferencing in function*/
+                         (LVM_UINT16)(sizeof(pData->ReverbBiquadTaps)/sizeof(LVM_INT16)));  /* Number of words */
+        }
 
         BQ_2I_D16F16Css_TRC_WRA_01_Init(&pCoefficients->ReverbBiquadInstance,
                                         &pData->ReverbBiquadTaps,
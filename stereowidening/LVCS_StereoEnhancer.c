@@ -38,6 +38,7 @@
 /*  history. It is also used for re-initialisation when one of the system control   */
 /*  parameters changes but will only change the coefficients and clear the history  */
 /*  if the sample rate or speaker type has changed.                                 */
+/*  The history is kept when the sample rate changes between two banked rates.      */
 /*                                                                                  */
 /* PARAMETERS:                                                                      */
 /*  hInstance               Instance Handle                                         */
@@ -76,6 +77,11 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
     if ((pInstance->Params.SampleRate != pParams->SampleRate) ||
         (pInstance->Params.SpeakerType != pParams->SpeakerType))
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!((pInstance->Params.SpeakerType == pParams->SpeakerType) &&
+                                                     (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                       pInstance->Params.SampleRate,
+                                                                       pParams->SampleRate) == LVM_TRUE));
+
         /*
          * Set the filter coefficients based on the sample rate
          */
@@ -88,11 +94,14 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
         CoeffsMid.B1 = (LVM_FLOAT)-LVCS_SEMidCoefTable[Offset].B1;
 
         /* Clear the taps */
-        LoadConst_Float(0,                                  /* Value */
-                        (void *)&pData->SEBiquadTapsMid,    /* Destination Cast to void:\
-                                                              no dereferencing in function*/
-                        /* Number of words */
-                        (LVM_UINT16)(sizeof(pData->SEBiquadTapsMid) / sizeof(LVM_FLOAT)));
+        if (ClearTaps)
+        {
+            LoadConst_Float(0,                                  /* Value */
+                            (void *)&pData->SEBiquadTapsMid,    /* Destination Cast to void:\
+                                                                  no dereferencing in function*/
+                            /* Number of words */
+                            (LVM_UINT16)(sizeof(pData->SEBiquadTapsMid) / sizeof(LVM_FLOAT)));
+        }
 
         FO_1I_D16F16Css_TRC_WRA_01_Init(&pCoefficient->SEBiquadInstanceMid,
                                         &pData->SEBiquadTapsMid,
@@ -116,11 +125,14 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
         CoeffsSide.B2 = (LVM_FLOAT)-pSESideCoefs[Offset].B2;
 
         /* Clear the taps */
-        LoadConst_Float(0,                                /* Value */
-                        (void *)&pData->SEBiquadTapsSide, /* Destination Cast to void:\
-                                                             no dereferencing in function*/
-                        /* Number of words */
-                        (LVM_UINT16)(sizeof(pData->SEBiquadTapsSide) / sizeof(LVM_FLOAT)));
+        if (ClearTaps)
+        {
+            LoadConst_Float(0,                                /* Value */
+                            (void *)&pData->SEBiquadTapsSide, /* Destination Cast to void:\
+                                                                 no dereferencing in function*/
+                            /* Number of words */
+                            (LVM_UINT16)(sizeof(pData->SEBiquadTapsSide) / sizeof(LVM_FLOAT)));
+        }
         /* Callbacks */
         switch(pSESideCoefs[Offset].Scale)
         {
@@ -165,6 +177,11 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
     if ((pInstance->Params.SampleRate != pParams->SampleRate) ||
         (pInstance->Params.SpeakerType != pParams->SpeakerType))
     {
+        LVM_INT16           ClearTaps = (LVM_INT16)!((pInstance->Params.SpeakerType == pParams->SpeakerType) &&
+                                                     (LVM_FsBankSwitch(pInstance->Capabilities.CoefBankRates,
+                                                                       pInstance->Params.SampleRate,
+                                                                       pParams->SampleRate) == LVM_TRUE));
+
         /*
          * Set the filter coefficients based on the sample rate
          */
@@ -177,10 +194,13 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
         CoeffsMid.B1 = (LVM_INT16)-LVCS_SEMidCoefTable[Offset].B1;
 
         /* Clear the taps */
-        LoadConst_16(0,                                                                 /* Value */
-                     (void *)&pData->SEBiquadTapsMid,              /* Destination Cast to void:\
-                                                                      no dereferencing in function*/
-                     (LVM_UINT16)(sizeof(pData->SEBiquadTapsMid)/sizeof(LVM_UINT16)));  /* Number of words */
+        if (ClearTaps)
+        {
+            LoadConst_16(0,                                                                 /* Value */
+                         (void *)&pData->SEBiquadTapsMid,              /* Destination Cast to void:\
+                                                                          no dereferencing in function*/
+                         (LVM_UINT16)(sizeof(pData->SEBiquadTapsMid)/sizeof(LVM_UINT16)));  /* Number of words */
+        }
 
         FO_1I_D16F16Css_TRC_WRA_01_Init(&pCoefficient->SEBiquadInstanceMid,
                                         &pData->SEBiquadTapsMid,
@@ -204,10 +224,13 @@ LVCS_ReturnStatus_en LVCS_SEnhancerInit(LVCS_Handle_t       hInstance,
         CoeffsSide.B2 = (LVM_INT16)-pSESideCoefs[Offset].B2;
 
         /* Clear the taps */
-        LoadConst_16(0,                                                                 /* Value */
-                     (void *)&pData->SEBiquadTapsSide,             /* Destination Cast to void:\
-                                                                      no dereferencing in function*/
-                     (LVM_UINT16)(sizeof(pData->SEBiquadTapsSide)/sizeof(LVM_UINT16))); /* Number of words */
+        if (ClearTaps)
+        {
+            LoadConst_16(0,                                                                 /* Value */
+                         (void *)&pData->SEBiquadTapsSide,             /* Destination Cast to void:\
+                                                                          no dereferencing in function*/
+                         (LVM_UINT16)(sizeof(pData->SEBiquadTapsSide)/sizeof(LVM_UINT16))); /* Number of words */
+        }
 
 
         /* Callbacks */
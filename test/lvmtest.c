@@ -1,16 +1,48 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "channels.h"
 #include "primitives.h"
 #include "LVM_Private.h"
+#include "VectorArithmetic.h"
 #include "audio_effect.h"
 #include "lvmtest.h"
 
+/* Sample formats of the input and output files */
+typedef enum
+{
+    LVM_FILE_I16,
+    LVM_FILE_P24,
+    LVM_FILE_I32,
+    LVM_FILE_F32
+} lvmFileFormat_en;
+
+typedef struct{
+    int               wav;            // WAV or RF64 container, else headerless
+    lvmFileFormat_en  format;
+    int               samplingFreq;
+    int               channels;
+    uint64_t          dataOffset;     // File offset of the samples
+    uint64_t          dataSize;       // Size of the samples in bytes
+}lvmFileInfo_t;
+
+/* Module memory allocated on demand, counted for the footprint report */
+typedef struct{
+    LVM_UINT32        Allocated;
+}lvmModuleMemory_t;
+
 typedef struct{
     int               samplingFreq;   
     int               nrChannels;      
@@ -21,10 +53,30 @@ typedef struct{
     int               bassEffectLevel; 
     int               eqPresetLevel;  
     int               frameLength;    
+    int               benchCreate;
+    int               lazyMem;
+    int               coefBank;
+    int               fsSwitch;
+    int               denormalStats;
+    int               dither;
+    int               planar;
+    int               pcm;
+    int               accumulate;
+    int               mmapBlock;
+    int               psa;
+    int               psaReaders;
+    lvmFileInfo_t     inFile;
+    lvmFileInfo_t     outFile;
     LVM_BE_Mode_en    bassEnable;     
+    LVM_BE_FilterSelect_en bassHpf;
     LVM_TE_Mode_en    trebleEnable;    
+    int               trebleEffectLevel;
     LVM_EQNB_Mode_en  eqEnable;       
     LVM_Mode_en       csEnable;       
+    int               eqNumBands;     // 5 or the 31 band graphic equaliser
+    LVM_InstParamsEx_t instParamsEx;  // Optional features of the instance
+    lvmModuleMemory_t moduleMemory;   // Module memory of -lazyMem
+    dither_state_t    ditherState;    // Dither of the 16 bit output
 }lvmConfigParams_t; 
 
 const audio_channel_mask_t lvmConfigChMask[] = {
@@ -61,6 +113,11 @@ void printUsage()
     printf("\nwhere, \n     <inputfile>  is the input file name");
     printf("\n                  on which LVM effects are applied");
     printf("\n     <outputfile> processed output file");
+    printf("\n     A WAV or RF64 input file sets the sampling rate, the number of file");
+    printf("\n     channels and the sample format (16, 24 or 32 bit integer, or 32 bit");
+    printf("\n     float), otherwise the input is 16 bit without a header. The output is");
+    printf("\n     written in the input sample format, as WAV (or RF64 above 4 GB) when");
+    printf("\n     the output file name ends with .wav");
     printf("\n     and options are mentioned below");
     printf("\n");
     printf("\n     -help (or) -h");
@@ -69,7 +126,7 @@ void printUsage()
     printf("\n     -chMask:<channel_mask>\n");
     printf("\n         0  - AUDIO_CHANNEL_OUT_MONO");
     printf("\n         1  - AUDIO_CHANNEL_OUT_STEREO");
-    printf("\n         default 0");
+    printf("\n         default 1");
     printf("\n     -vcBal:<Left Right Balance control in dB [-96 to 96 dB]>");
     printf("\n            -ve values reduce Right channel while +ve value reduces Left channel");
     printf("\n                 default 0");
@@ -86,14 +143,177 @@ void printUsage()
     printf("\n     -bE ");
     printf("\n           Enable Dynamic Bass Enhancement");
     printf("\n");
+    printf("\n     -bHPF:<0|1>");
+    printf("\n           Dynamic Bass Enhancement high pass filter off or on, default 1");
+    printf("\n");
     printf("\n     -tE ");
     printf("\n           Enable Treble Boost");
     printf("\n");
+    printf("\n     -treblelvl:<effect_level>");
+    printf("\n           Treble Boost gain in dB, %d - %d default 0 (no boost)",
+           LVM_TE_MIN_EFFECTLEVEL, LVM_TE_MAX_EFFECTLEVEL);
+    printf("\n");
     printf("\n     -csE ");
     printf("\n           Enable Concert Surround");
     printf("\n");
     printf("\n     -eqE ");
-    printf("\n           Enable Equalizer\n");
+    printf("\n           Enable Equalizer");
+    printf("\n");
+    printf("\n     -lazyMem");
+    printf("\n           Allocate the module memory when a module is first enabled and");
+    printf("\n           report the memory footprint of the enabled effects");
+    printf("\n");
+    printf("\n     -shareCoefs");
+    printf("\n           Clones share the equaliser coefficients of their template until");
+    printf("\n           their equaliser settings change, needs -lazyMem");
+    printf("\n");
+    printf("\n     -coefBank");
+    printf("\n           Precompute the coefficients for the input sampling rate and the");
+    printf("\n           -fsSwitch rate, switches between them keep the filter history");
+    printf("\n");
+    printf("\n     -fsSwitch:<sampling_rate>");
+    printf("\n           Switch the control sampling rate between the input rate and");
+    printf("\n           <sampling_rate> every second of audio and report the average");
+    printf("\n           time of a switch");
+    printf("\n");
+    printf("\n     -denormal:<mode>");
+    printf("\n           Denormal protection of LVM_Process");
+    printf("\n           0 - None (Default)");
+    printf("\n           1 - Flush denormals to zero");
+    printf("\n           2 - Inaudible offset");
+    printf("\n");
+    printf("\n     -denormalStats");
+    printf("\n           Count the denormal output samples and report them with the");
+    printf("\n           total processing time");
+    printf("\n");
+    printf("\n     -silence");
+    printf("\n           Skip the processing of silent input once the effect tails have");
+    printf("\n           decayed");
+    printf("\n");
+    printf("\n     -eqBands:<5|31>");
+    printf("\n           Equaliser bands, 31 for the third octave graphic equaliser with the");
+    printf("\n           preset gains interpolated from the 5 bands, default 5");
+    printf("\n");
+    printf("\n     -eqParallel");
+    printf("\n           Run the equaliser bands as parallel sections");
+    printf("\n");
+    printf("\n     -filterMerge");
+    printf("\n           Run the equaliser bands and the treble boost as one cascade");
+    printf("\n           of second order sections");
+    printf("\n");
+    printf("\n     -dither");
+    printf("\n           Convert the processed output to 16 bit with triangular dither");
+    printf("\n");
+    printf("\n     -simd:<level>");
+    printf("\n           Highest instruction set of the sample format conversions");
+    printf("\n           0 - Portable C");
+    printf("\n           1 - SSE2");
+    printf("\n           2 - AVX2 (Default, when supported)");
+    printf("\n");
+    printf("\n     -planar:<mode>");
+    printf("\n           Process channel planes and report the process time");
+    printf("\n           0 - Interleaved LVM_Process (Default)");
+    printf("\n           1 - Interleave, LVM_Process and deinterleave in the test");
+    printf("\n           2 - LVM_ProcessPlanar");
+    printf("\n");
+    printf("\n     -pcm");
+    printf("\n           Process the 16 bit samples with LVM_ProcessPcm and report the");
+    printf("\n           process time and the saturated samples");
+    printf("\n");
+    printf("\n     -accumulate:<mode>");
+    printf("\n           Mix the processed output into the input and report the process");
+    printf("\n           time");
+    printf("\n           0 - Write the output (Default)");
+    printf("\n           1 - LVM_Process followed by accumulate_float");
+    printf("\n           2 - Accumulate output mode of LVM_Process");
+    printf("\n");
+    printf("\n     -psa:<mode>");
+    printf("\n           Run the spectrum analyser and report the process time");
+    printf("\n           1 - In LVM_Process");
+    printf("\n           2 - Deferred, LVM_Process only fills the ring and an analysis");
+    printf("\n               thread runs LVM_ProcessSpectrum and LVM_GetSpectrum");
+    printf("\n");
+    printf("\n     -psaDecimate");
+    printf("\n           Filter the low spectrum analyser bands at decimated rates");
+    printf("\n");
+    printf("\n     -psaFFT:<bands>");
+    printf("\n           Analyse the spectrum in <bands> logarithmic bands (1 to 512) of a");
+    printf("\n           windowed FFT instead of the 9 band pass filters");
+    printf("\n");
+    printf("\n     -psaReaders:<count>");
+    printf("\n           With -psa, read the spectrum snapshots from <count> threads (1 to 64)");
+    printf("\n           every millisecond and report the snapshots read");
+    printf("\n");
+    printf("\n     -mmap[:<frames>]");
+    printf("\n           Render by mapping the input and output files, converting blocks of");
+    printf("\n           <frames> frames (Default 65536) directly between the mappings, and");
+    printf("\n           report the throughput and the real time factor");
+    printf("\n");
+    printf("\n     -batch:<manifest>");
+    printf("\n           Render the jobs of <manifest> instead of -i and -o, one job per line:");
+    printf("\n           <input_file> <output_file> [effect options]");
+    printf("\n           The effect options (-fs, -fch, -M, -vcBal, -basslvl, -eqPreset, -bE,");
+    printf("\n           -eqE, -tE, -csE) of a job add to those of the command line. Empty lines");
+    printf("\n           and lines starting with # are skipped");
+    printf("\n");
+    printf("\n     -threads:<count>");
+    printf("\n           Number of worker threads of -batch (Default: one per processor)");
+    printf("\n");
+    printf("\n     -benchConvert");
+    printf("\n           Report the throughput of the sample format conversions at each");
+    printf("\n           supported instruction set, no input or output file is needed");
+    printf("\n");
+    printf("\n     -benchPsa[:<bands>]");
+    printf("\n           Compare the time and the levels of the full rate and the decimated");
+    printf("\n           spectrum analyser of <bands> bands (Default 9) at every sampling");
+    printf("\n           rate, no input or output file is needed");
+    printf("\n");
+    printf("\n     -benchPsaFFT[:<bands>]");
+    printf("\n           Report the time of the FFT spectrum analyser of <bands> bands");
+    printf("\n           (Default 128) at every sampling rate and the band a 1 kHz tone");
+    printf("\n           peaks in, no input or output file is needed");
+    printf("\n");
+    printf("\n     -benchEq");
+    printf("\n           Compare the time and the output of the cascade and the parallel");
+    printf("\n           equaliser of 5, 10 and 31 bands at several sampling rates, no");
+    printf("\n           input or output file is needed");
+    printf("\n");
+    printf("\n     -benchEqBands");
+    printf("\n           Time the equaliser at 48 kHz against the number of bands, processing");
+    printf("\n           and control calls changing one band or all the bands, for both engines");
+    printf("\n");
+    printf("\n     -benchCreate:<count>");
+    printf("\n           Time <count> session creations with LVM_GetInstanceHandle and with");
+    printf("\n           LVM_CloneInstance, and check that a clone processes as a created session\n");
+}
+
+
+typedef union{
+    LVM_UINT32        Size;
+    max_align_t       Align;
+}lvmModuleBlock_t;
+
+/* Maximum number of spectrum snapshot reader threads */
+#define LVM_PSA_MAX_READERS 64
+
+void *lvmModuleAlloc(void *pAllocHandle, LVM_UINT32 size) 
+{
+    lvmModuleMemory_t *pModuleMemory = (lvmModuleMemory_t *)pAllocHandle;
+    lvmModuleBlock_t *pBlock = (lvmModuleBlock_t *)malloc(sizeof(lvmModuleBlock_t) + size);
+
+    if (pBlock == NULL) return NULL;
+    pBlock->Size = size;
+    pModuleMemory->Allocated += size;
+    return pBlock + 1;
+}
+
+void lvmModuleFree(void *pAllocHandle, void *pMemory) 
+{
+    lvmModuleMemory_t *pModuleMemory = (lvmModuleMemory_t *)pAllocHandle;
+    lvmModuleBlock_t *pBlock = (lvmModuleBlock_t *)pMemory - 1;
+
+    pModuleMemory->Allocated -= pBlock->Size;
+    free(pBlock);
 }
 
 
@@ -102,6 +322,9 @@ void LvmEffect_free(EffectContext *pContext)
     LVM_ReturnStatus_en LvmStatus = LVM_SUCCESS; /* Function call status */
     LVM_MemTab_t MemTab;
 
+    /* Free the module memory allocated on demand */
+    LvmStatus = LVM_FreeModuleMemory(pContext->pBundledContext->hInstance);
+
     /* Free the algorithm memory */
     LvmStatus = LVM_GetMemoryTable(pContext->pBundledContext->hInstance, &MemTab, LVM_NULL);
 
@@ -133,7 +356,48 @@ void LvmEffect_free(EffectContext *pContext)
 } 
 
 
-int LvmBundle_init(EffectContext *pContext, LVM_ControlParams_t *params) 
+/* Sets the bands of a preset, the gains of the 31 bands follow the 5 band gains linearly in
+ * octaves and are held below the first and above the last of the 5 bands */
+void lvmSetEqBands(LVM_EQNB_BandDef_t *pBandDefs, int numBands, int preset)
+{
+    const LVM_INT16 *pGains = &EQNB_5BandNormalPresets[FIVEBAND_NUMBANDS * preset];
+
+    if (numBands == FIVEBAND_NUMBANDS) 
+    {
+        for (int i = 0; i < FIVEBAND_NUMBANDS; i++) 
+        {
+            pBandDefs[i].Frequency = EQNB_5BandPresetsFrequencies[i];
+            pBandDefs[i].QFactor = EQNB_5BandPresetsQFactors[i];
+            pBandDefs[i].Gain = pGains[i];
+        }
+        return;
+    }
+
+    for (int i = 0; i < numBands; i++) 
+    {
+        const LVM_UINT16 frequency = EQNB_31BandPresetsFrequencies[i];
+        double gain = pGains[0];
+        int j = 0;
+
+        while (j < FIVEBAND_NUMBANDS - 1 && frequency > EQNB_5BandPresetsFrequencies[j + 1]) j++;
+        if (j == FIVEBAND_NUMBANDS - 1) 
+        {
+            gain = pGains[j];
+        }
+        else if (frequency > EQNB_5BandPresetsFrequencies[j]) 
+        {
+            const double x = log2((double)frequency / EQNB_5BandPresetsFrequencies[j]) /
+                             log2((double)EQNB_5BandPresetsFrequencies[j + 1] /
+                                  EQNB_5BandPresetsFrequencies[j]);
+            gain = pGains[j] + x * (pGains[j + 1] - pGains[j]);
+        }
+        pBandDefs[i].Frequency = frequency;
+        pBandDefs[i].QFactor = EQNB_31BandPresetsQFactor;
+        pBandDefs[i].Gain = (LVM_INT16)lround(gain);
+    }
+}
+
+int LvmBundle_init(EffectContext *pContext, lvmConfigParams_t *plvmConfigParams, LVM_ControlParams_t *params) 
 {
     // printf("\tLvmBundle_init start\n");
     pContext->config.inputCfg.accessMode = EFFECT_BUFFER_ACCESS_READ;
@@ -158,6 +422,7 @@ int LvmBundle_init(EffectContext *pContext, LVM_ControlParams_t *params)
 
     LVM_ReturnStatus_en LvmStatus = LVM_SUCCESS; /* Function call status */
     LVM_InstParams_t InstParams;                 /* Instance parameters */
+    LVM_InstParamsEx_t InstParamsEx;             /* Extended instance parameters */
     LVM_EQNB_BandDef_t BandDefs[MAX_NUM_BANDS];  /* Equaliser band definitions */
     LVM_HeadroomParams_t HeadroomParams;         /* Headroom parameters */
     LVM_HeadroomBandDef_t HeadroomBandDef[LVM_HEADROOM_MAX_NBANDS];
@@ -170,8 +435,17 @@ int LvmBundle_init(EffectContext *pContext, LVM_ControlParams_t *params)
     InstParams.EQNB_NumBands = MAX_NUM_BANDS;
     InstParams.PSA_Included = LVM_PSA_ON;
 
+    /* Set the optional features of the options */
+    InstParamsEx = plvmConfigParams->instParamsEx;
+    if (plvmConfigParams->lazyMem) 
+    {
+        InstParamsEx.ModuleAllocator.pAlloc = lvmModuleAlloc;
+        InstParamsEx.ModuleAllocator.pFree = lvmModuleFree;
+        InstParamsEx.ModuleAllocator.pAllocHandle = &plvmConfigParams->moduleMemory;
+    }
+
     /* Allocate memory, forcing alignment */
-    LvmStatus = LVM_GetMemoryTable(LVM_NULL, &MemTab, &InstParams);
+    LvmStatus = LVM_GetMemoryTableEx(LVM_NULL, &MemTab, &InstParams, &InstParamsEx);
     if (LvmStatus != LVM_SUCCESS) return -EINVAL;
 
     /* Allocate memory */
@@ -218,7 +492,7 @@ int LvmBundle_init(EffectContext *pContext, LVM_ControlParams_t *params)
     pContext->pBundledContext->hInstance = LVM_NULL;
 
     /* Init sets the instance handle */
-    LvmStatus = LVM_GetInstanceHandle(&pContext->pBundledContext->hInstance, &MemTab, &InstParams);
+    LvmStatus = LVM_GetInstanceHandleEx(&pContext->pBundledContext->hInstance, &MemTab, &InstParams, &InstParamsEx);
     if (LvmStatus != LVM_SUCCESS) return -EINVAL;
 
     /* Set the initial process parameters */
@@ -238,14 +512,9 @@ int LvmBundle_init(EffectContext *pContext, LVM_ControlParams_t *params)
 
     /* N-Band Equaliser parameters */
     params->EQNB_OperatingMode = LVM_EQNB_OFF;
-    params->EQNB_NBands = FIVEBAND_NUMBANDS;
+    params->EQNB_NBands = plvmConfigParams->eqNumBands;
     params->pEQNB_BandDefinition = &BandDefs[0];
-    for (int i = 0; i < FIVEBAND_NUMBANDS; i++) 
-    {
-        BandDefs[i].Frequency = EQNB_5BandPresetsFrequencies[i];
-        BandDefs[i].QFactor = EQNB_5BandPresetsQFactors[i];
-        BandDefs[i].Gain = EQNB_5BandNormalPresets[i];
-    }
+    lvmSetEqBands(BandDefs, plvmConfigParams->eqNumBands, 0);
 
     /* Volume Control parameters */
     params->VC_EffectLevel = 0;
@@ -346,7 +615,7 @@ int lvmCreate(EffectContext *pContext,
     }
     pContext->config.inputCfg.channels = plvmConfigParams->nrChannels;
     // printf("\tEffectCreate - Calling LvmBundle_init");
-    ret = LvmBundle_init(pContext, params);
+    ret = LvmBundle_init(pContext, plvmConfigParams, params);
     if (ret < 0) 
     {
     // printf("\tLVM_ERROR : lvmCreate() Bundle init failed");
@@ -355,37 +624,10 @@ int lvmCreate(EffectContext *pContext,
     return 0;
 }
 
-int lvmControl(EffectContext *pContext,
-               lvmConfigParams_t    *plvmConfigParams,
-               LVM_ControlParams_t  *params) 
+LVM_Fs_en lvmSampleRate(int samplingFreq) 
 {
-    LVM_ReturnStatus_en LvmStatus = LVM_SUCCESS; /* Function call status */
-
-    /* Set the initial process parameters */
-    /* General parameters */
-    params->OperatingMode = LVM_MODE_ON;
-    params->SpeakerType = LVM_HEADPHONES;
-
-    params->ChMask     = plvmConfigParams->chMask;
-    params->NrChannels = plvmConfigParams->nrChannels;
-    if (params->NrChannels == 1) 
-    {
-    params->SourceFormat = LVM_MONO;
-    } 
-    else if (params->NrChannels == 2) 
-    {
-    params->SourceFormat = LVM_STEREO;
-    } 
-    else if (params->NrChannels > 2 && params->NrChannels <= 8) 
-    { // FCC_2 FCC_8
-    params->SourceFormat = LVM_MULTICHANNEL;
-    } 
-    else {
-        return -EINVAL;
-    }
-
     LVM_Fs_en sampleRate;
-    switch (plvmConfigParams->samplingFreq) 
+    switch (samplingFreq) 
     {
         case 8000:
             sampleRate = LVM_FS_8000;
@@ -427,8 +669,43 @@ int lvmControl(EffectContext *pContext,
             sampleRate = LVM_FS_192000;
             break;
         default:
-            return -EINVAL;
+            sampleRate = LVM_FS_INVALID;
+            break;
+    }
+    return sampleRate;
+}
+
+int lvmControl(EffectContext *pContext,
+               lvmConfigParams_t    *plvmConfigParams,
+               LVM_ControlParams_t  *params) 
+{
+    LVM_ReturnStatus_en LvmStatus = LVM_SUCCESS; /* Function call status */
+
+    /* Set the initial process parameters */
+    /* General parameters */
+    params->OperatingMode = LVM_MODE_ON;
+    params->SpeakerType = LVM_HEADPHONES;
+
+    params->ChMask     = plvmConfigParams->chMask;
+    params->NrChannels = plvmConfigParams->nrChannels;
+    if (params->NrChannels == 1) 
+    {
+    params->SourceFormat = LVM_MONO;
+    } 
+    else if (params->NrChannels == 2) 
+    {
+    params->SourceFormat = LVM_STEREO;
+    } 
+    else if (params->NrChannels > 2 && params->NrChannels <= 8) 
+    { // FCC_2 FCC_8
+    params->SourceFormat = LVM_MULTICHANNEL;
+    } 
+    else {
+        return -EINVAL;
     }
+
+    LVM_Fs_en sampleRate = lvmSampleRate(plvmConfigParams->samplingFreq);
+    if (sampleRate == LVM_FS_INVALID) return -EINVAL;
     params->SampleRate = sampleRate;
 
     /* Concert Sound parameters */
@@ -440,12 +717,8 @@ int lvmControl(EffectContext *pContext,
     /* N-Band Equaliser parameters */
     const int eqPresetLevel = plvmConfigParams->eqPresetLevel;
     LVM_EQNB_BandDef_t BandDefs[MAX_NUM_BANDS];  /* Equaliser band definitions */
-    for (int i = 0; i < FIVEBAND_NUMBANDS; i++) 
-    {
-    BandDefs[i].Frequency = EQNB_5BandPresetsFrequencies[i];
-    BandDefs[i].QFactor = EQNB_5BandPresetsQFactors[i];
-    BandDefs[i].Gain = EQNB_5BandNormalPresets[(FIVEBAND_NUMBANDS * eqPresetLevel) + i];
-    }
+    lvmSetEqBands(BandDefs, plvmConfigParams->eqNumBands, eqPresetLevel);
+    params->EQNB_NBands = plvmConfigParams->eqNumBands;
     params->EQNB_OperatingMode = plvmConfigParams->eqEnable;
     params->pEQNB_BandDefinition = &BandDefs[0];
 
@@ -455,12 +728,14 @@ int lvmControl(EffectContext *pContext,
 
     /* Treble Enhancement parameters */
     params->TE_OperatingMode = plvmConfigParams->trebleEnable;
+    params->TE_EffectLevel = plvmConfigParams->trebleEffectLevel;
 
     /* PSA Control parameters */
     params->PSA_Enable = LVM_PSA_ON;
 
     /* Bass Enhancement parameters */
     params->BE_OperatingMode = plvmConfigParams->bassEnable;
+    params->BE_HPF = plvmConfigParams->bassHpf;
     params->BE_EffectLevel = plvmConfigParams->bassEffectLevel;
 
     /* Activate the initial settings */
@@ -473,205 +748,2495 @@ int lvmControl(EffectContext *pContext,
     return 0;
 }
 
-int lvmExecute(float *floatIn, float *floatOut, EffectContext *pContext,
-               lvmConfigParams_t *plvmConfigParams) 
+double lvmGetTimeUs()
 {
-    const int frameLength = plvmConfigParams->frameLength;
-    return LVM_Process(pContext->pBundledContext->hInstance, /* Instance handle */
-                    floatIn,                              /* Input buffer */
-                    floatOut,                             /* Output buffer */
-                    (LVM_UINT16)frameLength, /* Number of samples to read */
-                    0);                      /* Audio Time */
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
 }
 
-int lvmMainProcess(EffectContext *pContext,
-                   LVM_ControlParams_t *pParams,
-                   lvmConfigParams_t *plvmConfigParams,
-                   FILE *finp,
-                   FILE *fout) 
+/* Sample format conversions with a common signature for lvmBenchConvert */
+typedef struct {
+    const char *name;
+    size_t srcSize;
+    size_t dstSize;
+    void (*convert)(void *dst, const void *src, size_t count);
+} lvmConverter_t;
+
+static dither_state_t gDitherState;
+
+void lvmConvertI16FromFloat(void *dst, const void *src, size_t count)
 {
-    int errCode = lvmControl(pContext, plvmConfigParams, pParams);
-    if (errCode) 
+    memcpy_to_i16_from_float((int16_t *)dst, (const float *)src, count);
+}
+
+void lvmConvertI16FromFloatDither(void *dst, const void *src, size_t count)
+{
+    memcpy_to_i16_from_float_with_dither((int16_t *)dst, (const float *)src, count, &gDitherState);
+}
+
+void lvmConvertFloatFromI16(void *dst, const void *src, size_t count)
+{
+    memcpy_to_float_from_i16((float *)dst, (const int16_t *)src, count);
+}
+
+void lvmConvertP24FromFloat(void *dst, const void *src, size_t count)
+{
+    memcpy_to_p24_from_float((uint8_t *)dst, (const float *)src, count);
+}
+
+void lvmConvertFloatFromP24(void *dst, const void *src, size_t count)
+{
+    memcpy_to_float_from_p24((float *)dst, (const uint8_t *)src, count);
+}
+
+void lvmConvertQ4_27FromFloat(void *dst, const void *src, size_t count)
+{
+    memcpy_to_q4_27_from_float((int32_t *)dst, (const float *)src, count);
+}
+
+void lvmConvertFloatFromQ4_27(void *dst, const void *src, size_t count)
+{
+    memcpy_to_float_from_q4_27((float *)dst, (const int32_t *)src, count);
+}
+
+void lvmConvertI32FromFloat(void *dst, const void *src, size_t count)
+{
+    memcpy_to_i32_from_float((int32_t *)dst, (const float *)src, count);
+}
+
+void lvmConvertI16FromQ4_27(void *dst, const void *src, size_t count)
+{
+    memcpy_to_i16_from_q4_27((int16_t *)dst, (const int32_t *)src, count);
+}
+
+void lvmAdjustI16From2To6(void *dst, const void *src, size_t count)
+{
+    adjust_channels(src, 2, dst, 6, sizeof(int16_t), count * 2 * sizeof(int16_t));
+}
+
+void lvmAdjustI16From6To2(void *dst, const void *src, size_t count)
+{
+    adjust_channels(src, 6, dst, 2, sizeof(int16_t), count * 6 * sizeof(int16_t));
+}
+
+void lvmAdjustI16From8To2(void *dst, const void *src, size_t count)
+{
+    adjust_channels(src, 8, dst, 2, sizeof(int16_t), count * 8 * sizeof(int16_t));
+}
+
+void lvmAdjustFloatFrom6To8(void *dst, const void *src, size_t count)
+{
+    adjust_channels(src, 6, dst, 8, sizeof(float), count * 6 * sizeof(float));
+}
+
+void lvmAdjustFloatFromI16From6To2(void *dst, const void *src, size_t count)
+{
+    adjust_channels_to_float_from_i16((const int16_t *)src, 6, (float *)dst, 2, count * 6 * sizeof(int16_t));
+}
+
+/* Throughput in GB/s (bytes read plus bytes written) of each conversion on a cache
+ * resident block, at every instruction set supported by the processor. The count unit
+ * is a sample, or a frame for the channel adjustments. */
+int lvmBenchConvert()
+{
+    static const lvmConverter_t converters[] = {
+        {"i16 from float", sizeof(float), sizeof(int16_t), lvmConvertI16FromFloat},
+        {"i16 from float dither", sizeof(float), sizeof(int16_t), lvmConvertI16FromFloatDither},
+        {"float from i16", sizeof(int16_t), sizeof(float), lvmConvertFloatFromI16},
+        {"p24 from float", sizeof(float), 3, lvmConvertP24FromFloat},
+        {"float from p24", 3, sizeof(float), lvmConvertFloatFromP24},
+        {"q4_27 from float", sizeof(float), sizeof(int32_t), lvmConvertQ4_27FromFloat},
+        {"float from q4_27", sizeof(int32_t), sizeof(float), lvmConvertFloatFromQ4_27},
+        {"i32 from float", sizeof(float), sizeof(int32_t), lvmConvertI32FromFloat},
+        {"i16 from q4_27", sizeof(int32_t), sizeof(int16_t), lvmConvertI16FromQ4_27},
+        {"i16 2 to 6 channels", 2 * sizeof(int16_t), 6 * sizeof(int16_t), lvmAdjustI16From2To6},
+        {"i16 6 to 2 channels", 6 * sizeof(int16_t), 2 * sizeof(int16_t), lvmAdjustI16From6To2},
+        {"i16 8 to 2 channels", 8 * sizeof(int16_t), 2 * sizeof(int16_t), lvmAdjustI16From8To2},
+        {"float 6 to 8 channels", 6 * sizeof(float), 8 * sizeof(float), lvmAdjustFloatFrom6To8},
+        {"i16 6 to 2 float", 6 * sizeof(int16_t), 2 * sizeof(float), lvmAdjustFloatFromI16From6To2},
+    };
+    static const char *levelNames[] = {"C", "SSE2", "AVX2"};
+    const size_t count = 4096;
+    const int repeats = 20000;
+    const audio_utils_simd_t bestLevel = audio_utils_get_simd_level();
+    const size_t maxFrameSize = 8 * sizeof(float);
+    float *src = (float *)malloc(count * maxFrameSize);
+    float *dst = (float *)malloc(count * maxFrameSize);
+    if (src == NULL || dst == NULL) 
     {
-        printf("Error: lvmControl returned with %d\n", errCode);
-        return errCode;
+        free(src);
+        free(dst);
+        return -ENOMEM;
     }
 
-    const int channelCount = plvmConfigParams->nrChannels;
-    const int frameLength = plvmConfigParams->frameLength;
-    const int frameSize = channelCount * sizeof(float); 
-    const int ioChannelCount = plvmConfigParams->fChannels;
-    const int ioFrameSize = ioChannelCount * sizeof(short); 
-    const int maxChannelCount = channelCount > ioChannelCount?channelCount:ioChannelCount;
-    short *in = (short*)calloc(frameLength * maxChannelCount, sizeof(short));
-    short *out = (short*)calloc(frameLength * maxChannelCount, sizeof(short));
-    float *floatIn = (float*)calloc(frameLength * maxChannelCount, sizeof(float));
-    float *floatOut = (float*)calloc(frameLength * maxChannelCount, sizeof(float));
-
-    int frameCounter = 0;
-    while (fread(in, ioFrameSize, frameLength, finp) == (size_t)frameLength) 
+    /* full scale noise, valid input for the float and the integer sources */
+    srand(1);
+    for (size_t i = 0; i < count * maxFrameSize / sizeof(float); i++) 
     {
-        if (ioChannelCount != channelCount)
-        {
-            adjust_channels(in, ioChannelCount, in, channelCount, sizeof(short), frameLength * ioFrameSize);
-        }
-        memcpy_to_float_from_i16(floatIn, in, frameLength * channelCount);
+        src[i] = (float)rand() / RAND_MAX * 2.f - 1.f;
+    }
+    dither_init(&gDitherState, 1);
 
-        // Mono mode will replicate the first channel to all other channels.
-        // This ensures all audio channels are identical. This is useful for testing
-        // Bass Boost, which extracts a mono signal for processing.
-        if (plvmConfigParams->monoMode && channelCount > 1) 
+    printf("%-23s", "GB/s");
+    for (int level = AUDIO_UTILS_SIMD_NONE; level <= (int)bestLevel; level++) 
+    {
+        printf("%8s", levelNames[level]);
+    }
+    printf("\n");
+    for (size_t c = 0; c < sizeof(converters) / sizeof(converters[0]); c++) 
+    {
+        const lvmConverter_t *pConverter = &converters[c];
+        printf("%-23s", pConverter->name);
+        for (int level = AUDIO_UTILS_SIMD_NONE; level <= (int)bestLevel; level++) 
         {
-            for (int i = 0; i < frameLength; ++i) 
+            audio_utils_set_simd_level((audio_utils_simd_t)level);
+            const double start = lvmGetTimeUs();
+            for (int r = 0; r < repeats; r++) 
             {
-                float* fp = &floatIn[i * channelCount];
-                memcpy(fp+1, fp, sizeof(float));// replicate ch 0
+                pConverter->convert(dst, src, count);
             }
+            const double bytes = (double)repeats * count * (pConverter->srcSize + pConverter->dstSize);
+            printf("%8.2f", bytes / ((lvmGetTimeUs() - start) * 1e3));
         }
-    #ifndef BYPASS_EXEC
-        errCode = lvmExecute(floatIn, floatOut, pContext, plvmConfigParams);
-        if (errCode) 
-        {
-            printf("\nError: lvmExecute returned with %d\n", errCode);
-            return errCode;
-        }
-
-        (void)frameSize;  // eliminate warning
-    #else
-        memcpy(floatOut, floatIn, frameLength * frameSize);
-    #endif
-        memcpy_to_i16_from_float(out, floatOut, frameLength * channelCount);
-        if (ioChannelCount != channelCount) 
-        {
-            adjust_channels(out, channelCount, out, ioChannelCount, sizeof(short), frameLength * channelCount * sizeof(short));
-        }
-        (void)fwrite(out, ioFrameSize, frameLength, fout);
-        frameCounter += frameLength;
+        printf("\n");
     }
-    printf("frameCounter: [%d]\n", frameCounter);
+    audio_utils_set_simd_level(bestLevel);
+    free(src);
+    free(dst);
     return 0;
 }
 
-int main(int argc, const char *argv[]) 
+/* Spectrum analyser with the bands of the bundle, or with the FFT engine of fftSize
+ * samples when fftSize is not 0. The memory regions are allocated in pMemTab */
+pLVPSA_Handle_t lvmPsaCreate(LVM_UINT16 nBands, LVM_Fs_en fs, LVM_Mode_en decimation, LVM_UINT16 fftSize,
+                             LVPSA_MemTab_t *pMemTab)
 {
-  if (argc == 1) 
-  {
-    printUsage();
-    return -1;
-  }
+    LVPSA_FilterParam_t filtersParams[30];
+    LVPSA_InitParams_t initParams;
+    LVPSA_ControlParams_t controlParams;
+    pLVPSA_Handle_t hPsa = LVM_NULL;
 
-  lvmConfigParams_t lvmConfigParams; 
-  lvmConfigParams.samplingFreq    = 44100;
-  lvmConfigParams.nrChannels      = 2;
-  lvmConfigParams.chMask          = AUDIO_CHANNEL_OUT_STEREO;
-  lvmConfigParams.vcBal           = 0;
-  lvmConfigParams.fChannels       = 2;
-  lvmConfigParams.monoMode        = 0;
-  lvmConfigParams.bassEffectLevel = 0;
-  lvmConfigParams.eqPresetLevel   = 0;
-  lvmConfigParams.frameLength     = 256;
-  lvmConfigParams.bassEnable      = LVM_BE_OFF;
-  lvmConfigParams.trebleEnable    = LVM_TE_OFF;
-  lvmConfigParams.eqEnable        = LVM_EQNB_OFF;
-  lvmConfigParams.csEnable        = LVM_MODE_OFF;
+    for (int i = 0; i < nBands && i < 30; i++) 
+    {
+        filtersParams[i].CenterFrequency = 1000;
+        filtersParams[i].QFactor = 100;
+        filtersParams[i].PostGain = 0;
+    }
+    initParams.SpectralDataBufferDuration = 500;
+    initParams.MaxInputBlockSize = 2048;
+    initParams.nBands = nBands;
+    initParams.pFiltersParams = filtersParams;
+    initParams.CoefBankRates = LVM_FS_BANK_NONE;
+    initParams.Decimation = decimation;
+    initParams.Engine = (fftSize != 0) ? LVPSA_ENGINE_FFT : LVPSA_ENGINE_FILTERBANK;
+    initParams.FFTSize = fftSize;
+    initParams.HopSize = fftSize / 4;
+    controlParams.Fs = fs;
+    controlParams.LevelDetectionSpeed = LVPSA_SPEED_MEDIUM;
+
+    memset(pMemTab, 0, sizeof(*pMemTab));
+    if (LVPSA_Memory(LVM_NULL, pMemTab, &initParams) != LVPSA_OK) return LVM_NULL;
+    for (int i = 0; i < LVPSA_NR_MEMORY_REGIONS; i++) 
+    {
+        if (pMemTab->Region[i].Size == 0) continue;
+        pMemTab->Region[i].pBaseAddress = malloc(pMemTab->Region[i].Size);
+        if (pMemTab->Region[i].pBaseAddress == NULL) return LVM_NULL;
+    }
+    if (LVPSA_Init(&hPsa, &initParams, &controlParams, pMemTab) != LVPSA_OK) return LVM_NULL;
+    return hPsa;
+}
 
-  const char *infile = NULL;
-  const char *outfile = NULL;
+void lvmPsaFree(LVPSA_MemTab_t *pMemTab)
+{
+    for (int i = 0; i < LVPSA_NR_MEMORY_REGIONS; i++) 
+    {
+        free(pMemTab->Region[i].pBaseAddress);
+    }
+}
+
+/* Time of the full rate and of the decimated spectrum analyser for a second of audio at
+ * every sampling rate, and the difference of their levels read every 20 ms. The input is
+ * a logarithmic sweep to the Nyquist frequency over noise. */
+int lvmBenchPsa(int nBands)
+{
+    static const int rates[] = {8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000,
+                                88200, 96000, 176400, 192000};
+    const int blockSize = 256;
+    const int repeats = 20;
+    int errCode = 0;
+
+    printf("%8s %10s %10s %8s %10s %9s %9s\n", "Fs", "full us/s", "dec us/s", "speedup", "dec bands",
+           "max diff", "mean diff");
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]) && errCode == 0; r++) 
+    {
+        const int frameCount = 2 * rates[r];
+        const LVM_Fs_en fs = lvmSampleRate(rates[r]);
+        LVPSA_MemTab_t memTab[2];
+        pLVPSA_Handle_t hPsa[2];
+        LVM_UINT8 current[2][30];
+        LVM_UINT8 peak[30];
+        double elapsedUs[2] = {0, 0};
+        int maxDiff = 0;
+        long sumDiff = 0, diffCount = 0;
+        float *pIn = (float *)malloc(frameCount * sizeof(float));
+
+        hPsa[0] = lvmPsaCreate(nBands, fs, LVM_MODE_OFF, 0, &memTab[0]);
+        hPsa[1] = lvmPsaCreate(nBands, fs, LVM_MODE_ON, 0, &memTab[1]);
+        if (pIn == NULL || hPsa[0] == LVM_NULL || hPsa[1] == LVM_NULL) 
+        {
+            errCode = -ENOMEM;
+        }
+        else 
+        {
+            const double logRange = log(rates[r] / 2 / 20.0);
+            double phase = 0;
+            srand(1);
+            for (int i = 0; i < frameCount; i++) 
+            {
+                phase += 2 * M_PI * 20.0 * exp(logRange * i / frameCount) / rates[r];
+                pIn[i] = (float)(0.5 * sin(phase) + 0.1 * ((double)rand() / RAND_MAX * 2 - 1));
+            }
+
+            /* Levels of both analysers after every block */
+            for (int i = 0; i + blockSize <= frameCount; i += blockSize) 
+            {
+                const LVPSA_Time audioTime = (LVPSA_Time)((LVM_INT64)i * 1000 / rates[r]);
+                for (int a = 0; a < 2; a++) 
+                {
+                    LVPSA_Process(hPsa[a], pIn + i, blockSize, audioTime);
+                    LVPSA_GetSpectrum(hPsa[a], audioTime, current[a], peak);
+                }
+                for (int b = 0; b < nBands; b++) 
+                {
+                    const int diff = abs((int)current[0][b] - (int)current[1][b]);
+                    if (diff > maxDiff) maxDiff = diff;
+                    sumDiff += diff;
+                    diffCount++;
+                }
+            }
+
+            for (int a = 0; a < 2; a++) 
+            {
+                const double start = lvmGetTimeUs();
+                for (int rep = 0; rep < repeats; rep++) 
+                {
+                    for (int i = 0; i + blockSize <= frameCount; i += blockSize) 
+                    {
+                        LVPSA_Process(hPsa[a], pIn + i, blockSize, 0);
+                    }
+                }
+                elapsedUs[a] = (lvmGetTimeUs() - start) / (repeats * 2);
+            }
+            const LVPSA_InstancePr_t *pPsa = (const LVPSA_InstancePr_t *)hPsa[1];
+            int decimatedBands = 0;
+            for (int b = 0; b < pPsa->nRelevantFilters; b++) 
+            {
+                if (pPsa->pBPFiltersDecimation[b] != 0) decimatedBands++;
+            }
+            printf("%8d %10.1f %10.1f %8.2f %7d/%-2d %9d %9.3f\n", rates[r], elapsedUs[0], elapsedUs[1],
+                   elapsedUs[0] / elapsedUs[1], decimatedBands, pPsa->nRelevantFilters,
+                   maxDiff, (double)sumDiff / diffCount);
+        }
+        lvmPsaFree(&memTab[0]);
+        lvmPsaFree(&memTab[1]);
+        free(pIn);
+    }
+    return errCode;
+}
+
+/* Time of the FFT spectrum analyser for a second of audio at every sampling rate, and the
+ * band of the highest level and its center frequency for a 1 kHz tone over noise. */
+int lvmBenchPsaFFT(int nBands)
+{
+    static const int rates[] = {8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000,
+                                88200, 96000, 176400, 192000};
+    const int blockSize = 256;
+    const int repeats = 20;
+    const LVM_UINT16 fftSize = 4096;
+    int errCode = 0;
+
+    printf("FFT of %d samples, hop of %d samples\n", fftSize, fftSize / 4);
+    printf("%8s %10s %10s %10s %10s\n", "Fs", "us/s", "peak band", "center Hz", "level");
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]) && errCode == 0; r++) 
+    {
+        const int frameCount = 2 * rates[r];
+        const LVM_Fs_en fs = lvmSampleRate(rates[r]);
+        LVPSA_MemTab_t memTab;
+        pLVPSA_Handle_t hPsa = lvmPsaCreate(nBands, fs, LVM_MODE_OFF, fftSize, &memTab);
+        LVPSA_InitParams_t initParams;
+        LVM_UINT8 current[LVPSA_FFT_NBANDSMAX];
+        LVM_UINT8 peak[LVPSA_FFT_NBANDSMAX];
+        float *pIn = (float *)malloc(frameCount * sizeof(float));
+
+        if (pIn == NULL || hPsa == LVM_NULL) 
+        {
+            errCode = -ENOMEM;
+        }
+        else 
+        {
+            srand(1);
+            for (int i = 0; i < frameCount; i++) 
+            {
+                pIn[i] = (float)(0.5 * sin(2 * M_PI * 1000.0 * i / rates[r]) +
+                                 0.01 * ((double)rand() / RAND_MAX * 2 - 1));
+            }
+
+            LVPSA_Time audioTime = 0;
+            const double start = lvmGetTimeUs();
+            for (int rep = 0; rep < repeats; rep++) 
+            {
+                for (int i = 0; i + blockSize <= frameCount; i += blockSize) 
+                {
+                    audioTime = (LVPSA_Time)(((LVM_INT64)rep * frameCount + i) * 1000 / rates[r]);
+                    LVPSA_Process(hPsa, pIn + i, blockSize, audioTime);
+                }
+            }
+            const double elapsedUs = (lvmGetTimeUs() - start) / (repeats * 2);
+
+            // The last buffer update can be up to 20 ms before the last block
+            LVPSA_GetSpectrum(hPsa, audioTime - 40, current, peak);
+            LVPSA_GetInitParams(hPsa, &initParams);
+            int peakBand = 0;
+            for (int b = 1; b < nBands; b++) 
+            {
+                if (current[b] > current[peakBand]) peakBand = b;
+            }
+            printf("%8d %10.1f %10d %10d %10d\n", rates[r], elapsedUs, peakBand,
+                   initParams.pFiltersParams[peakBand].CenterFrequency, current[peakBand]);
+        }
+        lvmPsaFree(&memTab);
+        free(pIn);
+    }
+    return errCode;
+}
+
+LVEQNB_Handle_t lvmEqCreate(LVEQNB_BandDef_t *pBands, LVM_UINT16 nBands, LVM_Fs_en fs,
+                            LVEQNB_Engine_en engine, LVM_UINT16 blockSize, LVEQNB_MemTab_t *pMemTab)
+{
+    LVEQNB_Capabilities_t capabilities;
+    LVEQNB_Params_t params;
+    LVEQNB_Handle_t hEq = LVM_NULL;
+
+    capabilities.SampleRate = 0x1FFF;
+    capabilities.SourceFormat = LVEQNB_CAP_STEREO;
+    capabilities.MaxBlockSize = blockSize;
+    capabilities.MaxBands = nBands;
+    capabilities.CoefBankRates = LVM_FS_BANK_NONE;
+    capabilities.Engine = engine;
+    capabilities.CallBack = LVM_NULL;
+    capabilities.pBundleInstance = LVM_NULL;
+
+    memset(pMemTab, 0, sizeof(*pMemTab));
+    if (LVEQNB_Memory(LVM_NULL, pMemTab, &capabilities) != LVEQNB_SUCCESS) return LVM_NULL;
+    for (int i = 0; i < LVEQNB_NR_MEMORY_REGIONS; i++) 
+    {
+        if (pMemTab->Region[i].Size == 0) continue;
+        pMemTab->Region[i].pBaseAddress = malloc(pMemTab->Region[i].Size);
+        if (pMemTab->Region[i].pBaseAddress == NULL) return LVM_NULL;
+    }
+    if (LVEQNB_Init(&hEq, pMemTab, &capabilities) != LVEQNB_SUCCESS) return LVM_NULL;
+
+    params.OperatingMode = LVEQNB_ON;
+    params.SampleRate = (LVEQNB_Fs_en)fs;
+    params.SourceFormat = LVEQNB_STEREO;
+    params.NBands = nBands;
+    params.pBandDefinition = pBands;
+#ifdef SUPPORT_MC
+    params.NrChannels = FCC_2;
+#endif
+    if (LVEQNB_Control(hEq, &params) != LVEQNB_SUCCESS) return LVM_NULL;
+    return hEq;
+}
+
+void lvmEqFree(LVEQNB_MemTab_t *pMemTab)
+{
+    for (int i = 0; i < LVEQNB_NR_MEMORY_REGIONS; i++) 
+    {
+        free(pMemTab->Region[i].pBaseAddress);
+    }
+}
+
+/* Bench bands spread logarithmically from 20 Hz to 20 kHz with random gains of up to 12 dB,
+ * 31 bands are the third octave bands */
+void lvmEqBenchBands(LVEQNB_BandDef_t *pBands, int nBands)
+{
+    const double octaves = (nBands > 1) ? log2(1000.0) / (nBands - 1) : 1.0;
+
+    srand(nBands);
+    for (int i = 0; i < nBands; i++) 
+    {
+        pBands[i].Frequency = (LVM_UINT16)(20.0 * pow(2.0, i * octaves) + 0.5);
+        pBands[i].QFactor = (LVM_UINT16)(100.0 * sqrt(pow(2.0, octaves)) / (pow(2.0, octaves) - 1) + 0.5);
+        pBands[i].Gain = (LVM_INT16)(rand() % 25 - 12);
+        if (pBands[i].Gain == 0) pBands[i].Gain = 1;
+    }
+}
+
+/* Bench input, a logarithmic sweep to the Nyquist frequency over noise */
+void lvmEqBenchInput(float *pIn, int frameCount, int rate)
+{
+    const double logRange = log(rate / 2 / 20.0);
+    double phase = 0;
+
+    srand(1);
+    for (int i = 0; i < frameCount; i++) 
+    {
+        phase += 2 * M_PI * 20.0 * exp(logRange * i / frameCount) / rate;
+        for (int ch = 0; ch < FCC_2; ch++) 
+        {
+            pIn[FCC_2 * i + ch] = (float)(0.1 * sin(phase) +
+                                          0.05 * ((double)rand() / RAND_MAX * 2 - 1));
+        }
+    }
+}
+
+/* Time of the cascade and of the parallel equaliser for a second of stereo audio, and the
+ * difference of their outputs */
+int lvmBenchEq()
+{
+    static const int bandCounts[] = {5, 10, 31};
+    static const int rates[] = {16000, 44100, 48000, 96000, 192000};
+    const int blockSize = 256;
+    const int repeats = 20;
+    int errCode = 0;
+
+    printf("%6s %8s %8s %12s %13s %8s %12s %12s\n", "bands", "Fs", "form", "cascade us/s",
+           "parallel us/s", "speedup", "max diff dB", "rms diff dB");
+    for (size_t b = 0; b < sizeof(bandCounts) / sizeof(bandCounts[0]) && errCode == 0; b++) 
+    {
+        const int nBands = bandCounts[b];
+        LVEQNB_BandDef_t bands[31];
+
+        lvmEqBenchBands(bands, nBands);
+
+        for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]) && errCode == 0; r++) 
+        {
+            const int frameCount = rates[r];
+            const LVM_Fs_en fs = lvmSampleRate(rates[r]);
+            LVEQNB_MemTab_t memTab[2];
+            LVEQNB_Handle_t hEq[2];
+            double elapsedUs[2] = {0, 0};
+            float *pIn = (float *)malloc(FCC_2 * frameCount * sizeof(float));
+            float *pOut[2];
+            int usedBands = 0;
+
+            for (int i = 0; i < nBands; i++) 
+            {
+                if (2 * bands[i].Frequency <= rates[r]) usedBands = i + 1;
+            }
+            pOut[0] = (float *)malloc(FCC_2 * frameCount * sizeof(float));
+            pOut[1] = (float *)malloc(FCC_2 * frameCount * sizeof(float));
+            hEq[0] = lvmEqCreate(bands, nBands, fs, LVEQNB_ENGINE_CASCADE, blockSize, &memTab[0]);
+            hEq[1] = lvmEqCreate(bands, nBands, fs, LVEQNB_ENGINE_PARALLEL, blockSize, &memTab[1]);
+            if (pIn == NULL || pOut[0] == NULL || pOut[1] == NULL ||
+                hEq[0] == LVM_NULL || hEq[1] == LVM_NULL) 
+            {
+                errCode = -ENOMEM;
+            }
+            else 
+            {
+                lvmEqBenchInput(pIn, frameCount, rates[r]);
+
+                /* Time the engines, the output of the last repeat is compared */
+                for (int a = 0; a < 2; a++) 
+                {
+                    const double start = lvmGetTimeUs();
+                    for (int rep = 0; rep < repeats; rep++) 
+                    {
+                        for (int i = 0; i + blockSize <= frameCount; i += blockSize) 
+                        {
+                            LVEQNB_Process(hEq[a], pIn + FCC_2 * i, pOut[a] + FCC_2 * i, blockSize);
+                        }
+                    }
+                    elapsedUs[a] = (lvmGetTimeUs() - start) / repeats;
+                }
+
+                double maxDiff = 0, sumDiff = 0, sumOut = 0;
+                for (int i = 0; i < FCC_2 * (frameCount / blockSize) * blockSize; i++) 
+                {
+                    const double diff = fabs((double)pOut[0][i] - pOut[1][i]);
+                    if (diff > maxDiff) maxDiff = diff;
+                    sumDiff += diff * diff;
+                    sumOut += (double)pOut[0][i] * pOut[0][i];
+                }
+                const LVEQNB_Instance_t *pEq = (const LVEQNB_Instance_t *)hEq[1];
+                printf("%3d/%-2d %8d %8s %12.1f %13.1f %8.2f %12.1f %12.1f\n", usedBands, nBands,
+                       rates[r], pEq->ParallelGroups != 0 ? "parallel" : "series",
+                       elapsedUs[0], elapsedUs[1], elapsedUs[0] / elapsedUs[1],
+                       20 * log10(maxDiff + 1e-20), 10 * log10(sumDiff / sumOut + 1e-40));
+            }
+            lvmEqFree(&memTab[0]);
+            lvmEqFree(&memTab[1]);
+            free(pIn);
+            free(pOut[0]);
+            free(pOut[1]);
+        }
+    }
+    return errCode;
+}
+
+int lvmCloneCreate(EffectContext *pTemplate, EffectContext *pContext)
+{
+    LVM_ReturnStatus_en LvmStatus = LVM_SUCCESS; /* Function call status */
+    LVM_MemTab_t MemTab;
+
+    /* Same region sizes as the template */
+    LvmStatus = LVM_GetMemoryTable(pTemplate->pBundledContext->hInstance, &MemTab, LVM_NULL);
+    if (LvmStatus != LVM_SUCCESS) return -EINVAL;
+
+    for (int i = 0; i < LVM_NR_MEMORY_REGIONS; i++) 
+    {
+        MemTab.Region[i].pBaseAddress = NULL;
+        if (MemTab.Region[i].Size != 0) 
+        {
+            MemTab.Region[i].pBaseAddress = malloc(MemTab.Region[i].Size);
+            if (MemTab.Region[i].pBaseAddress == NULL) 
+            {
+                for (int j = 0; j < i; j++) free(MemTab.Region[j].pBaseAddress);
+                return -ENOMEM;
+            }
+        }
+    }
+
+    LvmStatus = LVM_CloneInstance(pTemplate->pBundledContext->hInstance,
+                                  &pContext->pBundledContext->hInstance,
+                                  &MemTab);
+    if (LvmStatus != LVM_SUCCESS) 
+    {
+        for (int i = 0; i < LVM_NR_MEMORY_REGIONS; i++) 
+        {
+            free(MemTab.Region[i].pBaseAddress);
+        }
+        return -EINVAL;
+    }
+    return 0;
+}
+
+/* Cost of the equaliser against the number of bands at 48 kHz, the time of a second of
+ * stereo audio and of a control call changing one band or all of them, as a graphic
+ * equaliser does, for each engine */
+int lvmBenchEqBands()
+{
+    static const int bandCounts[] = {1, 2, 4, 8, 16, 24, 31, 32};
+    const int rate = 48000;
+    const int blockSize = 256;
+    const int repeats = 20;
+    const int controls = 1000;
+    const LVM_Fs_en fs = lvmSampleRate(rate);
+    float *pIn = (float *)malloc(FCC_2 * rate * sizeof(float));
+    float *pOut = (float *)malloc(FCC_2 * rate * sizeof(float));
+    int errCode = 0;
+
+    if (pIn == NULL || pOut == NULL) 
+    {
+        free(pIn);
+        free(pOut);
+        return -ENOMEM;
+    }
+    lvmEqBenchInput(pIn, rate, rate);
+
+    printf("%6s %12s %10s %13s %10s %21s %21s\n", "", "", "", "", "",
+           "cascade control us", "parallel control us");
+    printf("%6s %12s %10s %13s %10s %10s %10s %10s %10s\n", "bands", "cascade us/s", "per band",
+           "parallel us/s", "per band", "1 band", "all bands", "1 band", "all bands");
+    for (size_t b = 0; b < sizeof(bandCounts) / sizeof(bandCounts[0]) && errCode == 0; b++) 
+    {
+        const int nBands = bandCounts[b];
+        LVEQNB_BandDef_t bands[32];
+        LVEQNB_MemTab_t memTab[2];
+        LVEQNB_Handle_t hEq[2];
+        double elapsedUs[2] = {0, 0};
+        double controlUs[2][2] = {{0, 0}, {0, 0}};
+
+        lvmEqBenchBands(bands, nBands);
+        hEq[0] = lvmEqCreate(bands, nBands, fs, LVEQNB_ENGINE_CASCADE, blockSize, &memTab[0]);
+        hEq[1] = lvmEqCreate(bands, nBands, fs, LVEQNB_ENGINE_PARALLEL, blockSize, &memTab[1]);
+        if (hEq[0] == LVM_NULL || hEq[1] == LVM_NULL) 
+        {
+            errCode = -ENOMEM;
+        }
+        else 
+        {
+            LVEQNB_Params_t params;
+
+            for (int a = 0; a < 2; a++) 
+            {
+                const double start = lvmGetTimeUs();
+                for (int rep = 0; rep < repeats; rep++) 
+                {
+                    for (int i = 0; i + blockSize <= rate; i += blockSize) 
+                    {
+                        LVEQNB_Process(hEq[a], pIn + FCC_2 * i, pOut + FCC_2 * i, blockSize);
+                    }
+                }
+                elapsedUs[a] = (lvmGetTimeUs() - start) / repeats;
+            }
+
+            /* Move the middle band, then all the bands, up and down by 1 dB */
+            for (int a = 0; a < 2; a++) 
+            {
+                LVEQNB_GetParameters(hEq[a], &params);
+                for (int c = 0; c < 2; c++) 
+                {
+                    const int first = (c == 0) ? nBands / 2 : 0;
+                    const int last = (c == 0) ? nBands / 2 + 1 : nBands;
+                    const double start = lvmGetTimeUs();
+                    for (int n = 0; n < controls; n++) 
+                    {
+                        for (int i = first; i < last; i++) 
+                        {
+                            bands[i].Gain = (LVM_INT16)(bands[i].Gain + ((n & 1) ? -1 : 1));
+                        }
+                        LVEQNB_Control(hEq[a], &params);
+                    }
+                    controlUs[a][c] = (lvmGetTimeUs() - start) / controls;
+                }
+            }
+
+            printf("%6d %12.1f %10.1f %13.1f %10.1f %10.2f %10.2f %10.2f %10.2f\n", nBands,
+                   elapsedUs[0], elapsedUs[0] / nBands, elapsedUs[1], elapsedUs[1] / nBands,
+                   controlUs[0][0], controlUs[0][1], controlUs[1][0], controlUs[1][1]);
+        }
+        lvmEqFree(&memTab[0]);
+        lvmEqFree(&memTab[1]);
+    }
+    free(pIn);
+    free(pOut);
+    return errCode;
+}
+
+/* Processes the same blocks with a session created and configured and with a clone of the
+ * configured template, the outputs must be the same. Halfway the equaliser preset of both
+ * changes, a clone sharing the coefficients of the template moves to a copy of them */
+int lvmCloneCompare(EffectContext *pTemplate, lvmConfigParams_t *plvmConfigParams)
+{
+    const int blockCount = 100;
+    const int frameLength = plvmConfigParams->frameLength;
+    const int channelCount = plvmConfigParams->nrChannels;
+    const int outChannelCount = (channelCount == 1) ? FCC_2 : channelCount;  // Mono gives stereo
+    EffectContext session[2];
+    BundledEffectContext cloneContext;
+    LVM_ControlParams_t sessionParams;
+    int mismatches = 0;
+    int errCode;
+
+    session[1].pBundledContext = &cloneContext;
+    errCode = lvmCreate(&session[0], plvmConfigParams, &sessionParams);
+    if (errCode == 0) errCode = lvmControl(&session[0], plvmConfigParams, &sessionParams);
+    if (errCode == 0) errCode = lvmCloneCreate(pTemplate, &session[1]);
+    else cloneContext.hInstance = NULL;
+    if (errCode) 
+    {
+        if (session[0].pBundledContext != NULL && session[0].pBundledContext->hInstance != NULL) 
+        {
+            LvmEffect_free(&session[0]);
+        }
+        free(session[0].pBundledContext);
+        return errCode;
+    }
+
+    float *pIn = (float *)malloc(frameLength * channelCount * sizeof(float));
+    float *pOut[2];
+    pOut[0] = (float *)calloc(frameLength * outChannelCount, sizeof(float));
+    pOut[1] = (float *)calloc(frameLength * outChannelCount, sizeof(float));
+    if (pIn == NULL || pOut[0] == NULL || pOut[1] == NULL) errCode = -ENOMEM;
+
+    const LVM_Instance_t *pClone = (LVM_Instance_t *)session[1].pBundledContext->hInstance;
+    const int shared = (pClone->pEQNB_CoefBlock != LVM_NULL);
+
+    srand(1);
+    for (int block = 0; block < blockCount && errCode == 0; block++) 
+    {
+        if (block == blockCount / 2) 
+        {
+            LVM_EQNB_BandDef_t BandDefs[MAX_NUM_BANDS];
+            lvmSetEqBands(BandDefs, plvmConfigParams->eqNumBands,
+                          (plvmConfigParams->eqPresetLevel + 1) % 10);
+            for (int s = 0; s < 2 && errCode == 0; s++) 
+            {
+                LVM_Handle_t hInstance = session[s].pBundledContext->hInstance;
+                if (LVM_GetControlParameters(hInstance, &sessionParams) != LVM_SUCCESS) errCode = -EINVAL;
+                sessionParams.pEQNB_BandDefinition = &BandDefs[0];
+                if (errCode == 0 && LVM_SetControlParameters(hInstance, &sessionParams) != LVM_SUCCESS) 
+                {
+                    errCode = -EINVAL;
+                }
+            }
+        }
+        for (int i = 0; i < frameLength * channelCount; i++) 
+        {
+            pIn[i] = (float)((double)rand() / RAND_MAX - 0.5);
+        }
+        for (int s = 0; s < 2 && errCode == 0; s++) 
+        {
+            if (LVM_Process(session[s].pBundledContext->hInstance, pIn, pOut[s],
+                            (LVM_UINT16)frameLength, 0) != LVM_SUCCESS) errCode = -EINVAL;
+        }
+        if (memcmp(pOut[0], pOut[1], frameLength * outChannelCount * sizeof(float)) != 0) 
+        {
+            mismatches++;
+        }
+    }
+    if (errCode == 0) 
+    {
+        printf("clone output: %d of %d blocks differ from a created session%s\n", mismatches,
+               blockCount, shared ? ", equaliser coefficients shared until the preset change" : "");
+        if (shared && pClone->EQNB_CoefCopied == LVM_FALSE) 
+        {
+            printf("Error: the clone changed the shared equaliser coefficients\n");
+            errCode = -EINVAL;
+        }
+        if (mismatches) errCode = -EINVAL;
+    }
+
+    free(pIn);
+    free(pOut[0]);
+    free(pOut[1]);
+    LvmEffect_free(&session[0]);
+    free(session[0].pBundledContext);
+    LvmEffect_free(&session[1]);
+    return errCode;
+}
+
+/* Time of a session created and configured against a clone of a configured template */
+int lvmBenchCreate(lvmConfigParams_t *plvmConfigParams)
+{
+    const int count = plvmConfigParams->benchCreate;
+    EffectContext template;
+    EffectContext session;
+    LVM_ControlParams_t sessionParams;
+    int errCode;
+
+    errCode = lvmCreate(&template, plvmConfigParams, &sessionParams);
+    if (errCode == 0) errCode = lvmControl(&template, plvmConfigParams, &sessionParams);
+
+    double start = lvmGetTimeUs();
+    for (int i = 0; i < count && errCode == 0; i++) 
+    {
+        errCode = lvmCreate(&session, plvmConfigParams, &sessionParams);
+        if (errCode == 0) errCode = lvmControl(&session, plvmConfigParams, &sessionParams);
+        if (session.pBundledContext != NULL && session.pBundledContext->hInstance != NULL) 
+        {
+            LvmEffect_free(&session);
+        }
+        free(session.pBundledContext);
+    }
+    const double createUs = (lvmGetTimeUs() - start) / count;
+
+    BundledEffectContext sessionContext;
+    session.pBundledContext = &sessionContext;
+    start = lvmGetTimeUs();
+    for (int i = 0; i < count && errCode == 0; i++) 
+    {
+        errCode = lvmCloneCreate(&template, &session);
+        if (errCode == 0) LvmEffect_free(&session);
+    }
+    const double cloneUs = (lvmGetTimeUs() - start) / count;
+
+    if (errCode == 0) 
+    {
+        printf("session create: %.2f us, clone: %.2f us (%d sessions)\n", createUs, cloneUs, count);
+
+        LVM_MemTab_t MemTab;
+        LVM_UINT32 persistentSize = 0;
+        LVM_GetMemoryTable(template.pBundledContext->hInstance, &MemTab, LVM_NULL);
+        for (int i = 0; i < LVM_NR_MEMORY_REGIONS; i++) 
+        {
+            if (i != LVM_MEMREGION_TEMPORARY_FAST) persistentSize += MemTab.Region[i].Size;
+        }
+        printf("session memory: %" PRIu32 " bytes persistent, %" PRIu32 " bytes scratch\n",
+               persistentSize, MemTab.Region[LVM_MEMREGION_TEMPORARY_FAST].Size);
+
+        errCode = lvmCloneCompare(&template, plvmConfigParams);
+    }
+
+    if (template.pBundledContext != NULL) 
+    {
+        if (template.pBundledContext->hInstance != NULL) LvmEffect_free(&template);
+        free(template.pBundledContext);
+    }
+    return errCode;
+}
+
+void lvmReportMemory(EffectContext *pContext, const lvmConfigParams_t *plvmConfigParams) 
+{
+    LVM_Instance_t *pInstance = (LVM_Instance_t *)pContext->pBundledContext->hInstance;
+    LVM_InstParams_t InstParams = pInstance->InstParams;
+    LVM_InstParamsEx_t InstParamsEx = pInstance->InstParamsEx;
+    LVM_MemTab_t MemTab;
+    LVM_UINT32 bundleSize = 0;
+    LVM_UINT32 staticSize = 0;
+
+    LVM_GetMemoryTable(pContext->pBundledContext->hInstance, &MemTab, LVM_NULL);
+    for (int i = 0; i < LVM_NR_MEMORY_REGIONS; i++) 
+    {
+        if (i != LVM_MEMREGION_TEMPORARY_FAST) bundleSize += MemTab.Region[i].Size;
+    }
+
+    /* The same instance with all of the module memory allocated up front */
+    InstParamsEx.ModuleAllocator.pAlloc = NULL;
+    InstParamsEx.CoefSharing = LVM_MODE_OFF;
+    LVM_GetMemoryTableEx(LVM_NULL, &MemTab, &InstParams, &InstParamsEx);
+    for (int i = 0; i < LVM_NR_MEMORY_REGIONS; i++) 
+    {
+        if (i != LVM_MEMREGION_TEMPORARY_FAST) staticSize += MemTab.Region[i].Size;
+    }
+
+    printf("memory footprint: %" PRIu32 " bytes persistent (%" PRIu32 " bundle + %" PRIu32
+           " modules), %" PRIu32 " bytes without lazy allocation\n",
+           bundleSize + plvmConfigParams->moduleMemory.Allocated, bundleSize,
+           plvmConfigParams->moduleMemory.Allocated, staticSize);
+}
+
+/* WAV and RF64 files */
+static const uint8_t gWavSubFormatGuid[14] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+int lvmFileSampleSize(lvmFileFormat_en format)
+{
+    switch (format) 
+    {
+        case LVM_FILE_I16: return sizeof(int16_t);
+        case LVM_FILE_P24: return 3;
+        case LVM_FILE_I32: return sizeof(int32_t);
+        case LVM_FILE_F32: return sizeof(float);
+    }
+    return 0;
+}
+
+LVM_PcmFormat_en lvmFilePcmFormat(lvmFileFormat_en format)
+{
+    switch (format) 
+    {
+        case LVM_FILE_P24: return LVM_PCM_PACKED_24BIT;
+        case LVM_FILE_I32: return LVM_PCM_32BIT;
+        default:           return LVM_PCM_16BIT;
+    }
+}
+
+uint32_t lvmGetLe16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t lvmGetLe32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t lvmGetLe64(const uint8_t *p)
+{
+    return lvmGetLe32(p) | ((uint64_t)lvmGetLe32(p + 4) << 32);
+}
+
+uint8_t *lvmPutLe16(uint8_t *p, uint32_t value)
+{
+    *p++ = (uint8_t)value;
+    *p++ = (uint8_t)(value >> 8);
+    return p;
+}
+
+uint8_t *lvmPutLe32(uint8_t *p, uint32_t value)
+{
+    p = lvmPutLe16(p, value & 0xFFFF);
+    return lvmPutLe16(p, value >> 16);
+}
+
+uint8_t *lvmPutLe64(uint8_t *p, uint64_t value)
+{
+    p = lvmPutLe32(p, (uint32_t)value);
+    return lvmPutLe32(p, (uint32_t)(value >> 32));
+}
+
+uint8_t *lvmPutId(uint8_t *p, const char *id)
+{
+    memcpy(p, id, 4);
+    return p + 4;
+}
+
+/*
+ * Reads the header of a WAV or RF64 file and leaves the file at the first sample. A file
+ * without a RIFF or RF64 header is rewound and reported as headerless.
+ */
+int lvmWavParse(FILE *fp, lvmFileInfo_t *pInfo)
+{
+    uint8_t header[40];
+    uint64_t ds64DataSize = 0;
+    int fmtFound = 0;
+    struct stat st;
+
+    pInfo->wav = 0;
+    if (fread(header, 1, 12, fp) != 12 ||
+        (memcmp(header, "RIFF", 4) && memcmp(header, "RF64", 4)) || memcmp(header + 8, "WAVE", 4)) 
+    {
+        rewind(fp);
+        return 0;
+    }
+    const int rf64 = !memcmp(header, "RF64", 4);
+
+    for (;;) 
+    {
+        if (fread(header, 1, 8, fp) != 8) return -EINVAL;
+        const uint64_t chunkSize = lvmGetLe32(header + 4);
+        uint64_t readSize = 0;
+
+        if (!memcmp(header, "ds64", 4) && chunkSize >= 24) 
+        {
+            readSize = 24;
+            if (fread(header, 1, readSize, fp) != readSize) return -EINVAL;
+            ds64DataSize = lvmGetLe64(header + 8);
+        }
+        else if (!memcmp(header, "fmt ", 4) && chunkSize >= 16) 
+        {
+            readSize = (chunkSize < sizeof(header)) ? chunkSize : sizeof(header);
+            if (fread(header, 1, readSize, fp) != readSize) return -EINVAL;
+            uint32_t formatTag = lvmGetLe16(header);
+            const uint32_t bits = lvmGetLe16(header + 14);
+            pInfo->channels = lvmGetLe16(header + 2);
+            pInfo->samplingFreq = lvmGetLe32(header + 4);
+            if (formatTag == 0xFFFE && readSize >= 40) 
+            {
+                if (memcmp(header + 26, gWavSubFormatGuid, sizeof(gWavSubFormatGuid))) return -EINVAL;
+                formatTag = lvmGetLe16(header + 24);
+            }
+            if (formatTag == 1 && bits == 16) pInfo->format = LVM_FILE_I16;
+            else if (formatTag == 1 && bits == 24) pInfo->format = LVM_FILE_P24;
+            else if (formatTag == 1 && bits == 32) pInfo->format = LVM_FILE_I32;
+            else if (formatTag == 3 && bits == 32) pInfo->format = LVM_FILE_F32;
+            else return -EINVAL;
+            if (pInfo->channels == 0 ||
+                lvmGetLe16(header + 12) != pInfo->channels * bits / 8) return -EINVAL;
+            fmtFound = 1;
+        }
+        else if (!memcmp(header, "data", 4)) 
+        {
+            if (!fmtFound) return -EINVAL;
+            pInfo->dataOffset = (uint64_t)ftello(fp);
+            pInfo->dataSize = (rf64 && chunkSize == 0xFFFFFFFF) ? ds64DataSize : chunkSize;
+            // Streaming writers may leave the size of the data unset or too large
+            if (fstat(fileno(fp), &st) == 0 && (uint64_t)st.st_size >= pInfo->dataOffset &&
+                pInfo->dataSize > (uint64_t)st.st_size - pInfo->dataOffset) 
+            {
+                pInfo->dataSize = (uint64_t)st.st_size - pInfo->dataOffset;
+            }
+            pInfo->wav = 1;
+            return 0;
+        }
+        // Chunks are padded to an even size
+        if (fseeko(fp, (off_t)(chunkSize + (chunkSize & 1) - readSize), SEEK_CUR) != 0) return -EINVAL;
+    }
+}
+
+/*
+ * Writes a WAV header for dataSize bytes of samples and returns its size, LVM_WAV_HEADER_MAX
+ * bytes at most. A JUNK chunk reserves the space of the ds64 chunk so that the same header
+ * size turns into RF64 when the data does not fit the 32 bit sizes of RIFF. The header size
+ * is a multiple of 4 bytes, so float samples stay aligned.
+ */
+#define LVM_WAV_HEADER_MAX 104
+
+size_t lvmWavHeader(uint8_t *header, const lvmFileInfo_t *pInfo, uint64_t dataSize)
+{
+    const uint32_t sampleSize = lvmFileSampleSize(pInfo->format);
+    const uint32_t blockAlign = pInfo->channels * sampleSize;
+    const int extensible = pInfo->format != LVM_FILE_I16 || pInfo->channels > 2;
+    const uint32_t fmtSize = extensible ? 40 : 16;
+    const size_t headerSize = 12 + 36 + 8 + fmtSize + 8;
+    const uint64_t riffSize = headerSize - 8 + dataSize + (dataSize & 1);
+    const int rf64 = riffSize > UINT32_MAX;
+    uint8_t *p = header;
+
+    p = lvmPutId(p, rf64 ? "RF64" : "RIFF");
+    p = lvmPutLe32(p, rf64 ? 0xFFFFFFFF : (uint32_t)riffSize);
+    p = lvmPutId(p, "WAVE");
+    p = lvmPutId(p, rf64 ? "ds64" : "JUNK");
+    p = lvmPutLe32(p, 28);
+    p = lvmPutLe64(p, rf64 ? riffSize : 0);
+    p = lvmPutLe64(p, rf64 ? dataSize : 0);
+    p = lvmPutLe64(p, rf64 ? dataSize / blockAlign : 0);
+    p = lvmPutLe32(p, 0);
+    p = lvmPutId(p, "fmt ");
+    p = lvmPutLe32(p, fmtSize);
+    p = lvmPutLe16(p, extensible ? 0xFFFE : 1);
+    p = lvmPutLe16(p, pInfo->channels);
+    p = lvmPutLe32(p, pInfo->samplingFreq);
+    p = lvmPutLe32(p, pInfo->samplingFreq * blockAlign);
+    p = lvmPutLe16(p, blockAlign);
+    p = lvmPutLe16(p, sampleSize * 8);
+    if (extensible) 
+    {
+        p = lvmPutLe16(p, 22);
+        p = lvmPutLe16(p, sampleSize * 8);
+        p = lvmPutLe32(p, (1u << pInfo->channels) - 1);
+        p = lvmPutLe16(p, pInfo->format == LVM_FILE_F32 ? 3 : 1);
+        memcpy(p, gWavSubFormatGuid, sizeof(gWavSubFormatGuid));
+        p += sizeof(gWavSubFormatGuid);
+    }
+    p = lvmPutId(p, "data");
+    p = lvmPutLe32(p, rf64 ? 0xFFFFFFFF : (uint32_t)dataSize);
+    return headerSize;
+}
+
+void lvmFileToFloat(float *dst, const void *src, lvmFileFormat_en format, size_t count)
+{
+    switch (format) 
+    {
+        case LVM_FILE_I16: memcpy_to_float_from_i16(dst, (const int16_t *)src, count); break;
+        case LVM_FILE_P24: memcpy_to_float_from_p24(dst, (const uint8_t *)src, count); break;
+        case LVM_FILE_I32: memcpy_to_float_from_i32(dst, (const int32_t *)src, count); break;
+        case LVM_FILE_F32: memcpy(dst, src, count * sizeof(float)); break;
+    }
+}
+
+void lvmFileFromFloat(void *dst, const float *src, lvmFileFormat_en format, size_t count,
+                      dither_state_t *pDither)
+{
+    switch (format) 
+    {
+        case LVM_FILE_I16:
+            if (pDither != NULL) memcpy_to_i16_from_float_with_dither((int16_t *)dst, src, count, pDither);
+            else memcpy_to_i16_from_float((int16_t *)dst, src, count);
+            break;
+        case LVM_FILE_P24: memcpy_to_p24_from_float((uint8_t *)dst, src, count); break;
+        case LVM_FILE_I32: memcpy_to_i32_from_float((int32_t *)dst, src, count); break;
+        case LVM_FILE_F32: memcpy(dst, src, count * sizeof(float)); break;
+    }
+}
+
+/* adjust_channels mixes a contraction to mono as integers, which does not hold for float */
+size_t lvmAdjustChannels(const void *in, int inChannels, void *out, int outChannels,
+                         lvmFileFormat_en format, size_t numInBytes)
+{
+    if (format == LVM_FILE_F32 && outChannels == 1 && inChannels > 1) 
+    {
+        const size_t frames = numInBytes / (inChannels * sizeof(float));
+        const float *src = (const float *)in;
+        float *dst = (float *)out;
+        for (size_t i = 0; i < frames; i++) 
+        {
+            dst[i] = 0.5f * (src[i * inChannels] + src[i * inChannels + 1]);
+        }
+        return frames * sizeof(float);
+    }
+    return adjust_channels(in, inChannels, out, outChannels, lvmFileSampleSize(format), numInBytes);
+}
+
+/*
+ * Opens the input and the output file of a render. The header of a WAV input sets the sampling
+ * rate and the file channels of the configuration.
+ */
+int lvmOpenFiles(lvmConfigParams_t *pConfig, const char *infile, const char *outfile,
+                 FILE **pFinp, FILE **pFout)
+{
+    FILE *finp = fopen(infile, "rb");
+    if (finp == NULL) 
+    {
+        printf("Cannot open input file %s\n", infile);
+        return -1;
+    }
+
+    lvmFileInfo_t *pInFile = &pConfig->inFile;
+    if (lvmWavParse(finp, pInFile) != 0) 
+    {
+        printf("Error: unsupported WAV file %s\n", infile);
+        fclose(finp);
+        return -1;
+    }
+    if (pInFile->wav) 
+    {
+        if (lvmSampleRate(pInFile->samplingFreq) == LVM_FS_INVALID ||
+            pInFile->channels > 8) 
+        {
+            printf("Error: unsupported WAV file %s: %d Hz, %d channels\n", infile,
+                   pInFile->samplingFreq, pInFile->channels);
+            fclose(finp);
+            return -1;
+        }
+        pConfig->samplingFreq = pInFile->samplingFreq;
+        pConfig->fChannels = pInFile->channels;
+    }
+    else 
+    {
+        struct stat st;
+        pInFile->format = LVM_FILE_I16;
+        pInFile->samplingFreq = pConfig->samplingFreq;
+        pInFile->channels = pConfig->fChannels;
+        pInFile->dataOffset = 0;
+        pInFile->dataSize = (fstat(fileno(finp), &st) == 0) ? (uint64_t)st.st_size : 0;
+    }
+    if (pConfig->pcm && pInFile->format == LVM_FILE_F32) 
+    {
+        printf("Error: -pcm needs an integer input file\n");
+        fclose(finp);
+        return -1;
+    }
+    const size_t outfileLength = strlen(outfile);
+    pConfig->outFile = *pInFile;
+    pConfig->outFile.wav = outfileLength >= 4 && !strcasecmp(outfile + outfileLength - 4, ".wav");
+
+    FILE *fout = fopen(outfile, "wb");
+    if (fout == NULL) 
+    {
+        printf("Cannot open output file %s\n", outfile);
+        fclose(finp);
+        return -1;
+    }
+    *pFinp = finp;
+    *pFout = fout;
+    return 0;
+}
+
+int lvmExecute(float *floatIn, float *floatOut, EffectContext *pContext,
+               lvmConfigParams_t *plvmConfigParams) 
+{
+    const int frameLength = plvmConfigParams->frameLength;
+    return LVM_Process(pContext->pBundledContext->hInstance, /* Instance handle */
+                    floatIn,                              /* Input buffer */
+                    floatOut,                             /* Output buffer */
+                    (LVM_UINT16)frameLength, /* Number of samples to read */
+                    0);                      /* Audio Time */
+}
+
+int lvmExecutePlanar(float *planarIn, float *planarOut, float *floatIn, float *floatOut,
+                     EffectContext *pContext, lvmConfigParams_t *plvmConfigParams) 
+{
+    const int frameLength = plvmConfigParams->frameLength;
+    const int channelCount = plvmConfigParams->nrChannels;
+    const int outChannelCount = (channelCount == 1) ? 2 : channelCount;
+    const LVM_FLOAT *pIn[LVM_MAX_CHANNELS];
+    LVM_FLOAT *pOut[LVM_MAX_CHANNELS];
+
+    for (int ch = 0; ch < LVM_MAX_CHANNELS; ch++) 
+    {
+        pIn[ch] = planarIn + ch * frameLength;
+        pOut[ch] = planarOut + ch * frameLength;
+    }
+    if (plvmConfigParams->planar == 2) 
+    {
+        return LVM_ProcessPlanar(pContext->pBundledContext->hInstance, pIn, pOut,
+                                 (LVM_UINT16)frameLength, 0);
+    }
+
+    Copy_Float_Planar_Mc(pIn, floatIn, (LVM_INT16)frameLength, channelCount);
+    const int errCode = lvmExecute(floatIn, floatOut, pContext, plvmConfigParams);
+    if (errCode) return errCode;
+    Copy_Float_Mc_Planar(floatOut, pOut, (LVM_INT16)frameLength, outChannelCount);
+    return 0;
+}
+
+int lvmExecuteAccumulate(float *floatIn, float *floatOut, float *floatWet, EffectContext *pContext,
+                         lvmConfigParams_t *plvmConfigParams) 
+{
+    const int frameLength = plvmConfigParams->frameLength;
+    const int channelCount = plvmConfigParams->nrChannels;
+    const int outChannelCount = (channelCount == 1) ? 2 : channelCount;
+
+    if (plvmConfigParams->accumulate == 2) 
+    {
+        return lvmExecute(floatIn, floatOut, pContext, plvmConfigParams);
+    }
+
+    const int errCode = lvmExecute(floatIn, floatWet, pContext, plvmConfigParams);
+    if (errCode) return errCode;
+    accumulate_float(floatOut, floatWet, frameLength * outChannelCount);
+    return 0;
+}
+
+/* Analysis thread of the deferred spectrum analyser */
+typedef struct{
+    LVM_Handle_t      hInstance;
+    pthread_t         thread;
+    atomic_int        stop;
+    int               spectrumCalls;
+    LVM_UINT32        analysedSamples;
+    LVM_UINT32        droppedSamples;
+    double            analysisUs;
+}lvmSpectrumThread_t;
+
+void *lvmSpectrumWorker(void *pArg) 
+{
+    lvmSpectrumThread_t *pThread = (lvmSpectrumThread_t*)pArg;
+    LVM_UINT8 currentPeaks[LVPSA_FFT_NBANDSMAX];  // Room for the bands of the analyser
+    LVM_UINT8 pastPeaks[LVPSA_FFT_NBANDSMAX];
+    const struct timespec period = {0, 1000000};
+    int stop = 0;
+
+    // The last pass after the stop request takes the blocks of the final process calls
+    while (!stop) 
+    {
+        stop = atomic_load(&pThread->stop);
+        const double start = lvmGetTimeUs();
+        (void)LVM_ProcessSpectrum(pThread->hInstance, &pThread->analysedSamples, &pThread->droppedSamples);
+        (void)LVM_GetSpectrum(pThread->hInstance, currentPeaks, pastPeaks, 0);
+        pThread->analysisUs += lvmGetTimeUs() - start;
+        pThread->spectrumCalls++;
+        if (!stop) nanosleep(&period, NULL);
+    }
+    return NULL;
+}
+
+/* Spectrum snapshot reader thread */
+typedef struct{
+    LVM_Handle_t            hInstance;
+    pthread_t               thread;
+    atomic_int              *pStop;
+    int                     reads;
+    int                     outOfOrder;     // Snapshots older than the previous one
+    LVM_PSA_SnapshotInfo_t  info;
+}lvmSnapshotReader_t;
+
+void *lvmSnapshotReader(void *pArg) 
+{
+    lvmSnapshotReader_t *pReader = (lvmSnapshotReader_t*)pArg;
+    LVM_FLOAT currentLevels[LVPSA_FFT_NBANDSMAX];
+    LVM_FLOAT peakLevels[LVPSA_FFT_NBANDSMAX];
+    const struct timespec period = {0, 1000000};
+    LVM_PSA_SnapshotInfo_t info;
+
+    while (!atomic_load(pReader->pStop)) 
+    {
+        if (LVM_GetSpectrumSnapshot(pReader->hInstance, currentLevels, peakLevels,
+                                    LVPSA_FFT_NBANDSMAX, &info) == LVM_SUCCESS) 
+        {
+            if (info.Number < pReader->info.Number) pReader->outOfOrder++;
+            pReader->info = info;
+            pReader->reads++;
+        }
+        nanosleep(&period, NULL);
+    }
+    return NULL;
+}
+
+int lvmMainProcess(EffectContext *pContext,
+                   LVM_ControlParams_t *pParams,
+                   lvmConfigParams_t *plvmConfigParams,
+                   FILE *finp,
+                   FILE *fout) 
+{
+    int errCode = lvmControl(pContext, plvmConfigParams, pParams);
+    if (errCode) 
+    {
+        printf("Error: lvmControl returned with %d\n", errCode);
+        return errCode;
+    }
+
+    const int channelCount = plvmConfigParams->nrChannels;
+    const int frameLength = plvmConfigParams->frameLength;
+    const int frameSize = channelCount * sizeof(float); 
+    const int ioChannelCount = plvmConfigParams->fChannels;
+    const lvmFileFormat_en ioFormat = plvmConfigParams->inFile.format;
+    const int ioSampleSize = lvmFileSampleSize(ioFormat);
+    const int ioFrameSize = ioChannelCount * ioSampleSize; 
+    // A mono source gives a stereo output
+    const int outChannelCount = (channelCount == 1) ? 2 : channelCount;
+    const int maxChannelCount = outChannelCount > ioChannelCount ? outChannelCount : ioChannelCount;
+    void *in = calloc(frameLength * maxChannelCount, ioSampleSize);
+    void *out = calloc(frameLength * maxChannelCount, ioSampleSize);
+    float *floatIn = (float*)calloc(frameLength * maxChannelCount, sizeof(float));
+    float *floatOut = (float*)calloc(frameLength * maxChannelCount, sizeof(float));
+    // Float files are read into and written from the process buffers
+    const int floatDirect = ioFormat == LVM_FILE_F32 && ioChannelCount == channelCount;
+    float *planarIn = NULL;
+    float *planarOut = NULL;
+    if (plvmConfigParams->planar) 
+    {
+        planarIn = (float*)calloc(frameLength * LVM_MAX_CHANNELS, sizeof(float));
+        planarOut = (float*)calloc(frameLength * LVM_MAX_CHANNELS, sizeof(float));
+    }
+    float *floatWet = NULL;
+    if (plvmConfigParams->accumulate) 
+    {
+        floatWet = (float*)calloc(frameLength * LVM_MAX_CHANNELS, sizeof(float));
+    }
+    uint8_t *pcmIn = NULL;
+    uint8_t *pcmOut = NULL;
+    if (plvmConfigParams->pcm) 
+    {
+        pcmIn = (uint8_t*)calloc(frameLength * LVM_MAX_CHANNELS, ioSampleSize);
+        pcmOut = (uint8_t*)calloc(frameLength * LVM_MAX_CHANNELS, ioSampleSize);
+    }
+
+    // The header is rewritten with the data size at the end
+    uint8_t header[LVM_WAV_HEADER_MAX];
+    uint64_t dataWritten = 0;
+    if (plvmConfigParams->outFile.wav) 
+    {
+        const size_t headerSize = lvmWavHeader(header, &plvmConfigParams->outFile, 0);
+        (void)fwrite(header, 1, headerSize, fout);
+    }
+    uint64_t dataLeft = plvmConfigParams->inFile.dataSize;
+
+    const LVM_Fs_en inputRate = pParams->SampleRate;
+    const LVM_Fs_en switchRate = lvmSampleRate(plvmConfigParams->fsSwitch);
+    int switchCounter = 0;
+    int nextSwitch = plvmConfigParams->samplingFreq;
+    double switchUs = 0;
+    double processUs = 0;
+
+    // LVM_Process only fills the ring of the deferred analyser
+    lvmSpectrumThread_t spectrum;
+    memset(&spectrum, 0, sizeof(spectrum));
+    if (plvmConfigParams->psa == 2) 
+    {
+        spectrum.hInstance = pContext->pBundledContext->hInstance;
+        atomic_init(&spectrum.stop, 0);
+        if (pthread_create(&spectrum.thread, NULL, lvmSpectrumWorker, &spectrum) != 0) 
+        {
+            printf("Error: cannot create the analysis thread\n");
+            spectrum.hInstance = NULL;
+            errCode = -EAGAIN;
+        }
+    }
+
+    // The readers only touch the published snapshots
+    lvmSnapshotReader_t readers[LVM_PSA_MAX_READERS];
+    atomic_int readersStop;
+    int readerCount = 0;
+    atomic_init(&readersStop, 0);
+    memset(readers, 0, sizeof(readers));
+    while (errCode == 0 && readerCount < plvmConfigParams->psaReaders) 
+    {
+        readers[readerCount].hInstance = pContext->pBundledContext->hInstance;
+        readers[readerCount].pStop = &readersStop;
+        if (pthread_create(&readers[readerCount].thread, NULL, lvmSnapshotReader, &readers[readerCount]) != 0) 
+        {
+            printf("Error: cannot create the snapshot reader threads\n");
+            errCode = -EAGAIN;
+            break;
+        }
+        readerCount++;
+    }
+
+    int frameCounter = 0;
+    while (errCode == 0 && dataLeft >= (uint64_t)frameLength * ioFrameSize &&
+           fread(floatDirect ? (void*)floatIn : in, ioFrameSize, frameLength, finp) == (size_t)frameLength) 
+    {
+        dataLeft -= (uint64_t)frameLength * ioFrameSize;
+        // Alternate the sampling rate every second of audio
+        if (plvmConfigParams->fsSwitch != 0 && frameCounter >= nextSwitch) 
+        {
+            LVM_ControlParams_t switchParams;
+            LVM_GetControlParameters(pContext->pBundledContext->hInstance, &switchParams);
+            switchParams.SampleRate = (switchParams.SampleRate == inputRate) ? switchRate : inputRate;
+            const double start = lvmGetTimeUs();
+            if (LVM_SetControlParameters(pContext->pBundledContext->hInstance, &switchParams) != LVM_SUCCESS ||
+                LVM_ApplyNewSettings(pContext->pBundledContext->hInstance) != LVM_SUCCESS) 
+            {
+                printf("\nError: sampling rate switch failed\n");
+                errCode = -EINVAL;
+                break;
+            }
+            switchUs += lvmGetTimeUs() - start;
+            switchCounter++;
+            nextSwitch += plvmConfigParams->samplingFreq;
+        }
+
+        if (plvmConfigParams->pcm) 
+        {
+            const double pcmStart = lvmGetTimeUs();
+            lvmAdjustChannels(in, ioChannelCount, pcmIn, channelCount, ioFormat, frameLength * ioFrameSize);
+            if (plvmConfigParams->monoMode && channelCount > 1) 
+            {
+                for (int i = 0; i < frameLength; ++i) 
+                {
+                    uint8_t *pp = &pcmIn[i * channelCount * ioSampleSize];
+                    memcpy(pp + ioSampleSize, pp, ioSampleSize); // replicate ch 0
+                }
+            }
+            errCode = LVM_ProcessPcm(pContext->pBundledContext->hInstance, pcmIn, pcmOut,
+                                     lvmFilePcmFormat(ioFormat), (LVM_UINT16)frameLength, 0);
+            processUs += lvmGetTimeUs() - pcmStart;
+            if (errCode) 
+            {
+                printf("\nError: LVM_ProcessPcm returned with %d\n", errCode);
+                break;
+            }
+            memcpy(out, pcmOut, frameLength * channelCount * ioSampleSize);
+            if (ioChannelCount != channelCount) 
+            {
+                lvmAdjustChannels(out, channelCount, out, ioChannelCount, ioFormat, frameLength * channelCount * ioSampleSize);
+            }
+            (void)fwrite(out, ioFrameSize, frameLength, fout);
+            dataWritten += (uint64_t)frameLength * ioFrameSize;
+            frameCounter += frameLength;
+            continue;
+        }
+
+        if (ioFormat == LVM_FILE_I16) 
+        {
+            adjust_channels_to_float_from_i16((const int16_t*)in, ioChannelCount, floatIn, channelCount, frameLength * ioFrameSize);
+        }
+        else if (!floatDirect) 
+        {
+            if (ioChannelCount != channelCount) 
+            {
+                lvmAdjustChannels(in, ioChannelCount, in, channelCount, ioFormat, frameLength * ioFrameSize);
+            }
+            lvmFileToFloat(floatIn, in, ioFormat, frameLength * channelCount);
+        }
+
+        // Mono mode will replicate the first channel to all other channels.
+        // This ensures all audio channels are identical. This is useful for testing
+        // Bass Boost, which extracts a mono signal for processing.
+        if (plvmConfigParams->monoMode && channelCount > 1) 
+        {
+            for (int i = 0; i < frameLength; ++i) 
+            {
+                float* fp = &floatIn[i * channelCount];
+                memcpy(fp+1, fp, sizeof(float));// replicate ch 0
+            }
+        }
+    #ifndef BYPASS_EXEC
+        // The planes of a planar host, outside of the timed process
+        if (plvmConfigParams->planar) 
+        {
+            for (int ch = 0; ch < channelCount; ch++) 
+            {
+                for (int i = 0; i < frameLength; ++i) 
+                {
+                    planarIn[ch * frameLength + i] = floatIn[i * channelCount + ch];
+                }
+            }
+            if (plvmConfigParams->accumulate) 
+            {
+                memcpy(planarOut, planarIn, frameLength * frameSize);
+            }
+        }
+        // The output buffer holds the dry signal to mix into
+        if (plvmConfigParams->accumulate) 
+        {
+            memcpy(floatOut, floatIn, frameLength * frameSize);
+        }
+        const double processStart = lvmGetTimeUs();
+        if (plvmConfigParams->planar) 
+        {
+            errCode = lvmExecutePlanar(planarIn, planarOut, floatIn, floatOut, pContext, plvmConfigParams);
+        }
+        else if (plvmConfigParams->accumulate) 
+        {
+            errCode = lvmExecuteAccumulate(floatIn, floatOut, floatWet, pContext, plvmConfigParams);
+        }
+        else 
+        {
+            errCode = lvmExecute(floatIn, floatOut, pContext, plvmConfigParams);
+        }
+        processUs += lvmGetTimeUs() - processStart;
+        if (errCode) 
+        {
+            printf("\nError: lvmExecute returned with %d\n", errCode);
+            break;
+        }
+
+        if (plvmConfigParams->planar) 
+        {
+            for (int ch = 0; ch < outChannelCount; ch++) 
+            {
+                for (int i = 0; i < frameLength; ++i) 
+                {
+                    floatOut[i * outChannelCount + ch] = planarOut[ch * frameLength + i];
+                }
+            }
+        }
+
+        (void)frameSize;  // eliminate warning
+    #else
+        memcpy(floatOut, floatIn, frameLength * frameSize);
+    #endif
+        if (floatDirect) 
+        {
+            (void)fwrite(floatOut, ioFrameSize, frameLength, fout);
+        }
+        else 
+        {
+            lvmFileFromFloat(out, floatOut, ioFormat, frameLength * channelCount,
+                             plvmConfigParams->dither ? &plvmConfigParams->ditherState : NULL);
+            if (ioChannelCount != channelCount) 
+            {
+                lvmAdjustChannels(out, channelCount, out, ioChannelCount, ioFormat, frameLength * channelCount * ioSampleSize);
+            }
+            (void)fwrite(out, ioFrameSize, frameLength, fout);
+        }
+        dataWritten += (uint64_t)frameLength * ioFrameSize;
+        frameCounter += frameLength;
+    }
+    if (spectrum.hInstance != NULL) 
+    {
+        atomic_store(&spectrum.stop, 1);
+        pthread_join(spectrum.thread, NULL);
+    }
+    atomic_store(&readersStop, 1);
+    for (int i = 0; i < readerCount; i++) 
+    {
+        pthread_join(readers[i].thread, NULL);
+    }
+    if (errCode == 0 && plvmConfigParams->outFile.wav) 
+    {
+        if (dataWritten & 1) (void)fputc(0, fout);
+        const size_t headerSize = lvmWavHeader(header, &plvmConfigParams->outFile, dataWritten);
+        if (fseeko(fout, 0, SEEK_SET) != 0 || fwrite(header, 1, headerSize, fout) != headerSize) 
+        {
+            printf("Error: cannot write the WAV header\n");
+            errCode = -EIO;
+        }
+    }
+    if (errCode != 0) 
+    {
+        free(in);
+        free(out);
+        free(floatIn);
+        free(floatOut);
+        free(floatWet);
+        free(planarIn);
+        free(planarOut);
+        free(pcmIn);
+        free(pcmOut);
+        return errCode;
+    }
+    printf("frameCounter: [%d]\n", frameCounter);
+    if (switchCounter > 0) 
+    {
+        printf("fs switch: %.2f us average (%d switches)\n", switchUs / switchCounter, switchCounter);
+    }
+    if (plvmConfigParams->denormalStats) 
+    {
+        LVM_DenormalStats_t stats;
+        LVM_GetDenormalStats(pContext->pBundledContext->hInstance, &stats);
+        printf("denormals: %" PRIu32 " samples in %" PRIu32 " of %" PRIu32 " calls, process %.0f us\n",
+               stats.DenormalSamples, stats.DenormalCalls, stats.ProcessCalls, processUs);
+    }
+    if (plvmConfigParams->planar) 
+    {
+        printf("planar mode %d: process %.0f us\n", plvmConfigParams->planar, processUs);
+    }
+    if (plvmConfigParams->pcm) 
+    {
+        LVM_PcmStats_t stats;
+        LVM_GetPcmStats(pContext->pBundledContext->hInstance, &stats);
+        printf("pcm: %" PRIu32 " saturated samples in %" PRIu32 " of %" PRIu32 " calls, process %.0f us\n",
+               stats.SaturatedSamples, stats.SaturatedCalls, stats.ProcessCalls, processUs);
+    }
+    if (plvmConfigParams->accumulate) 
+    {
+        printf("accumulate mode %d: process %.0f us\n", plvmConfigParams->accumulate, processUs);
+    }
+    if (plvmConfigParams->psa == 1) 
+    {
+        printf("psa mode 1: process %.0f us\n", processUs);
+    }
+    else if (plvmConfigParams->psa == 2) 
+    {
+        printf("psa mode 2: process %.0f us, analysis %.0f us in %d calls, %" PRIu32 " samples analysed, %" PRIu32 " dropped\n",
+               processUs, spectrum.analysisUs, spectrum.spectrumCalls,
+               spectrum.analysedSamples, spectrum.droppedSamples);
+    }
+    if (readerCount > 0) 
+    {
+        int reads = 0;
+        int outOfOrder = 0;
+        for (int i = 0; i < readerCount; i++) 
+        {
+            reads += readers[i].reads;
+            outOfOrder += readers[i].outOfOrder;
+        }
+        printf("psa readers: %d threads, %d snapshots read, %d out of order, last snapshot %" PRIu32
+               " at %" PRId32 " ms with %d bands\n",
+               readerCount, reads, outOfOrder, readers[0].info.Number,
+               readers[0].info.AudioTime, readers[0].info.NrBands);
+    }
+    free(in);
+    free(out);
+    free(floatIn);
+    free(floatOut);
+    free(floatWet);
+    free(planarIn);
+    free(planarOut);
+    free(pcmIn);
+    free(pcmOut);
+    return 0;
+}
+
+int lvmMmapProcess(EffectContext *pContext,
+                   LVM_ControlParams_t *pParams,
+                   lvmConfigParams_t *plvmConfigParams,
+                   const char *infile,
+                   const char *outfile) 
+{
+    int errCode = lvmControl(pContext, plvmConfigParams, pParams);
+    if (errCode) 
+    {
+        printf("Error: lvmControl returned with %d\n", errCode);
+        return errCode;
+    }
+
+    const int channelCount = plvmConfigParams->nrChannels;
+    const int frameLength = plvmConfigParams->frameLength;
+    const int ioChannelCount = plvmConfigParams->fChannels;
+    const lvmFileFormat_en ioFormat = plvmConfigParams->inFile.format;
+    const int ioSampleSize = lvmFileSampleSize(ioFormat);
+    const int ioFrameSize = ioChannelCount * ioSampleSize;
+    const int outChannelCount = (channelCount == 1) ? 2 : channelCount;
+    // Whole calls of frameLength frames, as the fread loop
+    const int blockFrames = (plvmConfigParams->mmapBlock + frameLength - 1) / frameLength * frameLength;
+
+    const int fdIn = open(infile, O_RDONLY);
+    if (fdIn < 0) 
+    {
+        printf("Cannot open input file %s", infile);
+        return -errno;
+    }
+    const int fdOut = open(outfile, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fdOut < 0) 
+    {
+        printf("Cannot open output file %s", outfile);
+        close(fdIn);
+        return -errno;
+    }
+    const size_t frameCount = plvmConfigParams->inFile.dataSize / ioFrameSize / frameLength * frameLength;
+    const size_t dataSize = frameCount * ioFrameSize;
+    const size_t inMapSize = plvmConfigParams->inFile.dataOffset + dataSize;
+    uint8_t header[LVM_WAV_HEADER_MAX];
+    const size_t headerSize = plvmConfigParams->outFile.wav ?
+            lvmWavHeader(header, &plvmConfigParams->outFile, dataSize) : 0;
+    // Chunks are padded to an even size
+    const size_t outMapSize = headerSize + dataSize + (headerSize != 0 ? (dataSize & 1) : 0);
+    if (frameCount == 0) 
+    {
+        printf("frameCounter: [0]\n");
+        errCode = (write(fdOut, header, headerSize) == (ssize_t)headerSize) ? 0 : -EIO;
+        close(fdIn);
+        close(fdOut);
+        return errCode;
+    }
+    if (ftruncate(fdOut, (off_t)outMapSize) != 0) 
+    {
+        errCode = -errno;
+        printf("Error: cannot size output file %s\n", outfile);
+        close(fdIn);
+        close(fdOut);
+        return errCode;
+    }
+    const uint8_t *pInMap = (const uint8_t*)mmap(NULL, inMapSize, PROT_READ, MAP_PRIVATE, fdIn, 0);
+    uint8_t *pOutMap = (uint8_t*)mmap(NULL, outMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fdOut, 0);
+    close(fdIn);
+    close(fdOut);
+    if (pInMap == MAP_FAILED || pOutMap == MAP_FAILED) 
+    {
+        errCode = -errno;
+        printf("Error: cannot map the input or output file\n");
+        if (pInMap != MAP_FAILED) munmap((void*)pInMap, inMapSize);
+        if (pOutMap != MAP_FAILED) munmap(pOutMap, outMapSize);
+        return errCode;
+    }
+    (void)madvise((void*)pInMap, inMapSize, MADV_SEQUENTIAL);
+    (void)madvise(pOutMap, outMapSize, MADV_SEQUENTIAL);
+    memcpy(pOutMap, header, headerSize);
+    const uint8_t *pInData = pInMap + plvmConfigParams->inFile.dataOffset;
+    uint8_t *pOutData = pOutMap + headerSize;
+
+    // Aligned float files are processed straight from the input to the output mapping
+    const int zeroCopy = ioFormat == LVM_FILE_F32 && ioChannelCount == channelCount &&
+            !plvmConfigParams->monoMode && plvmConfigParams->inFile.dataOffset % sizeof(float) == 0;
+    const int maxChannelCount = outChannelCount > ioChannelCount ? outChannelCount : ioChannelCount;
+    float *floatIn = NULL;
+    float *floatOut = NULL;
+    uint8_t *out = NULL;
+    if (!zeroCopy) 
+    {
+        floatIn = (float*)calloc((size_t)blockFrames * maxChannelCount, sizeof(float));
+        floatOut = (float*)calloc((size_t)blockFrames * maxChannelCount, sizeof(float));
+    }
+    // Needed to adjust the channels of formats without a fused conversion
+    if (ioChannelCount != channelCount) 
+    {
+        out = (uint8_t*)calloc((size_t)blockFrames * maxChannelCount, ioSampleSize);
+    }
+
+    double processUs = 0;
+    const double renderStart = lvmGetTimeUs();
+    for (size_t frame = 0; frame < frameCount; frame += blockFrames) 
+    {
+        const int blockLength = (frameCount - frame < (size_t)blockFrames) ?
+                (int)(frameCount - frame) : blockFrames;
+        const uint8_t *in = pInData + frame * ioFrameSize;
+        uint8_t *dst = pOutData + frame * ioFrameSize;
+        float *blockIn = zeroCopy ? (float*)in : floatIn;
+        float *blockOut = zeroCopy ? (float*)dst : floatOut;
+
+        if (ioFormat == LVM_FILE_I16) 
+        {
+            adjust_channels_to_float_from_i16((const int16_t*)in, ioChannelCount, floatIn, channelCount,
+                                              (size_t)blockLength * ioFrameSize);
+        }
+        else if (!zeroCopy) 
+        {
+            const uint8_t *src = in;
+            if (out != NULL) 
+            {
+                lvmAdjustChannels(in, ioChannelCount, out, channelCount, ioFormat,
+                                  (size_t)blockLength * ioFrameSize);
+                src = out;
+            }
+            lvmFileToFloat(floatIn, src, ioFormat, (size_t)blockLength * channelCount);
+        }
+        if (plvmConfigParams->monoMode && channelCount > 1) 
+        {
+            for (int i = 0; i < blockLength; ++i) 
+            {
+                float* fp = &floatIn[i * channelCount];
+                memcpy(fp+1, fp, sizeof(float));// replicate ch 0
+            }
+        }
+
+        const double processStart = lvmGetTimeUs();
+        for (int i = 0; i < blockLength; i += frameLength) 
+        {
+            errCode = lvmExecute(blockIn + i * channelCount, blockOut + i * outChannelCount,
+                                 pContext, plvmConfigParams);
+            if (errCode) break;
+        }
+        processUs += lvmGetTimeUs() - processStart;
+        if (errCode) 
+        {
+            printf("\nError: lvmExecute returned with %d\n", errCode);
+            break;
+        }
+
+        if (!zeroCopy) 
+        {
+            lvmFileFromFloat((out != NULL) ? out : dst, floatOut, ioFormat,
+                             (size_t)blockLength * channelCount,
+                             plvmConfigParams->dither ? &plvmConfigParams->ditherState : NULL);
+        }
+        if (out != NULL) 
+        {
+            lvmAdjustChannels(out, channelCount, dst, ioChannelCount, ioFormat,
+                              (size_t)blockLength * channelCount * ioSampleSize);
+        }
+    }
+    const double renderUs = lvmGetTimeUs() - renderStart;
+
+    if (errCode == 0) 
+    {
+        const double audioUs = (double)frameCount * 1e6 / plvmConfigParams->samplingFreq;
+        printf("frameCounter: [%zu]\n", frameCount);
+        printf("mmap: %d frame blocks%s, %.1f MB/s, %.1fx real time, render %.0f us, process %.0f us\n",
+               blockFrames, zeroCopy ? " (zero copy)" : "", (double)dataSize / renderUs,
+               audioUs / renderUs, renderUs, processUs);
+    }
+    munmap((void*)pInMap, inMapSize);
+    munmap(pOutMap, outMapSize);
+    free(floatIn);
+    free(floatOut);
+    free(out);
+    return errCode;
+}
+
+/*
+ * Parses an effect option of the command line or of a batch job. Returns 1 when the option
+ * was parsed, 0 when it is not an effect option and -1 when its value is not supported.
+ */
+int lvmParseEffectOption(const char *arg, lvmConfigParams_t *pConfig)
+{
+    // sampling rate
+    if (!strncmp(arg, "-fs:", 4)) 
+    {
+        const int samplingFreq = atoi(arg + 4);
+        if (samplingFreq != 8000 && samplingFreq != 11025 &&
+            samplingFreq != 12000 && samplingFreq != 16000 &&
+            samplingFreq != 22050 && samplingFreq != 24000 &&
+            samplingFreq != 32000 && samplingFreq != 44100 &&
+            samplingFreq != 48000 && samplingFreq != 88200 &&
+            samplingFreq != 96000 && samplingFreq != 176400 &&
+            samplingFreq != 192000) 
+        {
+            printf("Error: Unsupported Sampling Frequency : %d\n", samplingFreq);
+            return -1;
+        }
+        pConfig->samplingFreq = samplingFreq;
+    }
+    // balence
+    else if (!strncmp(arg, "-vcBal:", 7)) 
+    {
+        const int vcBalance = atoi(arg + 7);
+        if (vcBalance > 96 || vcBalance < -96) 
+        {
+            printf("\nError: Unsupported volume balance value: %d\n", vcBalance);
+        }
+        pConfig->vcBal = vcBalance;
+    } 
+    // channel
+    else if (!strncmp(arg, "-chMask:", 8))
+    {
+        const int chMaskConfigIdx = atoi(arg + 8);
+        if (chMaskConfigIdx < 0 ||
+            (size_t)chMaskConfigIdx >= sizeof(lvmConfigChMask) / sizeof(lvmConfigChMask[0]))
+        {
+            printf("Error: Unsupported Channel Mask : %d\n", chMaskConfigIdx);
+            return -1;
+        }
+        pConfig->chMask = lvmConfigChMask[chMaskConfigIdx];
+        pConfig->nrChannels = __builtin_popcount(pConfig->chMask);
+    }
+    else if (!strncmp(arg, "-fch:", 5)) 
+    {
+        const int fChannels = atoi(arg + 5);
+        if (fChannels > 8 || fChannels < 1) 
+        {
+            printf("Error: Unsupported number of file channels : %d\n", fChannels);
+            return -1;
+        }
+        pConfig->fChannels = fChannels;
+    } 
+    // mono mode
+    else if (!strcmp(arg,"-M")) 
+    {
+        pConfig->monoMode = true;
+    } 
+    // bass 
+    else if (!strncmp(arg, "-basslvl:", 9))
+    {
+        const int bassEffectLevel = atoi(arg + 9);
+        if (bassEffectLevel > LVM_BE_MAX_EFFECTLEVEL || bassEffectLevel < LVM_BE_MIN_EFFECTLEVEL) 
+        {
+            printf("Error: Unsupported Bass Effect Level : %d\n",bassEffectLevel);
+            printUsage();
+            return -1;
+        }
+        pConfig->bassEffectLevel = bassEffectLevel;
+    } 
+    // eq
+    else if (!strncmp(arg, "-eqPreset:", 10)) 
+    {
+        const int eqPresetLevel = atoi(arg + 10);
+        const int numPresetLvls = 10;
+        if (eqPresetLevel >= numPresetLvls || eqPresetLevel < 0) 
+        {
+            printf("Error: Unsupported Equalizer Preset : %d\n", eqPresetLevel);
+            printUsage();
+            return -1;
+        }
+        pConfig->eqPresetLevel = eqPresetLevel;
+    } 
+    else if (!strcmp(arg, "-bE")) 
+    {
+        pConfig->bassEnable = LVM_BE_ON;
+        // printf("bass enable\n");
+    } 
+    else if (!strncmp(arg, "-bHPF:", 6))
+    {
+        const int bassHpf = atoi(arg + 6);
+        if (bassHpf != 0 && bassHpf != 1)
+        {
+            printf("Error: Unsupported Bass Enhancement high pass filter : %d\n", bassHpf);
+            printUsage();
+            return -1;
+        }
+        pConfig->bassHpf = bassHpf ? LVM_BE_HPF_ON : LVM_BE_HPF_OFF;
+    }
+    else if (!strcmp(arg, "-eqE")) 
+    {
+        pConfig->eqEnable = LVM_EQNB_ON;
+        // printf("EQ enable\n");
+    } 
+    else if (!strcmp(arg, "-tE")) 
+    {
+        pConfig->trebleEnable = LVM_TE_ON;
+        // printf("treble enable\n");
+    } 
+    else if (!strncmp(arg, "-treblelvl:", 11))
+    {
+        const int trebleEffectLevel = atoi(arg + 11);
+        if (trebleEffectLevel > LVM_TE_MAX_EFFECTLEVEL || trebleEffectLevel < LVM_TE_MIN_EFFECTLEVEL) 
+        {
+            printf("Error: Unsupported Treble Effect Level : %d\n", trebleEffectLevel);
+            printUsage();
+            return -1;
+        }
+        pConfig->trebleEffectLevel = trebleEffectLevel;
+    } 
+    else if (!strcmp(arg, "-csE")) 
+    {
+        pConfig->csEnable = LVM_MODE_ON;
+        // printf("lvm mode enable\n");
+    }
+    else 
+    {
+        return 0;
+    }
+    return 1;
+}
+
+/* Batch render of the jobs of a manifest on a pool of worker threads */
+typedef struct{
+    char                *infile;
+    char                *outfile;
+    int                 line;           // Line of the job in the manifest
+    uint64_t            size;           // Size of the input file, to balance the workers
+    lvmConfigParams_t   config;
+    double              audioUs;
+    double              renderUs;
+    int                 worker;
+    int                 errCode;
+}lvmBatchJob_t;
+
+/* Jobs of a worker, the owner takes them from the head and the other workers steal from the tail */
+typedef struct{
+    pthread_mutex_t     lock;
+    lvmBatchJob_t       **ppJobs;
+    int                 head;
+    int                 tail;
+}lvmBatchQueue_t;
+
+typedef struct{
+    EffectContext           context;
+    BundledEffectContext    bundle;
+    LVM_ControlParams_t     params;
+    lvmBatchQueue_t         queue;
+    pthread_t               thread;
+    int                     started;        // The thread was created and must be joined
+    int                     index;
+    int                     steals;
+    struct lvmBatch_s       *pBatch;
+}lvmBatchWorker_t;
+
+typedef struct lvmBatch_s{
+    lvmBatchJob_t       *pJobs;
+    int                 jobCount;
+    lvmBatchWorker_t    *pWorkers;
+    int                 workerCount;
+}lvmBatch_t;
+
+int lvmBatchReadManifest(const char *manifest, const lvmConfigParams_t *pBaseConfig, lvmBatch_t *pBatch)
+{
+    FILE *fp = fopen(manifest, "r");
+    char line[4096];
+    int lineNumber = 0;
+    int capacity = 0;
+
+    if (fp == NULL) 
+    {
+        printf("Cannot open batch manifest %s\n", manifest);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) 
+    {
+        char *save = NULL;
+        char *infile = strtok_r(line, " \t\r\n", &save);
+        lineNumber++;
+        if (infile == NULL || infile[0] == '#') continue;
+        char *outfile = strtok_r(NULL, " \t\r\n", &save);
+        if (outfile == NULL) 
+        {
+            printf("Error: %s:%d: missing output file\n", manifest, lineNumber);
+            fclose(fp);
+            return -1;
+        }
+        if (pBatch->jobCount == capacity) 
+        {
+            capacity = capacity ? capacity * 2 : 16;
+            lvmBatchJob_t *pJobs = (lvmBatchJob_t*)realloc(pBatch->pJobs, capacity * sizeof(lvmBatchJob_t));
+            if (pJobs == NULL) 
+            {
+                fclose(fp);
+                return -ENOMEM;
+            }
+            pBatch->pJobs = pJobs;
+        }
+        lvmBatchJob_t *pJob = &pBatch->pJobs[pBatch->jobCount];
+        memset(pJob, 0, sizeof(*pJob));
+        pJob->line = lineNumber;
+        pJob->config = *pBaseConfig;
+        for (char *arg = strtok_r(NULL, " \t\r\n", &save); arg != NULL; arg = strtok_r(NULL, " \t\r\n", &save)) 
+        {
+            if (lvmParseEffectOption(arg, &pJob->config) <= 0) 
+            {
+                printf("Error: %s:%d: unsupported job option %s\n", manifest, lineNumber, arg);
+                fclose(fp);
+                return -1;
+            }
+        }
+        pJob->infile = strdup(infile);
+        pJob->outfile = strdup(outfile);
+        pBatch->jobCount++;
+        struct stat st;
+        if (stat(infile, &st) == 0) pJob->size = (uint64_t)st.st_size;
+    }
+    fclose(fp);
+    return 0;
+}
+
+lvmBatchJob_t *lvmBatchNextJob(lvmBatchWorker_t *pWorker)
+{
+    lvmBatch_t *pBatch = pWorker->pBatch;
+    lvmBatchJob_t *pJob = NULL;
+
+    pthread_mutex_lock(&pWorker->queue.lock);
+    if (pWorker->queue.head < pWorker->queue.tail) 
+    {
+        pJob = pWorker->queue.ppJobs[pWorker->queue.head++];
+    }
+    pthread_mutex_unlock(&pWorker->queue.lock);
+
+    // No job is ever added, so the batch is done when every queue is empty
+    for (int i = 1; pJob == NULL && i < pBatch->workerCount; i++) 
+    {
+        lvmBatchQueue_t *pVictim = &pBatch->pWorkers[(pWorker->index + i) % pBatch->workerCount].queue;
+        pthread_mutex_lock(&pVictim->lock);
+        if (pVictim->head < pVictim->tail) 
+        {
+            pJob = pVictim->ppJobs[--pVictim->tail];
+            pWorker->steals++;
+        }
+        pthread_mutex_unlock(&pVictim->lock);
+    }
+    return pJob;
+}
+
+void *lvmBatchWorker(void *pArg)
+{
+    lvmBatchWorker_t *pWorker = (lvmBatchWorker_t *)pArg;
+    lvmBatchJob_t *pJob;
+
+    while ((pJob = lvmBatchNextJob(pWorker)) != NULL) 
+    {
+        FILE *finp = NULL;
+        FILE *fout = NULL;
+        const double start = lvmGetTimeUs();
+
+        pJob->worker = pWorker->index;
+        pJob->errCode = lvmOpenFiles(&pJob->config, pJob->infile, pJob->outfile, &finp, &fout);
+        if (pJob->errCode != 0) continue;
+
+        // The pooled instance starts each job without the history of the previous one
+        LVM_ClearAudioBuffers(pWorker->context.pBundledContext->hInstance);
+        if (pJob->config.mmapBlock > 0) 
+        {
+            pJob->errCode = lvmMmapProcess(&pWorker->context, &pWorker->params, &pJob->config,
+                                           pJob->infile, pJob->outfile);
+        }
+        else 
+        {
+            pJob->errCode = lvmMainProcess(&pWorker->context, &pWorker->params, &pJob->config, finp, fout);
+        }
+        fclose(finp);
+        fclose(fout);
+        pJob->renderUs = lvmGetTimeUs() - start;
+
+        const uint64_t frameSize = (uint64_t)pJob->config.fChannels * lvmFileSampleSize(pJob->config.inFile.format);
+        const uint64_t frames = pJob->config.inFile.dataSize / frameSize /
+                pJob->config.frameLength * pJob->config.frameLength;
+        pJob->audioUs = (double)frames * 1e6 / pJob->config.samplingFreq;
+    }
+    return NULL;
+}
+
+int lvmBatchCompareSize(const void *pA, const void *pB)
+{
+    const lvmBatchJob_t *pJobA = *(lvmBatchJob_t * const *)pA;
+    const lvmBatchJob_t *pJobB = *(lvmBatchJob_t * const *)pB;
+    return (pJobA->size < pJobB->size) - (pJobA->size > pJobB->size);
+}
+
+int lvmBatchProcess(lvmConfigParams_t *pBaseConfig, const char *manifest, int threadCount)
+{
+    lvmBatch_t batch;
+    int errCode;
+
+    memset(&batch, 0, sizeof(batch));
+    errCode = lvmBatchReadManifest(manifest, pBaseConfig, &batch);
+    if (errCode == 0 && batch.jobCount == 0) 
+    {
+        printf("Error: no jobs in batch manifest %s\n", manifest);
+        errCode = -1;
+    }
+    if (errCode != 0) 
+    {
+        for (int i = 0; i < batch.jobCount; i++) 
+        {
+            free(batch.pJobs[i].infile);
+            free(batch.pJobs[i].outfile);
+        }
+        free(batch.pJobs);
+        return errCode;
+    }
+
+    batch.workerCount = (threadCount < batch.jobCount) ? threadCount : batch.jobCount;
+    batch.pWorkers = (lvmBatchWorker_t*)calloc(batch.workerCount, sizeof(lvmBatchWorker_t));
+    lvmBatchJob_t **ppJobs = (lvmBatchJob_t**)malloc(batch.jobCount * sizeof(lvmBatchJob_t*));
+    lvmBatchJob_t **ppSorted = (lvmBatchJob_t**)malloc(batch.jobCount * sizeof(lvmBatchJob_t*));
+
+    // The jobs are dealt round robin from the longest, so that each worker starts with a long
+    // one, and the stealing evens out the rest
+    for (int i = 0; i < batch.jobCount; i++) ppSorted[i] = &batch.pJobs[i];
+    qsort(ppSorted, batch.jobCount, sizeof(lvmBatchJob_t*), lvmBatchCompareSize);
+    for (int i = 0, offset = 0; i < batch.workerCount; i++) 
+    {
+        lvmBatchQueue_t *pQueue = &batch.pWorkers[i].queue;
+        pQueue->ppJobs = ppJobs + offset;
+        for (int j = i; j < batch.jobCount; j += batch.workerCount) 
+        {
+            pQueue->ppJobs[pQueue->tail++] = ppSorted[j];
+        }
+        offset += pQueue->tail;
+    }
+    free(ppSorted);
+
+    // One pooled instance per worker, a clone of the first one
+    int workerCount = 0;
+    for (; workerCount < batch.workerCount && errCode == 0; workerCount++) 
+    {
+        lvmBatchWorker_t *pWorker = &batch.pWorkers[workerCount];
+        pWorker->index = workerCount;
+        pWorker->pBatch = &batch;
+        pthread_mutex_init(&pWorker->queue.lock, NULL);
+        if (workerCount == 0) 
+        {
+            errCode = lvmCreate(&pWorker->context, pBaseConfig, &pWorker->params);
+            continue;
+        }
+        pWorker->bundle = *batch.pWorkers[0].context.pBundledContext;
+        pWorker->context.pBundledContext = &pWorker->bundle;
+        pWorker->params = batch.pWorkers[0].params;
+        errCode = lvmCloneCreate(&batch.pWorkers[0].context, &pWorker->context);
+        if (errCode) pWorker->context.pBundledContext = NULL;
+    }
+    if (errCode != 0) 
+    {
+        printf("Error: lvmCreate returned with the error: %d\n", errCode);
+    }
+    else 
+    {
+        const double start = lvmGetTimeUs();
+        int threadErrors = 0;
+        for (int i = 1; i < batch.workerCount; i++) 
+        {
+            // The jobs of a worker without a thread are stolen by the others
+            const int rc = pthread_create(&batch.pWorkers[i].thread, NULL, lvmBatchWorker, &batch.pWorkers[i]);
+            if (rc != 0) 
+            {
+                printf("Error: cannot create the thread of batch worker %d: %s\n", i, strerror(rc));
+                threadErrors++;
+                continue;
+            }
+            batch.pWorkers[i].started = 1;
+        }
+        lvmBatchWorker(&batch.pWorkers[0]);
+        for (int i = 1; i < batch.workerCount; i++) 
+        {
+            if (!batch.pWorkers[i].started) continue;
+            const int rc = pthread_join(batch.pWorkers[i].thread, NULL);
+            if (rc != 0) 
+            {
+                printf("Error: cannot join the thread of batch worker %d: %s\n", i, strerror(rc));
+                threadErrors++;
+            }
+        }
+        const double wallUs = lvmGetTimeUs() - start;
+
+        double audioUs = 0;
+        int failed = 0;
+        int steals = 0;
+        for (int i = 0; i < batch.jobCount; i++) 
+        {
+            const lvmBatchJob_t *pJob = &batch.pJobs[i];
+            if (pJob->errCode != 0) 
+            {
+                printf("job %d: %s: error %d\n", pJob->line, pJob->infile, pJob->errCode);
+                failed++;
+                continue;
+            }
+            printf("job %d: %s -> %s: %.2f s audio, %.1fx real time on worker %d\n", pJob->line,
+                   pJob->infile, pJob->outfile, pJob->audioUs / 1e6, pJob->audioUs / pJob->renderUs,
+                   pJob->worker);
+            audioUs += pJob->audioUs;
+        }
+        for (int i = 0; i < batch.workerCount; i++) steals += batch.pWorkers[i].steals;
+        printf("batch: %d jobs (%d failed) on %d threads, %.2f s audio in %.2f s, %.1fx real time, %d steals\n",
+               batch.jobCount, failed, batch.workerCount, audioUs / 1e6, wallUs / 1e6, audioUs / wallUs, steals);
+        if (failed) errCode = -1;
+        if (threadErrors) errCode = -EAGAIN;
+    }
+
+    for (int i = 0; i < workerCount; i++) 
+    {
+        lvmBatchWorker_t *pWorker = &batch.pWorkers[i];
+        pthread_mutex_destroy(&pWorker->queue.lock);
+        if (pWorker->context.pBundledContext == NULL) continue;
+        if (pWorker->context.pBundledContext->hInstance != NULL) LvmEffect_free(&pWorker->context);
+        if (i == 0) free(pWorker->context.pBundledContext);
+    }
+    for (int i = 0; i < batch.jobCount; i++) 
+    {
+        free(batch.pJobs[i].infile);
+        free(batch.pJobs[i].outfile);
+    }
+    free(batch.pJobs);
+    free(batch.pWorkers);
+    free(ppJobs);
+    return errCode;
+}
+
+int main(int argc, const char *argv[]) 
+{
+  if (argc == 1) 
+  {
+    printUsage();
+    return -1;
+  }
+
+  lvmConfigParams_t lvmConfigParams; 
+  lvmConfigParams.samplingFreq    = 44100;
+  lvmConfigParams.nrChannels      = 2;
+  lvmConfigParams.chMask          = AUDIO_CHANNEL_OUT_STEREO;
+  lvmConfigParams.vcBal           = 0;
+  lvmConfigParams.fChannels       = 2;
+  lvmConfigParams.monoMode        = 0;
+  lvmConfigParams.bassEffectLevel = 0;
+  lvmConfigParams.eqPresetLevel   = 0;
+  lvmConfigParams.frameLength     = 256;
+  lvmConfigParams.benchCreate     = 0;
+  lvmConfigParams.lazyMem         = 0;
+  lvmConfigParams.coefBank        = 0;
+  lvmConfigParams.fsSwitch        = 0;
+  lvmConfigParams.denormalStats   = 0;
+  lvmConfigParams.dither          = 0;
+  lvmConfigParams.planar          = 0;
+  lvmConfigParams.pcm             = 0;
+  lvmConfigParams.accumulate      = 0;
+  lvmConfigParams.mmapBlock       = 0;
+  lvmConfigParams.psa             = 0;
+  lvmConfigParams.psaReaders      = 0;
+  lvmConfigParams.bassEnable      = LVM_BE_OFF;
+  lvmConfigParams.bassHpf         = LVM_BE_HPF_ON;
+  lvmConfigParams.trebleEnable    = LVM_TE_OFF;
+  lvmConfigParams.trebleEffectLevel = 0;
+  lvmConfigParams.eqEnable        = LVM_EQNB_OFF;
+  lvmConfigParams.csEnable        = LVM_MODE_OFF;
+  lvmConfigParams.eqNumBands      = FIVEBAND_NUMBANDS;
+  memset(&lvmConfigParams.instParamsEx, 0, sizeof(lvmConfigParams.instParamsEx));
+  lvmConfigParams.instParamsEx.Size = sizeof(lvmConfigParams.instParamsEx);
+  lvmConfigParams.moduleMemory.Allocated = 0;
+
+  const char *infile = NULL;
+  const char *outfile = NULL;
+  const char *batchManifest = NULL;
+  long threadCount = sysconf(_SC_NPROCESSORS_ONLN);
 
   for (int i = 1; i < argc; i++) 
   {
+    const int effectOption = lvmParseEffectOption(argv[i], &lvmConfigParams);
+    if (effectOption < 0) return -1;
+    if (effectOption > 0) continue;
     // input file
     if (!strncmp(argv[i], "-i:", 3)) infile = argv[i] + 3;
     // output file
     else if (!strncmp(argv[i], "-o:", 3)) outfile = argv[i] + 3;
-    // sampling rate
-    else if (!strncmp(argv[i], "-fs:", 4)) 
-    {
-      const int samplingFreq = atoi(argv[i] + 4);
-      if (samplingFreq != 8000 && samplingFreq != 11025 &&
-          samplingFreq != 12000 && samplingFreq != 16000 &&
-          samplingFreq != 22050 && samplingFreq != 24000 &&
-          samplingFreq != 32000 && samplingFreq != 44100 &&
-          samplingFreq != 48000 && samplingFreq != 88200 &&
-          samplingFreq != 96000 && samplingFreq != 176400 &&
-          samplingFreq != 192000) 
-          {
-            printf("Error: Unsupported Sampling Frequency : %d\n", samplingFreq);
-            return -1;
-          }
-      lvmConfigParams.samplingFreq = samplingFreq;
-    }
-
-    // balence
-    else if (!strncmp(argv[i], "-vcBal:", 7)) 
+    else if (!strcmp(argv[i], "-lazyMem")) 
+    {
+      lvmConfigParams.lazyMem = 1;
+    } 
+    else if (!strcmp(argv[i], "-shareCoefs")) 
+    {
+      lvmConfigParams.instParamsEx.CoefSharing = LVM_MODE_ON;
+    } 
+    else if (!strcmp(argv[i], "-coefBank")) 
+    {
+      lvmConfigParams.coefBank = 1;
+    } 
+    else if (!strncmp(argv[i], "-fsSwitch:", 10)) 
     {
-      const int vcBalance = atoi(argv[i] + 7);
-      if (vcBalance > 96 || vcBalance < -96) 
+      const int fsSwitch = atoi(argv[i] + 10);
+      if (lvmSampleRate(fsSwitch) == LVM_FS_INVALID) 
       {
-        printf("\nError: Unsupported volume balance value: %d\n", vcBalance);
+        printf("Error: Unsupported Sampling Frequency : %d\n", fsSwitch);
+        return -1;
       }
-      lvmConfigParams.vcBal = vcBalance;
+      lvmConfigParams.fsSwitch = fsSwitch;
     } 
-    // channel
-    else if (!strncmp(argv[i], "-fch:", 5)) 
+    else if (!strncmp(argv[i], "-denormal:", 10)) 
     {
-      const int fChannels = atoi(argv[i] + 5);
-      if (fChannels > 8 || fChannels < 1) 
+      const int denormalMode = atoi(argv[i] + 10);
+      if (denormalMode < LVM_DENORMAL_OFF || denormalMode > LVM_DENORMAL_OFFSET) 
       {
-        printf("Error: Unsupported number of file channels : %d\n", fChannels);
+        printf("Error: Unsupported denormal mode : %d\n", denormalMode);
         return -1;
       }
-      lvmConfigParams.fChannels = fChannels;
+      lvmConfigParams.instParamsEx.DenormalMode = (LVM_Denormal_en)denormalMode;
     } 
-    // mono mode
-    else if (!strcmp(argv[i],"-M")) 
+    else if (!strcmp(argv[i], "-denormalStats")) 
     {
-          lvmConfigParams.monoMode = true;
+      lvmConfigParams.denormalStats = 1;
+      lvmConfigParams.instParamsEx.DenormalDetect = LVM_MODE_ON;
     } 
-    // bass 
-    else if (!strncmp(argv[i], "-basslvl:", 9))
+    else if (!strcmp(argv[i], "-silence")) 
+    {
+      lvmConfigParams.instParamsEx.SilenceDetect = LVM_MODE_ON;
+    } 
+    else if (!strncmp(argv[i], "-eqBands:", 9)) 
     {
-      const int bassEffectLevel = atoi(argv[i] + 9);
-      if (bassEffectLevel > LVM_BE_MAX_EFFECTLEVEL || bassEffectLevel < LVM_BE_MIN_EFFECTLEVEL) 
+      lvmConfigParams.eqNumBands = atoi(argv[i] + 9);
+      if (lvmConfigParams.eqNumBands != FIVEBAND_NUMBANDS &&
+          lvmConfigParams.eqNumBands != THIRTYONEBAND_NUMBANDS) 
       {
-        printf("Error: Unsupported Bass Effect Level : %d\n",bassEffectLevel);
-        printUsage();
+        printf("Error: Unsupported number of equaliser bands : %d\n", lvmConfigParams.eqNumBands);
         return -1;
       }
-      lvmConfigParams.bassEffectLevel = bassEffectLevel;
     } 
-    // eq
-    else if (!strncmp(argv[i], "-eqPreset:", 10)) 
+    else if (!strcmp(argv[i], "-eqParallel")) 
+    {
+      lvmConfigParams.instParamsEx.EQNB_Parallel = LVM_MODE_ON;
+    } 
+    else if (!strcmp(argv[i], "-filterMerge")) 
+    {
+      lvmConfigParams.instParamsEx.FilterMerge = LVM_MODE_ON;
+    } 
+    else if (!strcmp(argv[i], "-dither")) 
+    {
+      lvmConfigParams.dither = 1;
+      dither_init(&lvmConfigParams.ditherState, 1);
+    } 
+    else if (!strncmp(argv[i], "-simd:", 6)) 
+    {
+      const int simdLevel = atoi(argv[i] + 6);
+      if (simdLevel < AUDIO_UTILS_SIMD_NONE || simdLevel > AUDIO_UTILS_SIMD_AVX2) 
+      {
+        printf("Error: Unsupported instruction set : %d\n", simdLevel);
+        return -1;
+      }
+      if ((int)audio_utils_set_simd_level((audio_utils_simd_t)simdLevel) != simdLevel) 
+      {
+        printf("Warning: instruction set %d not supported, using %d\n", simdLevel, audio_utils_get_simd_level());
+      }
+    } 
+    else if (!strncmp(argv[i], "-planar:", 8)) 
+    {
+      const int planar = atoi(argv[i] + 8);
+      if (planar < 0 || planar > 2) 
+      {
+        printf("Error: Unsupported planar mode : %d\n", planar);
+        return -1;
+      }
+      lvmConfigParams.planar = planar;
+      lvmConfigParams.instParamsEx.PlanarIO = (planar == 2) ? LVM_MODE_ON : LVM_MODE_OFF;
+    } 
+    else if (!strcmp(argv[i], "-pcm")) 
+    {
+      lvmConfigParams.pcm = 1;
+      lvmConfigParams.instParamsEx.PcmIO = LVM_MODE_ON;
+    } 
+    else if (!strncmp(argv[i], "-accumulate:", 12)) 
+    {
+      const int accumulate = atoi(argv[i] + 12);
+      if (accumulate < 0 || accumulate > 2) 
+      {
+        printf("Error: Unsupported accumulate mode : %d\n", accumulate);
+        return -1;
+      }
+      lvmConfigParams.accumulate = accumulate;
+      lvmConfigParams.instParamsEx.OutputMode = (accumulate == 2) ? LVM_OUTPUT_ACCUMULATE : LVM_OUTPUT_WRITE;
+    } 
+    else if (!strncmp(argv[i], "-psa:", 5)) 
+    {
+      const int psa = atoi(argv[i] + 5);
+      if (psa < 0 || psa > 2) 
+      {
+        printf("Error: Unsupported psa mode : %d\n", psa);
+        return -1;
+      }
+      lvmConfigParams.psa = psa;
+      lvmConfigParams.instParamsEx.PSA_Deferred = (psa == 2) ? LVM_MODE_ON : LVM_MODE_OFF;
+    } 
+    else if (!strcmp(argv[i], "-psaDecimate")) 
+    {
+      lvmConfigParams.instParamsEx.PSA_Decimation = LVM_MODE_ON;
+    } 
+    else if (!strncmp(argv[i], "-psaFFT:", 8)) 
+    {
+      const int bands = atoi(argv[i] + 8);
+      if (bands < 1 || bands > LVPSA_FFT_NBANDSMAX) 
+      {
+        printf("Error: Unsupported number of bands : %d\n", bands);
+        return -1;
+      }
+      lvmConfigParams.instParamsEx.PSA_FFTBands = (LVM_UINT16)bands;
+    } 
+    else if (!strncmp(argv[i], "-mmap", 5) && (argv[i][5] == '\0' || argv[i][5] == ':')) 
+    {
+      const int mmapBlock = (argv[i][5] == ':') ? atoi(argv[i] + 6) : 65536;
+      if (mmapBlock < 1) 
+      {
+        printf("Error: Unsupported mmap block size : %d\n", mmapBlock);
+        return -1;
+      }
+      lvmConfigParams.mmapBlock = mmapBlock;
+    } 
+    else if (!strncmp(argv[i], "-batch:", 7)) 
+    {
+      batchManifest = argv[i] + 7;
+    } 
+    else if (!strncmp(argv[i], "-psaReaders:", 12)) 
+    {
+      const int readers = atoi(argv[i] + 12);
+      if (readers < 1 || readers > LVM_PSA_MAX_READERS) 
+      {
+        printf("Error: Unsupported number of readers : %d\n", readers);
+        return -1;
+      }
+      lvmConfigParams.psaReaders = readers;
+    } 
+    else if (!strncmp(argv[i], "-threads:", 9)) 
+    {
+      threadCount = atoi(argv[i] + 9);
+      if (threadCount < 1) 
+      {
+        printf("Error: Unsupported number of threads : %ld\n", threadCount);
+        return -1;
+      }
+    } 
+    else if (!strcmp(argv[i], "-benchConvert")) 
     {
-      const int eqPresetLevel = atoi(argv[i] + 10);
-      const int numPresetLvls = 10;
-      if (eqPresetLevel >= numPresetLvls || eqPresetLevel < 0) 
+      return lvmBenchConvert() ? -1 : 0;
+    } 
+    else if (!strncmp(argv[i], "-benchPsa", 9) && (argv[i][9] == '\0' || argv[i][9] == ':')) 
+    {
+      const int bands = (argv[i][9] == ':') ? atoi(argv[i] + 10) : 9;
+      if (bands < 1 || bands > 30) 
       {
-        printf("Error: Unsupported Equalizer Preset : %d\n", eqPresetLevel);
-        printUsage();
+        printf("Error: Unsupported number of bands : %d\n", bands);
         return -1;
       }
-      lvmConfigParams.eqPresetLevel = eqPresetLevel;
+      return lvmBenchPsa(bands) ? -1 : 0;
     } 
-    else if (!strcmp(argv[i], "-bE")) 
+    else if (!strncmp(argv[i], "-benchPsaFFT", 12) && (argv[i][12] == '\0' || argv[i][12] == ':')) 
     {
-      lvmConfigParams.bassEnable = LVM_BE_ON;
-      // printf("bass enable\n");
+      const int bands = (argv[i][12] == ':') ? atoi(argv[i] + 13) : 128;
+      if (bands < 1 || bands > LVPSA_FFT_NBANDSMAX) 
+      {
+        printf("Error: Unsupported number of bands : %d\n", bands);
+        return -1;
+      }
+      return lvmBenchPsaFFT(bands) ? -1 : 0;
     } 
-    else if (!strcmp(argv[i], "-eqE")) 
+    else if (!strcmp(argv[i], "-benchEq")) 
     {
-      lvmConfigParams.eqEnable = LVM_EQNB_ON;
-      // printf("EQ enable\n");
+      return lvmBenchEq() ? -1 : 0;
     } 
-    else if (!strcmp(argv[i], "-tE")) 
+    else if (!strcmp(argv[i], "-benchEqBands")) 
     {
-      lvmConfigParams.trebleEnable = LVM_TE_ON;
-      // printf("treble enable\n");
+      return lvmBenchEqBands() ? -1 : 0;
     } 
-    else if (!strcmp(argv[i], "-csE")) 
+    else if (!strncmp(argv[i], "-benchCreate:", 13)) 
     {
-      lvmConfigParams.csEnable = LVM_MODE_ON;
-      // printf("lvm mode enable\n");
+      const int benchCreate = atoi(argv[i] + 13);
+      if (benchCreate < 1) 
+      {
+        printf("Error: Unsupported number of sessions : %d\n", benchCreate);
+        return -1;
+      }
+      lvmConfigParams.benchCreate = benchCreate;
     } 
     else if (!strcmp(argv[i], "-h")) 
     {
@@ -680,38 +3245,101 @@ int main(int argc, const char *argv[])
     }
   }
 
-  if (infile == NULL || outfile == NULL) 
+  if (lvmConfigParams.psaReaders > 0 && lvmConfigParams.psa == 0) 
   {
-    printf("Error: missing input/output files\n");
-    printUsage();
+    printf("Error: -psaReaders needs -psa\n");
+    return -1;
+  }
+
+  if (lvmConfigParams.instParamsEx.CoefSharing == LVM_MODE_ON && lvmConfigParams.lazyMem == 0) 
+  {
+    printf("Error: -shareCoefs needs -lazyMem\n");
+    return -1;
+  }
+
+  if (lvmConfigParams.pcm && lvmConfigParams.accumulate) 
+  {
+    printf("Error: -pcm can not be combined with -accumulate\n");
     return -1;
   }
 
-  FILE *finp = fopen(infile, "rb");
-  if (finp == NULL) 
+  if (lvmConfigParams.mmapBlock > 0 &&
+      (lvmConfigParams.planar || lvmConfigParams.pcm || lvmConfigParams.accumulate ||
+       lvmConfigParams.psa || lvmConfigParams.fsSwitch != 0)) 
   {
-    printf("Cannot open input file %s", infile);
+    printf("Error: -mmap can not be combined with -planar, -pcm, -accumulate, -psa or -fsSwitch\n");
     return -1;
   }
 
-  FILE *fout = fopen(outfile, "wb");
-  if (fout == NULL) 
+  if (batchManifest != NULL) 
+  {
+    // The pooled instances share the module allocator of the first one, the analysis
+    // thread of -psa serves a single instance
+    if (lvmConfigParams.lazyMem || lvmConfigParams.benchCreate || lvmConfigParams.psa) 
+    {
+      printf("Error: -batch can not be combined with -lazyMem, -benchCreate or -psa\n");
+      return -1;
+    }
+    if (lvmConfigParams.coefBank) 
+    {
+      lvmConfigParams.instParamsEx.CoefBankRates = LVM_FS_BANK(lvmSampleRate(lvmConfigParams.samplingFreq));
+      if (lvmConfigParams.fsSwitch != 0) 
+      {
+        lvmConfigParams.instParamsEx.CoefBankRates |= LVM_FS_BANK(lvmSampleRate(lvmConfigParams.fsSwitch));
+      }
+    }
+    return lvmBatchProcess(&lvmConfigParams, batchManifest, threadCount < 1 ? 1 : (int)threadCount) ? -1 : 0;
+  }
+
+  if (infile == NULL || outfile == NULL) 
   {
-    printf("Cannot open output file %s", outfile);
-    fclose(finp);
+    printf("Error: missing input/output files\n");
+    printUsage();
     return -1;
   }
 
+  FILE *finp = NULL;
+  FILE *fout = NULL;
+  if (lvmOpenFiles(&lvmConfigParams, infile, outfile, &finp, &fout) != 0) return -1;
+
   EffectContext context;
   LVM_ControlParams_t params;
+  if (lvmConfigParams.coefBank) 
+  {
+    lvmConfigParams.instParamsEx.CoefBankRates = LVM_FS_BANK(lvmSampleRate(lvmConfigParams.samplingFreq));
+    if (lvmConfigParams.fsSwitch != 0) 
+    {
+      lvmConfigParams.instParamsEx.CoefBankRates |= LVM_FS_BANK(lvmSampleRate(lvmConfigParams.fsSwitch));
+    }
+  }
   int errCode = lvmCreate(&context, &lvmConfigParams, &params);
-  if (errCode == 0) 
+  if (errCode == 0 && lvmConfigParams.benchCreate > 0) 
+  {
+    errCode = lvmBenchCreate(&lvmConfigParams);
+    if (errCode != 0) 
+    {
+        printf("Error: lvmBenchCreate returned with the error: %d", errCode);
+    }
+  }
+  if (errCode == 0 && lvmConfigParams.mmapBlock > 0) 
+  {
+    errCode = lvmMmapProcess(&context, &params, &lvmConfigParams, infile, outfile);
+    if (errCode != 0) 
+    {
+        printf("Error: lvmMmapProcess returned with the error: %d", errCode);
+    }
+  }
+  else if (errCode == 0) 
   {
     errCode = lvmMainProcess(&context, &params, &lvmConfigParams, finp, fout);
     if (errCode != 0) 
     {
         printf("Error: lvmMainProcess returned with the error: %d",errCode);
     }
+    else if (lvmConfigParams.lazyMem) 
+    {
+      lvmReportMemory(&context, &lvmConfigParams);
+    }
   } 
   else 
   {
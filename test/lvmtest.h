@@ -9,7 +9,8 @@
 
 
 #define FIVEBAND_NUMBANDS          5
-#define MAX_NUM_BANDS              5
+#define THIRTYONEBAND_NUMBANDS     31
+#define MAX_NUM_BANDS              32
 #define MAX_CALL_SIZE              256
 #define LVM_MAX_SESSIONS           32
 #define LVM_UNUSED_SESSION         INT_MAX
@@ -117,6 +118,16 @@ static const LVM_UINT16 EQNB_5BandPresetsQFactors[] = {
                                        96,
                                        96};
 
+// ISO 266 third octave centre frequencies of a graphic equaliser, the gains of a preset are
+// interpolated from its 5 band gains
+static const LVM_UINT16 EQNB_31BandPresetsFrequencies[] = {
+                                       20, 25, 31, 40, 50, 63, 80, 100, 125, 160,
+                                       200, 250, 315, 400, 500, 630, 800, 1000, 1250, 1600,
+                                       2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500, 16000,
+                                       20000};
+
+static const LVM_UINT16 EQNB_31BandPresetsQFactor = 432;   /* Third octave bandwidth, Q x100 */
+
 static const LVM_INT16 EQNB_5BandNormalPresets[] = {
                                        3, 0, 0, 0, 3,       /* Normal Preset */
                                        8, 5, -3, 5, 6,      /* Classical Preset */